@@ -5,4 +5,8 @@
 #define BASE_BATTERY_ID    0x00000
 #define BASE_CONTROLLER_ID 0x00000
 
+/* IDs de falhas (erros do controlador e do BMS; BMS usa também ID_2 + 1) */
+#define BASE_BATTERY_ID_2    0x00000
+#define BASE_CONTROLLER_ID_2 0x00000
+
 #endif 
\ No newline at end of file
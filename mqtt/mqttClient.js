@@ -2,9 +2,12 @@
 const mqtt = require('mqtt');
 const { addCanMessage, getDecodedCanData } = require('../utils/api');
 const { saveCanMessage } = require('../utils/canService'); // ✅ Importa direto
+const { isAnchor, updateAnchor, resolveTimestamp } = require('../utils/timeBase');
 
 const MQTT_BROKER = process.env.MQTT_BROKER;
 const MQTT_TOPIC = process.env.MQTT_TOPIC;
+// Lane de falhas do firmware (frames de erro do MCU/BMS publicados na hora)
+const MQTT_FAULT_TOPIC = process.env.MQTT_FAULT_TOPIC || `${MQTT_TOPIC}/falhas`;
 const API_URL = process.env.API_URL;
 
 let client;
@@ -17,22 +20,99 @@ async function connectMQTT() {
 
   client.on('connect', () => {
     console.log(`✅ Conectado ao broker MQTT: ${MQTT_BROKER}`);
-    client.subscribe(MQTT_TOPIC, (err) => {
+    client.subscribe([MQTT_TOPIC, MQTT_FAULT_TOPIC], (err) => {
       if (err) {
-        console.error(`❌ Falha ao subscrever tópico ${MQTT_TOPIC}:`, err);
+        console.error(`❌ Falha ao subscrever tópicos ${MQTT_TOPIC}, ${MQTT_FAULT_TOPIC}:`, err);
       } else {
-        console.log(`📡 Subscrito ao tópico: ${MQTT_TOPIC}`);
+        console.log(`📡 Subscrito aos tópicos: ${MQTT_TOPIC}, ${MQTT_FAULT_TOPIC}`);
       }
     });
   });
 
   client.on('message', async (topic, message) => {
-    if (topic === MQTT_TOPIC) {
+    if (topic === MQTT_TOPIC || topic === MQTT_FAULT_TOPIC) {
       try {
         const payload = message.toString();
         const data = JSON.parse(payload);
         //data.deviceId = data.deviceId || 'unknown-device'; // Garantir que deviceId exista
-        
+
+        // Âncora de tempo: apenas atualiza a base de tempo do dispositivo
+        if (isAnchor(data)) {
+          updateAnchor(MQTT_TOPIC, data);
+          return;
+        }
+
+        // Contadores das filas do firmware (perdas por política de sobrecarga)
+        if (data.type === 'queue') {
+          console.log(`📊 Filas ESP32 [${data.pol}]: recebidos=${data.acc} pendentes=${data.pend} ` +
+            `perdidos(novos=${data.dn}, antigos=${data.do}, substituídos=${data.sup}, spill=${data.spl}) ` +
+            `spill=${data.sp} falhas_perdidas=${data.fd}`);
+          if (data.bf !== undefined) {
+            console.log(`📦 Envio ESP32: lote=${data.bf} intervalo=${data.bi}ms taxa=${data.br}/s latência=${data.lat}ms`);
+          }
+          if (data.cfg !== undefined) {
+            console.log(`⚙️ Config ESP32: versão=${data.cfg} recusadas=${data.cfr} ` +
+              `fora_do_filtro=${data.flt} dead-band=${data.db}`);
+          }
+          return;
+        }
+
+        // Resumo do barramento: carga, IDs mais frequentes e IDs ausentes
+        if (data.type === 'bus') {
+          const hex = (id) => `0x${Number(id).toString(16).toUpperCase()}`;
+          const top = (data.top || []).map(([id, fps]) => `${hex(id)}=${fps}/s`).join(' ');
+          console.log(`🚌 Barramento ESP32: carga=${(data.load / 10).toFixed(1)}% taxa=${data.fps}/s ` +
+            `ids=${data.ids} alarmes=${data.al} voltaram=${data.rec} top: ${top}`);
+          if (data.sil) {
+            console.warn('⚠️ Barramento CAN calado: nenhum frame chegando ao ESP32');
+          }
+          (data.miss || []).forEach(([id, silentMs, periodMs]) => {
+            console.warn(`⚠️ ID ${hex(id)} ausente há ${silentMs} ms (período aprendido ${periodMs} ms)`);
+          });
+          return;
+        }
+
+        // Resumo da viagem calculado no ESP32 (publicado no key-off)
+        if (data.type === 'trip') {
+          const [eco, std, turbo] = (data.mode || []).map((ms) => Math.round(ms / 1000));
+          console.log(`🏁 Viagem #${data.n} (${(data.dur / 60000).toFixed(1)} min): ` +
+            `consumo=${(data.whc / 1000).toFixed(1)}Wh regen=${(data.whr / 1000).toFixed(1)}Wh ` +
+            `pico=${data.pk}W média=${data.avg}W distância=${(data.dist / 1000).toFixed(2)}km ` +
+            `rpm_máx=${data.rpm} SoC ${data.soc0}→${data.soc1}% ECO/STD/TURBO=${eco}/${std}/${turbo}s`);
+          return;
+        }
+
+        // Alarme das regras avaliadas no ESP32 (transição ativo/normalizado)
+        if (data.type === 'alarm') {
+          const scale = ['v', 'a', 'tq'].includes(data.sig) ? 10 : 1;
+          const value = data.val / scale;
+          const threshold = data.thr / scale;
+          if (data.on) {
+            console.warn(`🚨 Regra ${data.rule}: ${data.sig}=${value} (limiar ${threshold})`);
+          } else {
+            console.log(`✅ Regra ${data.rule} normalizada: ${data.sig}=${value}`);
+          }
+          return;
+        }
+
+        // Janela mín/máx/média/último por sinal (só as longas vão para o log)
+        if (data.type === 'win') {
+          if (data.w >= 10000 && data.v) {
+            const [vMin, vMax, vMean] = data.v.map((v) => (v / 10).toFixed(1));
+            const rpm = data.rpm ? ` rpm=${data.rpm[0]}..${data.rpm[1]}` : '';
+            console.log(`🪟 Janela ${data.w / 1000}s: tensão=${vMin}..${vMax}V (média ${vMean}V)${rpm}`);
+          }
+          return;
+        }
+
+        // Reconstrói o horário absoluto a partir do delta monotônico
+        // (as âncoras vêm só no tópico principal, comum às duas lanes)
+        data.timestamp = resolveTimestamp(MQTT_TOPIC, data) || new Date();
+
+        if (topic === MQTT_FAULT_TOPIC) {
+          console.warn(`⚠️ Frame de falha recebido (ID 0x${Number(data.canId).toString(16)}): ${data.data}`);
+        }
+
         await saveCanMessage(data); // Salvar diretamente no banco
 
         
@@ -28,8 +28,8 @@ const httpServer = http.createServer(app);
 const wss = new WebSocket.Server({ server: httpsServer });
 
 wss.on('connection', async (ws, req) => {
-  ws.on('message', (message) => {
-    handleWebSocketMessage(wss, ws, message, req);
+  ws.on('message', (message, isBinary) => {
+    handleWebSocketMessage(wss, ws, message, req, isBinary);
   });
 
   ws.on('close', () => {
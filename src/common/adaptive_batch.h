@@ -0,0 +1,177 @@
+#ifndef ADAPTIVE_BATCH_H
+#define ADAPTIVE_BATCH_H
+
+// ------------------------------------------------------------------
+// --- LOTE E INTERVALO DE ENVIO ADAPTATIVOS (AIMD) ---
+// ------------------------------------------------------------------
+// Ponto de operação da task de envio: quantos frames de telemetria
+// entregar por ciclo (lote) e de quanto em quanto tempo acordar
+// (intervalo). O AIMD atua sobre uma taxa limite (frames/s); o lote é a
+// taxa × intervalo. Ajustados a cada ciclo pelo que foi observado:
+//
+//   sink recusou frames (outbox
+//   cheia) ou atraso de fila > alvo → taxa pela metade (MD), no máximo uma
+//                                    vez por latência observada
+//   sobrou fila depois do ciclo    → taxa + passo proporcional ao tempo
+//                                    (AI) e intervalo mínimo
+//   ciclo quase vazio (< mínimo)   → intervalo + passo (junta mais frames
+//                                    por mensagem quando há folga)
+//   fila vazia, enlace saudável    → intervalo − passo
+//
+// Com o enlace lento a taxa cai e o excesso fica na fila, onde a política
+// de sobrecarga decide o que descartar ou desviar, em vez de se acumular
+// nos buffers da rede ou ser recusado pela outbox. A latência e as
+// recusas vêm dos sinks (Sink::feedback()).
+//
+// O sinal de atraso é a latência acima da base (menor latência vista
+// recentemente), não a latência absoluta: um enlace de RTT alto mas sem
+// fila não deve ser estrangulado.
+
+#include <stdint.h>
+
+/**
+ * @brief O que os sinks observaram do enlace (Sink::feedback())
+ */
+struct LinkFeedback {
+  uint32_t latencyUs = 0; // Maior latência de entrega entre os sinks (0 = sem medida)
+  uint32_t rejected = 0;  // Total acumulado de frames recusados (buffer cheio)
+};
+
+/**
+ * @brief Limites e passos do controlador
+ */
+struct AdaptiveBatchConfig {
+  uint16_t minFrames = 5;
+  uint16_t maxFrames = 500;
+  uint32_t minIntervalMs = 20;
+  uint32_t maxIntervalMs = 200;
+  uint32_t stepIntervalMs = 10;
+  uint32_t initialIntervalMs = 50;
+  uint32_t initialRateFps = 1000;
+  uint32_t increaseFpsPerS = 500;  // Aumento aditivo da taxa por segundo
+  uint32_t targetQueueUs = 100000; // Atraso de fila tolerado acima da base
+  uint32_t baseWindowMs = 2000;    // Base = mínimo das duas últimas janelas
+};
+
+/**
+ * @brief Ponto de operação atual (publicado no relatório das filas)
+ */
+struct BatchMetrics {
+  uint16_t batchFrames = 0;
+  uint32_t intervalMs = 0;
+  uint32_t rateFps = 0;       // Taxa limite do AIMD
+  uint32_t latencyUs = 0;     // Média móvel da latência do enlace
+  uint32_t baseLatencyUs = 0; // Latência sem fila (mínimo recente)
+  uint32_t throughputFps = 0; // Média móvel de frames entregues por segundo
+  uint32_t decreases = 0;     // Reduções multiplicativas (congestionamentos)
+};
+
+class AdaptiveBatch {
+public:
+  void begin(const AdaptiveBatchConfig &config = AdaptiveBatchConfig()) {
+    config_ = config;
+    metrics_ = BatchMetrics();
+    metrics_.intervalMs = config.initialIntervalMs;
+    metrics_.rateFps = config.initialRateFps;
+    holdUs_ = 0;
+    windowUs_ = 0;
+    windowMinUs_ = previousMinUs_ = UINT32_MAX;
+    metrics_.batchFrames = batchFor(metrics_.rateFps, metrics_.intervalMs);
+  }
+
+  /** @brief Frames de telemetria a entregar neste ciclo */
+  uint16_t batchFrames() const { return metrics_.batchFrames; }
+
+  /** @brief Espera até o próximo ciclo */
+  uint32_t intervalMs() const { return metrics_.intervalMs; }
+
+  const BatchMetrics &metrics() const { return metrics_; }
+
+  /**
+   * @brief Fim de um ciclo: ajusta a taxa, o intervalo e o lote
+   * @param sent      Frames de telemetria entregues no ciclo
+   * @param elapsedUs Duração do ciclo anterior completo (envio + espera)
+   * @param latencyUs Latência do enlace informada pelos sinks (0 = sem medida)
+   * @param backlog   Frames que ficaram na fila de telemetria
+   * @param rejected  Frames do ciclo recusados pelos sinks (buffer cheio)
+   */
+  void update(uint32_t sent, uint32_t elapsedUs, uint32_t latencyUs, uint32_t backlog,
+              uint32_t rejected = 0) {
+    // Médias móveis com peso 1/4 para a amostra nova
+    if (latencyUs > 0) {
+      int64_t delta = (int64_t)latencyUs - metrics_.latencyUs;
+      metrics_.latencyUs = (uint32_t)(metrics_.latencyUs + delta / 4);
+
+      if (latencyUs < windowMinUs_) windowMinUs_ = latencyUs;
+    }
+    if (elapsedUs > 0) {
+      uint32_t fps = (uint32_t)((uint64_t)sent * 1000000ULL / elapsedUs);
+      int64_t delta = (int64_t)fps - metrics_.throughputFps;
+      metrics_.throughputFps = (uint32_t)(metrics_.throughputFps + delta / 4);
+    }
+
+    // Base: mínimo da janela atual e da anterior. Uma rota mais lenta é
+    // aprendida em até duas janelas; uma fila que dura menos que isso
+    // nunca vira base (ciclos de redução a esvaziam)
+    windowUs_ += elapsedUs;
+    if (windowUs_ >= config_.baseWindowMs * 1000ULL) {
+      previousMinUs_ = windowMinUs_;
+      windowMinUs_ = UINT32_MAX;
+      windowUs_ = 0;
+    }
+    uint32_t base = windowMinUs_ < previousMinUs_ ? windowMinUs_ : previousMinUs_;
+    if (base != UINT32_MAX) metrics_.baseLatencyUs = base;
+
+    uint32_t rate = metrics_.rateFps;
+    uint32_t interval = metrics_.intervalMs;
+    holdUs_ = holdUs_ > elapsedUs ? holdUs_ - elapsedUs : 0;
+
+    if (rejected > 0 || metrics_.latencyUs > metrics_.baseLatencyUs + config_.targetQueueUs) {
+      // Congestionado: taxa pela metade, no máximo uma vez por latência
+      // observada, dando tempo ao enlace de responder
+      if (holdUs_ == 0) {
+        rate /= 2;
+        metrics_.decreases++;
+        holdUs_ = metrics_.latencyUs;
+      }
+    } else if (backlog > 0) {
+      // Demanda maior que a taxa: aumento aditivo, ciclos mais curtos
+      rate += (uint32_t)((uint64_t)config_.increaseFpsPerS * elapsedUs / 1000000ULL);
+      interval = config_.minIntervalMs;
+    } else if (sent < config_.minFrames) {
+      // Folga: ciclos mais espaçados, lotes mais cheios
+      interval += config_.stepIntervalMs;
+    } else {
+      // Enlace saudável e fila vazia: ciclos mais curtos, dado mais novo
+      interval = interval > config_.stepIntervalMs ? interval - config_.stepIntervalMs : 0;
+    }
+
+    metrics_.rateFps = clamp(rate, minRate(), maxRate());
+    // Taxa baixa: em vez de lotes abaixo do mínimo, ciclos mais longos
+    uint32_t stretched = config_.minFrames * 1000UL / metrics_.rateFps;
+    if (interval < stretched) interval = stretched;
+    metrics_.intervalMs = clamp(interval, config_.minIntervalMs, config_.maxIntervalMs);
+    metrics_.batchFrames = batchFor(metrics_.rateFps, metrics_.intervalMs);
+  }
+
+private:
+  static uint32_t clamp(uint32_t value, uint32_t low, uint32_t high) {
+    return value < low ? low : value > high ? high : value;
+  }
+
+  uint32_t minRate() const { return config_.minFrames * 1000UL / config_.maxIntervalMs; }
+  uint32_t maxRate() const { return config_.maxFrames * 1000UL / config_.minIntervalMs; }
+
+  uint16_t batchFor(uint32_t rate, uint32_t intervalMs) const {
+    return (uint16_t)clamp(rate * intervalMs / 1000, config_.minFrames, config_.maxFrames);
+  }
+
+  AdaptiveBatchConfig config_;
+  BatchMetrics metrics_;
+  uint32_t holdUs_ = 0; // Espera antes de outra redução
+  uint64_t windowUs_ = 0;
+  uint32_t windowMinUs_ = UINT32_MAX;
+  uint32_t previousMinUs_ = UINT32_MAX;
+};
+
+#endif // ADAPTIVE_BATCH_H
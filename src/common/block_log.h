@@ -0,0 +1,278 @@
+#ifndef BLOCK_LOG_H
+#define BLOCK_LOG_H
+
+// ------------------------------------------------------------------
+// --- LOG EM BLOCOS COM CRC (À PROVA DE QUEDA DE ENERGIA) ---
+// ------------------------------------------------------------------
+// A moto é desligada cortando a alimentação: uma gravação interrompida
+// deixa linhas pela metade ou setores com lixo no fim do CSV. Aqui o log
+// é um único arquivo pré-alocado de N blocos de 512 B (um setor do SD),
+// gravados em círculo. Cada bloco leva só linhas inteiras e um cabeçalho
+// com sequência e CRC32; um bloco gravado não é alterado até a próxima
+// volta, então uma queda só pode estragar o bloco que estava em gravação.
+//
+// Formato do bloco (little-endian), lido por utils/blockLog.js:
+//   magic (uint32, "VZBL") | seq (uint32, >= 1) | tamanho (uint16)
+//   | versão (uint8) | flags (uint8) | crc32 (uint32) | linhas[tamanho]
+// O CRC cobre os 12 bytes anteriores do cabeçalho e as linhas.
+//
+// O bloco da sequência s fica no índice (s - 1) % N. Recuperação no boot,
+// sem percorrer o arquivo:
+//   1. busca binária do último índice i com seq(i) == seq(0) + i (só
+//      cabeçalhos, ~log2(N) leituras);
+//   2. confere o CRC desse bloco e, se falhar, volta até
+//      BLOCK_LOG_RECOVERY_BLOCKS blocos;
+//   3. continua gravando no índice seguinte.
+// Se o bloco 0 for o que se perdeu na queda, a busca parte do último
+// bloco do arquivo. Só se nada for válido na janela o arquivo inteiro é
+// lido (cartão danificado).
+
+#include <stdint.h>
+#include <string.h>
+#include "segment_log.h" // StdioSegmentFile
+
+#define BLOCK_LOG_BLOCK_BYTES 512
+#define BLOCK_LOG_HEADER_BYTES 16
+#define BLOCK_LOG_PAYLOAD_BYTES (BLOCK_LOG_BLOCK_BYTES - BLOCK_LOG_HEADER_BYTES)
+#define BLOCK_LOG_MAGIC 0x4C425A56UL // "VZBL"
+#define BLOCK_LOG_VERSION 1
+#define BLOCK_LOG_RECOVERY_BLOCKS 4 // Blocos conferidos para trás no boot
+
+/**
+ * @brief CRC-32 (IEEE 802.3, o mesmo do zlib) com tabela de 16 entradas
+ * @param crc Valor anterior, para continuar um cálculo (0 no início)
+ */
+inline uint32_t blockLogCrc32(const uint8_t *data, size_t length, uint32_t crc = 0) {
+  static const uint32_t TABLE[16] = {
+    0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+    0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+    0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+    0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL,
+  };
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+    crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+  }
+  return ~crc;
+}
+
+/**
+ * @brief Resultado da recuperação no boot e contadores do log
+ */
+struct BlockLogStats {
+  uint32_t written = 0;         // Bytes de linhas aceitos
+  uint32_t rejected = 0;        // Gravações recusadas (erro ou linha grande demais)
+  uint32_t blocks = 0;          // Blocos gravados desde o boot
+  uint32_t recoveryReads = 0;   // Blocos lidos para retomar no boot
+  uint32_t recoveryDropped = 0; // Blocos do fim descartados (CRC inválido)
+  bool recoveryFullScan = false;
+};
+
+template <class LogFile = StdioSegmentFile>
+class BlockLog {
+public:
+  /**
+   * @brief Abre (ou cria e pré-aloca) o arquivo e retoma após o último bloco válido
+   * @param path   Arquivo do log, ex.: "/sd/datalog.vzl"
+   * @param blocks Capacidade em blocos de BLOCK_LOG_BLOCK_BYTES
+   */
+  bool begin(const char *path, uint32_t blocks) {
+    file_.close();
+    stats_ = BlockLogStats();
+    length_ = 0;
+    if (blocks < 2) return false;
+    count_ = blocks;
+    if (!file_.open(path, false)) return false;
+    bool fresh = file_.size() < count_ * BLOCK_LOG_BLOCK_BYTES;
+    if (!file_.reserve(count_ * BLOCK_LOG_BLOCK_BYTES)) return false;
+
+    // Arquivo recém-criado: nada a recuperar
+    lastSeq_ = fresh ? 0 : recover();
+    return true;
+  }
+
+  /**
+   * @brief Acrescenta linhas inteiras ao bloco em montagem
+   * @details Se não couberem, o bloco atual é gravado e outro começa; um
+   *          registro nunca é dividido entre blocos
+   */
+  bool write(const char *data, size_t length) {
+    if (!file_.isOpen() || length == 0 || length > BLOCK_LOG_PAYLOAD_BYTES) {
+      stats_.rejected++;
+      return false;
+    }
+    if (length_ + length > BLOCK_LOG_PAYLOAD_BYTES && !writeBlock()) {
+      stats_.rejected++;
+      return false;
+    }
+    memcpy(block_ + BLOCK_LOG_HEADER_BYTES + length_, data, length);
+    length_ += (uint16_t)length;
+    stats_.written += length;
+    return true;
+  }
+
+  /**
+   * @brief Bytes livres no bloco em montagem (0 com o log fechado)
+   * @details Com espaço para a maior linha possível, a linha pode ser
+   *          formatada direto em cursor() e aceita com commit(), sem a
+   *          cópia de write()
+   */
+  size_t available() {
+    return file_.isOpen() ? BLOCK_LOG_PAYLOAD_BYTES - length_ : 0;
+  }
+
+  /** @brief Onde a próxima linha começa no bloco em montagem */
+  char *cursor() { return (char *)block_ + BLOCK_LOG_HEADER_BYTES + length_; }
+
+  /**
+   * @brief Aceita as linhas inteiras já formatadas em cursor()
+   * @param length Até available()
+   */
+  bool commit(size_t length) {
+    if (length == 0 || length > available()) {
+      stats_.rejected++;
+      return false;
+    }
+    length_ += (uint16_t)length;
+    stats_.written += length;
+    return true;
+  }
+
+  /**
+   * @brief Fecha o bloco em montagem (mesmo incompleto) e grava no meio físico
+   * @details O bloco não é reaberto: as próximas linhas vão para o seguinte
+   */
+  bool flush() {
+    if (length_ == 0) return true;
+    return writeBlock() && file_.sync();
+  }
+
+  /** @brief Sequência do último bloco gravado (0 = log vazio) */
+  uint32_t lastSequence() const { return lastSeq_; }
+  uint32_t capacityBlocks() const { return count_; }
+  const BlockLogStats &stats() const { return stats_; }
+
+private:
+  uint32_t indexOf(uint32_t seq) const { return (seq - 1) % count_; }
+
+  static void put32(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+  }
+
+  static uint32_t get32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+  }
+
+  /** @brief Grava o bloco em montagem no índice da próxima sequência */
+  bool writeBlock() {
+    uint32_t seq = lastSeq_ + 1;
+    uint8_t *h = block_;
+    put32(h, BLOCK_LOG_MAGIC);
+    put32(h + 4, seq);
+    h[8] = (uint8_t)length_;
+    h[9] = (uint8_t)(length_ >> 8);
+    h[10] = BLOCK_LOG_VERSION;
+    h[11] = 0;
+    put32(h + 12, blockLogCrc32(h + BLOCK_LOG_HEADER_BYTES, length_, blockLogCrc32(h, 12)));
+    // O resto do setor é zerado: nada da volta anterior fica no bloco
+    memset(h + BLOCK_LOG_HEADER_BYTES + length_, 0, BLOCK_LOG_PAYLOAD_BYTES - length_);
+
+    if (!file_.seek(indexOf(seq) * BLOCK_LOG_BLOCK_BYTES) ||
+        file_.write(block_, BLOCK_LOG_BLOCK_BYTES) != BLOCK_LOG_BLOCK_BYTES) {
+      return false; // O bloco continua em montagem para uma nova tentativa
+    }
+    lastSeq_ = seq;
+    length_ = 0;
+    stats_.blocks++;
+    return true;
+  }
+
+  /**
+   * @brief Sequência do cabeçalho no índice (0 = vazio ou inválido)
+   * @param verify Também lê as linhas e confere o CRC
+   */
+  uint32_t readSeq(uint32_t index, bool verify) {
+    stats_.recoveryReads++;
+    size_t want = verify ? BLOCK_LOG_BLOCK_BYTES : BLOCK_LOG_HEADER_BYTES;
+    if (!file_.seek(index * BLOCK_LOG_BLOCK_BYTES) || file_.read(block_, want) != want) return 0;
+    uint32_t seq = get32(block_ + 4);
+    uint16_t length = (uint16_t)(block_[8] | (block_[9] << 8));
+    if (get32(block_) != BLOCK_LOG_MAGIC || block_[10] != BLOCK_LOG_VERSION || seq == 0 ||
+        length > BLOCK_LOG_PAYLOAD_BYTES || indexOf(seq) != index) {
+      return 0;
+    }
+    if (verify &&
+        blockLogCrc32(block_ + BLOCK_LOG_HEADER_BYTES, length, blockLogCrc32(block_, 12)) != get32(block_ + 12)) {
+      return 0;
+    }
+    return seq;
+  }
+
+  /**
+   * @brief Último índice i com seq(i) == anchor + i (anchor = seq(0))
+   * @details Os blocos gravados nesta volta formam um prefixo contínuo a
+   *          partir do índice 0; depois dele vêm os da volta anterior
+   */
+  uint32_t searchTail(uint32_t anchor) {
+    uint32_t low = 0, high = count_ - 1;
+    while (low < high) {
+      uint32_t mid = low + (high - low + 1) / 2;
+      if (readSeq(mid, false) == anchor + mid) {
+        low = mid;
+      } else {
+        high = mid - 1;
+      }
+    }
+    return low;
+  }
+
+  /**
+   * @brief Acha o último bloco íntegro
+   * @return Sua sequência (0 = log vazio)
+   */
+  uint32_t recover() {
+    uint32_t candidate;
+    uint32_t anchor = readSeq(0, false);
+    if (anchor != 0) {
+      candidate = searchTail(anchor);
+    } else {
+      // Bloco 0 vazio ou perdido na queda: o fim está no último índice
+      candidate = count_ - 1;
+    }
+
+    for (uint32_t back = 0; back < BLOCK_LOG_RECOVERY_BLOCKS && back < count_; back++) {
+      uint32_t index = (candidate + count_ - back) % count_;
+      uint32_t seq = readSeq(index, true);
+      if (seq != 0) return seq;
+      // Voltou do índice 0 para um fim de arquivo nunca gravado: a queda
+      // foi na primeira volta e não há nada antes
+      if (index == count_ - 1 && readSeq(index, false) == 0) return 0;
+      stats_.recoveryDropped++;
+    }
+
+    // Nada íntegro perto do fim (não acontece numa queda de energia, só
+    // com o cartão danificado): maior sequência entre todos os blocos
+    stats_.recoveryFullScan = true;
+    stats_.recoveryDropped = 0;
+    uint32_t best = 0;
+    for (uint32_t index = 0; index < count_; index++) {
+      uint32_t seq = readSeq(index, true);
+      if (seq > best) best = seq;
+    }
+    return best;
+  }
+
+  LogFile file_;
+  uint32_t count_ = 0;
+  uint32_t lastSeq_ = 0;
+  uint16_t length_ = 0; // Bytes de linhas no bloco em montagem
+  uint8_t block_[BLOCK_LOG_BLOCK_BYTES];
+  BlockLogStats stats_;
+};
+
+#endif // BLOCK_LOG_H
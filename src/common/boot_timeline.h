@@ -0,0 +1,87 @@
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+// ------------------------------------------------------------------
+// --- MARCOS DO BOOT (TEMPO ATÉ O PRIMEIRO FRAME) ---
+// ------------------------------------------------------------------
+// Instantes, desde o boot, em que a captura começou, o primeiro frame foi
+// lido, a rede subiu e o primeiro frame saiu pelo enlace. A captura não
+// espera a rede: o que importa no começo da corrida é o primeiro frame,
+// e a diferença até o primeiro envio fica nas filas.
+//
+// Cada marco é gravado uma vez, pela task que o observa, e lido pela task
+// de envio para o relatório.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include "platform.h"
+
+enum BootMilestone {
+  BOOT_CAPTURE_STARTED, // Tasks de captura criadas
+  BOOT_FIRST_FRAME,     // Primeiro frame lido do barramento
+  BOOT_LINK_UP,         // WiFi conectado
+  BOOT_FIRST_UPLINK,    // Primeiro lote entregue com a rede no ar
+  BOOT_MILESTONES
+};
+
+inline const char *bootMilestoneName(BootMilestone milestone) {
+  switch (milestone) {
+    case BOOT_CAPTURE_STARTED: return "captura";
+    case BOOT_FIRST_FRAME: return "1o_frame";
+    case BOOT_LINK_UP: return "rede";
+    case BOOT_FIRST_UPLINK: return "1o_envio";
+    default: return "?";
+  }
+}
+
+class BootTimeline {
+public:
+  /**
+   * @brief Registra o marco na primeira vez (as seguintes são ignoradas)
+   * @param nowUs Instante em µs desde o boot (monoMicros() no firmware)
+   */
+  void mark(BootMilestone milestone, int64_t nowUs) {
+    if (at_[milestone].load(std::memory_order_relaxed) != 0) return; // Caminho de todo frame
+    uint32_t ms = (uint32_t)(nowUs / 1000) + 1; // 0 = não atingido
+    uint32_t expected = 0;
+    if (at_[milestone].compare_exchange_strong(expected, ms)) {
+      reached_.fetch_add(1);
+    }
+  }
+
+  void mark(BootMilestone milestone) { mark(milestone, monoMicros()); }
+
+  /** @brief ms desde o boot, ou -1 se ainda não atingido */
+  int32_t atMs(BootMilestone milestone) const {
+    return (int32_t)at_[milestone].load() - 1;
+  }
+
+  bool reached(BootMilestone milestone) const { return at_[milestone].load() != 0; }
+
+  /** @brief Quantos marcos já foram atingidos (para relatar só mudanças) */
+  uint32_t count() const { return reached_.load(); }
+
+  /**
+   * @brief Linha de relatório: "captura=120ms 1o_frame=135ms rede=- 1o_envio=-"
+   */
+  int format(char *text, size_t size) const {
+    int length = 0;
+    for (int i = 0; i < BOOT_MILESTONES && length >= 0 && (size_t)length < size; i++) {
+      BootMilestone milestone = (BootMilestone)i;
+      int32_t ms = atMs(milestone);
+      const char *separator = i == 0 ? "" : " ";
+      length += ms < 0
+          ? snprintf(text + length, size - length, "%s%s=-", separator, bootMilestoneName(milestone))
+          : snprintf(text + length, size - length, "%s%s=%ldms", separator,
+                     bootMilestoneName(milestone), (long)ms);
+    }
+    return length;
+  }
+
+private:
+  std::atomic<uint32_t> at_[BOOT_MILESTONES] = {};
+  std::atomic<uint32_t> reached_{0};
+};
+
+#endif // BOOT_TIMELINE_H
@@ -0,0 +1,362 @@
+#ifndef BUS_STATS_H
+#define BUS_STATS_H
+
+// ------------------------------------------------------------------
+// --- ESTATÍSTICAS POR ID DO BARRAMENTO (TAXA, PERÍODO, AUSÊNCIA) ---
+// ------------------------------------------------------------------
+// Para cada ID: contagem, período médio (média móvel), menor e maior
+// intervalo entre chegadas e jitter, atualizados em O(1) por frame. O
+// período esperado é aprendido: depois de BusStatsConfig::learnGaps
+// intervalos e learnUs de observação o ID passa a ter prazo (os IDs da
+// moto têm rajadas e pausas de segundos que só aparecem com tempo), e o
+// silêncio além dele dispara um alarme de ausência (BMS ou controlador
+// mudo) em vez de esperar o painel congelar. O aprendizado é travado no
+// ID (armed): os carimbos de 32 bits dão a volta a cada ~71,6 min e não
+// servem para medir desde quando o ID é observado.
+//
+// Período e jitter seguem o estimador do RTO do TCP (RFC 6298):
+//   período ← período + (intervalo − período) / 8
+//   jitter  ← jitter + (|intervalo − período| − jitter) / 4
+//   prazo   = max(missPeriods × período + 4 × jitter,
+//                 maior intervalo já visto fora de alarme + período)
+// Um ID regular (jitter baixo) é cobrado cedo; um ID irregular ganha
+// prazo proporcional à própria variação e não gera alarme falso.
+//
+// O silêncio de um ID só conta enquanto o resto do barramento fala: um
+// nó mudo aparece como ausência do seu ID; o barramento inteiro calado
+// (transceptor, chicote, moto desligada) é um único alarme de silêncio
+// depois de busSilentUs, e não um alarme por ID. A captura de referência
+// tem pausas de 1,0 e 1,4 s do barramento todo, que sem essa distinção
+// cobrariam os IDs de 150 ms.
+//
+// Tabela fixa de endereçamento aberto indexada pelo ID cru (como
+// frame_cache.h), sem alocação. Pertence a uma única task: record() e
+// checkMissing() na decodificação; o resumo (BusSummary) é copiado para
+// a task de envio.
+//
+// Carga do barramento: bits de cada frame sem bit stuffing (SOF..IFS,
+// 47 + 8·DLC padrão, 67 + 8·DLC estendido) sobre o bitrate. É o limite
+// inferior; o stuffing acrescenta até ~20%.
+
+#include <stdint.h>
+#include "can_message.h"
+
+#define BUS_STATS_EXTENDED_FLAG 0x80000000UL // Bit 31 da chave: ID estendido
+#define BUS_SUMMARY_TOP 5     // IDs mais frequentes no resumo
+#define BUS_SUMMARY_MISSING 4 // IDs ausentes listados no resumo
+
+/**
+ * @brief Limites do detector
+ */
+struct BusStatsConfig {
+  uint32_t bitrate = 250000;
+  uint8_t learnGaps = 16;           // Intervalos antes de armar o alarme...
+  uint32_t learnUs = 30000000;      // ...e tempo mínimo observando o ID
+  uint8_t missPeriods = 5;          // Períodos sem o ID até o alarme
+  uint32_t minTimeoutUs = 200000;   // Prazo mínimo (IDs de 10 ms)
+  uint32_t maxTimeoutUs = 60000000; // Prazo máximo: ID muito raro ainda é cobrado
+  uint32_t busSilentUs = 2000000;   // Barramento inteiro calado até o alarme
+};
+
+struct BusIdStats {
+  uint32_t key = 0;          // ID | BUS_STATS_EXTENDED_FLAG; válido se used
+  uint32_t count = 0;        // Frames desde o boot
+  uint32_t windowCount = 0;  // Frames desde o último resumo
+  uint32_t observedUs = 0;   // Soma dos intervalos até armar (satura)
+  uint32_t lastUs = 0;       // Chegada do último frame
+  uint32_t periodUs = 0;     // Período médio (média móvel 1/8)
+  uint32_t jitterUs = 0;     // Desvio médio do período (média móvel 1/4)
+  uint32_t minGapUs = UINT32_MAX;
+  uint32_t maxGapUs = 0;
+  uint32_t normalMaxGapUs = 0; // Maior intervalo fora de alarme (piso do prazo)
+  uint32_t alarms = 0;       // Vezes que o ID sumiu
+  uint8_t gaps = 0;          // Intervalos vistos (satura em 255)
+  bool armed = false;        // Período aprendido: o ID tem prazo
+  bool missing = false;      // Alarme ativo
+  bool used = false;
+
+  uint32_t id() const { return key & ~BUS_STATS_EXTENDED_FLAG; }
+  bool isExtended() const { return (key & BUS_STATS_EXTENDED_FLAG) != 0; }
+};
+
+/**
+ * @brief Resumo periódico (copiado entre tasks, sem ponteiros)
+ */
+struct BusTalker {
+  uint32_t id;
+  bool extended;
+  uint32_t fps;       // Frames/s na janela
+  uint16_t shareDeci; // Parcela dos frames da janela (0,1%)
+};
+
+struct BusMissing {
+  uint32_t id;
+  bool extended;
+  uint32_t silentMs; // Tempo do barramento ativo sem o ID
+  uint32_t periodMs; // Período aprendido
+};
+
+struct BusSummary {
+  uint32_t windowMs = 0;     // Duração da janela (0 = ainda sem resumo)
+  uint16_t loadDeci = 0;     // Carga do barramento (0,1%)
+  uint32_t fps = 0;          // Frames/s na janela
+  uint16_t ids = 0;          // IDs distintos desde o boot
+  uint16_t tableFull = 0;    // IDs que não couberam na tabela
+  uint32_t alarms = 0;       // Alarmes de ausência desde o boot
+  uint32_t recoveries = 0;   // IDs que voltaram depois do alarme
+  bool busSilent = false;    // Nenhum frame há mais de busSilentUs
+  uint32_t silences = 0;     // Alarmes de barramento calado desde o boot
+  uint8_t topCount = 0;
+  BusTalker top[BUS_SUMMARY_TOP];
+  uint8_t missingCount = 0;  // IDs ausentes agora (lista limitada a BUS_SUMMARY_MISSING)
+  BusMissing missing[BUS_SUMMARY_MISSING];
+};
+
+enum BusEvent {
+  BUS_EVENT_NONE,
+  BUS_EVENT_RECOVERED  // ID (ou o barramento calado) voltou; ausências vêm de checkMissing()
+};
+
+/**
+ * @tparam Capacity Potência de 2, folga para ~Capacity/2 IDs
+ */
+template <uint16_t Capacity>
+class BusStats {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity precisa ser potencia de 2");
+
+public:
+  void begin(const BusStatsConfig &config = BusStatsConfig()) {
+    config_ = config;
+    for (uint16_t i = 0; i < Capacity; i++) entries_[i] = BusIdStats();
+    size_ = 0;
+    tableFull_ = 0;
+    windowBits_ = 0;
+    windowFrames_ = 0;
+    windowStarted_ = false;
+    alarms_ = 0;
+    recoveries_ = 0;
+    lastBusUs_ = 0;
+    busSilent_ = false;
+    silences_ = 0;
+  }
+
+  /**
+   * @brief Contabiliza o frame (O(1))
+   * @return BUS_EVENT_RECOVERED se o ID (ou o barramento) estava em alarme
+   */
+  BusEvent record(const CanMessage &frame) {
+    uint32_t nowUs = frame.timestampUs;
+    if (!windowStarted_) {
+      windowStarted_ = true;
+      windowStartUs_ = nowUs;
+    }
+    lastBusUs_ = nowUs;
+    bool busBack = busSilent_;
+    busSilent_ = false;
+    uint8_t dlc = frame.length > 8 ? 8 : frame.length;
+    windowBits_ += (frame.isExtended ? 67 : 47) + 8u * dlc;
+    windowFrames_++;
+
+    BusIdStats *entry = slot(makeKey(frame.id, frame.isExtended));
+    if (!entry) {
+      tableFull_++;
+      return busBack ? BUS_EVENT_RECOVERED : BUS_EVENT_NONE;
+    }
+    if (!entry->used) {
+      entry->used = true;
+      entry->key = makeKey(frame.id, frame.isExtended);
+      entry->lastUs = nowUs;
+      entry->count = 1;
+      entry->windowCount = 1;
+      size_++;
+      return busBack ? BUS_EVENT_RECOVERED : BUS_EVENT_NONE;
+    }
+
+    uint32_t gap = nowUs - entry->lastUs;
+    entry->lastUs = nowUs;
+    entry->count++;
+    entry->windowCount++;
+    if (gap < entry->minGapUs) entry->minGapUs = gap;
+    if (gap > entry->maxGapUs) entry->maxGapUs = gap;
+    if (entry->gaps == 0) {
+      entry->periodUs = gap;
+      entry->jitterUs = gap / 2;
+    } else {
+      int32_t error = (int32_t)(gap - entry->periodUs);
+      uint32_t deviation = error < 0 ? (uint32_t)-error : (uint32_t)error;
+      entry->jitterUs = (uint32_t)((int32_t)entry->jitterUs +
+                                   ((int32_t)deviation - (int32_t)entry->jitterUs) / 4);
+      entry->periodUs = (uint32_t)((int32_t)entry->periodUs + error / 8);
+    }
+    if (entry->gaps < 255) entry->gaps++;
+    if (!entry->armed) {
+      entry->observedUs = gap > UINT32_MAX - entry->observedUs ? UINT32_MAX : entry->observedUs + gap;
+      entry->armed = entry->gaps >= config_.learnGaps && entry->observedUs >= config_.learnUs;
+    }
+
+    // O intervalo que encerra um alarme não vira referência de normalidade
+    if (!entry->missing && gap > entry->normalMaxGapUs) entry->normalMaxGapUs = gap;
+    if (entry->missing) {
+      entry->missing = false;
+      recoveries_++;
+      return BUS_EVENT_RECOVERED;
+    }
+    return busBack ? BUS_EVENT_RECOVERED : BUS_EVENT_NONE;
+  }
+
+  /**
+   * @brief Prazo do ID: sem frame por mais que isso, alarme de ausência
+   * @return 0 enquanto o período ainda está sendo aprendido
+   */
+  uint32_t timeoutUs(const BusIdStats &entry) const {
+    if (!entry.armed) return 0;
+    uint64_t timeout = (uint64_t)config_.missPeriods * entry.periodUs + 4ULL * entry.jitterUs;
+    uint64_t seen = (uint64_t)entry.normalMaxGapUs + entry.periodUs;
+    if (timeout < seen) timeout = seen;
+    if (timeout < config_.minTimeoutUs) timeout = config_.minTimeoutUs;
+    if (timeout > config_.maxTimeoutUs) timeout = config_.maxTimeoutUs;
+    return (uint32_t)timeout;
+  }
+
+  /**
+   * @brief Procura IDs que passaram do prazo e o barramento calado
+   *        (chamar a cada ~100 ms, inclusive sem frames chegando)
+   * @param onMissing Chamado uma vez por alarme de ID: fn(const BusIdStats &, silentUs)
+   * @return Quantos alarmes novos (IDs + barramento calado)
+   */
+  template <class Fn>
+  uint16_t checkMissing(uint32_t nowUs, Fn onMissing) {
+    if (!windowStarted_) return 0; // Nenhum frame desde o boot
+    uint16_t raised = 0;
+    if (!busSilent_ && nowUs - lastBusUs_ > config_.busSilentUs) {
+      busSilent_ = true;
+      silences_++;
+      raised++;
+    }
+    for (uint16_t i = 0; i < Capacity; i++) {
+      BusIdStats &entry = entries_[i];
+      if (!entry.used || entry.missing) continue;
+      uint32_t timeout = timeoutUs(entry);
+      // Só o tempo em que outros IDs continuaram chegando
+      uint32_t silent = lastBusUs_ - entry.lastUs;
+      if (timeout == 0 || silent <= timeout) continue;
+      entry.missing = true;
+      entry.alarms++;
+      alarms_++;
+      raised++;
+      onMissing(entry, silent);
+    }
+    return raised;
+  }
+
+  uint16_t checkMissing(uint32_t nowUs) {
+    return checkMissing(nowUs, [](const BusIdStats &, uint32_t) {});
+  }
+
+  /**
+   * @brief Resumo da janela desde o último resumo (e abre a próxima)
+   */
+  void summarize(uint32_t nowUs, BusSummary &out) {
+    out = BusSummary();
+    uint32_t windowUs = windowStarted_ ? nowUs - windowStartUs_ : 0;
+    out.windowMs = windowUs / 1000;
+    if (out.windowMs == 0) out.windowMs = 1;
+    out.fps = (uint32_t)((uint64_t)windowFrames_ * 1000000ULL / (windowUs ? windowUs : 1));
+    uint64_t capacityBits = (uint64_t)config_.bitrate * windowUs / 1000000ULL;
+    uint64_t load = capacityBits ? windowBits_ * 1000ULL / capacityBits : 0;
+    out.loadDeci = (uint16_t)(load > 1000 ? 1000 : load);
+    out.ids = size_;
+    out.tableFull = tableFull_;
+    out.alarms = alarms_;
+    out.recoveries = recoveries_;
+    out.busSilent = busSilent_;
+    out.silences = silences_;
+
+    for (uint16_t i = 0; i < Capacity; i++) {
+      BusIdStats &entry = entries_[i];
+      if (!entry.used) continue;
+      if (entry.missing) {
+        if (out.missingCount < BUS_SUMMARY_MISSING) {
+          BusMissing &m = out.missing[out.missingCount];
+          m.id = entry.id();
+          m.extended = entry.isExtended();
+          m.silentMs = (lastBusUs_ - entry.lastUs) / 1000;
+          m.periodMs = entry.periodUs / 1000;
+        }
+        out.missingCount++;
+      }
+      if (entry.windowCount > 0) insertTalker(out, entry, windowUs);
+      entry.windowCount = 0;
+    }
+
+    windowStartUs_ = nowUs;
+    windowStarted_ = true;
+    windowBits_ = 0;
+    windowFrames_ = 0;
+  }
+
+  /** @brief Estatística do ID, ou nullptr se nunca visto */
+  const BusIdStats *find(uint32_t id, bool extended) const {
+    uint32_t key = makeKey(id, extended);
+    for (uint16_t probe = 0, i = home(key); probe < Capacity; probe++, i = (i + 1) & MASK) {
+      if (!entries_[i].used) return nullptr;
+      if (entries_[i].key == key) return &entries_[i];
+    }
+    return nullptr;
+  }
+
+  uint16_t size() const { return size_; }
+
+private:
+  static const uint16_t MASK = Capacity - 1;
+
+  static uint32_t makeKey(uint32_t id, bool extended) {
+    return (id & ~BUS_STATS_EXTENDED_FLAG) | (extended ? BUS_STATS_EXTENDED_FLAG : 0);
+  }
+
+  static uint16_t home(uint32_t key) {
+    return (uint16_t)((uint32_t)(key * 2654435761u) >> 16) & MASK;
+  }
+
+  BusIdStats *slot(uint32_t key) {
+    for (uint16_t probe = 0, i = home(key); probe < Capacity; probe++, i = (i + 1) & MASK) {
+      if (!entries_[i].used || entries_[i].key == key) return &entries_[i];
+    }
+    return nullptr;
+  }
+
+  /** @brief Mantém out.top ordenado por frames na janela (inserção) */
+  void insertTalker(BusSummary &out, const BusIdStats &entry, uint32_t windowUs) {
+    uint8_t position = out.topCount;
+    while (position > 0 && out.top[position - 1].fps * (uint64_t)windowUs <
+                               (uint64_t)entry.windowCount * 1000000ULL) {
+      position--;
+    }
+    if (position >= BUS_SUMMARY_TOP) return;
+    uint8_t last = out.topCount < BUS_SUMMARY_TOP ? out.topCount : BUS_SUMMARY_TOP - 1;
+    for (uint8_t i = last; i > position; i--) out.top[i] = out.top[i - 1];
+    BusTalker &talker = out.top[position];
+    talker.id = entry.id();
+    talker.extended = entry.isExtended();
+    talker.fps = (uint32_t)((uint64_t)entry.windowCount * 1000000ULL / (windowUs ? windowUs : 1));
+    talker.shareDeci = (uint16_t)(windowFrames_ ? (uint64_t)entry.windowCount * 1000ULL / windowFrames_ : 0);
+    if (out.topCount < BUS_SUMMARY_TOP) out.topCount++;
+  }
+
+  BusStatsConfig config_;
+  BusIdStats entries_[Capacity];
+  uint16_t size_ = 0;
+  uint16_t tableFull_ = 0;
+  uint64_t windowBits_ = 0;
+  uint32_t windowFrames_ = 0;
+  uint32_t windowStartUs_ = 0;
+  bool windowStarted_ = false;
+  uint32_t alarms_ = 0;
+  uint32_t recoveries_ = 0;
+  uint32_t lastBusUs_ = 0;
+  bool busSilent_ = false;
+  uint32_t silences_ = 0;
+};
+
+#endif // BUS_STATS_H
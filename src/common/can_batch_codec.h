@@ -0,0 +1,94 @@
+#ifndef CAN_BATCH_CODEC_H
+#define CAN_BATCH_CODEC_H
+
+// ------------------------------------------------------------------
+// --- LOTE BINÁRIO DE FRAMES CAN (UPLINK WEBSOCKET) ---
+// ------------------------------------------------------------------
+// Formato (little-endian), decodificado por utils/canBatchCodec.js:
+//
+//   Cabeçalho (5 bytes): 'V' 'B' | versão (1) | quantidade (uint16)
+//   Cada frame (5 + dlc bytes):
+//     id (uint32, bit 31 = ID estendido) | dlc (uint8) | dados[dlc]
+//
+// Um frame de 8 bytes ocupa 13 bytes, contra ~80 do JSON por frame.
+
+#include <stdint.h>
+#include <string.h>
+
+#define CAN_BATCH_MAGIC_0 0x56 // 'V'
+#define CAN_BATCH_MAGIC_1 0x42 // 'B'
+#define CAN_BATCH_VERSION 1
+#define CAN_BATCH_HEADER_SIZE 5
+#define CAN_BATCH_MAX_FRAME_SIZE 13
+#define CAN_BATCH_EXTENDED_FLAG 0x80000000UL
+
+/**
+ * @brief Tamanho de buffer necessário para um lote de N frames
+ */
+#define CAN_BATCH_BUFFER_SIZE(frames) \
+  (CAN_BATCH_HEADER_SIZE + (frames) * CAN_BATCH_MAX_FRAME_SIZE)
+
+/**
+ * @brief Monta um lote binário em um buffer fornecido pelo chamador
+ */
+class CanBatchWriter {
+public:
+  CanBatchWriter(uint8_t *buffer, size_t capacity)
+      : buffer_(buffer), capacity_(capacity) {
+    reset();
+  }
+
+  /**
+   * @brief Descarta o lote atual e reescreve o cabeçalho
+   */
+  void reset() {
+    buffer_[0] = CAN_BATCH_MAGIC_0;
+    buffer_[1] = CAN_BATCH_MAGIC_1;
+    buffer_[2] = CAN_BATCH_VERSION;
+    length_ = CAN_BATCH_HEADER_SIZE;
+    count_ = 0;
+    writeCount();
+  }
+
+  /**
+   * @brief Acrescenta um frame ao lote
+   * @return false se não houver espaço (o lote deve ser enviado antes)
+   */
+  bool add(uint32_t id, bool isExtended, const uint8_t *data, uint8_t dlc) {
+    if (dlc > 8) dlc = 8;
+    if (length_ + 5 + dlc > capacity_ || count_ == 0xFFFF) return false;
+
+    uint32_t word = isExtended ? (id | CAN_BATCH_EXTENDED_FLAG) : id;
+    uint8_t *p = buffer_ + length_;
+    p[0] = (uint8_t)word;
+    p[1] = (uint8_t)(word >> 8);
+    p[2] = (uint8_t)(word >> 16);
+    p[3] = (uint8_t)(word >> 24);
+    p[4] = dlc;
+    memcpy(p + 5, data, dlc);
+
+    length_ += 5 + dlc;
+    count_++;
+    writeCount();
+    return true;
+  }
+
+  bool empty() const { return count_ == 0; }
+  uint16_t count() const { return count_; }
+  size_t length() const { return length_; }
+  const uint8_t *data() const { return buffer_; }
+  uint8_t *data() { return buffer_; }
+
+private:
+  void writeCount() {
+    buffer_[3] = (uint8_t)count_;
+    buffer_[4] = (uint8_t)(count_ >> 8);
+  }
+
+  uint8_t *buffer_;
+  size_t capacity_;
+  size_t length_;
+  uint16_t count_;
+};
+
+#endif // CAN_BATCH_CODEC_H
@@ -0,0 +1,17 @@
+#ifndef CAN_MESSAGE_H
+#define CAN_MESSAGE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Frame CAN genérico trafegado entre os estágios do pipeline
+ */
+struct CanMessage {
+  uint32_t id;
+  uint8_t data[8];
+  uint8_t length;
+  bool isExtended;
+  uint32_t timestampUs; // Contador monotônico (µs) no momento da leitura do CAN
+};
+
+#endif // CAN_MESSAGE_H
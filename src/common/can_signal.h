@@ -0,0 +1,98 @@
+#ifndef CAN_SIGNAL_H
+#define CAN_SIGNAL_H
+
+// ------------------------------------------------------------------
+// --- EXTRAÇÃO DE SINAIS NO LAYOUT DO DBC ---
+// ------------------------------------------------------------------
+// Os layouts vêm de config/voltz.dbc; tools/dbc_codegen.js gera
+// voltz_signals.h (este lado) e utils/voltzSignals.js (backend) a partir
+// dele, então firmware e backend não digitam mais os bytes à mão.
+//
+// Numeração de bits do DBC: bit b = byte b/8, bit b%8 (0 = LSB).
+//   Motorola (@0): startBit é o MSB do sinal; os bits seguem para o LSB
+//                  do byte e continuam no MSB do byte seguinte.
+//   Intel (@1):    startBit é o LSB do sinal; os bits sobem de byte.
+//
+// Fator e offset viram frações de denominador comum (DEN, potência de
+// 10): físico = (raw × FACTOR_NUM + OFFSET_NUM) / DEN. Assim o firmware
+// decodifica em ponto fixo exato: dbcValue<S, 10> dá décimos (os campos
+// *Deci de VehicleState), dbcValue<S> dá a unidade do DBC.
+
+#include <stdint.h>
+
+struct DbcSignalSpec {
+  const char *name;
+  uint8_t startBit;
+  uint8_t length;      // 1..32
+  bool motorola;       // @0 (big-endian)
+  bool isSigned;       // '-' no DBC
+  int32_t factorNum;   // fator × den
+  int32_t offsetNum;   // offset × den
+  int32_t den;
+  const char *unit;
+};
+
+struct DbcMessageSpec {
+  uint32_t id;
+  bool extended;
+  const char *name;
+  uint8_t dlc;
+  const DbcSignalSpec *signals;
+  uint8_t signalCount;
+};
+
+/**
+ * @brief Bits crus do sinal, com extensão de sinal se isSigned
+ * @details Com os parâmetros constantes (dbcRaw<S>) o compilador resolve o
+ *          caminho alinhado em bytes e desenrola o laço: vira os mesmos
+ *          shifts que eram escritos à mão.
+ */
+inline int32_t dbcExtract(const uint8_t *data, uint8_t startBit, uint8_t length,
+                          bool motorola, bool isSigned) {
+  uint32_t raw = 0;
+  if (motorola && (startBit & 7) == 7 && (length & 7) == 0) {
+    // Bytes inteiros em ordem big-endian
+    for (uint8_t i = 0; i < length / 8; i++) raw = (raw << 8) | data[startBit / 8 + i];
+  } else if (!motorola && (startBit & 7) == 0 && (length & 7) == 0) {
+    for (uint8_t i = length / 8; i > 0; i--) raw = (raw << 8) | data[startBit / 8 + i - 1];
+  } else if (motorola) {
+    uint8_t bit = startBit;
+    for (uint8_t i = 0; i < length; i++) {
+      raw = (raw << 1) | ((data[bit / 8] >> (bit & 7)) & 1u);
+      bit = (bit & 7) == 0 ? bit + 15 : bit - 1;
+    }
+  } else {
+    for (uint8_t i = 0; i < length; i++) {
+      uint8_t bit = startBit + i;
+      raw |= (uint32_t)((data[bit / 8] >> (bit & 7)) & 1u) << i;
+    }
+  }
+  if (isSigned && length < 32 && (raw >> (length - 1)) & 1u) {
+    raw |= ~0u << length;
+  }
+  return (int32_t)raw;
+}
+
+/**
+ * @brief Valor físico × den (exato) pela tabela (ferramentas, depuração serial)
+ */
+inline int32_t dbcFixed(const DbcSignalSpec &signal, const uint8_t *data) {
+  return dbcExtract(data, signal.startBit, signal.length, signal.motorola, signal.isSigned) *
+             signal.factorNum + signal.offsetNum;
+}
+
+/**
+ * @brief Valor físico × Scale do sinal S (tipo gerado em voltz_signals.h)
+ * @details Especializado por sinal em tempo de compilação. Scale tem de
+ *          representar a resolução do sinal sem arredondar (ex.: fator 0,1
+ *          pede Scale múltiplo de 10).
+ */
+template <class S, int32_t Scale = 1>
+inline int32_t dbcValue(const uint8_t *data) {
+  static_assert((S::FACTOR_NUM * Scale) % S::DEN == 0 && (S::OFFSET_NUM * Scale) % S::DEN == 0,
+                "Scale menor que a resolucao do sinal no DBC");
+  return dbcExtract(data, S::START_BIT, S::LENGTH, S::MOTOROLA, S::IS_SIGNED) *
+             (S::FACTOR_NUM * Scale / S::DEN) + S::OFFSET_NUM * Scale / S::DEN;
+}
+
+#endif // CAN_SIGNAL_H
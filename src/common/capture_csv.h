@@ -0,0 +1,73 @@
+#ifndef CAPTURE_CSV_H
+#define CAPTURE_CSV_H
+
+// ------------------------------------------------------------------
+// --- LINHA DA CAPTURA CSV (LOG BRUTO E REPLAY) ---
+// ------------------------------------------------------------------
+// Formato do log do esp32_can_read_web_ok (logCanFrame), reproduzido
+// pelas ferramentas de replay no PC:
+//
+//   4278,0x301,S,8,00000000000E0002
+//   ms  ,ID   ,S|E (padrão/estendido), DLC, payload em hex contínuo
+//
+// Gravado por formatCaptureLine (CsvWriter, igual ao snprintf de antes)
+// e lido por parseCaptureLine campo a campo com hex_codec.h, sem
+// sscanf/strtoul por byte. Linhas fora do formato (cabeçalho, linha
+// cortada, hex inválido) são recusadas.
+
+#include <stdint.h>
+#include <string.h>
+#include "csv_writer.h"
+#include "hex_codec.h"
+
+struct CaptureLine {
+  uint32_t ms;
+  uint32_t id;
+  bool isExtended;
+  uint8_t length;
+  uint8_t data[8]; // Bytes além de length ficam zerados
+};
+
+#define CAPTURE_LINE_MAX 48 // "4294967295,0x1FFFFFFF,E,8,0011223344556677\n"
+
+/**
+ * @brief Escreve a linha, igual a "%lu,0x%lX,%s,%u," e "%02X" por byte
+ * @return Tamanho escrito (com '\n', sem terminador), ou 0 se não coube
+ */
+inline int formatCaptureLine(const CaptureLine &line, char *out, size_t size) {
+  CsvWriter csv(out, size);
+  csv.u32(line.ms).hexU32(line.id).str(line.isExtended ? "E" : "S").u32(line.length)
+      .hex(line.data, line.length);
+  return csv.finish();
+}
+
+/**
+ * @brief Lê uma linha da captura
+ * @return false se a linha não está no formato
+ */
+inline bool parseCaptureLine(const char *line, CaptureLine &out) {
+  const char *p = line;
+  uint32_t ms = 0;
+  if (*p < '0' || *p > '9') return false;
+  while (*p >= '0' && *p <= '9') ms = ms * 10 + (uint32_t)(*p++ - '0');
+  if (*p++ != ',') return false;
+
+  p = hexParseU32(p, out.id);
+  if (!p || *p++ != ',') return false;
+
+  out.isExtended = *p == 'E';
+  while (*p && *p != ',') p++;
+  if (*p++ != ',') return false;
+
+  if (*p < '0' || *p > '8' || p[1] != ',') return false;
+  out.length = (uint8_t)(*p - '0');
+  p += 2;
+
+  memset(out.data, 0, sizeof(out.data));
+  if (strnlen(p, 2 * out.length) < 2u * out.length) return false;
+  if (!hexDecode(out.data, p, out.length)) return false;
+  out.ms = ms;
+  return true;
+}
+
+#endif // CAPTURE_CSV_H
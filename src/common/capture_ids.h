@@ -0,0 +1,27 @@
+#ifndef CAPTURE_IDS_H
+#define CAPTURE_IDS_H
+
+// ------------------------------------------------------------------
+// --- IDS DA MOTO DA CAPTURA PARA AS FERRAMENTAS NO PC (SÓ PC) ---
+// ------------------------------------------------------------------
+// Os IDs do firmware vêm de config/constants.h, que muda de uma moto
+// para outra e, copiado do constants_example.h, tem todos zerados. As
+// ferramentas que reproduzem a captura "_can_log (2).csv" (ou geram
+// tráfego no mesmo formato) precisam dos IDs dessa moto: este cabeçalho
+// os define e ocupa o guard de constants.h, então vehicle_state.h,
+// pipeline.h, vehicle_sim.h etc. usam os mesmos valores no programa
+// inteiro. Tem de ser o primeiro include da ferramenta.
+//
+// Não entra no firmware.
+
+#ifdef CONSTANTS_H
+#error "capture_ids.h precisa vir antes de qualquer cabeçalho que inclua config/constants.h"
+#endif
+#define CONSTANTS_H
+
+#define BASE_BATTERY_ID 0x120    // BMS (voltz_dbc::Battery::ID)
+#define BASE_CONTROLLER_ID 0x300 // Controlador (voltz_dbc::Controller::ID)
+#define BASE_BATTERY_ID_2 0x130  // Erros do BMS (e 0x131)
+#define BASE_CONTROLLER_ID_2 0x301
+
+#endif // CAPTURE_IDS_H
@@ -0,0 +1,81 @@
+#ifndef CAPTURE_REPLAY_H
+#define CAPTURE_REPLAY_H
+
+// ------------------------------------------------------------------
+// --- LEITURA DA CAPTURA CSV PARA AS FERRAMENTAS DE REPLAY (SÓ PC) ---
+// ------------------------------------------------------------------
+// Carrega o arquivo inteiro (linhas de capture_csv.h) em memória, com o
+// tempo em µs contínuo: o log recomeça do 0 a cada boot do ESP32, então
+// quando o ms volta atrás a nova sessão é colocada sessionGapUs depois
+// do fim da anterior (moto desligada e ligada de novo). Linhas fora do
+// formato são puladas.
+//
+// Usa stdio e std::vector: não entra no firmware.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "can_message.h"
+#include "capture_csv.h"
+
+/**
+ * @brief Frame da captura com o tempo contínuo de 64 bits
+ * @details O firmware só vê os 32 bits baixos (message.timestampUs, que o
+ *          loader não preenche)
+ */
+struct CaptureFrame {
+  uint64_t us;
+  CanMessage message;
+};
+
+/**
+ * @brief Lê a captura, costurando as sessões
+ * @return false se o arquivo não abriu ou não tem nenhum frame
+ */
+inline bool loadCapture(const char *path, std::vector<CaptureFrame> &frames,
+                        uint64_t sessionGapUs) {
+  FILE *file = fopen(path, "r");
+  if (!file) return false;
+  char line[128];
+  uint64_t offsetUs = 0, lastUs = 0;
+  while (fgets(line, sizeof(line), file)) {
+    CaptureLine row;
+    if (!parseCaptureLine(line, row)) continue;
+    uint64_t us = (uint64_t)row.ms * 1000ULL + offsetUs;
+    if (us < lastUs) { // Nova sessão: continua depois da anterior
+      offsetUs = lastUs + sessionGapUs - (uint64_t)row.ms * 1000ULL;
+      us = lastUs + sessionGapUs;
+    }
+    lastUs = us;
+
+    CaptureFrame frame;
+    frame.us = us;
+    memset(&frame.message, 0, sizeof(frame.message));
+    frame.message.id = row.id;
+    frame.message.isExtended = row.isExtended;
+    frame.message.length = row.length;
+    memcpy(frame.message.data, row.data, sizeof(row.data));
+    frames.push_back(frame);
+  }
+  fclose(file);
+  return !frames.empty();
+}
+
+/**
+ * @brief Lê a captura como o firmware a veria: timestampUs com os 32 bits
+ *        baixos do tempo contínuo (como TimeBase::stamp())
+ */
+inline bool loadCapture(const char *path, std::vector<CanMessage> &frames,
+                        uint64_t sessionGapUs) {
+  std::vector<CaptureFrame> capture;
+  if (!loadCapture(path, capture, sessionGapUs)) return false;
+  frames.reserve(frames.size() + capture.size());
+  for (size_t i = 0; i < capture.size(); i++) {
+    capture[i].message.timestampUs = (uint32_t)capture[i].us;
+    frames.push_back(capture[i].message);
+  }
+  return true;
+}
+
+#endif // CAPTURE_REPLAY_H
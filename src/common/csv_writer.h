@@ -0,0 +1,114 @@
+#ifndef CSV_WRITER_H
+#define CSV_WRITER_H
+
+// ------------------------------------------------------------------
+// --- LINHAS CSV DE FORMATO FIXO (SEM PRINTF) ---
+// ------------------------------------------------------------------
+// Mesma ideia do JsonWriter para os logs em cartão/flash: cada linha é
+// uma sequência fixa de campos, a vírgula entre eles é automática e os
+// números saem por text_format.h (deci() igual a "%.1f" de v / 10.0).
+//
+//   CsvWriter csv(out, size);
+//   csv.u32(ms).str(rideModeName(m.mode)).i32(m.rpm).deci(m.torqueDeci);
+//   int length = csv.finish(); // com '\n', sem terminador; 0 se não coube
+//
+// Strings com str() não são escapadas: só nomes internos (modo, sinal).
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "hex_codec.h"
+#include "text_format.h"
+
+class CsvWriter {
+public:
+  CsvWriter(char *out, size_t size)
+      : out_(out), size_(size), length_(0), overflow_(false), first_(true) {}
+
+  CsvWriter &str(const char *text) {
+    separate();
+    return put(text, strlen(text));
+  }
+
+  CsvWriter &u32(uint32_t value) {
+    separate();
+    char *p = reserve();
+    return commit(p, formatU32(p, value));
+  }
+
+  CsvWriter &i32(int32_t value) {
+    separate();
+    char *p = reserve();
+    return commit(p, formatI32(p, value));
+  }
+
+  /** @brief Décimos como "72.5", igual a %.1f */
+  CsvWriter &deci(int32_t value) {
+    separate();
+    char *p = reserve();
+    return commit(p, formatFixed(p, value, 1));
+  }
+
+  /** @brief "0x" e o valor em hex maiúsculo, igual a "0x%lX" */
+  CsvWriter &hexU32(uint32_t value) {
+    separate();
+    put("0x", 2);
+    char *p = reserve();
+    return commit(p, hexFormatU32(p, value));
+  }
+
+  /** @brief Payload em hex contínuo ("AABBCC") */
+  CsvWriter &hex(const uint8_t *data, uint8_t length) {
+    separate();
+    if (overflow_ || length_ + 2u * length > size_) return fail();
+    length_ += hexEncode(out_ + length_, data, length);
+    return *this;
+  }
+
+  /**
+   * @brief Termina a linha com '\n'
+   * @return Tamanho escrito, ou 0 se não coube
+   */
+  int finish() {
+    put("\n", 1);
+    return overflow_ ? 0 : (int)length_;
+  }
+
+private:
+  void separate() {
+    if (!first_) put(",", 1);
+    first_ = false;
+  }
+
+  CsvWriter &put(const char *text, size_t length) {
+    if (overflow_ || length_ + length > size_) return fail();
+    memcpy(out_ + length_, text, length);
+    length_ += length;
+    return *this;
+  }
+
+  /** @brief Direto no buffer se cabe o maior número possível, senão em scratch_ */
+  char *reserve() {
+    return !overflow_ && length_ + TEXT_NUMBER_MAX <= size_ ? out_ + length_ : scratch_;
+  }
+
+  CsvWriter &commit(const char *written, uint8_t length) {
+    if (written == scratch_) return put(scratch_, length);
+    length_ += length;
+    return *this;
+  }
+
+  CsvWriter &fail() {
+    overflow_ = true;
+    return *this;
+  }
+
+  char *out_;
+  size_t size_;
+  size_t length_;
+  bool overflow_;
+  bool first_;
+  char scratch_[TEXT_NUMBER_MAX];
+};
+
+#endif // CSV_WRITER_H
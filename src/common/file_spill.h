@@ -0,0 +1,145 @@
+#ifndef FILE_SPILL_H
+#define FILE_SPILL_H
+
+// ------------------------------------------------------------------
+// --- EXCESSO DA FILA EM ARQUIVO (OVERLOAD_SPILL) ---
+// ------------------------------------------------------------------
+// Segundo nível do buffer de captura: quando a fila em RAM enche, os
+// frames são acumulados em um bloco em RAM e gravados em blocos inteiros
+// (escrita sequencial grande) em uma região circular pré-alocada do
+// arquivo (SD montado em /sd no ESP32, ou qualquer caminho no host).
+//
+// Leitura, na ordem de chegada:
+//   bloco de leitura (mais antigo) → blocos da região → bloco de escrita
+// O bloco de escrita parcial é entregue direto da RAM quando o
+// consumidor alcança o produtor, sem gravar blocos incompletos.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "can_message.h"
+#include "overload_queue.h"
+
+#define SPILL_BLOCK_FRAMES 128 // 2560 bytes por bloco (5 setores de 512)
+#define SPILL_BLOCK_BYTES (SPILL_BLOCK_FRAMES * sizeof(CanMessage))
+
+class FileSpill : public FrameSpill {
+public:
+  ~FileSpill() { close(); }
+
+  /**
+   * @brief Abre o arquivo e pré-aloca a região circular
+   * @param maxFrames Capacidade da região (arredondada para blocos inteiros)
+   * @details A pré-alocação acontece uma vez, no boot; durante a sobrecarga
+   *          o arquivo nunca cresce (sem atualizar FAT/metadados)
+   */
+  bool begin(const char *path, uint32_t maxFrames) {
+    close();
+    regionBlocks_ = (maxFrames + SPILL_BLOCK_FRAMES - 1) / SPILL_BLOCK_FRAMES;
+    if (regionBlocks_ == 0) return false;
+
+    file_ = fopen(path, "r+b");
+    if (file_ == NULL) file_ = fopen(path, "w+b");
+    if (file_ == NULL) return false;
+
+    fseek(file_, 0, SEEK_END);
+    long size = ftell(file_);
+    long wanted = (long)(regionBlocks_ * SPILL_BLOCK_BYTES);
+    if (size < wanted) {
+      memset(writeBlock_, 0, sizeof(writeBlock_));
+      for (long pos = size - size % (long)SPILL_BLOCK_BYTES; pos < wanted;
+           pos += SPILL_BLOCK_BYTES) {
+        fseek(file_, pos, SEEK_SET);
+        if (fwrite(writeBlock_, SPILL_BLOCK_BYTES, 1, file_) != 1) {
+          close();
+          return false;
+        }
+      }
+      fflush(file_);
+    }
+
+    headBlock_ = tailBlock_ = usedBlocks_ = 0;
+    writeCount_ = readIndex_ = readCount_ = 0;
+    return true;
+  }
+
+  void close() {
+    if (file_ != NULL) fclose(file_);
+    file_ = NULL;
+  }
+
+  bool write(const CanMessage &frame) {
+    if (file_ == NULL) return false;
+    if (writeCount_ == SPILL_BLOCK_FRAMES && !flushWriteBlock()) return false;
+    writeBlock_[writeCount_++] = frame;
+    return true;
+  }
+
+  bool read(CanMessage &frame) {
+    if (readIndex_ == readCount_ && !refillReadBlock()) return false;
+    frame = readBlock_[readIndex_++];
+    return true;
+  }
+
+  bool empty() {
+    return readIndex_ == readCount_ && usedBlocks_ == 0 && writeCount_ == 0;
+  }
+
+  /** @brief Frames guardados (RAM + região) */
+  uint32_t size() const {
+    return (readCount_ - readIndex_) + usedBlocks_ * SPILL_BLOCK_FRAMES + writeCount_;
+  }
+
+  uint32_t capacity() const { return regionBlocks_ * SPILL_BLOCK_FRAMES; }
+
+private:
+  /**
+   * @brief Grava o bloco de escrita cheio no fim da região circular
+   * @return false se a região está cheia (o frame será perdido)
+   */
+  bool flushWriteBlock() {
+    if (usedBlocks_ == regionBlocks_) return false;
+    long pos = (long)(tailBlock_ * SPILL_BLOCK_BYTES);
+    if (fseek(file_, pos, SEEK_SET) != 0) return false;
+    if (fwrite(writeBlock_, SPILL_BLOCK_BYTES, 1, file_) != 1) return false;
+    tailBlock_ = (tailBlock_ + 1) % regionBlocks_;
+    usedBlocks_++;
+    writeCount_ = 0;
+    return true;
+  }
+
+  /**
+   * @brief Carrega o próximo bloco: da região ou, se vazia, o de escrita
+   */
+  bool refillReadBlock() {
+    if (usedBlocks_ > 0) {
+      long pos = (long)(headBlock_ * SPILL_BLOCK_BYTES);
+      if (fseek(file_, pos, SEEK_SET) != 0) return false;
+      if (fread(readBlock_, SPILL_BLOCK_BYTES, 1, file_) != 1) return false;
+      headBlock_ = (headBlock_ + 1) % regionBlocks_;
+      usedBlocks_--;
+      readCount_ = SPILL_BLOCK_FRAMES;
+    } else if (writeCount_ > 0) {
+      memcpy(readBlock_, writeBlock_, writeCount_ * sizeof(CanMessage));
+      readCount_ = writeCount_;
+      writeCount_ = 0;
+    } else {
+      return false;
+    }
+    readIndex_ = 0;
+    return true;
+  }
+
+  FILE *file_ = NULL;
+  uint32_t regionBlocks_ = 0;
+  uint32_t headBlock_ = 0;  // Próximo bloco a ler
+  uint32_t tailBlock_ = 0;  // Próximo bloco a gravar
+  uint32_t usedBlocks_ = 0;
+  CanMessage writeBlock_[SPILL_BLOCK_FRAMES];
+  uint16_t writeCount_ = 0;
+  CanMessage readBlock_[SPILL_BLOCK_FRAMES];
+  uint16_t readIndex_ = 0;
+  uint16_t readCount_ = 0;
+};
+
+#endif // FILE_SPILL_H
@@ -0,0 +1,141 @@
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+// ------------------------------------------------------------------
+// --- ÚLTIMO FRAME POR ID (ENDEREÇAMENTO ABERTO) ---
+// ------------------------------------------------------------------
+// Tabela de tamanho fixo indexada pelo ID CAN cru: guarda o último
+// payload, DLC, instante e quantas vezes o conteúdo mudou. Serve para
+// descartar frames repetidos (o barramento da moto reenvia o mesmo
+// payload dezenas de vezes por segundo) sem String nem std::map.
+//
+// Sondagem linear a partir de um hash multiplicativo do ID; sem remoção,
+// então uma entrada ocupada nunca vira buraco. Toda a memória fica no
+// objeto: nenhuma alocação depois de construído. Com a tabela cheia, IDs
+// novos não entram (FRAME_CACHE_FULL) e quem chama os trata como mudados.
+//
+// Não é thread-safe: uma única task (a de leitura do CAN) atualiza.
+
+#include <stdint.h>
+#include <string.h>
+
+#define FRAME_CACHE_EXTENDED_FLAG 0x80000000UL // Bit 31 da chave: ID estendido
+
+enum FrameCacheResult {
+  FRAME_CACHE_NEW,     // ID visto pela primeira vez
+  FRAME_CACHE_CHANGED, // Payload ou DLC diferente do anterior
+  FRAME_CACHE_SAME,    // Repetição: pode ser descartado
+  FRAME_CACHE_FULL     // Tabela cheia, ID não guardado
+};
+
+struct FrameCacheEntry {
+  uint32_t key = 0;       // ID | FRAME_CACHE_EXTENDED_FLAG; válido se used
+  uint32_t timestamp = 0; // Instante da última leitura (unidade de quem chama)
+  uint32_t changes = 0;   // Quantas vezes o conteúdo mudou desde a inserção
+  uint32_t repeats = 0;   // Repetições descartadas
+  uint8_t data[8] = {0};
+  uint8_t dlc = 0;
+  bool used = false;
+
+  uint32_t id() const { return key & ~FRAME_CACHE_EXTENDED_FLAG; }
+  bool isExtended() const { return (key & FRAME_CACHE_EXTENDED_FLAG) != 0; }
+};
+
+/**
+ * @tparam Capacity Potência de 2. Com até ~Capacity/2 IDs distintos a
+ *         sondagem média fica perto de 1 acesso.
+ */
+template <uint16_t Capacity>
+class FrameCache {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity precisa ser potencia de 2");
+
+public:
+  /**
+   * @brief Registra o frame e diz se ele traz algo novo
+   * @param timestamp Guardado na entrada (ms ou µs, a critério de quem chama)
+   */
+  FrameCacheResult update(uint32_t id, bool extended, const uint8_t *data, uint8_t dlc,
+                          uint32_t timestamp) {
+    if (dlc > 8) dlc = 8;
+    uint32_t key = makeKey(id, extended);
+    FrameCacheEntry *entry = slot(key);
+    if (!entry) return FRAME_CACHE_FULL;
+
+    if (!entry->used) {
+      entry->used = true;
+      entry->key = key;
+      entry->dlc = dlc;
+      memcpy(entry->data, data, dlc);
+      entry->timestamp = timestamp;
+      size_++;
+      return FRAME_CACHE_NEW;
+    }
+
+    entry->timestamp = timestamp;
+    if (entry->dlc == dlc && memcmp(entry->data, data, dlc) == 0) {
+      entry->repeats++;
+      return FRAME_CACHE_SAME;
+    }
+    entry->dlc = dlc;
+    memcpy(entry->data, data, dlc);
+    entry->changes++;
+    return FRAME_CACHE_CHANGED;
+  }
+
+  /** @brief Último frame do ID, ou nullptr se nunca visto */
+  const FrameCacheEntry *find(uint32_t id, bool extended) const {
+    uint32_t key = makeKey(id, extended);
+    for (uint16_t probe = 0, i = home(key); probe < Capacity; probe++, i = (i + 1) & MASK) {
+      const FrameCacheEntry &entry = entries_[i];
+      if (!entry.used) return nullptr;
+      if (entry.key == key) return &entry;
+    }
+    return nullptr;
+  }
+
+  void clear() {
+    for (uint16_t i = 0; i < Capacity; i++) entries_[i] = FrameCacheEntry();
+    size_ = 0;
+  }
+
+  uint16_t size() const { return size_; }
+  static uint16_t capacity() { return Capacity; }
+
+  /** @brief Percorre as entradas ocupadas (relatórios, página de status) */
+  template <class Fn>
+  void forEach(Fn fn) const {
+    for (uint16_t i = 0; i < Capacity; i++) {
+      if (entries_[i].used) fn(entries_[i]);
+    }
+  }
+
+private:
+  static const uint16_t MASK = Capacity - 1;
+
+  static uint32_t makeKey(uint32_t id, bool extended) {
+    return (id & ~FRAME_CACHE_EXTENDED_FLAG) | (extended ? FRAME_CACHE_EXTENDED_FLAG : 0);
+  }
+
+  /**
+   * @brief Hash de Fibonacci: IDs vizinhos (0x120, 0x121...) e IDs J1939
+   *        que só diferem nos bits altos se espalham pela tabela
+   */
+  static uint16_t home(uint32_t key) {
+    return (uint16_t)((uint32_t)(key * 2654435761u) >> 16) & MASK;
+  }
+
+  /** @brief Entrada do ID ou a vaga livre onde ele entraria; nullptr se cheia */
+  FrameCacheEntry *slot(uint32_t key) {
+    for (uint16_t probe = 0, i = home(key); probe < Capacity; probe++, i = (i + 1) & MASK) {
+      FrameCacheEntry &entry = entries_[i];
+      if (!entry.used || entry.key == key) return &entry;
+    }
+    return nullptr;
+  }
+
+  FrameCacheEntry entries_[Capacity];
+  uint16_t size_ = 0;
+};
+
+#endif // FRAME_CACHE_H
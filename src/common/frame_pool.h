@@ -0,0 +1,147 @@
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+// ------------------------------------------------------------------
+// --- POOL DE FRAMES (HANDLES ENTRE ESTÁGIOS, SEM CÓPIA DO FRAME) ---
+// ------------------------------------------------------------------
+// Os frames vivem em um vetor fixo, criado no boot. O que anda pelos
+// rings e filas entre os estágios é o índice do slot (FrameHandle, 2
+// bytes) no lugar do CanMessage inteiro: a fonte lê direto no slot e
+// cada estágio usa o frame por referência.
+//
+// Cada slot tem um contador de referências. acquire() entrega o slot com
+// uma referência; quem repassa o handle a N consumidores (fan-out) chama
+// retain(handle, N - 1), e cada um chama release() ao terminar. O último
+// release() devolve o slot à lista livre. Quem coloca o handle numa fila
+// passa a referência junto; quem retira, fica com ela.
+//
+// A lista livre é uma pilha lock-free (Treiber) com o topo e uma etiqueta
+// numa palavra de 32 bits: índice nos 16 bits baixos e, nos altos, um
+// contador que muda a cada retirada. Assim um compare_exchange não aceita
+// um topo que saiu e voltou entre a leitura e a troca (ABA), com qualquer
+// número de tasks tirando e devolvendo slots ao mesmo tempo.
+
+#include <stdint.h>
+#include <atomic>
+#include "can_message.h"
+
+typedef uint16_t FrameHandle;
+#define FRAME_NONE 0xFFFF // Pool esgotado / sem frame
+
+class FramePool {
+public:
+  /**
+   * @brief Retira um slot livre, com uma referência
+   * @return FRAME_NONE se o pool está esgotado (contabilizado)
+   */
+  FrameHandle acquire() {
+    uint32_t top = top_.load(std::memory_order_acquire);
+    for (;;) {
+      FrameHandle index = (FrameHandle)(top & 0xFFFF);
+      if (index == FRAME_NONE) {
+        exhausted_.fetch_add(1, std::memory_order_relaxed);
+        return FRAME_NONE;
+      }
+      uint32_t next = ((top + 0x10000) & 0xFFFF0000) | next_[index].load(std::memory_order_relaxed);
+      if (top_.compare_exchange_weak(top, next, std::memory_order_acquire,
+                                     std::memory_order_acquire)) {
+        refs_[index].store(1, std::memory_order_relaxed);
+        return index;
+      }
+    }
+  }
+
+  /** @brief Mais count referências (fan-out para count consumidores a mais) */
+  void retain(FrameHandle handle, uint8_t count = 1) {
+    refs_[handle].fetch_add(count, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Solta uma referência; a última devolve o slot ao pool
+   * @return true se o slot voltou ao pool
+   */
+  bool release(FrameHandle handle) {
+    // Contagem 1 vista por quem tem uma referência: ninguém mais tem o
+    // slot (só um dono chama retain()), então dispensa a operação atômica
+    if (refs_[handle].load(std::memory_order_acquire) == 1) {
+      refs_[handle].store(0, std::memory_order_relaxed);
+    } else if (refs_[handle].fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return false;
+    }
+    uint32_t top = top_.load(std::memory_order_relaxed);
+    do {
+      next_[handle].store((FrameHandle)(top & 0xFFFF), std::memory_order_relaxed);
+    } while (!top_.compare_exchange_weak(top, (top & 0xFFFF0000) | handle,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed));
+    return true;
+  }
+
+  CanMessage &frame(FrameHandle handle) { return frames_[handle]; }
+  const CanMessage &frame(FrameHandle handle) const { return frames_[handle]; }
+
+  uint16_t capacity() const { return capacity_; }
+  /** @brief acquire() recusados com o pool esgotado */
+  uint32_t exhausted() const { return exhausted_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Percorre a lista livre: slots livres, ou FRAME_NONE se ela está
+   *        corrompida (índice inválido, slot com referência, ciclo)
+   * @note Só com o pool parado (ferramentas / fim de teste); sem contador
+   *       atômico, acquire() e release() ficam com um CAS cada
+   */
+  uint16_t available() const {
+    uint16_t count = 0;
+    for (uint32_t index = top_.load() & 0xFFFF; index != FRAME_NONE; index = next_[index].load()) {
+      if (index >= capacity_ || refs_[index].load() != 0 || ++count > capacity_) return FRAME_NONE;
+    }
+    return count;
+  }
+
+protected:
+  FramePool() {}
+
+  void init(CanMessage *frames, std::atomic<uint8_t> *refs, std::atomic<FrameHandle> *next,
+            uint16_t capacity) {
+    frames_ = frames;
+    refs_ = refs;
+    next_ = next;
+    capacity_ = capacity;
+    for (uint16_t i = 0; i < capacity; i++) {
+      refs_[i].store(0, std::memory_order_relaxed);
+      next_[i].store(i + 1 < capacity ? (FrameHandle)(i + 1) : FRAME_NONE,
+                     std::memory_order_relaxed);
+    }
+    top_.store(0, std::memory_order_release);
+  }
+
+private:
+  FramePool(const FramePool &);
+  FramePool &operator=(const FramePool &);
+
+  CanMessage *frames_ = nullptr;
+  std::atomic<uint8_t> *refs_ = nullptr;
+  std::atomic<FrameHandle> *next_ = nullptr;
+  uint16_t capacity_ = 0;
+  std::atomic<uint32_t> top_{FRAME_NONE}; // Etiqueta << 16 | índice do topo
+  std::atomic<uint32_t> exhausted_{0};
+};
+
+/**
+ * @brief Pool com os slots dentro do objeto (global no firmware: alocado
+ *        uma vez, fora do heap)
+ */
+template <uint16_t Capacity>
+class StaticFramePool : public FramePool {
+  static_assert(Capacity > 0 && Capacity < FRAME_NONE, "Capacity deve caber em um FrameHandle");
+
+public:
+  StaticFramePool() { init(frames_, refs_, next_, Capacity); }
+
+private:
+  CanMessage frames_[Capacity];
+  std::atomic<uint8_t> refs_[Capacity];
+  std::atomic<FrameHandle> next_[Capacity];
+};
+
+#endif // FRAME_POOL_H
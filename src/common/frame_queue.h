@@ -0,0 +1,99 @@
+#ifndef FRAME_QUEUE_H
+#define FRAME_QUEUE_H
+
+// ------------------------------------------------------------------
+// --- FILA DE FRAMES ENTRE TASKS (FreeRTOS / HOST) ---
+// ------------------------------------------------------------------
+// No ESP32 é uma fila do FreeRTOS; no host, deque + mutex com a mesma
+// semântica (capacidade fixa, push sem bloqueio, pop com espera), para
+// que a lógica de lanes rode igual em testes e benchmarks no PC.
+//
+// Os itens são handles do pool de frames (frame_pool.h): a fila copia 2
+// bytes por frame na entrada e na saída, não o CanMessage. Ela não conta
+// referências; quem chama push()/pop() cuida do release().
+
+#include <stddef.h>
+#include <stdint.h>
+#include "frame_pool.h"
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#else
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#endif
+
+class FrameQueue {
+public:
+  bool begin(size_t capacity) {
+#ifdef ARDUINO
+    queue_ = xQueueCreate(capacity, sizeof(FrameHandle));
+    return queue_ != NULL;
+#else
+    capacity_ = capacity;
+    return capacity > 0;
+#endif
+  }
+
+  /**
+   * @brief Enfileira sem bloquear
+   * @return false se a fila estiver cheia (handle não enfileirado)
+   */
+  bool push(FrameHandle handle) {
+#ifdef ARDUINO
+    return xQueueSend(queue_, &handle, 0) == pdTRUE;
+#else
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (items_.size() >= capacity_) return false;
+      items_.push_back(handle);
+    }
+    ready_.notify_one();
+    return true;
+#endif
+  }
+
+  /**
+   * @brief Retira o handle mais antigo, esperando até waitUs se vazia
+   */
+  bool pop(FrameHandle &handle, uint32_t waitUs = 0) {
+#ifdef ARDUINO
+    TickType_t ticks = waitUs / (1000UL * portTICK_PERIOD_MS);
+    return xQueueReceive(queue_, &handle, ticks) == pdTRUE;
+#else
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (items_.empty() && waitUs > 0) {
+      ready_.wait_for(lock, std::chrono::microseconds(waitUs),
+                      [this] { return !items_.empty(); });
+    }
+    if (items_.empty()) return false;
+    handle = items_.front();
+    items_.pop_front();
+    return true;
+#endif
+  }
+
+  size_t size() {
+#ifdef ARDUINO
+    return uxQueueMessagesWaiting(queue_);
+#else
+    std::lock_guard<std::mutex> lock(mutex_);
+    return items_.size();
+#endif
+  }
+
+private:
+#ifdef ARDUINO
+  QueueHandle_t queue_ = NULL;
+#else
+  size_t capacity_ = 0;
+  std::deque<FrameHandle> items_;
+  std::mutex mutex_;
+  std::condition_variable ready_;
+#endif
+};
+
+#endif // FRAME_QUEUE_H
@@ -0,0 +1,233 @@
+#ifndef HEX_CODEC_H
+#define HEX_CODEC_H
+
+// ------------------------------------------------------------------
+// --- HEX DOS PAYLOADS CAN (CODIFICAÇÃO E LEITURA) ---
+// ------------------------------------------------------------------
+// O payload sai em hex maiúsculo em todo lugar: "AA BB CC" no JSON do
+// MQTT e na serial, "AABBCC" no CSV da captura. Em vez de um sprintf
+// ("%02X") por byte, cada byte vira uma cópia de 2 bytes de uma tabela
+// de 256 pares (512 bytes em flash).
+//
+// No PC (64 bits, little-endian) hexEncode troca a tabela por SWAR:
+// 4 bytes viram 8 dígitos dentro de uma palavra de 64 bits, com uns dez
+// deslocamentos/máscaras e nenhum acesso à memória; com SSE2 (todo
+// x86-64) os 8 bytes de um payload cheio viram 16 dígitos em um
+// registrador de 128 bits. No ESP32 (32 bits) as operações de 64 bits
+// custam mais que a tabela, então fica nela.
+//
+// A leitura é o caminho inverso para o replay da captura nas ferramentas:
+// tabela de 256 entradas (valor do dígito ou HEX_INVALID), ou SWAR de
+// 8 dígitos por vez no PC, com validação; qualquer caractere que não seja
+// 0-9, A-F ou a-f recusa o campo inteiro.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef HEX_CODEC_SWAR
+#if (defined(__x86_64__) || defined(__aarch64__)) && defined(__BYTE_ORDER__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define HEX_CODEC_SWAR 1
+#else
+#define HEX_CODEC_SWAR 0
+#endif
+#endif
+
+#if HEX_CODEC_SWAR && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define HEX_INVALID 0xFF
+
+/** @brief "00" "01" ... "FF" */
+inline const char *hexPairs() {
+  static const char PAIRS[513] =
+      "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+      "202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+      "404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+      "606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+      "808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+      "A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+      "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+      "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+  return PAIRS;
+}
+
+/** @brief Valor de cada caractere como dígito hex, ou HEX_INVALID */
+inline const uint8_t *hexDigitValues() {
+  static const uint8_t X = HEX_INVALID;
+  static const uint8_t VALUES[256] = {
+      X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+      X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+      X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+      0, 1, 2, 3, 4, 5, 6, 7, 8, 9, X, X, X, X, X, X,
+      X, 10, 11, 12, 13, 14, 15, X, X, X, X, X, X, X, X, X,
+      X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+      X, 10, 11, 12, 13, 14, 15, X, X, X, X, X, X, X, X, X,
+      X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+      X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+      X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+      X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+      X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+      X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+      X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+      X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+      X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  };
+  return VALUES;
+}
+
+#if HEX_CODEC_SWAR
+/**
+ * @brief 4 bytes → 8 dígitos ASCII numa palavra (ordem de memória)
+ * @details Espalha cada byte para 16 bits, separa os nibbles (alto
+ *          primeiro) e soma '0', mais 7 onde o nibble passa de 9.
+ */
+inline uint64_t hexSwarEncode4(const uint8_t *data) {
+  uint32_t four;
+  memcpy(&four, data, 4);
+  uint64_t x = four;
+  x = (x | x << 16) & 0x0000FFFF0000FFFFULL;
+  x = (x | x << 8) & 0x00FF00FF00FF00FFULL;
+  uint64_t nibbles = ((x >> 4) & 0x000F000F000F000FULL) | ((x & 0x000F000F000F000FULL) << 8);
+  uint64_t letters = ((nibbles + 0x0606060606060606ULL) >> 4) & 0x0101010101010101ULL;
+  return nibbles + 0x3030303030303030ULL + letters * 7;
+}
+
+#ifdef __SSE2__
+/**
+ * @brief 8 bytes → 16 dígitos: nibbles intercalados (alto primeiro),
+ *        mais '0' e mais 7 onde passa de 9
+ */
+inline void hexSse2Encode8(char *out, const uint8_t *data) {
+  const __m128i NIBBLE = _mm_set1_epi8(0x0F);
+  __m128i x = _mm_loadl_epi64((const __m128i *)data);
+  __m128i high = _mm_and_si128(_mm_srli_epi16(x, 4), NIBBLE);
+  __m128i nibbles = _mm_unpacklo_epi8(high, _mm_and_si128(x, NIBBLE));
+  __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8(7));
+  __m128i digits = _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+  _mm_storeu_si128((__m128i *)out, digits);
+}
+#endif
+
+/**
+ * @brief 8 dígitos → 4 bytes, recusando qualquer caractere fora de [0-9A-Fa-f]
+ * @details Faixas por byte sem vai-um (todos < 0x80): o bit alto de
+ *          x + (0x80 - lo) marca x >= lo e o de x + (0x7F - hi), x > hi.
+ */
+inline bool hexSwarDecode8(const char *text, uint8_t *out) {
+  const uint64_t ONES = 0x0101010101010101ULL;
+  const uint64_t HIGH = 0x8080808080808080ULL;
+  uint64_t x;
+  memcpy(&x, text, 8);
+  if (x & HIGH) return false;
+  uint64_t lower = x | 0x2020202020202020ULL;
+  uint64_t digit = (x + ONES * (0x80 - '0')) & ~(x + ONES * (0x7F - '9'));
+  uint64_t letter = (lower + ONES * (0x80 - 'a')) & ~(lower + ONES * (0x7F - 'f'));
+  if (((digit | letter) & HIGH) != HIGH) return false;
+
+  uint64_t values = (x & 0x0F0F0F0F0F0F0F0FULL) + ((x >> 6) & ONES) * 9;
+  uint64_t bytes = ((values << 4) | (values >> 8)) & 0x00FF00FF00FF00FFULL;
+  bytes = (bytes | bytes >> 8) & 0x0000FFFF0000FFFFULL;
+  uint32_t four = (uint32_t)(bytes | bytes >> 16);
+  memcpy(out, &four, 4);
+  return true;
+}
+#endif
+
+/**
+ * @brief Payload em hex contínuo ("AABBCC"), sem terminador
+ * @return 2 * length
+ */
+inline uint8_t hexEncode(char *out, const uint8_t *data, uint8_t length) {
+  uint8_t i = 0;
+#if HEX_CODEC_SWAR
+#ifdef __SSE2__
+  for (; i + 8 <= length; i += 8) hexSse2Encode8(out + 2 * i, data + i);
+#endif
+  for (; i + 4 <= length; i += 4) {
+    uint64_t digits = hexSwarEncode4(data + i);
+    memcpy(out + 2 * i, &digits, 8);
+  }
+#endif
+  const char *pairs = hexPairs();
+  for (; i < length; i++) memcpy(out + 2 * i, pairs + data[i] * 2, 2);
+  return (uint8_t)(length * 2);
+}
+
+/**
+ * @brief Payload em hex separado por espaço ("AA BB CC"), sem terminador
+ * @return 3 * length - 1 (0 se length == 0)
+ */
+inline uint8_t hexEncodeSpaced(char *out, const uint8_t *data, uint8_t length) {
+  if (length == 0) return 0;
+  const char *pairs = hexPairs();
+  memcpy(out, pairs + data[0] * 2, 2);
+  char *p = out + 2;
+  for (uint8_t i = 1; i < length; i++) {
+    p[0] = ' ';
+    memcpy(p + 1, pairs + data[i] * 2, 2);
+    p += 3;
+  }
+  return (uint8_t)(p - out);
+}
+
+/**
+ * @brief Inteiro em hex maiúsculo sem zeros à esquerda ("6F2020"), como %lX
+ * @return Dígitos escritos (1 a 8), sem terminador
+ */
+inline uint8_t hexFormatU32(char *out, uint32_t value) {
+  char digits[8];
+  char *p = digits + sizeof(digits);
+  const char *pairs = hexPairs();
+  do {
+    *--p = pairs[(value & 0x0F) * 2 + 1]; // Segundo dígito de "00".."0F"
+    value >>= 4;
+  } while (value != 0);
+  uint8_t length = (uint8_t)(digits + sizeof(digits) - p);
+  memcpy(out, p, length);
+  return length;
+}
+
+/**
+ * @brief Lê 2 * length dígitos hex contínuos em out
+ * @return false se algum caractere não for dígito hex (out fica incompleto)
+ */
+inline bool hexDecode(uint8_t *out, const char *text, uint8_t length) {
+  uint8_t i = 0;
+#if HEX_CODEC_SWAR
+  for (; i + 4 <= length; i += 4) {
+    if (!hexSwarDecode8(text + 2 * i, out + i)) return false;
+  }
+#endif
+  const uint8_t *values = hexDigitValues();
+  for (; i < length; i++) {
+    uint8_t high = values[(uint8_t)text[2 * i]];
+    uint8_t low = values[(uint8_t)text[2 * i + 1]];
+    if ((high | low) == HEX_INVALID) return false;
+    out[i] = (uint8_t)(high << 4 | low);
+  }
+  return true;
+}
+
+/**
+ * @brief Lê um inteiro hex ("0x6F2020", "301"), como strtoul(text, &end, 16)
+ * @return Ponteiro para o primeiro caractere depois dos dígitos, ou NULL
+ *         se não há dígito ou passa de 8
+ */
+inline const char *hexParseU32(const char *text, uint32_t &value) {
+  if (text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) text += 2;
+  const uint8_t *values = hexDigitValues();
+  uint32_t result = 0;
+  uint8_t count = 0;
+  for (uint8_t digit; (digit = values[(uint8_t)*text]) != HEX_INVALID; text++) {
+    if (++count > 8) return NULL;
+    result = result << 4 | digit;
+  }
+  if (count == 0) return NULL;
+  value = result;
+  return text;
+}
+
+#endif // HEX_CODEC_H
@@ -0,0 +1,125 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+// ------------------------------------------------------------------
+// --- JSON DE FORMATO FIXO (SEM DOM, SEM PRINTF) ---
+// ------------------------------------------------------------------
+// Os payloads da telemetria têm sempre os mesmos campos na mesma ordem,
+// então não há por que montar um documento (ArduinoJson) nem interpretar
+// um formato (snprintf) a cada frame. Cada payload é uma sequência fixa
+// de chamadas: as chaves e a pontuação são literais cujo tamanho o
+// compilador conhece (raw() vira cópias de tamanho constante) e os
+// números e o payload saem por text_format.h e hex_codec.h.
+//
+//   JsonWriter json(buffer, sizeof(buffer));
+//   json.raw("{\"v\":").deci(s.battery.voltageDeci).raw(",\"soc\":").i32(s.battery.soc)
+//       .raw("}");
+//   int length = json.finish();
+//
+// Strings com str() não são escapadas: só nomes internos (modo, sinal).
+// Se o buffer acaba, a escrita para e finish() devolve size (>= size,
+// como o snprintf que isto substitui).
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "hex_codec.h"
+#include "text_format.h"
+
+class JsonWriter {
+public:
+  JsonWriter(char *out, size_t size) : out_(out), size_(size), length_(0), overflow_(false) {}
+
+  /** @brief Trecho literal (chave, pontuação), copiado sem medir */
+  template <size_t N>
+  JsonWriter &raw(const char (&text)[N]) {
+    return put(text, N - 1);
+  }
+
+  /** @brief String entre aspas, sem escape */
+  JsonWriter &str(const char *text) {
+    put("\"", 1);
+    put(text, strlen(text));
+    return put("\"", 1);
+  }
+
+  JsonWriter &u32(uint32_t value) {
+    char *p = reserve();
+    return commit(p, formatU32(p, value));
+  }
+
+  JsonWriter &i32(int32_t value) {
+    char *p = reserve();
+    return commit(p, formatI32(p, value));
+  }
+
+  /** @brief value / 10^decimals com decimals casas (ver formatFixed) */
+  JsonWriter &fixed(int32_t value, uint8_t decimals) {
+    char *p = reserve();
+    return commit(p, formatFixed(p, value, decimals));
+  }
+
+  /** @brief Décimos (VehicleState) como "72.5", igual a %.1f */
+  JsonWriter &deci(int32_t value) { return fixed(value, 1); }
+
+  JsonWriter &boolean(bool value) {
+    return value ? put("true", 4) : put("false", 5);
+  }
+
+  /** @brief Bytes como "AA BB CC" (maiúsculas, separados por espaço) */
+  JsonWriter &hex(const uint8_t *data, uint8_t length) {
+    size_t needed = length > 0 ? length * 3 + 1 : 2;
+    if (overflow_ || length_ + needed > size_) return fail();
+    char *p = out_ + length_;
+    *p++ = '"';
+    p += hexEncodeSpaced(p, data, length);
+    *p++ = '"';
+    length_ = p - out_;
+    return *this;
+  }
+
+  /**
+   * @brief Termina a string
+   * @return Tamanho escrito, ou size se não coube
+   */
+  int finish() {
+    if (overflow_ || length_ >= size_) return (int)size_;
+    out_[length_] = '\0';
+    return (int)length_;
+  }
+
+private:
+  JsonWriter &put(const char *text, size_t length) {
+    if (overflow_ || length_ + length > size_) return fail();
+    memcpy(out_ + length_, text, length);
+    length_ += length;
+    return *this;
+  }
+
+  /**
+   * @brief Onde escrever um número: direto no buffer se cabe o maior
+   *        número possível, senão em scratch_ (commit() confere)
+   */
+  char *reserve() {
+    return !overflow_ && length_ + TEXT_NUMBER_MAX <= size_ ? out_ + length_ : scratch_;
+  }
+
+  JsonWriter &commit(const char *written, uint8_t length) {
+    if (written == scratch_) return put(scratch_, length);
+    length_ += length;
+    return *this;
+  }
+
+  JsonWriter &fail() {
+    overflow_ = true;
+    return *this;
+  }
+
+  char *out_;
+  size_t size_;
+  size_t length_;
+  bool overflow_;
+  char scratch_[TEXT_NUMBER_MAX];
+};
+
+#endif // JSON_WRITER_H
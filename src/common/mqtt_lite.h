@@ -0,0 +1,617 @@
+#ifndef MQTT_LITE_H
+#define MQTT_LITE_H
+
+// ------------------------------------------------------------------
+// --- CLIENTE MQTT 3.1.1 NÃO BLOQUEANTE (QoS0/QoS1) ---
+// ------------------------------------------------------------------
+// publish() só codifica o PUBLISH na caixa de saída (outbox) e retorna;
+// loop() envia o que o transporte aceitar sem bloquear, lê CONNACK /
+// PUBACK / PINGRESP e mantém a conexão. Em QoS1 até `window` mensagens
+// ficam em voo esperando PUBACK; a mensagem só sai da outbox confirmada.
+// Ao reconectar, tudo o que estava em voo é retransmitido (flag DUP) na
+// ordem original, antes das mensagens novas.
+//
+// Uma assinatura opcional (setSubscription) é refeita a cada CONNACK, em
+// QoS0: o broker entrega o retido e as mensagens novas sem PUBACK do
+// cliente. Cada PUBLISH recebido vai para o handler dentro de loop();
+// os maiores que MQTT_LITE_RX_BYTES são descartados.
+//
+// Layout da outbox (anel de bytes, registros contíguos):
+//   [OutboxHeader][pacote PUBLISH já codificado] ...
+// Um registro que não cabe no fim do anel recomeça no início; o resto
+// do fim vira preenchimento (marcado com length = MQTT_LITE_WRAP).
+//
+// Transport (não bloqueante depois de conectado):
+//   bool connect(const char *host, uint16_t port);
+//   bool connected();
+//   int  write(const uint8_t *data, size_t len); // aceitos, 0 = tente depois, <0 erro
+//   int  read(uint8_t *data, size_t len);        // lidos, 0 = nada, <0 erro/fechado
+//   void stop();
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "platform.h"
+
+#define MQTT_LITE_MAX_WINDOW 32
+#ifndef MQTT_LITE_RX_BYTES
+#define MQTT_LITE_RX_BYTES 128          // Pacotes de controle (e PUBLISH assinados)
+#endif
+#define MQTT_LITE_TOPIC_BYTES 56        // Tópico assinado (SUBSCRIBE cabe em ctrl_)
+#define MQTT_LITE_CONNACK_TIMEOUT_MS 5000
+#define MQTT_LITE_WRAP 0xFFFF
+
+enum MqttLiteState : uint8_t {
+  MQTT_LITE_DISCONNECTED = 0,
+  MQTT_LITE_CONNECTING, // CONNECT enviado, esperando CONNACK
+  MQTT_LITE_CONNECTED
+};
+
+/**
+ * @brief Contadores da entrega (para o relatório periódico)
+ */
+struct MqttLiteStats {
+  uint32_t queued = 0;        // Aceitos por publish()
+  uint32_t rejected = 0;      // Outbox cheia
+  uint32_t acked = 0;         // QoS1 confirmados por PUBACK
+  uint32_t retransmitted = 0; // QoS1 reenviados com DUP após reconexão
+  uint32_t reconnects = 0;    // CONNACK aceitos
+};
+
+/**
+ * @brief PUBLISH recebido na assinatura (topic não termina em '\\0')
+ */
+typedef void (*MqttLiteHandler)(void *context, const char *topic, size_t topicLength,
+                                const uint8_t *payload, size_t length);
+
+template <class Transport, uint32_t OutboxBytes>
+class MqttLite {
+public:
+  void setServer(const char *host, uint16_t port) {
+    host_ = host;
+    port_ = port;
+  }
+
+  /** @brief Identificador do cliente (copiado; até 23 caracteres) */
+  void setClientId(const char *clientId) {
+    strncpy(clientId_, clientId, sizeof(clientId_) - 1);
+    clientId_[sizeof(clientId_) - 1] = '\0';
+  }
+
+  /** @brief Mensagens QoS1 em voo sem PUBACK (1..MQTT_LITE_MAX_WINDOW) */
+  void setWindow(uint8_t window) {
+    if (window < 1) window = 1;
+    if (window > MQTT_LITE_MAX_WINDOW) window = MQTT_LITE_MAX_WINDOW;
+    window_ = window;
+  }
+
+  /**
+   * @brief Assina topic (QoS0) a cada conexão; mensagens vão para handler
+   * @return false se o tópico não couber
+   */
+  bool setSubscription(const char *topic, MqttLiteHandler handler, void *context) {
+    size_t length = strlen(topic);
+    if (length == 0 || length >= sizeof(subscription_)) return false;
+    memcpy(subscription_, topic, length + 1);
+    handler_ = handler;
+    handlerContext_ = context;
+    subscribePending_ = connected();
+    return true;
+  }
+
+  void setKeepAlive(uint16_t seconds) { keepAliveS_ = seconds; }
+  void setReconnectInterval(uint32_t ms) { reconnectMs_ = ms; }
+
+  /**
+   * @brief Coloca o PUBLISH na outbox (não envia nada agora)
+   * @param reserve Bytes da outbox que devem continuar livres depois desta
+   *        mensagem (reserva para mensagens mais importantes)
+   * @return false se não coube (a mensagem foi descartada)
+   */
+  bool publish(const char *topic, const uint8_t *payload, size_t length,
+               uint8_t qos = 1, size_t reserve = 0) {
+    size_t topicLen = strlen(topic);
+    size_t remaining = 2 + topicLen + (qos > 0 ? 2 : 0) + length;
+    size_t packetLen = 1 + varintSize(remaining) + remaining;
+    uint8_t *packet = reserveRecord(packetLen, reserve);
+    if (packet == NULL) {
+      stats_.rejected++;
+      return false;
+    }
+
+    uint16_t packetId = 0;
+    if (qos > 0) {
+      if (++nextPacketId_ == 0) nextPacketId_ = 1;
+      packetId = nextPacketId_;
+    }
+
+    uint8_t *p = packet;
+    *p++ = 0x30 | (qos > 0 ? 0x02 : 0x00);
+    p += writeVarint(p, remaining);
+    *p++ = topicLen >> 8;
+    *p++ = topicLen & 0xFF;
+    memcpy(p, topic, topicLen);
+    p += topicLen;
+    if (qos > 0) {
+      *p++ = packetId >> 8;
+      *p++ = packetId & 0xFF;
+    }
+    memcpy(p, payload, length);
+
+    commitRecord(packetLen, packetId, qos, (uint32_t)(monoMicros() / 1000));
+    stats_.queued++;
+    return true;
+  }
+
+  bool publish(const char *topic, const char *payload, uint8_t qos = 1, size_t reserve = 0) {
+    return publish(topic, (const uint8_t *)payload, strlen(payload), qos, reserve);
+  }
+
+  /**
+   * @brief Máquina de estados: conecta, lê respostas e envia a outbox
+   * @details Nunca espera pelo broker; só transport.connect() pode levar
+   *          o tempo do handshake TCP (limitado a 1 tentativa por intervalo)
+   */
+  void loop() {
+    uint32_t now = (uint32_t)(monoMicros() / 1000);
+
+    if (state_ == MQTT_LITE_DISCONNECTED) {
+      if (attempted_ && now - lastAttemptMs_ < reconnectMs_) return;
+      attempted_ = true;
+      lastAttemptMs_ = now;
+      startSession(now);
+      if (state_ == MQTT_LITE_DISCONNECTED) return;
+    }
+
+    if (!transport_.connected() || !receive(now)) {
+      dropConnection();
+      return;
+    }
+
+    if (state_ == MQTT_LITE_CONNECTING) {
+      if (now - lastAttemptMs_ > MQTT_LITE_CONNACK_TIMEOUT_MS) {
+        dropConnection();
+        return;
+      }
+    } else if (subscribePending_ && ctrlPos_ == ctrlLen_) {
+      queueSubscribe();
+    } else if (keepAliveS_ > 0) {
+      if (now - lastRxMs_ > keepAliveS_ * 1500UL) {
+        dropConnection(); // Broker mudo: 1,5 × keep-alive sem nada recebido
+        return;
+      }
+      if (now - lastTxMs_ >= keepAliveS_ * 1000UL / 2 && ctrlPos_ == ctrlLen_) {
+        ctrl_[0] = 0xC0; // PINGREQ
+        ctrl_[1] = 0x00;
+        ctrlLen_ = 2;
+        ctrlPos_ = 0;
+      }
+    }
+
+    if (!transmit(now)) dropConnection();
+  }
+
+  /** @brief Fecha a conexão; a outbox é preservada para a próxima */
+  void disconnect() {
+    if (state_ == MQTT_LITE_CONNECTED) {
+      const uint8_t packet[2] = {0xE0, 0x00}; // DISCONNECT
+      transport_.write(packet, sizeof(packet));
+    }
+    dropConnection();
+  }
+
+  bool connected() const { return state_ == MQTT_LITE_CONNECTED; }
+  MqttLiteState state() const { return state_; }
+
+  /** @brief Mensagens na outbox (na fila ou em voo) */
+  uint32_t pending() const { return records_; }
+  uint8_t inFlight() const { return inFlight_; }
+
+  /**
+   * @brief Latência de publicação: publish() → PUBACK, incluindo a espera
+   *        na outbox (média móvel) ou a idade da mensagem mais antiga
+   *        ainda na outbox, se for maior (enlace parado não gera PUBACK)
+   */
+  uint32_t latencyMs() const {
+    if (records_ == 0) return ackLatencyMs_;
+    uint32_t oldest = (uint32_t)(monoMicros() / 1000) - headerAt(head_).queuedMs;
+    return oldest > ackLatencyMs_ ? oldest : ackLatencyMs_;
+  }
+  size_t outboxUsed() const { return used_; }
+  static size_t outboxCapacity() { return OutboxBytes; }
+  const MqttLiteStats &stats() const { return stats_; }
+  Transport &transport() { return transport_; }
+
+private:
+  enum RecordState : uint8_t { RECORD_QUEUED = 0, RECORD_SENDING, RECORD_SENT, RECORD_DONE };
+
+  struct OutboxHeader {
+    uint16_t length;   // Bytes do pacote (MQTT_LITE_WRAP = preenchimento)
+    uint16_t packetId; // 0 em QoS0
+    uint8_t state;     // RecordState
+    uint8_t qos;
+    uint32_t queuedMs; // Instante do publish() (latência até o PUBACK)
+  };
+  static const uint32_t HEADER = sizeof(OutboxHeader);
+
+  // ------------------------------------------------------------------
+  // --- CONEXÃO ---
+  // ------------------------------------------------------------------
+
+  void startSession(uint32_t now) {
+    if (host_ == NULL || !transport_.connect(host_, port_)) return;
+
+    // CONNECT: protocolo "MQTT" nível 4 (3.1.1), sessão limpa
+    size_t idLen = strlen(clientId_);
+    size_t remaining = 10 + 2 + idLen;
+    uint8_t *p = ctrl_;
+    *p++ = 0x10;
+    p += writeVarint(p, remaining);
+    static const uint8_t header[] = {0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04, 0x02};
+    memcpy(p, header, sizeof(header));
+    p += sizeof(header);
+    *p++ = keepAliveS_ >> 8;
+    *p++ = keepAliveS_ & 0xFF;
+    *p++ = idLen >> 8;
+    *p++ = idLen & 0xFF;
+    memcpy(p, clientId_, idLen);
+    p += idLen;
+    ctrlLen_ = p - ctrl_;
+    ctrlPos_ = 0;
+
+    rxLen_ = 0;
+    lastRxMs_ = lastTxMs_ = now;
+    state_ = MQTT_LITE_CONNECTING;
+  }
+
+  /**
+   * @brief Perda da conexão: tudo o que foi iniciado volta para a fila
+   * @details QoS1 enviado (ou parcialmente enviado) recebe a flag DUP e é
+   *          retransmitido; registros concluídos são pulados pelo envio
+   */
+  void dropConnection() {
+    transport_.stop();
+    state_ = MQTT_LITE_DISCONNECTED;
+    ctrlLen_ = ctrlPos_ = 0;
+    txActive_ = false;
+    inFlight_ = 0;
+
+    uint32_t offset = head_;
+    uint32_t started = records_ - unsent_;
+    for (uint32_t i = 0; i < started; i++) {
+      OutboxHeader h = headerAt(offset);
+      if (h.state == RECORD_SENDING || h.state == RECORD_SENT) {
+        if (h.qos > 0) {
+          buffer_[offset + HEADER] |= 0x08; // DUP
+          stats_.retransmitted++;
+        }
+        h.state = RECORD_QUEUED;
+        setHeader(offset, h);
+      }
+      offset = nextRecord(offset, h);
+    }
+    send_ = head_;
+    unsent_ = records_;
+  }
+
+  // ------------------------------------------------------------------
+  // --- RECEPÇÃO ---
+  // ------------------------------------------------------------------
+
+  /**
+   * @brief Lê o que chegou e trata os pacotes completos
+   * @return false em erro do transporte ou do protocolo
+   */
+  bool receive(uint32_t now) {
+    for (;;) {
+      int n = transport_.read(rx_ + rxLen_, sizeof(rx_) - rxLen_);
+      if (n < 0) return false;
+      if (n == 0) return true;
+      rxLen_ += n;
+      lastRxMs_ = now;
+
+      for (;;) {
+        if (skip_ > 0) {
+          size_t drop = skip_ < rxLen_ ? skip_ : rxLen_;
+          consume(drop);
+          skip_ -= drop;
+          if (skip_ > 0) break;
+        }
+        size_t remaining, lengthBytes;
+        if (!readVarint(rx_ + 1, rxLen_ - (rxLen_ > 0 ? 1 : 0), remaining, lengthBytes)) break;
+        size_t total = 1 + lengthBytes + remaining;
+        if (total > sizeof(rx_)) {
+          skip_ = total; // PUBLISH recebido grande demais: descartado
+          continue;
+        }
+        if (rxLen_ < total) break;
+        if (!handlePacket(rx_[0], rx_ + 1 + lengthBytes, remaining, now)) return false;
+        consume(total);
+      }
+    }
+  }
+
+  bool handlePacket(uint8_t type, const uint8_t *body, size_t length, uint32_t now) {
+    switch (type & 0xF0) {
+      case 0x20: // CONNACK
+        if (length < 2 || body[1] != 0) return false;
+        state_ = MQTT_LITE_CONNECTED;
+        stats_.reconnects++;
+        subscribePending_ = subscription_[0] != '\0'; // Sessão limpa: assina de novo
+        return true;
+      case 0x40: // PUBACK
+        if (length >= 2) acknowledge((body[0] << 8) | body[1], now);
+        return true;
+      case 0x30: // PUBLISH da assinatura (QoS0: sem packet id nem PUBACK)
+        return deliver(type, body, length);
+      default: // PINGRESP, SUBACK: ignorados
+        return true;
+    }
+  }
+
+  bool deliver(uint8_t type, const uint8_t *body, size_t length) {
+    if (length < 2) return false;
+    size_t topicLength = (body[0] << 8) | body[1];
+    size_t offset = 2 + topicLength + ((type & 0x06) ? 2 : 0);
+    if (offset > length) return false;
+    if (handler_) {
+      handler_(handlerContext_, (const char *)body + 2, topicLength, body + offset,
+               length - offset);
+    }
+    return true;
+  }
+
+  /** @brief SUBSCRIBE do tópico configurado em ctrl_ (QoS0) */
+  void queueSubscribe() {
+    size_t topicLength = strlen(subscription_);
+    if (++nextPacketId_ == 0) nextPacketId_ = 1; // SUBACK não passa por acknowledge()
+    uint16_t packetId = nextPacketId_;
+    uint8_t *p = ctrl_;
+    *p++ = 0x82;
+    p += writeVarint(p, 2 + 2 + topicLength + 1);
+    *p++ = packetId >> 8;
+    *p++ = packetId & 0xFF;
+    *p++ = topicLength >> 8;
+    *p++ = topicLength & 0xFF;
+    memcpy(p, subscription_, topicLength);
+    p += topicLength;
+    *p++ = 0x00; // QoS máximo pedido
+    ctrlLen_ = p - ctrl_;
+    ctrlPos_ = 0;
+    subscribePending_ = false;
+  }
+
+  void acknowledge(uint16_t packetId, uint32_t now) {
+    uint32_t offset = head_;
+    uint32_t started = records_ - unsent_;
+    for (uint32_t i = 0; i < started; i++) {
+      OutboxHeader h = headerAt(offset);
+      if (h.state == RECORD_SENT && h.packetId == packetId) {
+        h.state = RECORD_DONE;
+        setHeader(offset, h);
+        inFlight_--;
+        stats_.acked++;
+        // Média móvel com peso 1/8 para a amostra nova
+        int32_t delta = (int32_t)(now - h.queuedMs) - (int32_t)ackLatencyMs_;
+        ackLatencyMs_ = (uint32_t)((int32_t)ackLatencyMs_ + delta / 8);
+        break;
+      }
+      offset = nextRecord(offset, h);
+    }
+    releaseDone();
+  }
+
+  void consume(size_t bytes) {
+    memmove(rx_, rx_ + bytes, rxLen_ - bytes);
+    rxLen_ -= bytes;
+  }
+
+  // ------------------------------------------------------------------
+  // --- ENVIO ---
+  // ------------------------------------------------------------------
+
+  /**
+   * @brief Escreve controle pendente e depois a outbox, até o transporte
+   *        recusar ou a janela QoS1 encher
+   * @return false em erro do transporte
+   */
+  bool transmit(uint32_t now) {
+    if (ctrlPos_ < ctrlLen_) {
+      int n = transport_.write(ctrl_ + ctrlPos_, ctrlLen_ - ctrlPos_);
+      if (n < 0) return false;
+      ctrlPos_ += n;
+      if (n > 0) lastTxMs_ = now;
+      if (ctrlPos_ < ctrlLen_) return true;
+    }
+    if (state_ != MQTT_LITE_CONNECTED) return true;
+
+    for (;;) {
+      if (!txActive_ && !startNextRecord()) return true;
+
+      OutboxHeader h = headerAt(txOffset_);
+      const uint8_t *packet = buffer_ + txOffset_ + HEADER;
+      int n = transport_.write(packet + txPos_, h.length - txPos_);
+      if (n < 0) return false;
+      if (n > 0) lastTxMs_ = now;
+      txPos_ += n;
+      if (txPos_ < h.length) return true; // Buffer do socket cheio
+
+      txActive_ = false;
+      h.state = h.qos > 0 ? RECORD_SENT : RECORD_DONE;
+      setHeader(txOffset_, h);
+      if (h.qos == 0) releaseDone();
+    }
+  }
+
+  /**
+   * @brief Escolhe o próximo registro a enviar (pula os já concluídos)
+   */
+  bool startNextRecord() {
+    while (unsent_ > 0) {
+      OutboxHeader h = headerAt(send_);
+      if (h.state == RECORD_DONE) {
+        send_ = nextRecord(send_, h);
+        unsent_--;
+        releaseDone();
+        continue;
+      }
+      if (h.qos > 0) {
+        if (inFlight_ >= window_) return false;
+        inFlight_++;
+      }
+      h.state = RECORD_SENDING;
+      setHeader(send_, h);
+      txOffset_ = send_;
+      txPos_ = 0;
+      txActive_ = true;
+      send_ = nextRecord(send_, h);
+      unsent_--;
+      return true;
+    }
+    return false;
+  }
+
+  // ------------------------------------------------------------------
+  // --- OUTBOX (ANEL DE REGISTROS CONTÍGUOS) ---
+  // ------------------------------------------------------------------
+
+  OutboxHeader headerAt(uint32_t offset) const {
+    OutboxHeader h;
+    memcpy(&h, buffer_ + offset, HEADER);
+    return h;
+  }
+
+  void setHeader(uint32_t offset, const OutboxHeader &h) {
+    memcpy(buffer_ + offset, &h, HEADER);
+  }
+
+  /** @brief Início do registro seguinte, pulando o preenchimento do fim */
+  uint32_t nextRecord(uint32_t offset, const OutboxHeader &h) const {
+    uint32_t next = offset + HEADER + h.length;
+    if (next + HEADER > OutboxBytes) return 0;
+    if (next != tail_ && headerAt(next).length == MQTT_LITE_WRAP) return 0;
+    return next;
+  }
+
+  uint8_t *reserveRecord(size_t packetLen, size_t reserve) {
+    uint32_t need = HEADER + packetLen;
+    uint32_t pad = tail_ + need > OutboxBytes ? OutboxBytes - tail_ : 0;
+    if (packetLen >= MQTT_LITE_WRAP || used_ + pad + need + reserve > OutboxBytes) return NULL;
+    return buffer_ + (pad ? 0 : tail_) + HEADER;
+  }
+
+  void commitRecord(size_t packetLen, uint16_t packetId, uint8_t qos, uint32_t now) {
+    uint32_t need = HEADER + packetLen;
+    if (tail_ + need > OutboxBytes) {
+      if (tail_ + HEADER <= OutboxBytes) {
+        OutboxHeader wrap = {MQTT_LITE_WRAP, 0, RECORD_DONE, 0, 0};
+        setHeader(tail_, wrap);
+      }
+      used_ += OutboxBytes - tail_;
+      tail_ = 0;
+    }
+    OutboxHeader h = {(uint16_t)packetLen, packetId, RECORD_QUEUED, qos, now};
+    setHeader(tail_, h);
+    if (unsent_ == 0) send_ = tail_;
+    tail_ += need;
+    used_ += need;
+    records_++;
+    unsent_++;
+  }
+
+  /**
+   * @brief Libera do início da outbox os registros concluídos
+   */
+  void releaseDone() {
+    while (records_ > unsent_) {
+      OutboxHeader h = headerAt(head_);
+      if (h.state != RECORD_DONE) break;
+      uint32_t next = head_ + HEADER + h.length;
+      uint32_t following = nextRecord(head_, h);
+      used_ -= HEADER + h.length;
+      if (following == 0 && next != 0 && records_ > 1) used_ -= OutboxBytes - next;
+      records_--;
+      head_ = following;
+    }
+    if (records_ == 0) {
+      head_ = tail_ = send_ = 0;
+      used_ = 0;
+    }
+  }
+
+  // ------------------------------------------------------------------
+  // --- COMPRIMENTO RESTANTE (VARINT DO MQTT) ---
+  // ------------------------------------------------------------------
+
+  static size_t varintSize(size_t value) {
+    return value < 128 ? 1 : value < 16384 ? 2 : value < 2097152 ? 3 : 4;
+  }
+
+  static size_t writeVarint(uint8_t *out, size_t value) {
+    size_t n = 0;
+    do {
+      uint8_t byte = value % 128;
+      value /= 128;
+      out[n++] = value > 0 ? (byte | 0x80) : byte;
+    } while (value > 0);
+    return n;
+  }
+
+  static bool readVarint(const uint8_t *in, size_t available, size_t &value, size_t &bytes) {
+    value = 0;
+    for (bytes = 0; bytes < 4 && bytes < available; bytes++) {
+      value |= (size_t)(in[bytes] & 0x7F) << (7 * bytes);
+      if ((in[bytes] & 0x80) == 0) {
+        bytes++;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Transport transport_;
+  const char *host_ = NULL;
+  uint16_t port_ = 1883;
+  char clientId_[24] = "voltz";
+  uint16_t keepAliveS_ = 15;
+  uint32_t reconnectMs_ = 2000;
+  uint8_t window_ = 8;
+
+  MqttLiteState state_ = MQTT_LITE_DISCONNECTED;
+  bool attempted_ = false;
+  uint32_t lastAttemptMs_ = 0;
+  uint32_t lastRxMs_ = 0;
+  uint32_t lastTxMs_ = 0;
+  uint16_t nextPacketId_ = 0;
+  uint8_t inFlight_ = 0;
+  uint32_t ackLatencyMs_ = 0;
+  MqttLiteStats stats_;
+
+  // Assinatura (refeita a cada conexão)
+  char subscription_[MQTT_LITE_TOPIC_BYTES] = "";
+  MqttLiteHandler handler_ = NULL;
+  void *handlerContext_ = NULL;
+  bool subscribePending_ = false;
+
+  // Pacote de controle em envio (CONNECT, PINGREQ, SUBSCRIBE)
+  uint8_t ctrl_[64];
+  size_t ctrlLen_ = 0;
+  size_t ctrlPos_ = 0;
+
+  uint8_t rx_[MQTT_LITE_RX_BYTES];
+  size_t rxLen_ = 0;
+  size_t skip_ = 0;
+
+  uint8_t buffer_[OutboxBytes];
+  uint32_t head_ = 0;    // Registro mais antigo
+  uint32_t tail_ = 0;    // Onde entra o próximo registro
+  uint32_t send_ = 0;    // Próximo registro a enviar
+  uint32_t used_ = 0;    // Bytes ocupados (registros + preenchimento)
+  uint32_t records_ = 0; // Registros na outbox
+  uint32_t unsent_ = 0;  // Registros a partir de send_
+  bool txActive_ = false;
+  uint32_t txOffset_ = 0; // Registro sendo escrito no transporte
+  size_t txPos_ = 0;
+};
+
+#endif // MQTT_LITE_H
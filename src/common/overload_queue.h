@@ -0,0 +1,232 @@
+#ifndef OVERLOAD_QUEUE_H
+#define OVERLOAD_QUEUE_H
+
+// ------------------------------------------------------------------
+// --- FILA COM POLÍTICA DE SOBRECARGA E CONTABILIDADE ---
+// ------------------------------------------------------------------
+// Quando a fila de telemetria enche, o que fazer com o próximo frame:
+//
+//   OVERLOAD_DROP_NEWEST   descarta o frame que chegou (comportamento antigo)
+//   OVERLOAD_DROP_OLDEST   descarta o mais antigo da fila e enfileira o novo
+//   OVERLOAD_LATEST_PER_ID guarda só o último frame de cada ID até a fila
+//                          esvaziar (para telemetria, o valor atual vale mais
+//                          que um histórico atrasado)
+//   OVERLOAD_SPILL         desvia para armazenamento (FrameSpill) e relê
+//                          quando a fila esvaziar, na ordem de chegada
+//
+// Em LATEST_PER_ID e SPILL, enquanto houver frames no nível de excesso
+// todos os novos frames vão para ele: o consumidor esvazia primeiro a
+// fila (mais antigos) e depois o excesso, sem inverter a ordem.
+//
+// Os frames entram e saem como handles do FramePool (frame_pool.h) com a
+// referência junto: push() fica com ela e, se o frame for perdido ou
+// substituído, devolve o slot ao pool; pop() a entrega a quem retira.
+// O spill guarda o conteúdo (o slot volta ao pool na gravação) e a
+// releitura ocupa um slot novo.
+
+#include <stddef.h>
+#include <stdint.h>
+#include "can_message.h"
+#include "frame_pool.h"
+#include "frame_queue.h"
+#include "platform.h"
+
+#define OVERLOAD_LATEST_SLOTS 64 // IDs distintos guardados em LATEST_PER_ID
+
+enum OverloadPolicy : uint8_t {
+  OVERLOAD_DROP_NEWEST = 0,
+  OVERLOAD_DROP_OLDEST,
+  OVERLOAD_LATEST_PER_ID,
+  OVERLOAD_SPILL
+};
+
+inline const char *overloadPolicyName(OverloadPolicy policy) {
+  switch (policy) {
+    case OVERLOAD_DROP_NEWEST: return "drop-newest";
+    case OVERLOAD_DROP_OLDEST: return "drop-oldest";
+    case OVERLOAD_LATEST_PER_ID: return "latest-per-id";
+    case OVERLOAD_SPILL: return "spill";
+    default: return "?";
+  }
+}
+
+/**
+ * @brief Contadores do que entrou e do que foi perdido, por política
+ */
+struct OverloadStats {
+  uint32_t accepted = 0;      // Frames recebidos por push()
+  uint32_t droppedNewest = 0; // DROP_NEWEST (ou excesso sem espaço)
+  uint32_t droppedOldest = 0; // DROP_OLDEST: antigos descartados
+  uint32_t superseded = 0;    // LATEST_PER_ID: substituídos por um mais novo
+  uint32_t spilled = 0;       // SPILL: desviados para o armazenamento
+  uint32_t spillLost = 0;     // SPILL: falha de escrita no armazenamento
+
+  uint32_t lost() const { return droppedNewest + droppedOldest + superseded + spillLost; }
+};
+
+/**
+ * @brief Armazenamento de excesso usado por OVERLOAD_SPILL
+ * @details Acesso serializado pela OverloadQueue (não precisa de trava)
+ */
+class FrameSpill {
+public:
+  virtual ~FrameSpill() {}
+  virtual bool write(const CanMessage &frame) = 0;
+  virtual bool read(CanMessage &frame) = 0;
+  virtual bool empty() = 0;
+};
+
+class OverloadQueue {
+public:
+  bool begin(FramePool &pool, size_t capacity, OverloadPolicy policy = OVERLOAD_DROP_NEWEST,
+             FrameSpill *spill = NULL) {
+    pool_ = &pool;
+    spill_ = spill;
+    setPolicy(policy);
+    return queue_.begin(capacity);
+  }
+
+  /**
+   * @brief Troca a política (SPILL sem armazenamento vira DROP_NEWEST)
+   */
+  void setPolicy(OverloadPolicy policy) {
+    if (policy == OVERLOAD_SPILL && spill_ == NULL) policy = OVERLOAD_DROP_NEWEST;
+    policy_ = policy;
+  }
+
+  OverloadPolicy policy() const { return policy_; }
+
+  /**
+   * @brief Produtor: enfileira aplicando a política se estiver cheia
+   * @return false se o frame foi perdido (slot já devolvido ao pool)
+   */
+  bool push(FrameHandle handle) {
+    stats_.accepted++;
+
+    // Caminho comum: sem excesso pendente, vai direto para a fila
+    if (overflowing_) return pushOverflow(handle);
+    if (queue_.push(handle)) return true;
+
+    switch (policy_) {
+      case OVERLOAD_DROP_OLDEST: {
+        FrameHandle oldest;
+        if (queue_.pop(oldest, 0)) {
+          pool_->release(oldest);
+          stats_.droppedOldest++;
+        }
+        if (queue_.push(handle)) return true;
+        return drop(handle);
+      }
+
+      case OVERLOAD_LATEST_PER_ID:
+      case OVERLOAD_SPILL:
+        return pushOverflow(handle);
+
+      case OVERLOAD_DROP_NEWEST:
+      default:
+        return drop(handle);
+    }
+  }
+
+  /**
+   * @brief Consumidor: fila primeiro, depois o excesso (mais novo)
+   * @details O handle retirado vem com a referência (release() é de quem
+   *          retira). Com o pool esgotado o spill espera a próxima chamada
+   */
+  bool pop(FrameHandle &handle) {
+    if (queue_.pop(handle, 0)) return true;
+    if (!overflowing_) return false;
+
+    PlatformLock lock(mutex_);
+    // O produtor pode ter enchido a fila e entrado em excesso entre a
+    // leitura acima e a trava: os frames da fila são mais antigos
+    if (queue_.pop(handle, 0)) return true;
+
+    // Lê os dois níveis: a política pode ter mudado durante o excesso
+    if (popLatest(handle)) return true;
+    if (spill_ != NULL && !spill_->empty()) {
+      FrameHandle slot = pool_->acquire();
+      if (slot == FRAME_NONE) return false;
+      if (spill_->read(pool_->frame(slot))) {
+        handle = slot;
+        return true;
+      }
+      pool_->release(slot);
+    }
+    // Excesso esvaziado: novos frames voltam para a fila
+    overflowing_ = false;
+    return false;
+  }
+
+  size_t size() { return queue_.size() + latestCount_; }
+
+  /** @brief Há frames no excesso (slots por ID ou spill), fora de size() */
+  bool overflowing() const { return overflowing_; }
+  const OverloadStats &stats() const { return stats_; }
+
+private:
+  bool pushOverflow(FrameHandle handle) {
+    PlatformLock lock(mutex_);
+
+    // O consumidor pode ter esvaziado o excesso enquanto esperávamos
+    if (!overflowing_ && queue_.push(handle)) return true;
+    overflowing_ = true;
+
+    if (policy_ == OVERLOAD_SPILL && spill_ != NULL) {
+      bool written = spill_->write(pool_->frame(handle));
+      pool_->release(handle);
+      if (written) {
+        stats_.spilled++;
+        return true;
+      }
+      stats_.spillLost++;
+      return false;
+    }
+    return putLatest(handle);
+  }
+
+  /**
+   * @brief Guarda o frame substituindo o anterior do mesmo ID
+   */
+  bool putLatest(FrameHandle handle) {
+    const CanMessage &frame = pool_->frame(handle);
+    for (uint8_t i = 0; i < latestCount_; i++) {
+      const CanMessage &slot = pool_->frame(latest_[i]);
+      if (slot.id == frame.id && slot.isExtended == frame.isExtended) {
+        pool_->release(latest_[i]);
+        latest_[i] = handle;
+        stats_.superseded++;
+        return true;
+      }
+    }
+    if (latestCount_ >= OVERLOAD_LATEST_SLOTS) return drop(handle);
+    latest_[latestCount_++] = handle;
+    return true;
+  }
+
+  bool popLatest(FrameHandle &handle) {
+    if (latestCount_ == 0) return false;
+    handle = latest_[0];
+    latest_[0] = latest_[--latestCount_];
+    return true;
+  }
+
+  /** @brief Frame que chegou perdido: conta e devolve o slot */
+  bool drop(FrameHandle handle) {
+    pool_->release(handle);
+    stats_.droppedNewest++;
+    return false;
+  }
+
+  FrameQueue queue_;
+  FramePool *pool_ = NULL;
+  FrameSpill *spill_ = NULL;
+  volatile OverloadPolicy policy_ = OVERLOAD_DROP_NEWEST;
+  volatile bool overflowing_ = false;
+  PlatformMutex mutex_;
+  FrameHandle latest_[OVERLOAD_LATEST_SLOTS];
+  uint8_t latestCount_ = 0;
+  OverloadStats stats_;
+};
+
+#endif // OVERLOAD_QUEUE_H
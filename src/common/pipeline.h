@@ -0,0 +1,516 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+// ------------------------------------------------------------------
+// --- PIPELINE COMPOSTO EM TEMPO DE COMPILAÇÃO ---
+// ------------------------------------------------------------------
+// fonte → filtro → decodificador → sinks
+//
+// Cada estágio é um tipo concreto passado como parâmetro de template,
+// então as chamadas entre estágios são diretas (inline) e um estágio
+// desabilitado (PassFilter, NullDecoder, lista de sinks vazia) não
+// gera código. O perfil do firmware escolhe os tipos (ver
+// src/sketch_def/profiles.h).
+//
+// Interfaces esperadas:
+//   Source : bool begin();  bool read(CanMessage &frame);
+//   Filter : bool accept(const CanMessage &frame);
+//   Decoder: bool decode(const CanMessage &frame, VehicleState &state);
+//            bool tick(uint32_t nowUs, TripSummary &trip);
+//            bool popWindow(WindowRecord &record);
+//            bool popAlarm(RuleEvent &event);
+//            bool publishRules(const RuleProgram<RULE_CAPACITY> *program);
+//            bool rulesWritable(const RuleProgram<RULE_CAPACITY> *program) const;
+//   Sink   : bool begin();  void poll();
+//            void write(const CanMessage &frame, const VehicleState &state);
+//            void writeUrgent(const CanMessage &frame, const VehicleState &state);
+//            void writeTrip(const TripSummary &trip);
+//            void writeWindow(const WindowRecord &record);
+//            void writeAlarm(const RuleEvent &event);
+//            void flush();
+//            void report(const LaneStatus &status);
+//            void feedback(LinkFeedback &link);
+//            bool receiveConfig(ConfigUpdate &update);
+//
+// tick() é chamado periodicamente pelo estágio de decodificação, mesmo
+// sem frames; devolve true quando uma viagem terminou (trip_stats.h), e o
+// resumo chega a todos os sinks por writeTrip() no estágio de envio.
+// popWindow() entrega as janelas mín/máx/média encerradas por decode() ou
+// tick() (signal_window.h); elas seguem por um SpscRing até writeWindow().
+// popAlarm() entrega as transições das regras (rule_engine.h), que seguem
+// por outro SpscRing até writeAlarm(), entregue junto com as falhas.
+// report() recebe periodicamente os contadores das lanes/sobrecarga.
+// writeUrgent() recebe os frames da lane de falhas (priority_lanes.h) e
+// deve entregá-los na hora, sem esperar o flush() do lote.
+// feedback() acumula em link o que o sink mede do enlace (latência de
+// entrega, recusas por buffer cheio); sinks locais não alteram nada.
+// A task de envio ajusta o lote e o intervalo com isso (adaptive_batch.h).
+// receiveConfig() entrega uma configuração recebida pelo sink (tópico MQTT
+// do dispositivo): update chega com a atual, sai com a nova já validada ou
+// com error preenchido; o primeiro sink que tiver uma responde (true).
+//
+// Estágios de execução (cada um em uma task, ver sketch_def.ino):
+//
+//   capture()  fonte + timestamp             Core 0, prioridade 3
+//        │  SpscRing (lock-free)
+//   prepare()  filtro + decodificador        Core 0, prioridade 2
+//        │  PriorityLanes (falhas / telemetria com política de sobrecarga)
+//   process()  serialização + envio (sinks)  Core 1, prioridade 1
+//
+// O ring de captura leva o frame por cópia; o frame aceito por prepare()
+// vai para um slot do FramePool (frame_pool.h) e as lanes levam só o
+// handle, e os estágios recebem o frame por referência.
+//
+// O estado decodificado pertence ao estágio prepare(); os sinks recebem
+// a cópia mais recente publicada por ele (SeqLockValue), nunca o estado
+// que está sendo alterado no outro núcleo.
+
+#include "adaptive_batch.h"
+#include "can_message.h"
+#include "priority_lanes.h"
+#include "rule_engine.h"
+#include "runtime_config.h"
+#include "signal_window.h"
+#include "spsc_ring.h"
+#include "time_base.h"
+#include "trip_stats.h"
+#include "vehicle_state.h"
+
+// ------------------------------------------------------------------
+// --- ESTÁGIOS NEUTROS ---
+// ------------------------------------------------------------------
+
+/**
+ * @brief Filtro desabilitado: aceita todos os frames
+ */
+struct PassFilter {
+  bool accept(const CanMessage &) { return true; }
+};
+
+/**
+ * @brief Aceita apenas os frames de bateria, controlador e falhas
+ */
+struct TelemetryIdFilter {
+  bool accept(const CanMessage &frame) {
+    return frame.id == BASE_BATTERY_ID || frame.id == BASE_CONTROLLER_ID ||
+           frameLane(frame) == LANE_HIGH;
+  }
+};
+
+/**
+ * @brief Decodificador desabilitado: não mantém estado
+ */
+struct NullDecoder {
+  bool decode(const CanMessage &, VehicleState &) { return false; }
+  bool tick(uint32_t, TripSummary &) { return false; }
+  bool popWindow(WindowRecord &) { return false; }
+  bool popAlarm(RuleEvent &) { return false; }
+  bool publishRules(const RuleProgram<RULE_CAPACITY> *) { return false; }
+  bool rulesWritable(const RuleProgram<RULE_CAPACITY> *) const { return true; }
+};
+
+/**
+ * @brief Decodificador dos frames de bateria/controlador (últimos valores)
+ */
+struct StateDecoder {
+  bool decode(const CanMessage &frame, VehicleState &state) {
+    return applyFrame(state, frame.id, frame.data, frame.length,
+                      TimeBase::stampMillis(frame.timestampUs));
+  }
+  bool tick(uint32_t, TripSummary &) { return false; }
+  bool popWindow(WindowRecord &) { return false; }
+  bool popAlarm(RuleEvent &) { return false; }
+  bool publishRules(const RuleProgram<RULE_CAPACITY> *) { return false; }
+  bool rulesWritable(const RuleProgram<RULE_CAPACITY> *) const { return true; }
+};
+
+/**
+ * @brief Últimos valores + agregados no ESP32
+ * @tparam Trips   Agregados da viagem (energia, distância, modos; trip_stats.h)
+ * @tparam Windows Janelas mín/máx/média/último por sinal (signal_window.h)
+ * @tparam Rules   Regras de limiar/alarme (rule_engine.h)
+ * @note Um agregado desabilitado não gera código (if sobre constante)
+ */
+template <bool Trips, bool Windows, bool Rules = false>
+class AggregateDecoder {
+public:
+  typedef RuleEngine<RULE_CAPACITY> Engine;
+
+  AggregateDecoder() {
+    trip_.begin();
+    const uint32_t periodsMs[] = {SIGNAL_WINDOW_SHORT_MS, SIGNAL_WINDOW_LONG_MS};
+    windows_.begin(periodsMs, 2);
+  }
+
+  bool decode(const CanMessage &frame, VehicleState &state) {
+    if (!applyFrame(state, frame.id, frame.data, frame.length,
+                    TimeBase::stampMillis(frame.timestampUs))) {
+      return false;
+    }
+    bool battery = frame.id == BASE_BATTERY_ID;
+    if (Trips) {
+      // Frame depois de uma pausa maior que o key-off: a viagem anterior
+      // termina aqui mesmo que tick() ainda não tenha rodado
+      if (!pending_ && trip_.checkKeyOff(frame.timestampUs, ended_)) pending_ = true;
+      if (battery) {
+        trip_.addBattery(state.battery, frame.timestampUs);
+      } else {
+        trip_.addMotor(state.motor, frame.timestampUs);
+      }
+    }
+    if (Windows) {
+      WindowOutput out(*this);
+      if (battery) {
+        windows_.addBattery(state.battery, frame.timestampUs, out);
+      } else {
+        windows_.addMotor(state.motor, frame.timestampUs, out);
+      }
+    }
+    if (Rules) {
+      AlarmOutput out(*this);
+      if (battery) {
+        rules_.evaluateBattery(state.battery, frame.timestampUs, out);
+      } else {
+        rules_.evaluateMotor(state.motor, frame.timestampUs, out);
+      }
+    }
+    return true;
+  }
+
+  bool tick(uint32_t nowUs, TripSummary &trip) {
+    if (Windows) windows_.poll(nowUs, WindowOutput(*this));
+    if (!Trips) return false;
+    if (pending_) {
+      pending_ = false;
+      trip = ended_;
+      return true;
+    }
+    return trip_.checkKeyOff(nowUs, trip);
+  }
+
+  /** @brief Próxima janela encerrada (o pipeline esvazia após cada chamada) */
+  bool popWindow(WindowRecord &record) {
+    if (windowRead_ == windowCount_) return false;
+    record = window_[windowRead_++];
+    if (windowRead_ == windowCount_) windowRead_ = windowCount_ = 0;
+    return true;
+  }
+
+  /** @brief Próxima transição de regra (o pipeline esvazia após cada frame) */
+  bool popAlarm(RuleEvent &event) {
+    if (alarmRead_ == alarmCount_) return false;
+    event = alarm_[alarmRead_++];
+    if (alarmRead_ == alarmCount_) alarmRead_ = alarmCount_ = 0;
+    return true;
+  }
+
+  /** @brief Transições descartadas (mais de RULE_EVENT_BURST no mesmo frame) */
+  uint32_t alarmOverflows() const { return alarmOverflows_; }
+
+  /** @brief Programa de regras novo (qualquer task; ver RuleEngine::publish) */
+  bool publishRules(const typename Engine::Program *program) {
+    return Rules && rules_.publish(program);
+  }
+  bool rulesWritable(const typename Engine::Program *program) const {
+    return rules_.canWrite(program);
+  }
+
+private:
+  // Cada chamada encerra no máximo uma janela por nível
+  static const uint8_t WINDOW_PENDING = SIGNAL_WINDOW_MAX_LEVELS;
+
+  struct WindowOutput {
+    explicit WindowOutput(AggregateDecoder &owner) : owner(owner) {}
+    void operator()(const WindowRecord &record) const {
+      if (owner.windowCount_ < WINDOW_PENDING) owner.window_[owner.windowCount_++] = record;
+    }
+    AggregateDecoder &owner;
+  };
+
+  struct AlarmOutput {
+    explicit AlarmOutput(AggregateDecoder &owner) : owner(owner) {}
+    void operator()(const RuleEvent &event) const {
+      if (owner.alarmCount_ < RULE_EVENT_BURST) {
+        owner.alarm_[owner.alarmCount_++] = event;
+      } else {
+        owner.alarmOverflows_++;
+      }
+    }
+    AggregateDecoder &owner;
+  };
+
+  TripAggregator trip_;
+  TripSummary ended_; // Encerrada em decode(), entregue no próximo tick()
+  bool pending_ = false;
+  SignalWindows windows_;
+  WindowRecord window_[WINDOW_PENDING];
+  uint8_t windowCount_ = 0;
+  uint8_t windowRead_ = 0;
+  Engine rules_;
+  RuleEvent alarm_[RULE_EVENT_BURST];
+  uint8_t alarmCount_ = 0;
+  uint8_t alarmRead_ = 0;
+  uint32_t alarmOverflows_ = 0;
+};
+
+/** @brief Últimos valores + agregados da viagem */
+typedef AggregateDecoder<true, false> TripDecoder;
+
+// ------------------------------------------------------------------
+// --- LISTA DE SINKS (RECURSÃO VARIÁDICA, COMPATÍVEL COM C++11) ---
+// ------------------------------------------------------------------
+
+template <class... Sinks> class SinkChain;
+
+template <> class SinkChain<> {
+public:
+  bool begin() { return true; }
+  void poll() {}
+  void write(const CanMessage &, const VehicleState &) {}
+  void writeUrgent(const CanMessage &, const VehicleState &) {}
+  void writeTrip(const TripSummary &) {}
+  void writeWindow(const WindowRecord &) {}
+  void writeAlarm(const RuleEvent &) {}
+  void flush() {}
+  void report(const LaneStatus &) {}
+  void feedback(LinkFeedback &) {}
+  bool receiveConfig(ConfigUpdate &) { return false; }
+};
+
+template <class Head, class... Tail>
+class SinkChain<Head, Tail...> {
+public:
+  bool begin() {
+    bool ok = head_.begin();
+    return tail_.begin() && ok;
+  }
+  void poll() {
+    head_.poll();
+    tail_.poll();
+  }
+  void write(const CanMessage &frame, const VehicleState &state) {
+    head_.write(frame, state);
+    tail_.write(frame, state);
+  }
+  void writeUrgent(const CanMessage &frame, const VehicleState &state) {
+    head_.writeUrgent(frame, state);
+    tail_.writeUrgent(frame, state);
+  }
+  void writeTrip(const TripSummary &trip) {
+    head_.writeTrip(trip);
+    tail_.writeTrip(trip);
+  }
+  void writeWindow(const WindowRecord &record) {
+    head_.writeWindow(record);
+    tail_.writeWindow(record);
+  }
+  void writeAlarm(const RuleEvent &event) {
+    head_.writeAlarm(event);
+    tail_.writeAlarm(event);
+  }
+  void flush() {
+    head_.flush();
+    tail_.flush();
+  }
+  void report(const LaneStatus &status) {
+    head_.report(status);
+    tail_.report(status);
+  }
+  void feedback(LinkFeedback &link) {
+    head_.feedback(link);
+    tail_.feedback(link);
+  }
+  bool receiveConfig(ConfigUpdate &update) {
+    return head_.receiveConfig(update) || tail_.receiveConfig(update);
+  }
+  Head &head() { return head_; }
+  SinkChain<Tail...> &tail() { return tail_; }
+
+private:
+  Head head_;
+  SinkChain<Tail...> tail_;
+};
+
+// ------------------------------------------------------------------
+// --- PIPELINE ---
+// ------------------------------------------------------------------
+
+template <class Source, class Filter, class Decoder, class... Sinks>
+class Pipeline {
+public:
+  /**
+   * @brief Inicializa sinks e fonte
+   * @return false se a fonte não iniciou (um sink com falha apenas degrada)
+   */
+  bool begin() {
+    sinks_.begin();
+    return source_.begin();
+  }
+
+  /**
+   * @brief Estágio 1 (captura): lê da fonte, já com o timestamp
+   * @return true se há um frame para o estágio de decodificação
+   */
+  bool capture(CanMessage &frame) { return source_.read(frame); }
+
+  /**
+   * @brief Estágio 2 (decodificação): filtro + decodificador
+   * @details Publica o estado para os sinks quando o frame o altera
+   * @return true se o frame segue para as lanes de envio
+   */
+  bool prepare(const CanMessage &frame) {
+    if (!filter_.accept(frame)) return false;
+    if (decoder_.decode(frame, state_)) {
+      published_.write(state_);
+      queueWindows();
+      queueAlarms();
+    }
+    return true;
+  }
+
+  /**
+   * @brief Estágio 2 sem frames (chamado a cada ~100 ms): fim de viagem
+   * @return true se uma viagem terminou e o resumo foi publicado
+   */
+  bool tick(uint32_t nowUs) {
+    TripSummary trip;
+    bool ended = decoder_.tick(nowUs, trip);
+    queueWindows();
+    if (!ended) return false;
+    tripPublished_.write(trip);
+    tripCount_++;
+    return true;
+  }
+
+  /**
+   * @brief Estágio 3: entrega aos sinks o resumo da viagem que terminou
+   */
+  void processTrip() {
+    uint32_t count = tripCount_;
+    if (count == tripDelivered_) return;
+    tripDelivered_ = count;
+    TripSummary trip;
+    tripPublished_.read(trip);
+    sinks_.writeTrip(trip);
+  }
+
+  /**
+   * @brief Estágio 3: entrega aos sinks as janelas encerradas
+   */
+  void processWindows() {
+    WindowRecord record;
+    while (windowRing_.pop(record)) sinks_.writeWindow(record);
+  }
+
+  /** @brief Janelas perdidas com o ring cheio (estágio 3 atrasado) */
+  uint32_t windowDrops() const { return windowDrops_; }
+
+  /**
+   * @brief Estágio 3: entrega aos sinks as transições das regras
+   * @return Número de eventos entregues
+   */
+  uint32_t processAlarms() {
+    RuleEvent event;
+    uint32_t count = 0;
+    while (alarmRing_.pop(event)) {
+      sinks_.writeAlarm(event);
+      count++;
+    }
+    return count;
+  }
+
+  /** @brief Alarmes perdidos com o ring cheio */
+  uint32_t alarmDrops() const { return alarmDrops_; }
+
+  /**
+   * @brief Troca as regras sem parar a decodificação (qualquer task)
+   * @return false sem motor de regras, ou com a troca anterior pendente
+   */
+  bool publishRules(const RuleProgram<RULE_CAPACITY> *program) {
+    return decoder_.publishRules(program);
+  }
+
+  /** @brief O programa pode ser recompilado (não está ativo nem à espera) */
+  bool rulesWritable(const RuleProgram<RULE_CAPACITY> *program) const {
+    return decoder_.rulesWritable(program);
+  }
+
+  /**
+   * @brief Estágio 3 (envio): entrega a todos os sinks
+   */
+  void process(const CanMessage &frame) {
+    published_.read(view_);
+    sinks_.write(frame, view_);
+  }
+
+  /**
+   * @brief Frame da lane de falhas: entregue imediatamente pelos sinks
+   */
+  void processUrgent(const CanMessage &frame) {
+    published_.read(view_);
+    sinks_.writeUrgent(frame, view_);
+  }
+
+  /** @brief Fim de um lote: sinks enviam/gravam o que acumularam */
+  void flush() { sinks_.flush(); }
+
+  /** @brief Manutenção periódica (conexões, keep-alive) */
+  void poll() { sinks_.poll(); }
+
+  /** @brief Contadores das filas (o que foi perdido e por qual política) */
+  void report(const LaneStatus &status) { sinks_.report(status); }
+
+  /** @brief Latência e recusas medidas pelos sinks (lote adaptativo) */
+  LinkFeedback feedback() {
+    LinkFeedback link;
+    sinks_.feedback(link);
+    return link;
+  }
+
+  /**
+   * @brief Estágio 3: configuração recebida por um sink (uma por chamada)
+   * @return false se nenhuma chegou
+   */
+  bool receiveConfig(ConfigUpdate &update) { return sinks_.receiveConfig(update); }
+
+  Source &source() { return source_; }
+  SinkChain<Sinks...> &sinks() { return sinks_; }
+  /** @brief Estado visto pelos sinks (cópia do estágio de envio) */
+  const VehicleState &state() const { return view_; }
+  /** @brief Estado do estágio 2, só para o próprio estágio 2 (dead-band) */
+  const VehicleState &decodedState() const { return state_; }
+
+private:
+  /** @brief Estágio 2: janelas encerradas pelo decodificador → estágio 3 */
+  void queueWindows() {
+    WindowRecord record;
+    while (decoder_.popWindow(record)) {
+      if (!windowRing_.push(record)) windowDrops_++;
+    }
+  }
+
+  /** @brief Estágio 2: transições das regras → estágio 3 */
+  void queueAlarms() {
+    RuleEvent event;
+    while (decoder_.popAlarm(event)) {
+      if (!alarmRing_.push(event)) alarmDrops_++;
+    }
+  }
+
+  Source source_;
+  Filter filter_;
+  Decoder decoder_;
+  SinkChain<Sinks...> sinks_;
+  VehicleState state_;                   // Só o estágio 2 escreve
+  SeqLockValue<VehicleState> published_; // Estágio 2 → estágio 3
+  VehicleState view_;                    // Só o estágio 3 lê
+  SeqLockValue<TripSummary> tripPublished_; // Última viagem encerrada
+  volatile uint32_t tripCount_ = 0;         // Escrito pelo estágio 2
+  uint32_t tripDelivered_ = 0;              // Só o estágio 3
+  SpscRing<WindowRecord, SIGNAL_WINDOW_QUEUE> windowRing_;
+  volatile uint32_t windowDrops_ = 0;       // Escrito pelo estágio 2
+  SpscRing<RuleEvent, RULE_EVENT_QUEUE> alarmRing_;
+  volatile uint32_t alarmDrops_ = 0;        // Escrito pelo estágio 2
+};
+
+#endif // PIPELINE_H
@@ -0,0 +1,85 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+// ------------------------------------------------------------------
+// --- ABSTRAÇÃO DE PLATAFORMA (ESP32 / HOST) ---
+// ------------------------------------------------------------------
+// Os módulos de src/common são escritos em C++ portátil para que o
+// mesmo código rode no firmware e em ferramentas/benchmarks no PC.
+// Tudo que depende do hardware fica concentrado aqui.
+
+#include <stdint.h>
+#include <sys/time.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#else
+#include <chrono>
+#include <mutex>
+#endif
+
+/**
+ * @brief Contador monotônico em microssegundos desde o boot
+ * @details No ESP32 lê o esp_timer (64 bits, não sofre ajuste de NTP).
+ *          No host usa o steady_clock.
+ */
+inline int64_t monoMicros() {
+#ifdef ARDUINO
+  return esp_timer_get_time();
+#else
+  using namespace std::chrono;
+  static const steady_clock::time_point boot = steady_clock::now();
+  return duration_cast<microseconds>(steady_clock::now() - boot).count();
+#endif
+}
+
+/**
+ * @brief Relógio de parede (UTC) em microssegundos desde epoch
+ * @note Sujeito a saltos quando o NTP sincroniza. Não usar por frame.
+ */
+inline int64_t wallClockMicros() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+/**
+ * @brief Mutex entre tasks (FreeRTOS estático no ESP32, std::mutex no host)
+ * @note Não usar em ISR. Pode ser instanciado como global.
+ */
+class PlatformMutex {
+public:
+#ifdef ARDUINO
+  PlatformMutex() { handle_ = xSemaphoreCreateMutexStatic(&buffer_); }
+  void lock() { xSemaphoreTake(handle_, portMAX_DELAY); }
+  void unlock() { xSemaphoreGive(handle_); }
+#else
+  void lock() { mutex_.lock(); }
+  void unlock() { mutex_.unlock(); }
+#endif
+
+private:
+#ifdef ARDUINO
+  StaticSemaphore_t buffer_;
+  SemaphoreHandle_t handle_;
+#else
+  std::mutex mutex_;
+#endif
+};
+
+/**
+ * @brief Trava o mutex no escopo atual
+ */
+class PlatformLock {
+public:
+  explicit PlatformLock(PlatformMutex &mutex) : mutex_(mutex) { mutex_.lock(); }
+  ~PlatformLock() { mutex_.unlock(); }
+
+private:
+  PlatformMutex &mutex_;
+};
+
+#endif // PLATFORM_H
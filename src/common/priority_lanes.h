@@ -0,0 +1,155 @@
+#ifndef PRIORITY_LANES_H
+#define PRIORITY_LANES_H
+
+// ------------------------------------------------------------------
+// --- LANES DE PRIORIDADE (CAPTURA → ENVIO) ---
+// ------------------------------------------------------------------
+// Frames de falha (MCU / BMS, ver ControllerErrorInfo e BMSErrorInfo em
+// src/esp32/esp32_can.cpp) vão para uma fila própria, pequena e sempre
+// esvaziada primeiro. Assim um over-current ou motor lock não espera
+// atrás de centenas de frames de telemetria durante uma queda do Wi-Fi,
+// nem é descartado porque a fila de telemetria encheu. A lane de
+// telemetria aplica a política de sobrecarga (overload_queue.h).
+//
+// As duas lanes carregam handles do pool de frames (frame_pool.h) com a
+// referência: push() fica com ela (frame perdido volta ao pool) e quem
+// retira com popHigh()/popLow() chama release() depois de entregar.
+
+#include <stdint.h>
+#include "../../config/constants.h"
+#include "adaptive_batch.h"
+#include "bus_stats.h"
+#include "can_message.h"
+#include "frame_pool.h"
+#include "frame_queue.h"
+#include "overload_queue.h"
+
+#define LANE_HIGH 0 // Falhas / segurança
+#define LANE_LOW 1  // Telemetria de rotina
+#define LANE_COUNT 2
+
+#define LANE_HIGH_CAPACITY 32
+#define FAULT_BACKLOG_SIZE 8
+
+/**
+ * @brief Lane do frame pelo ID
+ * @details BASE_CONTROLLER_ID_2: erros do controlador (MCU);
+ *          BASE_BATTERY_ID_2 e +1: erros/avisos do BMS
+ */
+inline uint8_t frameLane(const CanMessage &frame) {
+  if (frame.isExtended) return LANE_LOW;
+  if (frame.id == BASE_CONTROLLER_ID_2 || frame.id == BASE_BATTERY_ID_2 ||
+      frame.id == BASE_BATTERY_ID_2 + 1) {
+    return LANE_HIGH;
+  }
+  return LANE_LOW;
+}
+
+/**
+ * @brief Retrato das lanes para relatório periódico (sinks → report())
+ */
+struct LaneStatus {
+  OverloadPolicy policy;
+  OverloadStats telemetry;   // Lane de telemetria
+  uint32_t telemetryPending;
+  uint32_t faultDropped;     // Lane de falhas cheia (não deveria acontecer)
+  BatchMetrics batch;        // Ponto de operação da task de envio
+  BusSummary bus;            // Carga, IDs mais frequentes e ausentes
+  uint32_t configVersion = 0;  // Configuração em uso (runtime_config.h)
+  uint32_t configRejected = 0; // Configurações recusadas
+  uint32_t configFiltered = 0; // Frames fora do filtro de IDs
+  uint32_t deadbandHeld = 0;   // Frames segurados pelo dead-band
+};
+
+class PriorityLanes {
+public:
+  bool begin(FramePool &pool, size_t lowCapacity, OverloadPolicy policy = OVERLOAD_DROP_NEWEST,
+             FrameSpill *spill = NULL, size_t highCapacity = LANE_HIGH_CAPACITY) {
+    pool_ = &pool;
+    return high_.begin(highCapacity) && low_.begin(pool, lowCapacity, policy, spill);
+  }
+
+  /**
+   * @brief Enfileira o frame na lane correspondente (sem bloquear)
+   * @return false se o frame foi perdido (contabilizado, slot devolvido)
+   */
+  bool push(FrameHandle handle) {
+    if (frameLane(pool_->frame(handle)) == LANE_LOW) return low_.push(handle);
+    if (high_.push(handle)) return true;
+    pool_->release(handle);
+    highDropped_++;
+    return false;
+  }
+
+  /**
+   * @brief Próximo frame de falha, esperando até waitUs se não houver
+   * @details O consumidor usa a espera como "sleep" entre ciclos: um
+   *          frame de falha o acorda imediatamente
+   */
+  bool popHigh(FrameHandle &handle, uint32_t waitUs = 0) {
+    return high_.pop(handle, waitUs);
+  }
+
+  bool popLow(FrameHandle &handle) { return low_.pop(handle); }
+
+  size_t pending(uint8_t lane) { return lane == LANE_HIGH ? high_.size() : low_.size(); }
+
+  /** @brief Telemetria à espera, incluindo o excesso (slots por ID / spill) */
+  uint32_t telemetryBacklog() { return (uint32_t)low_.size() + (low_.overflowing() ? 1 : 0); }
+  uint32_t dropped(uint8_t lane) const {
+    return lane == LANE_HIGH ? highDropped_ : low_.stats().lost();
+  }
+
+  OverloadQueue &telemetry() { return low_; }
+
+  LaneStatus status() {
+    LaneStatus st;
+    st.policy = low_.policy();
+    st.telemetry = low_.stats();
+    st.telemetryPending = low_.size();
+    st.faultDropped = highDropped_;
+    return st;
+  }
+
+private:
+  FramePool *pool_ = NULL;
+  FrameQueue high_;
+  OverloadQueue low_;
+  volatile uint32_t highDropped_ = 0;
+};
+
+/**
+ * @brief Últimas falhas que um sink não conseguiu entregar (desconectado)
+ * @details Reenviadas na reconexão; cheia, sobrescreve a mais antiga
+ */
+class FaultBacklog {
+public:
+  void push(const CanMessage &frame) {
+    items_[(head_ + count_) % FAULT_BACKLOG_SIZE] = frame;
+    if (count_ < FAULT_BACKLOG_SIZE) {
+      count_++;
+    } else {
+      head_ = (head_ + 1) % FAULT_BACKLOG_SIZE;
+    }
+  }
+
+  bool pop(CanMessage &frame) {
+    if (count_ == 0) return false;
+    frame = items_[head_];
+    head_ = (head_ + 1) % FAULT_BACKLOG_SIZE;
+    count_--;
+    return true;
+  }
+
+  /** @brief Mais antigo sem retirar (NULL se vazio) */
+  const CanMessage *front() const { return count_ ? &items_[head_] : NULL; }
+
+  bool empty() const { return count_ == 0; }
+
+private:
+  CanMessage items_[FAULT_BACKLOG_SIZE];
+  uint8_t head_ = 0;
+  uint8_t count_ = 0;
+};
+
+#endif // PRIORITY_LANES_H
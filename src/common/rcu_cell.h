@@ -0,0 +1,95 @@
+#ifndef RCU_CELL_H
+#define RCU_CELL_H
+
+// ------------------------------------------------------------------
+// --- VALOR TROCADO POR PONTEIRO (ESTILO RCU, SEM LOCK NA LEITURA) ---
+// ------------------------------------------------------------------
+// Para configuração lida a todo frame e trocada raramente: o escritor
+// preenche uma cópia nova fora de uso e publica o ponteiro de uma vez;
+// o leitor nunca espera nem copia, só lê pelo ponteiro.
+//
+// Cada leitor (task) tem um índice fixo e anuncia o ponteiro que está
+// usando (hazard pointer): read() carrega o atual, anuncia e confere que
+// ainda é o atual. O ponteiro vale até o próximo read() do mesmo leitor.
+// O escritor (um só) só reaproveita um slot que não é o atual nem está
+// anunciado por nenhum leitor; com Readers + 2 slots sempre há um livre.
+//
+// Diferente do SeqLockValue (spsc_ring.h), que copia o valor e repete a
+// leitura se cruzou uma escrita, aqui a leitura é O(1) qualquer que seja
+// o tamanho de T e nunca se repete por causa do escritor (só a confirmação
+// do anúncio, quando a troca acontece exatamente entre as duas cargas).
+
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, uint8_t Readers>
+class RcuCell {
+public:
+  /**
+   * @brief Começa com value publicado
+   */
+  explicit RcuCell(const T &value = T()) {
+    slots_[0] = value;
+    current_.store(&slots_[0], std::memory_order_relaxed);
+    for (uint8_t r = 0; r < Readers; r++) hazard_[r].store(nullptr, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Leitor reader: valor atual, válido até o próximo read(reader)
+   */
+  const T *read(uint8_t reader) {
+    const T *value = current_.load(std::memory_order_acquire);
+    for (;;) {
+      hazard_[reader].store(value, std::memory_order_seq_cst);
+      const T *check = current_.load(std::memory_order_seq_cst);
+      if (check == value) return value;
+      value = check;
+    }
+  }
+
+  /** @brief Leitor deixa de usar o valor (não impede trocas futuras) */
+  void release(uint8_t reader) { hazard_[reader].store(nullptr, std::memory_order_release); }
+
+  /**
+   * @brief Escritor: slot livre para preencher, já com uma cópia do atual
+   */
+  T *prepare() {
+    const T *current = current_.load(std::memory_order_relaxed);
+    for (;;) {
+      for (uint8_t s = 0; s < SLOTS; s++) {
+        T *slot = &slots_[s];
+        if (slot == current || inUse(slot)) continue;
+        *slot = *current;
+        return slot;
+      }
+      // Inalcançável: Readers anúncios + o atual ocupam no máximo Readers + 1
+    }
+  }
+
+  /** @brief Escritor: torna slot (de prepare()) o valor atual */
+  void publish(T *slot) {
+    current_.store(slot, std::memory_order_seq_cst);
+    swaps_++;
+  }
+
+  /** @brief Valor atual visto pelo escritor (sem anúncio) */
+  const T &current() const { return *current_.load(std::memory_order_relaxed); }
+  uint32_t swaps() const { return swaps_; }
+
+private:
+  static const uint8_t SLOTS = Readers + 2;
+
+  bool inUse(const T *slot) const {
+    for (uint8_t r = 0; r < Readers; r++) {
+      if (hazard_[r].load(std::memory_order_seq_cst) == slot) return true;
+    }
+    return false;
+  }
+
+  T slots_[SLOTS];
+  std::atomic<const T *> current_;
+  std::atomic<const T *> hazard_[Readers];
+  uint32_t swaps_ = 0; // Só o escritor
+};
+
+#endif // RCU_CELL_H
@@ -0,0 +1,373 @@
+#ifndef RULE_ENGINE_H
+#define RULE_ENGINE_H
+
+// ------------------------------------------------------------------
+// --- REGRAS DE LIMIAR / ALARME SOBRE OS SINAIS DECODIFICADOS ---
+// ------------------------------------------------------------------
+// Regras em texto (sinal, comparador, limiar, histerese, duração mínima)
+// são compiladas para uma tabela ordenada por sinal. Um frame de bateria
+// só avalia as regras de v/a/soc/tB e um do controlador só as de
+// rpm/tq/tM/tC; cada regra custa uma multiplicação, duas comparações e
+// o estado (ocioso / aguardando a duração / ativo).
+//
+// Texto: uma regra por linha (ou separadas por ';'), '#' comenta:
+//
+//   <id> <sinal> <op> <limiar> [h<histerese>] [t<duração ms>]
+//   1 tM > 90 h5 t2000     # motor acima de 90 °C por 2 s, volta abaixo de 85
+//   2 v < 60.5 h1 t5000    # tensão abaixo de 60,5 V por 5 s
+//   3 a >= 150 t500        # corrente de 150 A ou mais por 0,5 s
+//
+// Sinais com os nomes do payload (signal_window.h); limiar e histerese nas
+// unidades de engenharia, com uma casa decimal em v, a e tq. Operadores
+// > >= < <=; os inclusivos viram estritos (valores inteiros) e "abaixo"
+// vira "acima" com o sinal trocado, então a avaliação tem um único caso.
+//
+// Cada transição gera um RuleEvent: ativo quando a condição se mantém
+// pela duração mínima, inativo quando o valor volta além da histerese.
+//
+// Troca sem reflash: o programa compilado é imutável e a task de
+// decodificação adota um novo (publish()) no início da próxima avaliação,
+// sem lock. Quem publica alterna entre dois programas e só reescreve o
+// que não está em uso (canWrite()).
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include "csv_writer.h"
+#include "json_writer.h"
+#include "signal_window.h"
+#include "vehicle_state.h"
+
+#ifndef RULE_CAPACITY
+#define RULE_CAPACITY 32 // Regras por programa no firmware
+#endif
+#ifndef RULE_EVENT_BURST
+#define RULE_EVENT_BURST 8 // Transições guardadas por frame no decodificador
+#endif
+#ifndef RULE_EVENT_QUEUE
+#define RULE_EVENT_QUEUE 16 // Transições entre decodificação e envio (potência de 2)
+#endif
+
+/**
+ * @brief Transição de uma regra (copiada entre tasks, sem ponteiros)
+ */
+struct RuleEvent {
+  uint32_t timestampUs; // Frame que causou a transição
+  uint16_t ruleId;
+  uint8_t signal;       // WindowSignal
+  bool active;          // true: disparou; false: normalizou
+  int32_t value;        // Valor do sinal (unidades de VehicleState)
+  int32_t threshold;    // Limiar como escrito na regra (mesmas unidades)
+};
+
+/**
+ * @brief Regra compilada: ativa com key > enter, normaliza com key < exit
+ * @details key = sign × valor (sign = -1 nas regras "abaixo")
+ */
+struct RuleSlot {
+  int32_t enter;
+  int32_t exit;
+  int32_t sign;
+  uint32_t holdUs;     // Duração mínima da condição
+  int32_t threshold;   // Para o evento
+  uint16_t id;
+  uint8_t signal;
+};
+
+/** @brief Sinal medido em décimos em VehicleState */
+inline bool ruleSignalIsDeci(uint8_t signal) {
+  return signal == WINDOW_VOLTAGE || signal == WINDOW_CURRENT || signal == WINDOW_TORQUE;
+}
+
+/**
+ * @brief Tabela de regras compilada (imutável depois de compile())
+ */
+template <uint16_t Capacity>
+class RuleProgram {
+public:
+  /**
+   * @brief Compila o texto; em caso de erro o programa fica vazio
+   * @return false com errorLine() apontando a regra (1 = primeira linha)
+   */
+  bool compile(const char *text) {
+    count_ = 0;
+    errorLine_ = 0;
+    for (uint8_t s = 0; s <= WINDOW_SIGNAL_COUNT; s++) first_[s] = 0;
+
+    // Regras na ordem do texto; depois, contagem por sinal e
+    // distribuição estável (counting sort) na tabela final
+    RuleSlot parsed[Capacity];
+    uint16_t parsedCount = 0;
+    uint16_t line = 1;
+    const char *p = text ? text : "";
+    while (*p) {
+      p = skipBlank(p);
+      if (*p == '\n' || *p == ';') {
+        if (*p == '\n') line++;
+        p++;
+        continue;
+      }
+      if (*p == '#') {
+        while (*p && *p != '\n') p++;
+        continue;
+      }
+      if (!*p) break;
+      if (parsedCount == Capacity || !parseRule(p, parsed[parsedCount])) return fail(line);
+      parsedCount++;
+    }
+
+    uint16_t perSignal[WINDOW_SIGNAL_COUNT] = {0};
+    for (uint16_t i = 0; i < parsedCount; i++) perSignal[parsed[i].signal]++;
+    for (uint8_t s = 0; s < WINDOW_SIGNAL_COUNT; s++) first_[s + 1] = first_[s] + perSignal[s];
+    uint16_t next[WINDOW_SIGNAL_COUNT];
+    for (uint8_t s = 0; s < WINDOW_SIGNAL_COUNT; s++) next[s] = first_[s];
+    for (uint16_t i = 0; i < parsedCount; i++) slots_[next[parsed[i].signal]++] = parsed[i];
+    count_ = parsedCount;
+    return true;
+  }
+
+  uint16_t count() const { return count_; }
+  uint16_t errorLine() const { return errorLine_; }
+  const RuleSlot &slot(uint16_t index) const { return slots_[index]; }
+  /** @brief Faixa [first(s), first(s + 1)) da tabela com as regras do sinal s */
+  uint16_t first(uint8_t signal) const { return first_[signal]; }
+
+private:
+  bool fail(uint16_t line) {
+    count_ = 0;
+    errorLine_ = line;
+    for (uint8_t s = 0; s <= WINDOW_SIGNAL_COUNT; s++) first_[s] = 0;
+    return false;
+  }
+
+  static const char *skipBlank(const char *p) {
+    while (*p == ' ' || *p == '\t' || *p == '\r') p++;
+    return p;
+  }
+
+  /** @brief Número com até uma casa decimal, multiplicado por scale (1 ou 10) */
+  static bool parseNumber(const char *&p, int32_t scale, int32_t &out) {
+    char *end;
+    long whole = strtol(p, &end, 10);
+    if (end == p && *p != '.' && *p != '-') return false;
+    bool negative = *p == '-';
+    p = end;
+    int32_t tenth = 0;
+    if (*p == '.') {
+      p++;
+      if (*p < '0' || *p > '9') return false;
+      tenth = *p++ - '0';
+      if (*p >= '0' && *p <= '9') return false; // Mais precisão que o sinal
+      if (scale == 1 && tenth != 0) return false;
+    }
+    out = (int32_t)whole * scale + (scale == 10 ? (negative ? -tenth : tenth) : 0);
+    return true;
+  }
+
+  /** @brief Uma regra; avança p até o fim dela */
+  static bool parseRule(const char *&p, RuleSlot &slot) {
+    char *end;
+    long id = strtol(p, &end, 10);
+    if (end == p || id < 0 || id > UINT16_MAX) return false;
+    p = skipBlank(end);
+
+    uint8_t signal = WINDOW_SIGNAL_COUNT;
+    for (uint8_t s = 0; s < WINDOW_SIGNAL_COUNT; s++) {
+      const char *name = windowSignalName(s);
+      size_t length = strlen(name);
+      if (strncmp(p, name, length) == 0 && (p[length] == ' ' || p[length] == '\t' ||
+                                            p[length] == '<' || p[length] == '>')) {
+        signal = s;
+        p += length;
+        break;
+      }
+    }
+    if (signal == WINDOW_SIGNAL_COUNT) return false;
+    p = skipBlank(p);
+
+    bool above;
+    if (*p == '>') above = true;
+    else if (*p == '<') above = false;
+    else return false;
+    p++;
+    bool inclusive = *p == '=';
+    if (inclusive) p++;
+    p = skipBlank(p);
+
+    int32_t scale = ruleSignalIsDeci(signal) ? 10 : 1;
+    int32_t threshold, hysteresis = 0;
+    uint32_t holdMs = 0;
+    if (!parseNumber(p, scale, threshold)) return false;
+    for (;;) {
+      p = skipBlank(p);
+      if (*p == 'h') {
+        p++;
+        if (!parseNumber(p, scale, hysteresis) || hysteresis < 0) return false;
+      } else if (*p == 't') {
+        p++;
+        long ms = strtol(p, &end, 10);
+        if (end == p || ms < 0 || ms > 3600000L) return false;
+        holdMs = (uint32_t)ms;
+        p = end;
+      } else {
+        break;
+      }
+    }
+    if (*p && *p != '\n' && *p != ';' && *p != '#') return false;
+
+    // v >= t → v > t - 1; v < t → -v > -t; v <= t → -v > -(t + 1)
+    int32_t strict = inclusive ? (above ? threshold - 1 : threshold + 1) : threshold;
+    slot.sign = above ? 1 : -1;
+    slot.enter = slot.sign * strict;
+    slot.exit = slot.sign * threshold - hysteresis;
+    slot.holdUs = holdMs * 1000UL;
+    slot.threshold = threshold;
+    slot.id = (uint16_t)id;
+    slot.signal = signal;
+    return true;
+  }
+
+  RuleSlot slots_[Capacity];
+  uint16_t first_[WINDOW_SIGNAL_COUNT + 1] = {0};
+  uint16_t count_ = 0;
+  uint16_t errorLine_ = 0;
+};
+
+/**
+ * @brief Avalia o programa ativo nos sinais que cada frame alterou
+ * @note evaluate*() só na task de decodificação; publish()/canWrite() em
+ *       qualquer outra (uma só publicadora)
+ */
+template <uint16_t Capacity>
+class RuleEngine {
+public:
+  typedef RuleProgram<Capacity> Program;
+
+  /**
+   * @brief Entrega um programa novo; adotado na próxima avaliação
+   * @details O programa precisa continuar válido enquanto estiver ativo
+   * @return false se o anterior ainda não foi adotado
+   */
+  bool publish(const Program *program) {
+    const Program *expected = nullptr;
+    return next_.compare_exchange_strong(expected, program, std::memory_order_release,
+                                         std::memory_order_relaxed);
+  }
+
+  /** @brief O programa pode ser reescrito (não está ativo nem à espera) */
+  bool canWrite(const Program *program) const {
+    return program != active_.load(std::memory_order_acquire) &&
+           program != next_.load(std::memory_order_acquire);
+  }
+
+  const Program *active() const { return active_.load(std::memory_order_relaxed); }
+
+  template <class Fn>
+  void evaluateBattery(const BatteryState &battery, uint32_t nowUs, Fn emit) {
+    int32_t values[4] = {battery.voltageDeci, battery.currentDeci, battery.soc,
+                         battery.temperature};
+    evaluate(WINDOW_VOLTAGE, values, nowUs, emit);
+  }
+
+  template <class Fn>
+  void evaluateMotor(const MotorState &motor, uint32_t nowUs, Fn emit) {
+    int32_t values[4] = {motor.rpm, motor.torqueDeci, motor.motorTemp, motor.controllerTemp};
+    evaluate(WINDOW_RPM, values, nowUs, emit);
+  }
+
+private:
+  enum Phase : uint8_t { RULE_IDLE, RULE_PENDING, RULE_ACTIVE };
+
+  struct RuleState {
+    uint32_t sinceUs;
+    Phase phase;
+  };
+
+  /** @brief Regras dos 4 sinais a partir de base (todos do mesmo frame) */
+  template <class Fn>
+  void evaluate(uint8_t base, const int32_t *values, uint32_t nowUs, Fn &emit) {
+    adopt();
+    const Program *program = active_.load(std::memory_order_relaxed);
+    if (!program) return;
+    uint16_t end = program->first(base + 4);
+    for (uint16_t i = program->first(base); i < end; i++) {
+      const RuleSlot &slot = program->slot(i);
+      int32_t value = values[slot.signal - base];
+      int32_t key = slot.sign * value;
+      RuleState &state = state_[i];
+      if (state.phase == RULE_ACTIVE) {
+        if (key < slot.exit) {
+          state.phase = RULE_IDLE;
+          emit(event(slot, value, nowUs, false));
+        }
+      } else if (key > slot.enter) {
+        if (state.phase == RULE_IDLE) {
+          state.phase = RULE_PENDING;
+          state.sinceUs = nowUs;
+        }
+        if (nowUs - state.sinceUs >= slot.holdUs) {
+          state.phase = RULE_ACTIVE;
+          emit(event(slot, value, nowUs, true));
+        }
+      } else {
+        state.phase = RULE_IDLE;
+      }
+    }
+  }
+
+  /** @brief Troca para o programa publicado (estados recomeçam ociosos) */
+  void adopt() {
+    if (!next_.load(std::memory_order_relaxed)) return;
+    const Program *program = next_.load(std::memory_order_acquire);
+    for (uint16_t i = 0; i < Capacity; i++) state_[i].phase = RULE_IDLE;
+    active_.store(program, std::memory_order_release);
+    next_.store(nullptr, std::memory_order_release);
+  }
+
+  static RuleEvent event(const RuleSlot &slot, int32_t value, uint32_t nowUs, bool active) {
+    RuleEvent e;
+    e.timestampUs = nowUs;
+    e.ruleId = slot.id;
+    e.signal = slot.signal;
+    e.active = active;
+    e.value = value;
+    e.threshold = slot.threshold;
+    return e;
+  }
+
+  std::atomic<const Program *> active_{nullptr};
+  std::atomic<const Program *> next_{nullptr};
+  RuleState state_[Capacity] = {};
+};
+
+/**
+ * @brief Evento em JSON ({"type":"alarm"}); valores nas unidades de VehicleState
+ * @return Tamanho escrito, ou >= size se não coube (como snprintf)
+ */
+inline int ruleEventToJson(const RuleEvent &e, long deltaUs, unsigned long anchorSeq, char *out,
+                           size_t size) {
+  JsonWriter json(out, size);
+  json.raw("{\"type\":\"alarm\",\"rule\":").u32(e.ruleId)
+      .raw(",\"sig\":").str(windowSignalName(e.signal))
+      .raw(",\"on\":").boolean(e.active)
+      .raw(",\"val\":").i32(e.value)
+      .raw(",\"thr\":").i32(e.threshold)
+      .raw(",\"dt\":").i32((int32_t)deltaUs)
+      .raw(",\"as\":").u32((uint32_t)anchorSeq)
+      .raw("}");
+  return json.finish();
+}
+
+/**
+ * @brief Linha de SD_ALARM_FILE (ms,regra,sinal,ativo,valor,limiar)
+ * @return Tamanho escrito (com '\n', sem terminador), ou 0 se não coube
+ */
+inline int ruleEventToCsv(const RuleEvent &e, uint32_t ms, char *out, size_t size) {
+  CsvWriter csv(out, size);
+  csv.u32(ms).u32(e.ruleId).str(windowSignalName(e.signal)).u32(e.active ? 1 : 0)
+      .i32(e.value).i32(e.threshold);
+  return csv.finish();
+}
+
+#endif // RULE_ENGINE_H
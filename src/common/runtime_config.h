@@ -0,0 +1,140 @@
+#ifndef RUNTIME_CONFIG_H
+#define RUNTIME_CONFIG_H
+
+// ------------------------------------------------------------------
+// --- CONFIGURAÇÃO ALTERÁVEL EM CAMPO (SEM REFLASH) ---
+// ------------------------------------------------------------------
+// O que as tasks consultam a cada frame/ciclo e pode mudar com a moto
+// rodando: filtro de IDs, intervalos, tamanho do lote e dead-bands da
+// telemetria. Os valores de firmware_config.h são só o ponto de partida
+// (montado no sketch); uma configuração nova chega pelo tópico MQTT
+// do dispositivo, é validada aqui e trocada por ponteiro (rcu_cell.h).
+//
+// Dead-band: um frame de bateria/controlador só segue para o envio se
+// algum dos seus sinais mudou mais que a faixa desde o último enviado,
+// ou se passou heartbeatMs; faixa 0 = qualquer mudança. Sem nenhuma
+// faixa configurada o filtro não atua. Frames de falha nunca são filtrados.
+
+#include <stdint.h>
+#include "can_message.h"
+#include "priority_lanes.h"
+#include "signal_window.h"
+#include "vehicle_state.h"
+
+#define CONFIG_MAX_FILTER_IDS 16
+#define CONFIG_MAX_BATCH_FRAMES 4096
+
+#ifndef RULES_TEXT_MAX
+#define RULES_TEXT_MAX 1024 // Maior texto de regras aceito
+#endif
+
+/**
+ * @brief Configuração em uso (copiada inteira a cada troca; sem ponteiros)
+ */
+struct RuntimeConfig {
+  uint32_t version = 0;             // "ver": obrigatório, só versões maiores são aceitas
+  uint32_t transmitIntervalMs = 50; // "tx": ciclo da task de envio (mínimo, se adaptativo)
+  uint32_t batchFrames = 1024;      // "batch": máximo de frames por ciclo
+  uint32_t reportIntervalMs = 10000;// "rep": relatório das filas
+  uint32_t heartbeatMs = 1000;      // "hb": envio mínimo com dead-band
+  uint8_t filterCount = 0;          // "ids": 0 = todos os IDs
+  uint32_t filterIds[CONFIG_MAX_FILTER_IDS] = {0};
+  bool deadbandOn = false;          // Alguma faixa em "db"
+  int32_t deadband[WINDOW_SIGNAL_COUNT] = {0}; // Unidades de VehicleState
+};
+
+/**
+ * @brief Mensagem de configuração recebida (entra com a atual e sai com a nova)
+ */
+struct ConfigUpdate {
+  RuntimeConfig config;
+  char rules[RULES_TEXT_MAX + 1]; // Vazio: regras mantidas
+  const char *error;              // NULL: aceita
+};
+
+/**
+ * @brief Confere limites e coerência; error aponta o campo recusado
+ */
+inline bool validateRuntimeConfig(const RuntimeConfig &c, const char *&error) {
+  error = NULL;
+  if (c.transmitIntervalMs < 10 || c.transmitIntervalMs > 5000) error = "tx";
+  else if (c.batchFrames < 1 || c.batchFrames > CONFIG_MAX_BATCH_FRAMES) error = "batch";
+  else if (c.reportIntervalMs < 1000 || c.reportIntervalMs > 3600000UL) error = "rep";
+  else if (c.heartbeatMs < c.transmitIntervalMs || c.heartbeatMs > 600000UL) error = "hb";
+  else if (c.filterCount > CONFIG_MAX_FILTER_IDS) error = "ids";
+  for (uint8_t i = 0; !error && i < c.filterCount; i++) {
+    if (c.filterIds[i] > 0x1FFFFFFF) error = "ids";
+  }
+  for (uint8_t s = 0; !error && s < WINDOW_SIGNAL_COUNT; s++) {
+    if (c.deadband[s] < 0 || c.deadband[s] > 100000) error = "db";
+  }
+  return error == NULL;
+}
+
+/**
+ * @brief Filtro de IDs da configuração (falhas passam sempre)
+ */
+inline bool runtimeConfigAccepts(const RuntimeConfig &c, const CanMessage &frame) {
+  if (c.filterCount == 0 || frameLane(frame) == LANE_HIGH) return true;
+  for (uint8_t i = 0; i < c.filterCount; i++) {
+    if (c.filterIds[i] == frame.id) return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Dead-band da telemetria: lembra o último valor enviado de cada sinal
+ * @note Só a task de decodificação usa
+ */
+class DeadbandGate {
+public:
+  /**
+   * @return true se o frame deve seguir para o envio
+   */
+  bool pass(const RuntimeConfig &c, const CanMessage &frame, const VehicleState &state) {
+    if (!c.deadbandOn) return true;
+    uint8_t base;
+    int32_t values[4];
+    if (frame.id == BASE_BATTERY_ID) {
+      base = WINDOW_VOLTAGE;
+      values[0] = state.battery.voltageDeci;
+      values[1] = state.battery.currentDeci;
+      values[2] = state.battery.soc;
+      values[3] = state.battery.temperature;
+    } else if (frame.id == BASE_CONTROLLER_ID) {
+      base = WINDOW_RPM;
+      values[0] = state.motor.rpm;
+      values[1] = state.motor.torqueDeci;
+      values[2] = state.motor.motorTemp;
+      values[3] = state.motor.controllerTemp;
+    } else {
+      return true;
+    }
+
+    uint8_t group = base / 4;
+    bool changed = !sent_[group] || frame.timestampUs - sentUs_[group] >= c.heartbeatMs * 1000UL;
+    for (uint8_t i = 0; !changed && i < 4; i++) {
+      int32_t delta = values[i] - last_[base + i];
+      if (delta < 0) delta = -delta;
+      changed = delta > c.deadband[base + i];
+    }
+    if (!changed) {
+      suppressed_++;
+      return false;
+    }
+    for (uint8_t i = 0; i < 4; i++) last_[base + i] = values[i];
+    sent_[group] = true;
+    sentUs_[group] = frame.timestampUs;
+    return true;
+  }
+
+  uint32_t suppressed() const { return suppressed_; }
+
+private:
+  int32_t last_[WINDOW_SIGNAL_COUNT] = {0};
+  uint32_t sentUs_[2] = {0, 0};
+  bool sent_[2] = {false, false};
+  uint32_t suppressed_ = 0;
+};
+
+#endif // RUNTIME_CONFIG_H
@@ -0,0 +1,378 @@
+#ifndef SEGMENT_LOG_H
+#define SEGMENT_LOG_H
+
+// ------------------------------------------------------------------
+// --- LOG CIRCULAR EM SEGMENTOS DE TAMANHO FIXO ---
+// ------------------------------------------------------------------
+// O log é dividido em N arquivos de tamanho fixo (segmentos) gravados em
+// sequência; quando o último enche, o mais antigo é reaproveitado. O
+// espaço ocupado nunca cresce e o aparelho guarda sempre as horas mais
+// recentes, em vez de parar de gravar com o cartão/flash cheio.
+//
+// FAT (cartão SD, preallocate = true): cada segmento é alocado uma única
+// vez, no primeiro boot. Durante a gravação o arquivo não cresce, então
+// não há alocação de clusters (FAT + FSInfo) nem mudança de tamanho na
+// entrada de diretório a cada flush.
+// LittleFS (preallocate = false): sobrescrever o meio de um arquivo
+// reescreve todos os blocos seguintes (lista CTZ), então lá o segmento
+// é truncado ao ser reaproveitado e só recebe appends.
+//
+// Formato de um segmento (texto):
+//   "#SEG 0000000042\n"  cabeçalho com a sequência do segmento
+//   linhas do log...
+//   '\0'                 fim dos dados (só com preallocate, regravado a
+//                        cada flush; depois dele há lixo da volta anterior)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SEGMENT_LOG_MAX_SEGMENTS 64
+#define SEGMENT_HEADER_BYTES 16 // "#SEG %010lu\n"
+#define SEGMENT_PATH_MAX 48
+
+/**
+ * @brief Segmento via stdio: VFS do ESP32 (/sd, /littlefs) ou arquivo no host
+ * @details Interface esperada por SegmentLog:
+ *   bool open(const char *path, bool truncate);  void close();  bool isOpen();
+ *   uint32_t size();  bool reserve(uint32_t bytes);  bool seek(uint32_t offset);
+ *   size_t read(void *data, size_t length);
+ *   size_t write(const void *data, size_t length);  bool sync();
+ */
+class StdioSegmentFile {
+public:
+  ~StdioSegmentFile() { close(); }
+
+  /** @brief Abre para leitura e escrita, criando se não existir */
+  bool open(const char *path, bool truncate) {
+    close();
+    if (!truncate) file_ = fopen(path, "r+b");
+    if (file_ == NULL) file_ = fopen(path, "w+b");
+    return file_ != NULL;
+  }
+
+  void close() {
+    if (file_ != NULL) fclose(file_);
+    file_ = NULL;
+  }
+
+  bool isOpen() const { return file_ != NULL; }
+
+  uint32_t size() {
+    if (file_ == NULL || fseek(file_, 0, SEEK_END) != 0) return 0;
+    long size = ftell(file_);
+    return size < 0 ? 0 : (uint32_t)size;
+  }
+
+  /**
+   * @brief Garante o tamanho do arquivo gravando só o último byte
+   * @details No FAT isso aloca a cadeia de clusters sem gravar os dados
+   */
+  bool reserve(uint32_t bytes) {
+    if (size() >= bytes) return true;
+    return fseek(file_, (long)bytes - 1, SEEK_SET) == 0 && fputc(0, file_) != EOF && sync();
+  }
+
+  bool seek(uint32_t offset) { return fseek(file_, (long)offset, SEEK_SET) == 0; }
+  size_t read(void *data, size_t length) { return fread(data, 1, length, file_); }
+  size_t write(const void *data, size_t length) { return fwrite(data, 1, length, file_); }
+
+  /** @brief Buffer do stdio → sistema de arquivos → meio físico */
+  bool sync() { return fflush(file_) == 0 && fsync(fileno(file_)) == 0; }
+
+private:
+  FILE *file_ = NULL;
+};
+
+/**
+ * @brief Contadores do log (relatório / depuração)
+ */
+struct SegmentLogStats {
+  uint32_t written = 0;   // Bytes de linhas aceitos
+  uint32_t rejected = 0;  // Gravações recusadas (erro ou maior que um segmento)
+  uint32_t rotations = 0; // Segmentos com dados reaproveitados (descartados)
+};
+
+template <class SegmentFile = StdioSegmentFile>
+class SegmentLog {
+public:
+  /**
+   * @brief Abre (ou cria) os segmentos e continua do mais recente
+   * @param pattern Caminho com um %u para o índice, ex.: "/sd/datalog_%02u.csv"
+   * @param preallocate true no FAT (SD), false no LittleFS
+   * @details Só o cabeçalho de cada segmento é lido; o mais recente é
+   *          percorrido até o fim dos dados para continuar a gravação
+   */
+  bool begin(const char *pattern, uint8_t segments, uint32_t segmentBytes, bool preallocate) {
+    file_.close();
+    if (segments == 0 || segments > SEGMENT_LOG_MAX_SEGMENTS) return false;
+    if (segmentBytes < SEGMENT_HEADER_BYTES * 4) return false;
+    pattern_ = pattern;
+    count_ = segments;
+    segmentBytes_ = segmentBytes;
+    preallocate_ = preallocate;
+    dirty_ = false;
+
+    // Sequência de cada segmento (0 = vazio), lida só do cabeçalho
+    uint8_t newest = 0;
+    for (uint8_t i = 0; i < count_; i++) {
+      char path[SEGMENT_PATH_MAX];
+      if (!file_.open(pathOf(i, path), false)) return false;
+      if (preallocate_ && !file_.reserve(segmentBytes_)) {
+        file_.close();
+        return false;
+      }
+      seq_[i] = readHeader();
+      file_.close();
+      if (seq_[i] > seq_[newest]) newest = i;
+    }
+
+    if (seq_[newest] == 0) return startSegment(0, 1);
+    if (resume(newest)) return true;
+    return startSegment(next(newest), seq_[newest] + 1);
+  }
+
+  /**
+   * @brief Acrescenta bytes (linhas inteiras) ao log
+   * @details Não divide um registro entre segmentos: se não couber no
+   *          atual, o próximo (o mais antigo) é reaproveitado antes
+   * @return false se não foi gravado (contabilizado em stats().rejected)
+   */
+  bool write(const char *data, size_t length) {
+    if (!file_.isOpen() || SEGMENT_HEADER_BYTES + length + 1 > segmentBytes_) {
+      stats_.rejected++;
+      return false;
+    }
+    if (position_ + length + 1 > segmentBytes_ &&
+        !startSegment(next(current_), seq_[current_] + 1)) {
+      stats_.rejected++;
+      return false;
+    }
+    if (seekNeeded_ && !file_.seek(position_)) {
+      stats_.rejected++;
+      return false;
+    }
+    seekNeeded_ = false;
+    if (file_.write(data, length) != length) {
+      seekNeeded_ = true; // Posição do arquivo incerta após a falha
+      stats_.rejected++;
+      return false;
+    }
+    position_ += length;
+    stats_.written += length;
+    dirty_ = true;
+    return true;
+  }
+
+  /**
+   * @brief Marca o fim dos dados e grava no meio físico
+   */
+  bool flush() {
+    if (!dirty_) return true;
+    dirty_ = false;
+    if (preallocate_) {
+      const char end = '\0';
+      if (seekNeeded_ && !file_.seek(position_)) return false;
+      if (file_.write(&end, 1) != 1) return false;
+      seekNeeded_ = true; // A próxima linha sobrescreve o '\0'
+    }
+    return file_.sync();
+  }
+
+  /**
+   * @brief Esvazia o log: invalida os cabeçalhos e recomeça do segmento 0
+   */
+  bool clear() {
+    uint32_t seq = seq_[current_] + 1;
+    file_.close();
+    for (uint8_t i = 0; i < count_; i++) {
+      char path[SEGMENT_PATH_MAX];
+      if (!file_.open(pathOf(i, path), !preallocate_)) return false;
+      const char empty = '\0';
+      bool ok = file_.seek(0) && file_.write(&empty, 1) == 1 && file_.sync();
+      file_.close();
+      if (!ok) return false;
+      seq_[i] = 0;
+    }
+    return startSegment(0, seq);
+  }
+
+  /**
+   * @brief Percorre os dados guardados, do mais antigo ao mais recente
+   * @param fn Chamada com (const char *data, size_t length) por trecho
+   * @details Fecha o segmento atual durante a leitura (o FAT do ESP-IDF
+   *          não abre o mesmo arquivo duas vezes para escrita)
+   */
+  template <class Fn> bool readAll(Fn fn) {
+    flush();
+    file_.close();
+    bool ok = true;
+    uint32_t last = 0;
+    for (uint8_t n = 0; n < count_; n++) {
+      // Próximo segmento em ordem de sequência (N pequeno: busca linear)
+      uint8_t index = count_;
+      for (uint8_t i = 0; i < count_; i++) {
+        if (seq_[i] > last && (index == count_ || seq_[i] < seq_[index])) index = i;
+      }
+      if (index == count_) break;
+      last = seq_[index];
+
+      char path[SEGMENT_PATH_MAX];
+      if (!file_.open(pathOf(index, path), false)) {
+        ok = false;
+        continue;
+      }
+      uint32_t end = index == current_ ? position_ : segmentBytes_;
+      if (!preallocate_ && file_.size() < end) end = file_.size();
+      scan(end, fn);
+      file_.close();
+    }
+
+    char path[SEGMENT_PATH_MAX];
+    ok = file_.open(pathOf(current_, path), false) && ok;
+    seekNeeded_ = true;
+    return ok;
+  }
+
+  /** @brief Bytes guardados (aproximado: segmentos anteriores contados cheios) */
+  uint32_t storedBytes() const {
+    uint32_t used = 0;
+    for (uint8_t i = 0; i < count_; i++) {
+      if (seq_[i] != 0 && i != current_) used++;
+    }
+    return used * (segmentBytes_ - SEGMENT_HEADER_BYTES) + (position_ - SEGMENT_HEADER_BYTES);
+  }
+
+  uint32_t capacityBytes() const { return count_ * (segmentBytes_ - SEGMENT_HEADER_BYTES); }
+  uint8_t currentSegment() const { return current_; }
+  uint32_t currentSequence() const { return seq_[current_]; }
+  const SegmentLogStats &stats() const { return stats_; }
+
+private:
+  const char *pathOf(uint8_t index, char *path) const {
+    snprintf(path, SEGMENT_PATH_MAX, pattern_, (unsigned)index);
+    return path;
+  }
+
+  uint8_t next(uint8_t index) const { return (uint8_t)((index + 1) % count_); }
+
+  /** @brief Sequência do cabeçalho do arquivo aberto (0 = vazio/inválido) */
+  uint32_t readHeader() {
+    char header[SEGMENT_HEADER_BYTES + 1];
+    if (!file_.seek(0) || file_.read(header, SEGMENT_HEADER_BYTES) != SEGMENT_HEADER_BYTES) {
+      return 0;
+    }
+    header[SEGMENT_HEADER_BYTES] = '\0';
+    unsigned long seq = 0;
+    if (memcmp(header, "#SEG ", 5) != 0 || header[SEGMENT_HEADER_BYTES - 1] != '\n') return 0;
+    if (sscanf(header + 5, "%10lu", &seq) != 1) return 0;
+    return (uint32_t)seq;
+  }
+
+  /**
+   * @brief Entrega os dados do arquivo aberto, do cabeçalho até end
+   * @return Posição logo após a última linha completa
+   * @details Para no '\0' ou no primeiro byte que não é texto (gravação
+   *          interrompida por queda de energia antes do terminador)
+   */
+  template <class Fn> uint32_t scan(uint32_t end, Fn &fn) {
+    char chunk[256];
+    uint32_t offset = SEGMENT_HEADER_BYTES;
+    uint32_t lineEnd = offset;
+    if (!file_.seek(offset)) return lineEnd;
+    while (offset < end) {
+      size_t want = end - offset < sizeof(chunk) ? end - offset : sizeof(chunk);
+      size_t n = file_.read(chunk, want);
+      if (n == 0) break;
+      size_t valid = 0;
+      while (valid < n && isText(chunk[valid])) {
+        if (chunk[valid] == '\n') lineEnd = offset + (uint32_t)valid + 1;
+        valid++;
+      }
+      if (lineEnd > offset) {
+        // Só linhas completas; o resto do trecho é relido no próximo
+        fn(chunk, lineEnd - offset);
+      } else if (valid == sizeof(chunk)) {
+        // Linha maior que o trecho: entregue como está
+        fn(chunk, valid);
+        lineEnd = offset + (uint32_t)valid;
+      } else {
+        break; // Linha final incompleta
+      }
+      if (valid < n) break;
+      offset = lineEnd;
+      if (!file_.seek(offset)) break;
+    }
+    return lineEnd;
+  }
+
+  static bool isText(char c) {
+    return c == '\n' || c == '\r' || c == '\t' || ((unsigned char)c >= 0x20 && (unsigned char)c < 0x7F);
+  }
+
+  static void ignore(const char *, size_t) {}
+
+  /**
+   * @brief Continua no segmento mais recente, logo após a última linha
+   * @return false se o segmento deve ser substituído por um novo
+   */
+  bool resume(uint8_t index) {
+    char path[SEGMENT_PATH_MAX];
+    if (!file_.open(pathOf(index, path), false)) return false;
+    uint32_t end = preallocate_ ? segmentBytes_ : file_.size();
+    void (*discard)(const char *, size_t) = ignore;
+    uint32_t position = scan(end, discard);
+
+    // LittleFS: sem truncar, lixo após a última linha não pode ficar
+    bool clean = preallocate_ || position == end;
+    if (!clean || position + SEGMENT_HEADER_BYTES >= segmentBytes_) {
+      file_.close();
+      return false;
+    }
+    current_ = index;
+    position_ = position;
+    seekNeeded_ = true;
+    if (preallocate_) {
+      // Reescreve o terminador (a última gravação pode não tê-lo)
+      dirty_ = true;
+      return flush();
+    }
+    return true;
+  }
+
+  /**
+   * @brief Passa a gravar no segmento index (o mais antigo), com nova sequência
+   */
+  bool startSegment(uint8_t index, uint32_t seq) {
+    flush(); // Terminador do segmento que termina aqui
+    file_.close();
+    char path[SEGMENT_PATH_MAX];
+    if (!file_.open(pathOf(index, path), !preallocate_)) return false;
+    if (seq_[index] != 0) stats_.rotations++;
+
+    char header[SEGMENT_HEADER_BYTES + 2];
+    snprintf(header, sizeof(header), "#SEG %010lu\n", (unsigned long)seq);
+    bool ok = file_.seek(0) && file_.write(header, SEGMENT_HEADER_BYTES) == SEGMENT_HEADER_BYTES;
+    seq_[index] = ok ? seq : 0;
+    current_ = index;
+    position_ = SEGMENT_HEADER_BYTES;
+    seekNeeded_ = false;
+    dirty_ = ok;
+    return ok && flush();
+  }
+
+  SegmentFile file_;
+  const char *pattern_ = NULL;
+  uint8_t count_ = 0;
+  uint32_t segmentBytes_ = 0;
+  bool preallocate_ = true;
+  uint32_t seq_[SEGMENT_LOG_MAX_SEGMENTS] = {0}; // 0 = segmento vazio
+  uint8_t current_ = 0;
+  uint32_t position_ = 0;  // Próximo byte a gravar no segmento atual
+  bool seekNeeded_ = false;
+  bool dirty_ = false;
+  SegmentLogStats stats_;
+};
+
+#endif // SEGMENT_LOG_H
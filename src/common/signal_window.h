@@ -0,0 +1,254 @@
+#ifndef SIGNAL_WINDOW_H
+#define SIGNAL_WINDOW_H
+
+// ------------------------------------------------------------------
+// --- JANELAS POR SINAL (MÍN / MÁX / MÉDIA / ÚLTIMO) ---
+// ------------------------------------------------------------------
+// Reduz a telemetria decodificada a um registro por janela fixa (por
+// exemplo 1 s para o painel e 10 s para o histórico) sem perder os
+// extremos que a decimação simples perde: a queda de tensão e o pico de
+// corrente de uma arrancada ficam no mín/máx da janela mesmo que durem
+// um único frame.
+//
+// Janelas "tumbling": consecutivas, sem sobreposição, cada uma começando
+// onde a anterior terminou. Janelas sem nenhuma amostra não geram
+// registro; depois de uma pausa maior que uma janela a próxima se alinha
+// ao período, contado a partir da primeira amostra.
+//
+// Memória constante: por nível e por sinal, mín, máx, último, soma (64
+// bits) e contagem. Uma amostra custa algumas comparações e uma soma por
+// sinal; nada de alocação nem de histórico de amostras.
+//
+// Os valores ficam nas unidades de VehicleState (tensão, corrente e
+// torque em décimos). A média é a das amostras (arredondada), não
+// ponderada pelo tempo: os frames de bateria e controlador têm período
+// fixo. Os timestamps são os 32 bits baixos do contador monotônico (µs);
+// só diferenças são usadas.
+
+#include <stdint.h>
+#include <stdio.h>
+#include "json_writer.h"
+#include "vehicle_state.h"
+
+#ifndef SIGNAL_WINDOW_SHORT_MS
+#define SIGNAL_WINDOW_SHORT_MS 1000 // Janela curta (painel ao vivo)
+#endif
+#ifndef SIGNAL_WINDOW_LONG_MS
+#define SIGNAL_WINDOW_LONG_MS 10000 // Janela longa (histórico)
+#endif
+#ifndef SIGNAL_WINDOW_QUEUE
+#define SIGNAL_WINDOW_QUEUE 16 // Janelas entre decodificação e envio (potência de 2)
+#endif
+
+#define SIGNAL_WINDOW_MAX_LEVELS 4
+
+enum WindowSignal {
+  WINDOW_VOLTAGE,    // 0,1 V
+  WINDOW_CURRENT,    // 0,1 A
+  WINDOW_SOC,        // %
+  WINDOW_BATTERY_TEMP,
+  WINDOW_RPM,
+  WINDOW_TORQUE,     // 0,1 Nm
+  WINDOW_MOTOR_TEMP,
+  WINDOW_CONTROLLER_TEMP,
+  WINDOW_SIGNAL_COUNT
+};
+
+/**
+ * @brief Nome do sinal no payload (mesmos campos de vehicleStateToJson)
+ */
+inline const char *windowSignalName(uint8_t signal) {
+  static const char *const NAMES[WINDOW_SIGNAL_COUNT] = {"v", "a", "soc", "tB",
+                                                         "rpm", "tq", "tM", "tC"};
+  return signal < WINDOW_SIGNAL_COUNT ? NAMES[signal] : "?";
+}
+
+struct WindowStats {
+  int32_t min;
+  int32_t max;
+  int32_t mean;
+  int32_t last;
+  uint16_t count; // 0: sinal ausente na janela (demais campos sem valor)
+};
+
+/**
+ * @brief Uma janela encerrada (copiada entre tasks, sem ponteiros)
+ */
+struct WindowRecord {
+  uint32_t startUs;    // Início da janela (mesma base de CanMessage::timestampUs)
+  uint32_t periodMs;   // Duração nominal
+  uint8_t level;       // Índice do período em SignalWindows
+  uint8_t mode;        // Último modo de condução (RIDE_MODE_*)
+  WindowStats signals[WINDOW_SIGNAL_COUNT];
+};
+
+/**
+ * @brief Acumulador de um sinal em uma janela
+ */
+struct SignalAccumulator {
+  int32_t min = 0;
+  int32_t max = 0;
+  int32_t last = 0;
+  int64_t sum = 0;
+  uint16_t count = 0;
+
+  void add(int32_t value) {
+    if (count == 0 || value < min) min = value;
+    if (count == 0 || value > max) max = value;
+    last = value;
+    sum += value;
+    if (count < UINT16_MAX) count++;
+  }
+
+  void finish(WindowStats &out) const {
+    out.count = count;
+    out.min = min;
+    out.max = max;
+    out.last = last;
+    if (count == 0) {
+      out.mean = 0;
+    } else {
+      // Arredondamento simétrico (a corrente pode ser negativa)
+      out.mean = (int32_t)(sum >= 0 ? (sum + count / 2) / count : (sum - count / 2) / count);
+    }
+  }
+};
+
+/**
+ * @brief Janelas de até SIGNAL_WINDOW_MAX_LEVELS períodos sobre os sinais decodificados
+ * @note Uma única task (a de decodificação) chama tudo; os registros
+ *       encerrados saem pelo callback fn(const WindowRecord &)
+ */
+class SignalWindows {
+public:
+  /**
+   * @param periodsMs Período de cada nível (ex.: {1000, 10000}); 0 encerra a lista
+   */
+  void begin(const uint32_t *periodsMs, uint8_t levels) {
+    levels_ = levels > SIGNAL_WINDOW_MAX_LEVELS ? SIGNAL_WINDOW_MAX_LEVELS : levels;
+    for (uint8_t l = 0; l < levels_; l++) {
+      Level &level = level_[l];
+      level = Level();
+      level.periodUs = periodsMs[l] * 1000UL;
+      if (level.periodUs == 0) {
+        levels_ = l;
+        break;
+      }
+    }
+  }
+
+  template <class Fn>
+  void addBattery(const BatteryState &battery, uint32_t nowUs, Fn emit) {
+    for (uint8_t l = 0; l < levels_; l++) {
+      Level &level = open(l, nowUs, emit);
+      level.acc[WINDOW_VOLTAGE].add(battery.voltageDeci);
+      level.acc[WINDOW_CURRENT].add(battery.currentDeci);
+      level.acc[WINDOW_SOC].add(battery.soc);
+      level.acc[WINDOW_BATTERY_TEMP].add(battery.temperature);
+    }
+  }
+
+  template <class Fn>
+  void addMotor(const MotorState &motor, uint32_t nowUs, Fn emit) {
+    for (uint8_t l = 0; l < levels_; l++) {
+      Level &level = open(l, nowUs, emit);
+      level.acc[WINDOW_RPM].add(motor.rpm);
+      level.acc[WINDOW_TORQUE].add(motor.torqueDeci);
+      level.acc[WINDOW_MOTOR_TEMP].add(motor.motorTemp);
+      level.acc[WINDOW_CONTROLLER_TEMP].add(motor.controllerTemp);
+      level.mode = motor.mode;
+    }
+  }
+
+  /**
+   * @brief Encerra as janelas que terminaram até nowUs (chamar também sem frames)
+   */
+  template <class Fn>
+  void poll(uint32_t nowUs, Fn emit) {
+    for (uint8_t l = 0; l < levels_; l++) {
+      Level &level = level_[l];
+      if (level.started && nowUs - level.startUs >= level.periodUs) close(l, nowUs, emit);
+    }
+  }
+
+  uint8_t levels() const { return levels_; }
+
+private:
+  struct Level {
+    uint32_t periodUs = 0;
+    uint32_t startUs = 0;
+    bool started = false;
+    bool samples = false; // Alguma amostra na janela atual
+    uint8_t mode = 0;     // Persiste entre janelas (último conhecido)
+    SignalAccumulator acc[WINDOW_SIGNAL_COUNT];
+  };
+
+  /** @brief Janela que contém nowUs (encerra a anterior se já terminou) */
+  template <class Fn>
+  Level &open(uint8_t l, uint32_t nowUs, Fn emit) {
+    Level &level = level_[l];
+    if (!level.started) {
+      level.started = true;
+      level.startUs = nowUs;
+    } else if (nowUs - level.startUs >= level.periodUs) {
+      close(l, nowUs, emit);
+    }
+    level.samples = true;
+    return level;
+  }
+
+  /** @brief Emite a janela (se teve amostras) e avança para a que contém nowUs */
+  template <class Fn>
+  void close(uint8_t l, uint32_t nowUs, Fn emit) {
+    Level &level = level_[l];
+    if (level.samples) {
+      WindowRecord record;
+      record.startUs = level.startUs;
+      record.periodMs = level.periodUs / 1000;
+      record.level = l;
+      record.mode = level.mode;
+      for (uint8_t s = 0; s < WINDOW_SIGNAL_COUNT; s++) {
+        level.acc[s].finish(record.signals[s]);
+        level.acc[s] = SignalAccumulator();
+      }
+      emit(record);
+    }
+    level.samples = false;
+    // Pula as janelas vazias mantendo o alinhamento ao período
+    uint32_t elapsed = nowUs - level.startUs;
+    level.startUs += elapsed - elapsed % level.periodUs;
+  }
+
+  Level level_[SIGNAL_WINDOW_MAX_LEVELS];
+  uint8_t levels_ = 0;
+};
+
+// ------------------------------------------------------------------
+// --- SERIALIZAÇÃO ---
+// ------------------------------------------------------------------
+
+/**
+ * @brief Registro compacto ({"type":"win"}): [mín, máx, média, último] por sinal
+ * @details "dt"/"as" como nos frames brutos (início da janela em relação à
+ *          âncora de tempo); sinais sem amostra na janela são omitidos
+ * @return Tamanho escrito, ou >= size se não coube (como snprintf)
+ */
+inline int windowRecordToJson(const WindowRecord &record, long deltaUs, unsigned long anchorSeq,
+                              char *out, size_t size) {
+  JsonWriter json(out, size);
+  json.raw("{\"type\":\"win\",\"w\":").u32(record.periodMs)
+      .raw(",\"dt\":").i32((int32_t)deltaUs)
+      .raw(",\"as\":").u32((uint32_t)anchorSeq)
+      .raw(",\"m\":").u32(record.mode);
+  for (uint8_t s = 0; s < WINDOW_SIGNAL_COUNT; s++) {
+    const WindowStats &w = record.signals[s];
+    if (w.count == 0) continue;
+    json.raw(",").str(windowSignalName(s))
+        .raw(":[").i32(w.min).raw(",").i32(w.max).raw(",").i32(w.mean).raw(",").i32(w.last)
+        .raw("]");
+  }
+  json.raw("}");
+  return json.finish();
+}
+
+#endif // SIGNAL_WINDOW_H
@@ -0,0 +1,98 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+// ------------------------------------------------------------------
+// --- RING LOCK-FREE DE UM PRODUTOR / UM CONSUMIDOR ---
+// ------------------------------------------------------------------
+// Liga dois estágios do pipeline que rodam em tasks (ou núcleos)
+// diferentes sem mutex nem seção crítica: o produtor só escreve head_,
+// o consumidor só escreve tail_. Exige exatamente um produtor e um
+// consumidor. Capacidade potência de 2 (índices com máscara).
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+// Separa head_ e tail_ em linhas de cache diferentes no host (evita
+// false sharing entre threads); no ESP32 não há cache de dados a disputar
+#ifdef ARDUINO
+#define SPSC_CACHE_LINE 4
+#else
+#define SPSC_CACHE_LINE 64
+#endif
+
+template <typename T, uint32_t Capacity>
+class SpscRing {
+  static_assert((Capacity & (Capacity - 1)) == 0, "Capacity deve ser potência de 2");
+
+public:
+  /**
+   * @brief Produtor: copia o item para o ring
+   * @return false se cheio
+   */
+  bool push(const T &item) {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == Capacity) return false;
+    items_[head & (Capacity - 1)] = item;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Consumidor: retira o item mais antigo
+   * @return false se vazio
+   */
+  bool pop(T &item) {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (head_.load(std::memory_order_acquire) == tail) return false;
+    item = items_[tail & (Capacity - 1)];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  uint32_t size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  bool empty() const { return size() == 0; }
+  static uint32_t capacity() { return Capacity; }
+
+private:
+  alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> head_{0};
+  alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> tail_{0};
+  alignas(SPSC_CACHE_LINE) T items_[Capacity];
+};
+
+/**
+ * @brief Valor publicado por um estágio e lido por outro (seqlock)
+ * @details Um escritor; leitores nunca bloqueiam o escritor e repetem a
+ *          cópia se ela coincidir com uma escrita. Para structs pequenas
+ *          (ex.: VehicleState) atualizadas com frequência.
+ */
+template <typename T>
+class SeqLockValue {
+public:
+  void write(const T &value) {
+    uint32_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed); // Ímpar: escrita em curso
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&value_, &value, sizeof(T));
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  void read(T &out) const {
+    uint32_t before, after;
+    do {
+      before = seq_.load(std::memory_order_acquire);
+      memcpy(&out, &value_, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = seq_.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+  }
+
+private:
+  std::atomic<uint32_t> seq_{0};
+  T value_;
+};
+
+#endif // SPSC_RING_H
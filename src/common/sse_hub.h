@@ -0,0 +1,141 @@
+#ifndef SSE_HUB_H
+#define SSE_HUB_H
+
+// ------------------------------------------------------------------
+// --- SERVER-SENT EVENTS (PUSH PARA O NAVEGADOR) ---
+// ------------------------------------------------------------------
+// Mantém as conexões abertas de /events e envia o mesmo quadro SSE a
+// todos os clientes. O quadro é montado uma única vez por evento,
+// independentemente de quantos celulares estejam conectados.
+//
+// No ESP32 o envio vai direto ao socket do lwIP com MSG_DONTWAIT (como o
+// WifiTransport do MQTT): o WiFiClient::write espera segundos com a
+// janela TCP do celular cheia, e isso pararia o loop da captura CAN.
+// Um cliente que não aceita o quadro inteiro na hora é desconectado (um
+// quadro pela metade corromperia o stream); o navegador reconecta
+// sozinho após o "retry".
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#ifdef ARDUINO
+#include <errno.h>
+#include <lwip/sockets.h>
+#endif
+
+#ifndef SSE_MAX_CLIENTS
+#define SSE_MAX_CLIENTS 4 // Conexões simultâneas (cada uma ocupa um socket)
+#endif
+
+#ifndef SSE_FRAME_SIZE
+#define SSE_FRAME_SIZE 512 // Tamanho máximo de um evento serializado
+#endif
+
+static const char SSE_RESPONSE_HEADER[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n"
+    "Access-Control-Allow-Origin: *\r\n\r\n"
+    "retry: 2000\n\n";
+
+/**
+ * @brief Envia tudo sem esperar
+ * @return false se o socket não aceitou os len bytes na hora (buffer de
+ *         envio cheio, envio parcial ou conexão fechada)
+ */
+template <typename Client>
+inline bool sseSendNow(Client &client, const uint8_t *data, size_t len) {
+#ifdef ARDUINO
+  int fd = client.fd();
+  if (fd < 0) return false;
+  return send(fd, data, len, MSG_DONTWAIT) == (int)len;
+#else
+  return client.write(data, len) == len;
+#endif
+}
+
+/**
+ * @brief Distribuidor de eventos SSE
+ * @tparam Client Tipo de conexão (WiFiClient no ESP32)
+ */
+template <typename Client, uint8_t MaxClients = SSE_MAX_CLIENTS>
+class SseHub {
+public:
+  SseHub() : count_(0) {
+    for (uint8_t i = 0; i < MaxClients; i++) used_[i] = false;
+  }
+
+  /**
+   * @brief Assume a conexão HTTP atual e envia o cabeçalho do stream
+   * @return false se não houver vaga ou o cabeçalho não saiu na hora (o
+   *         cliente é desconectado)
+   */
+  bool subscribe(Client client) {
+    for (uint8_t i = 0; i < MaxClients; i++) {
+      if (used_[i]) continue;
+      client.setNoDelay(true);
+      if (!sseSendNow(client, (const uint8_t *)SSE_RESPONSE_HEADER,
+                      sizeof(SSE_RESPONSE_HEADER) - 1)) {
+        break;
+      }
+      clients_[i] = client;
+      used_[i] = true;
+      count_++;
+      return true;
+    }
+    client.stop();
+    return false;
+  }
+
+  /**
+   * @brief Envia um evento a todos os clientes conectados
+   * @details Clientes desconectados ou que não aceitam o quadro inteiro
+   *          na hora (buffer TCP cheio) são descartados, sem esperar.
+   * @return Número de clientes que receberam o evento
+   */
+  uint8_t broadcast(const char *event, const char *data, size_t dataLen) {
+    if (count_ == 0) return 0;
+
+    size_t eventLen = strlen(event);
+    size_t frameLen = 7 + eventLen + 7 + dataLen + 2;
+    if (frameLen > sizeof(frame_)) return 0;
+
+    // "event: <nome>\ndata: <json>\n\n"
+    char *p = frame_;
+    memcpy(p, "event: ", 7); p += 7;
+    memcpy(p, event, eventLen); p += eventLen;
+    memcpy(p, "\ndata: ", 7); p += 7;
+    memcpy(p, data, dataLen); p += dataLen;
+    memcpy(p, "\n\n", 2);
+
+    uint8_t delivered = 0;
+    for (uint8_t i = 0; i < MaxClients; i++) {
+      if (!used_[i]) continue;
+      if (!clients_[i].connected() ||
+          !sseSendNow(clients_[i], (const uint8_t *)frame_, frameLen)) {
+        drop(i);
+        continue;
+      }
+      delivered++;
+    }
+    return delivered;
+  }
+
+  uint8_t clientCount() const { return count_; }
+
+private:
+  void drop(uint8_t i) {
+    clients_[i].stop();
+    clients_[i] = Client();
+    used_[i] = false;
+    count_--;
+  }
+
+  Client clients_[MaxClients];
+  bool used_[MaxClients];
+  uint8_t count_;
+  char frame_[SSE_FRAME_SIZE];
+};
+
+#endif // SSE_HUB_H
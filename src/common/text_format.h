@@ -0,0 +1,88 @@
+#ifndef TEXT_FORMAT_H
+#define TEXT_FORMAT_H
+
+// ------------------------------------------------------------------
+// --- NÚMEROS EM TEXTO SEM PRINTF ---
+// ------------------------------------------------------------------
+// Inteiros e ponto fixo escritos por tabela de pares de dígitos, sem
+// printf nem float. formatFixed(v, 1) de um valor em décimos sai igual
+// a printf("%.1f", v / 10.0f) para |v| < 10.000.000 (até aí o erro do
+// float fica longe da metade de um décimo), então os payloads e CSVs de
+// antes continuam byte a byte os mesmos.
+//
+// Cada função escreve em out, que precisa de TEXT_NUMBER_MAX bytes
+// livres, e devolve quantos escreveu (sem terminador).
+
+#include <stdint.h>
+#include <string.h>
+
+#define TEXT_NUMBER_MAX 12 // "-2147483648" ou "-214748364.8"
+
+/** @brief "00" "01" ... "99" */
+inline const char *textDigitPairs() {
+  static const char PAIRS[201] =
+      "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+  return PAIRS;
+}
+
+/**
+ * @brief Decimal sem sinal
+ */
+inline uint8_t formatU32(char *out, uint32_t value) {
+  char digits[10];
+  char *p = digits + sizeof(digits);
+  const char *pairs = textDigitPairs();
+  while (value >= 100) {
+    uint32_t rest = value % 100;
+    value /= 100;
+    p -= 2;
+    memcpy(p, pairs + rest * 2, 2);
+  }
+  if (value >= 10) {
+    p -= 2;
+    memcpy(p, pairs + value * 2, 2);
+  } else {
+    *--p = (char)('0' + value);
+  }
+  uint8_t length = (uint8_t)(digits + sizeof(digits) - p);
+  memcpy(out, p, length);
+  return length;
+}
+
+/**
+ * @brief Decimal com sinal
+ */
+inline uint8_t formatI32(char *out, int32_t value) {
+  if (value >= 0) return formatU32(out, (uint32_t)value);
+  *out = '-';
+  return 1 + formatU32(out + 1, 0u - (uint32_t)value);
+}
+
+/**
+ * @brief Ponto fixo: value / 10^decimals com exatamente decimals casas
+ * @details formatFixed(out, -5, 1) = "-0.5"; formatFixed(out, 7200, 2) = "72.00"
+ * @param decimals 1 a 9
+ */
+inline uint8_t formatFixed(char *out, int32_t value, uint8_t decimals) {
+  static const uint32_t SCALE[10] = {1, 10, 100, 1000, 10000, 100000,
+                                     1000000, 10000000, 100000000, 1000000000};
+  uint8_t length = 0;
+  uint32_t magnitude = (uint32_t)value;
+  if (value < 0) {
+    out[length++] = '-';
+    magnitude = 0u - magnitude;
+  }
+  uint32_t whole = magnitude / SCALE[decimals];
+  uint32_t fraction = magnitude - whole * SCALE[decimals];
+  length += formatU32(out + length, whole);
+  out[length++] = '.';
+  for (uint8_t i = decimals; i > 0; i--) {
+    out[length + i - 1] = (char)('0' + fraction % 10);
+    fraction /= 10;
+  }
+  return length + decimals;
+}
+
+#endif // TEXT_FORMAT_H
@@ -0,0 +1,143 @@
+#ifndef TIME_BASE_H
+#define TIME_BASE_H
+
+// ------------------------------------------------------------------
+// --- BASE DE TEMPO MONOTÔNICA COM ÂNCORAS UTC ---
+// ------------------------------------------------------------------
+// Cada frame é carimbado apenas com os 32 bits baixos do contador
+// monotônico (µs). Periodicamente é emitida uma âncora que associa o
+// contador monotônico ao UTC; o backend reconstrói o horário absoluto
+// a partir de (âncora + delta). Assim o caminho quente não chama
+// gettimeofday() nem faz multiplicação/divisão de 64 bits, e um ajuste
+// de NTP no meio do percurso não distorce o intervalo entre frames.
+
+#include <stdint.h>
+#include "platform.h"
+
+#ifndef TIME_ANCHOR_INTERVAL_MS
+#define TIME_ANCHOR_INTERVAL_MS 1000 // Período entre âncoras
+#endif
+
+// Idade máxima da âncora referenciada por um frame: o delta é de 32 bits
+// com sinal (µs) e estoura em ~35,8 min. Sem conexão, as âncoras não são
+// publicadas a cada intervalo, só antes desse limite
+#ifndef TIME_ANCHOR_MAX_AGE_MS
+#define TIME_ANCHOR_MAX_AGE_MS 600000
+#endif
+
+// Diferença entre relógio de parede e monotônico acima da qual
+// consideramos que o NTP deu um salto (e não apenas um ajuste fino)
+#define TIME_STEP_THRESHOLD_US 100000LL
+
+// UTC mínimo considerado válido (2020-01-01). Antes disso o NTP
+// ainda não sincronizou e o relógio de parede conta desde 1970.
+#define TIME_MIN_VALID_UTC_US 1577836800000000LL
+
+/**
+ * @brief Associação entre o contador monotônico e o UTC
+ */
+struct TimeAnchor {
+  uint32_t seq = 0;        // Número de sequência (referenciado pelos frames)
+  int64_t monoUs = 0;      // Contador monotônico no instante da âncora
+  int64_t utcUs = 0;       // UTC no mesmo instante
+  float driftPpm = 0.0f;   // Desvio medido do relógio UTC vs monotônico
+  bool synced = false;     // UTC válido (NTP já sincronizou)
+  bool stepped = false;    // Houve salto de relógio desde a âncora anterior
+};
+
+class TimeBase {
+public:
+  explicit TimeBase(uint32_t intervalMs = TIME_ANCHOR_INTERVAL_MS)
+      : intervalUs_((int64_t)intervalMs * 1000LL) {}
+
+  /**
+   * @brief Carimbo barato para o caminho quente (captura de frames)
+   */
+  static inline uint32_t stamp() { return (uint32_t)monoMicros(); }
+
+  /**
+   * @brief Momento de um carimbo na base de millis()
+   * @details O carimbo tem só os 32 bits baixos (volta em ~71,6 min), então
+   *          stamp / 1000 não é millis(). A idade do carimbo (diferença de
+   *          32 bits, certa até ~71 min) é descontada do contador atual em
+   *          µs e só o resultado é truncado para ms, como millis() faz.
+   */
+  static inline uint32_t stampMillis(uint32_t stampUs) {
+    int64_t nowUs = monoMicros();
+    uint32_t ageUs = (uint32_t)nowUs - stampUs;
+    return (uint32_t)((nowUs - ageUs) / 1000);
+  }
+
+  /**
+   * @brief Indica se já passou o período desde a última âncora
+   */
+  bool anchorDue() const {
+    return anchor_.seq == 0 || monoMicros() - anchor_.monoUs >= intervalUs_;
+  }
+
+  /**
+   * @brief Indica se a âncora está perto da idade em que o delta estoura
+   */
+  bool anchorExpiring() const {
+    return anchor_.seq == 0 ||
+           monoMicros() - anchor_.monoUs >= (int64_t)TIME_ANCHOR_MAX_AGE_MS * 1000LL;
+  }
+
+  /**
+   * @brief Lê o relógio de parede uma vez e gera uma nova âncora
+   */
+  const TimeAnchor &updateAnchor() {
+    anchor_ = nextAnchor();
+    return anchor_;
+  }
+
+  /**
+   * @brief Próxima âncora, sem adotá-la (setAnchor() depois de publicada)
+   * @details Estima o desvio (slew do NTP) comparando o avanço do UTC com
+   *          o avanço do contador monotônico entre âncoras consecutivas.
+   */
+  TimeAnchor nextAnchor() const {
+    TimeAnchor next;
+    next.monoUs = monoMicros();
+    next.utcUs = wallClockMicros();
+    next.seq = anchor_.seq + 1;
+    next.synced = next.utcUs >= TIME_MIN_VALID_UTC_US;
+    next.driftPpm = anchor_.driftPpm;
+
+    if (anchor_.seq != 0) {
+      int64_t monoElapsed = next.monoUs - anchor_.monoUs;
+      int64_t utcElapsed = next.utcUs - anchor_.utcUs;
+      int64_t error = utcElapsed - monoElapsed;
+
+      if (next.synced != anchor_.synced || error > TIME_STEP_THRESHOLD_US ||
+          error < -TIME_STEP_THRESHOLD_US) {
+        // Salto do relógio: o desvio anterior não vale mais
+        next.stepped = true;
+        next.driftPpm = 0.0f;
+      } else if (monoElapsed > 0) {
+        // Média móvel exponencial (alpha = 1/8) do desvio em ppm
+        float ppm = (float)error * 1e6f / (float)monoElapsed;
+        next.driftPpm += (ppm - next.driftPpm) * 0.125f;
+      }
+    }
+    return next;
+  }
+
+  void setAnchor(const TimeAnchor &anchor) { anchor_ = anchor; }
+
+  /**
+   * @brief Delta (µs, com sinal) de um carimbo em relação à âncora atual
+   * @note Frames capturados antes da âncora resultam em delta negativo.
+   */
+  int32_t deltaUs(uint32_t stampUs) const {
+    return (int32_t)(stampUs - (uint32_t)anchor_.monoUs);
+  }
+
+  const TimeAnchor &anchor() const { return anchor_; }
+
+private:
+  int64_t intervalUs_;
+  TimeAnchor anchor_;
+};
+
+#endif // TIME_BASE_H
@@ -0,0 +1,348 @@
+#ifndef TRIP_STATS_H
+#define TRIP_STATS_H
+
+// ------------------------------------------------------------------
+// --- AGREGADOS DA VIAGEM (ENERGIA, POTÊNCIA, DISTÂNCIA, MODOS) ---
+// ------------------------------------------------------------------
+// Calculados no próprio ESP32 a cada frame de bateria/controlador, para
+// que o backend receba o resumo da viagem pronto em vez de reconstruí-lo
+// dos frames brutos:
+//   - energia consumida e regenerada (∫ tensão × corrente), em mWh
+//   - potência de pico (descarga e regeneração) e média
+//   - distância (∫ RPM × circunferência da roda; motor de cubo)
+//   - RPM e temperaturas máximas, tensão mínima, SoC inicial e final
+//   - tempo em cada modo de condução (byte 5 do controlador)
+// A viagem começa no primeiro frame e termina quando bateria e
+// controlador ficam calados por keyOffUs (chave desligada).
+//
+// Integração em ponto fixo, sem float: potência em cW (0,1 V × 0,1 A),
+// regra do trapézio entre duas amostras e, quando a potência troca de
+// sinal no intervalo, divisão exata no cruzamento do zero (a parte
+// positiva vai para o consumo, a negativa para a regeneração). As somas
+// ficam em inteiros de 64 bits em unidades de (cW·µs × 2); cada mWh
+// completo passa para o contador e só o resto fica no acumulador, então
+// nada se perde nem deriva em viagens longas. O único arredondamento é o
+// instante do cruzamento (truncado em µs).
+//
+// Intervalos maiores que maxHoldUs entre duas amostras do mesmo tipo não
+// são integrados (a potência de 30 s atrás não descreve o intervalo) e
+// aparecem em holdGapMs. O BMS da captura manda a bateria a cada ~5 s,
+// com pausas de até 26 s; por isso o limite padrão é 30 s.
+//
+// Os timestamps são os 32 bits baixos do contador monotônico (µs): só
+// diferenças entre amostras consecutivas são usadas, então a volta do
+// contador (71 min) não afeta viagens mais longas.
+
+#include <stdint.h>
+#include <stdio.h>
+#include "csv_writer.h"
+#include "vehicle_state.h"
+
+#ifndef TRIP_KEY_OFF_MS
+#define TRIP_KEY_OFF_MS 5000 // Bateria e controlador calados: fim da viagem
+#endif
+#ifndef TRIP_MAX_HOLD_MS
+#define TRIP_MAX_HOLD_MS 30000 // Maior intervalo integrado entre duas amostras
+#endif
+#ifndef TRIP_WHEEL_CIRCUMFERENCE_MM
+#define TRIP_WHEEL_CIRCUMFERENCE_MM 1759 // 2π × 0,28 m (raio do vehicle_sim.h)
+#endif
+
+#define TRIP_UNITS_PER_MWH 720000000LL    // cW·µs × 2 em 1 mWh (3,6e8 × 2)
+#define TRIP_UNITS_PER_MM 120000000ULL   // RPM·mm·µs × 2 em 1 mm (60e6 × 2)
+
+enum TripMode {
+  TRIP_MODE_ECO,
+  TRIP_MODE_STD,
+  TRIP_MODE_TURBO,
+  TRIP_MODE_OTHER, // Byte de modo desconhecido
+  TRIP_MODE_COUNT
+};
+
+struct TripConfig {
+  uint32_t wheelCircumferenceMm = TRIP_WHEEL_CIRCUMFERENCE_MM;
+  uint32_t maxHoldUs = TRIP_MAX_HOLD_MS * 1000UL;
+  uint32_t keyOffUs = TRIP_KEY_OFF_MS * 1000UL;
+};
+
+/**
+ * @brief Resumo de uma viagem (copiado entre tasks, sem ponteiros)
+ */
+struct TripSummary {
+  uint32_t number = 0;           // Viagem desde o boot (1, 2...)
+  uint32_t durationMs = 0;       // Primeiro ao último frame
+  uint32_t consumedMilliWh = 0;  // Energia tirada do pack
+  uint32_t regenMilliWh = 0;     // Energia devolvida ao pack
+  int32_t peakPowerW = 0;        // Maior potência de descarga
+  int32_t peakRegenW = 0;        // Maior potência de regeneração (positiva)
+  int32_t avgPowerW = 0;         // Energia líquida / tempo integrado
+  uint32_t distanceM = 0;
+  int32_t maxRpm = 0;
+  int32_t maxMotorTemp = 0;      // °C
+  int32_t maxControllerTemp = 0; // °C
+  int32_t maxBatteryTemp = 0;    // °C
+  int32_t minVoltageDeci = 0;    // 0,1 V
+  int32_t socStart = 0;          // %
+  int32_t socEnd = 0;            // %
+  uint32_t modeMs[TRIP_MODE_COUNT] = {0};
+  uint32_t batteryFrames = 0;
+  uint32_t motorFrames = 0;
+  uint32_t holdGapMs = 0;        // Tempo não integrado (intervalos > maxHoldUs)
+};
+
+/**
+ * @brief Modo de condução → índice de TripSummary::modeMs
+ */
+inline TripMode tripMode(uint8_t mode) {
+  switch (mode) {
+    case RIDE_MODE_ECO: return TRIP_MODE_ECO;
+    case RIDE_MODE_STD: return TRIP_MODE_STD;
+    case RIDE_MODE_TURBO: return TRIP_MODE_TURBO;
+    default: return TRIP_MODE_OTHER;
+  }
+}
+
+/**
+ * @brief Acumulador da viagem em andamento
+ * @note Uma única task (a de decodificação) chama tudo; o resumo sai por cópia
+ */
+class TripAggregator {
+public:
+  void begin(const TripConfig &config = TripConfig()) {
+    config_ = config;
+    trips_ = 0;
+    reset();
+  }
+
+  /**
+   * @brief Amostra da bateria (depois de applyFrame)
+   */
+  void addBattery(const BatteryState &battery, uint32_t nowUs) {
+    touch(nowUs);
+    int64_t power = (int64_t)battery.voltageDeci * battery.currentDeci; // cW
+    if (summary_.batteryFrames == 0) {
+      summary_.socStart = battery.soc;
+      summary_.minVoltageDeci = battery.voltageDeci;
+      summary_.maxBatteryTemp = battery.temperature;
+    } else {
+      uint32_t dt = nowUs - lastBatteryUs_;
+      if (dt <= config_.maxHoldUs) {
+        integratePower(lastPowerCw_, power, dt);
+        integratedUs_ += dt;
+      } else {
+        holdGapUs_ += dt;
+      }
+    }
+    lastBatteryUs_ = nowUs;
+    lastPowerCw_ = power;
+    summary_.batteryFrames++;
+    summary_.socEnd = battery.soc;
+
+    int32_t watts = (int32_t)(power / 100);
+    if (watts > summary_.peakPowerW) summary_.peakPowerW = watts;
+    if (-watts > summary_.peakRegenW) summary_.peakRegenW = -watts;
+    if (battery.voltageDeci < summary_.minVoltageDeci) summary_.minVoltageDeci = battery.voltageDeci;
+    if (battery.temperature > summary_.maxBatteryTemp) summary_.maxBatteryTemp = battery.temperature;
+  }
+
+  /**
+   * @brief Amostra do controlador (depois de applyFrame)
+   */
+  void addMotor(const MotorState &motor, uint32_t nowUs) {
+    touch(nowUs);
+    int32_t rpm = motor.rpm > 0 ? motor.rpm : 0;
+    if (summary_.motorFrames == 0) {
+      summary_.maxMotorTemp = motor.motorTemp;
+      summary_.maxControllerTemp = motor.controllerTemp;
+    } else {
+      uint32_t dt = nowUs - lastMotorUs_;
+      if (dt <= config_.maxHoldUs) {
+        // O intervalo pertence ao modo em que a moto estava
+        modeUs_[tripMode(lastMode_)] += dt;
+        distanceUnits_ += (uint64_t)(lastRpm_ + rpm) * dt * config_.wheelCircumferenceMm;
+        distanceMm_ += distanceUnits_ / TRIP_UNITS_PER_MM;
+        distanceUnits_ %= TRIP_UNITS_PER_MM;
+      }
+    }
+    lastMotorUs_ = nowUs;
+    lastRpm_ = rpm;
+    lastMode_ = motor.mode;
+    summary_.motorFrames++;
+
+    if (motor.rpm > summary_.maxRpm) summary_.maxRpm = motor.rpm;
+    if (motor.motorTemp > summary_.maxMotorTemp) summary_.maxMotorTemp = motor.motorTemp;
+    if (motor.controllerTemp > summary_.maxControllerTemp) {
+      summary_.maxControllerTemp = motor.controllerTemp;
+    }
+  }
+
+  /**
+   * @brief Encerra a viagem se bateria e controlador calaram por keyOffUs
+   * @details Chamar periodicamente, inclusive sem frames chegando, e antes
+   *          de add*() quando o frame chega depois de uma pausa dessas
+   * @return true se out recebeu o resumo de uma viagem encerrada
+   */
+  bool checkKeyOff(uint32_t nowUs, TripSummary &out) {
+    if (!active_ || nowUs - lastFrameUs_ <= config_.keyOffUs) return false;
+    return finish(out);
+  }
+
+  /**
+   * @brief Encerra a viagem em andamento (se houver)
+   */
+  bool finish(TripSummary &out) {
+    if (!active_) return false;
+    snapshot(out);
+    reset();
+    return true;
+  }
+
+  /**
+   * @brief Agregados da viagem em andamento, sem encerrá-la
+   */
+  void snapshot(TripSummary &out) const {
+    out = summary_;
+    out.durationMs = (uint32_t)(durationUs_ / 1000);
+    out.consumedMilliWh = consumedMilliWh_;
+    out.regenMilliWh = regenMilliWh_;
+    // Energia líquida com o resto abaixo de 1 mWh: W = (cW·µs × 2) / (200 × µs)
+    int64_t netUnits = ((int64_t)consumedMilliWh_ - regenMilliWh_) * TRIP_UNITS_PER_MWH +
+                       consumedUnits_ - regenUnits_;
+    out.avgPowerW = integratedUs_ ? (int32_t)(netUnits / (200 * (int64_t)integratedUs_)) : 0;
+    out.distanceM = (uint32_t)(distanceMm_ / 1000);
+    for (uint8_t i = 0; i < TRIP_MODE_COUNT; i++) out.modeMs[i] = (uint32_t)(modeUs_[i] / 1000);
+    out.holdGapMs = (uint32_t)(holdGapUs_ / 1000);
+  }
+
+  bool active() const { return active_; }
+  uint32_t trips() const { return trips_; }
+
+private:
+  /** @brief Início da viagem e relógio da duração (diferenças de 32 bits) */
+  void touch(uint32_t nowUs) {
+    if (!active_) {
+      active_ = true;
+      trips_++;
+      summary_.number = trips_;
+    } else {
+      durationUs_ += nowUs - lastFrameUs_;
+    }
+    lastFrameUs_ = nowUs;
+  }
+
+  /**
+   * @brief Trapézio de p0 a p1 (cW) em dt µs, separado pelo sinal
+   */
+  void integratePower(int64_t p0, int64_t p1, uint32_t dt) {
+    if (p0 >= 0 && p1 >= 0) {
+      consumedUnits_ += (p0 + p1) * dt;
+    } else if (p0 <= 0 && p1 <= 0) {
+      regenUnits_ -= (p0 + p1) * dt;
+    } else {
+      // Cruzamento do zero em t0 (linear entre as amostras)
+      int64_t t0 = p0 * dt / (p0 - p1);
+      if (p0 > 0) {
+        consumedUnits_ += p0 * t0;
+        regenUnits_ -= p1 * ((int64_t)dt - t0);
+      } else {
+        regenUnits_ -= p0 * t0;
+        consumedUnits_ += p1 * ((int64_t)dt - t0);
+      }
+    }
+    consumedMilliWh_ += (uint32_t)(consumedUnits_ / TRIP_UNITS_PER_MWH);
+    consumedUnits_ %= TRIP_UNITS_PER_MWH;
+    regenMilliWh_ += (uint32_t)(regenUnits_ / TRIP_UNITS_PER_MWH);
+    regenUnits_ %= TRIP_UNITS_PER_MWH;
+  }
+
+  void reset() {
+    summary_ = TripSummary();
+    active_ = false;
+    lastFrameUs_ = 0;
+    durationUs_ = 0;
+    lastBatteryUs_ = 0;
+    lastPowerCw_ = 0;
+    consumedUnits_ = 0;
+    regenUnits_ = 0;
+    consumedMilliWh_ = 0;
+    regenMilliWh_ = 0;
+    integratedUs_ = 0;
+    holdGapUs_ = 0;
+    lastMotorUs_ = 0;
+    lastRpm_ = 0;
+    lastMode_ = 0;
+    distanceUnits_ = 0;
+    distanceMm_ = 0;
+    for (uint8_t i = 0; i < TRIP_MODE_COUNT; i++) modeUs_[i] = 0;
+  }
+
+  TripConfig config_;
+  TripSummary summary_;
+  uint32_t trips_ = 0;
+  bool active_ = false;
+  uint32_t lastFrameUs_ = 0;
+  uint64_t durationUs_ = 0;
+
+  // Bateria
+  uint32_t lastBatteryUs_ = 0;
+  int64_t lastPowerCw_ = 0;
+  int64_t consumedUnits_ = 0; // Resto abaixo de 1 mWh (cW·µs × 2)
+  int64_t regenUnits_ = 0;
+  uint32_t consumedMilliWh_ = 0;
+  uint32_t regenMilliWh_ = 0;
+  uint64_t integratedUs_ = 0;
+  uint64_t holdGapUs_ = 0;
+
+  // Controlador
+  uint32_t lastMotorUs_ = 0;
+  int32_t lastRpm_ = 0;
+  uint8_t lastMode_ = 0;
+  uint64_t distanceUnits_ = 0; // Resto abaixo de 1 mm (RPM·mm·µs × 2)
+  uint64_t distanceMm_ = 0;
+  uint64_t modeUs_[TRIP_MODE_COUNT] = {0};
+};
+
+/**
+ * @brief Serializa o resumo no payload MQTT {"type":"trip",...}
+ * @details Tudo inteiro, nas unidades de TripSummary (mWh, W, m, ms, 0,1 V);
+ *          "mode" é o tempo em ECO, STD, TURBO e modo desconhecido
+ * @return Número de bytes escritos (sem o terminador)
+ */
+inline int tripSummaryToJson(const TripSummary &t, char *out, size_t size) {
+  return snprintf(out, size,
+      "{\"type\":\"trip\",\"n\":%lu,\"dur\":%lu,\"whc\":%lu,\"whr\":%lu,"
+      "\"pk\":%ld,\"pkr\":%ld,\"avg\":%ld,\"dist\":%lu,\"rpm\":%ld,"
+      "\"tM\":%ld,\"tC\":%ld,\"tB\":%ld,\"vmin\":%ld,\"soc0\":%ld,\"soc1\":%ld,"
+      "\"mode\":[%lu,%lu,%lu,%lu],\"fb\":%lu,\"fm\":%lu,\"gap\":%lu}",
+      (unsigned long)t.number, (unsigned long)t.durationMs,
+      (unsigned long)t.consumedMilliWh, (unsigned long)t.regenMilliWh,
+      (long)t.peakPowerW, (long)t.peakRegenW, (long)t.avgPowerW,
+      (unsigned long)t.distanceM, (long)t.maxRpm, (long)t.maxMotorTemp,
+      (long)t.maxControllerTemp, (long)t.maxBatteryTemp, (long)t.minVoltageDeci,
+      (long)t.socStart, (long)t.socEnd,
+      (unsigned long)t.modeMs[TRIP_MODE_ECO], (unsigned long)t.modeMs[TRIP_MODE_STD],
+      (unsigned long)t.modeMs[TRIP_MODE_TURBO], (unsigned long)t.modeMs[TRIP_MODE_OTHER],
+      (unsigned long)t.batteryFrames, (unsigned long)t.motorFrames,
+      (unsigned long)t.holdGapMs);
+}
+
+/**
+ * @brief Linha de SD_TRIP_FILE (viagem,fim_ms,...,outro_ms)
+ * @details Byte a byte igual ao printf de antes: tudo inteiro, menos
+ *          tensao_min em volts com uma casa
+ * @return Tamanho escrito (com '\n', sem terminador), ou 0 se não coube
+ */
+inline int tripSummaryToCsv(const TripSummary &t, uint32_t endMs, char *out, size_t size) {
+  CsvWriter csv(out, size);
+  csv.u32(t.number).u32(endMs).u32(t.durationMs)
+      .u32(t.consumedMilliWh).u32(t.regenMilliWh)
+      .i32(t.peakPowerW).i32(t.peakRegenW).i32(t.avgPowerW)
+      .u32(t.distanceM).i32(t.maxRpm).i32(t.maxMotorTemp)
+      .i32(t.maxControllerTemp).i32(t.maxBatteryTemp).deci(t.minVoltageDeci)
+      .i32(t.socStart).i32(t.socEnd)
+      .u32(t.modeMs[TRIP_MODE_ECO]).u32(t.modeMs[TRIP_MODE_STD])
+      .u32(t.modeMs[TRIP_MODE_TURBO]).u32(t.modeMs[TRIP_MODE_OTHER]);
+  return csv.finish();
+}
+
+#endif // TRIP_STATS_H
@@ -0,0 +1,334 @@
+#ifndef VEHICLE_SIM_H
+#define VEHICLE_SIM_H
+
+// ------------------------------------------------------------------
+// --- SIMULADOR FÍSICO DA MOTO (FONTE CAN PARA TESTES) ---
+// ------------------------------------------------------------------
+// Substitui os bytes aleatórios do modo TESTMODE por um percurso
+// plausível: perfil de acelerador, dinâmica longitudinal, RPM/torque do
+// motor, queda de tensão do pack com a corrente, consumo de SoC,
+// aquecimento de motor/controlador/bateria e troca de modo (ECO/STD/
+// TURBO). Os valores são codificados no layout real dos frames de
+// bateria e controlador, e o restante do barramento é preenchido com
+// os IDs observados na captura até a carga configurada (até 100%).
+//
+// O simulador trabalha em tempo virtual: nextFrame() apenas avança o
+// relógio interno, então no host roda muito mais rápido que o tempo
+// real (horas de tráfego em segundos). No ESP32 a task de origem faz o
+// ritmo comparando o tempo virtual com o monotônico.
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "vehicle_state.h"
+
+#define SIM_CAN_BITRATE 250000
+#define SIM_FRAME_BITS 125          // Frame padrão de 8 bytes + bit stuffing médio
+#define SIM_PHYSICS_STEP_US 10000   // Passo de integração (10 ms)
+
+struct SimConfig {
+  uint8_t busLoadPercent = 30;         // Carga alvo do barramento (0..100)
+  uint32_t bitrate = SIM_CAN_BITRATE;
+  uint32_t batteryPeriodUs = 100000;   // Frame da bateria a 10 Hz
+  uint32_t controllerPeriodUs = 50000; // Frame do controlador a 20 Hz
+  uint32_t seed = 0x5EED1234;
+};
+
+/**
+ * @brief Estado físico contínuo da simulação (unidades SI)
+ */
+struct SimPhysics {
+  float throttle = 0.0f;      // 0..1 (negativo = freio regenerativo)
+  float speedMps = 0.0f;      // Velocidade da moto
+  float motorRpm = 0.0f;
+  float torqueNm = 0.0f;      // Negativo durante regeneração
+  float currentA = 0.0f;      // Positivo = descarga, negativo = regeneração
+  float packVoltage = 0.0f;
+  float soc = 0.85f;          // 0..1
+  float batteryTempC = 25.0f;
+  float motorTempC = 25.0f;
+  float controllerTempC = 25.0f;
+  uint8_t mode = RIDE_MODE_STD;
+};
+
+struct SimFrame {
+  uint64_t timeUs;            // Tempo virtual desde o início da simulação
+  uint32_t id;
+  uint8_t data[8];
+  uint8_t length;
+  bool isExtended;
+};
+
+// Parâmetros do veículo (ordem de grandeza de uma scooter elétrica)
+namespace sim {
+const float MASS_KG = 170.0f;          // Moto + piloto
+const float WHEEL_RADIUS_M = 0.28f;    // Motor de cubo: RPM do motor = RPM da roda
+const float DRAG_COEFF = 0.35f;        // 0.5 * rho * Cd * A
+const float ROLLING_COEFF = 0.015f;
+const float PACK_CAPACITY_AH = 50.0f;
+const float PACK_V_EMPTY = 58.0f;      // Tensão de circuito aberto com SoC 0%
+const float PACK_V_FULL = 67.2f;       // Tensão de circuito aberto com SoC 100%
+const float PACK_RESISTANCE = 0.08f;   // Resistência interna (ohm) → queda sob carga
+const float DRIVE_EFFICIENCY = 0.85f;
+const float AMBIENT_C = 25.0f;
+const float MAX_REGEN_TORQUE = 20.0f;
+
+/**
+ * @brief Torque máximo por modo de condução
+ */
+inline float maxTorque(uint8_t mode) {
+  switch (mode) {
+    case RIDE_MODE_ECO: return 60.0f;
+    case RIDE_MODE_TURBO: return 140.0f;
+    default: return 100.0f;
+  }
+}
+
+/**
+ * @brief Potência elétrica máxima liberada pelo controlador por modo (W)
+ */
+inline float maxPower(uint8_t mode) {
+  switch (mode) {
+    case RIDE_MODE_ECO: return 3000.0f;
+    case RIDE_MODE_TURBO: return 7000.0f;
+    default: return 5000.0f;
+  }
+}
+
+// IDs de fundo observados em "_can_log (2).csv" com um payload típico
+struct BackgroundId {
+  uint32_t id;
+  bool isExtended;
+  uint8_t data[8];
+};
+
+static const BackgroundId BACKGROUND_IDS[] = {
+  {0x301, false, {0x00, 0x00, 0x00, 0x00, 0x00, 0x0E, 0x00, 0x02}},
+  {0x401, false, {0x00, 0x00, 0xCC, 0x01, 0xBB, 0x24, 0x00, 0x00}},
+  {0x110, false, {0x03, 0x3E, 0x00, 0xC8, 0x03, 0x00, 0x1D, 0x00}},
+  {0x400, false, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+  {0x130, false, {0x00, 0x00, 0x00, 0x00, 0x02, 0xEE, 0x00, 0x00}},
+  {0x6F2020, true, {0xFE, 0xFF, 0x73, 0x02, 0x2E, 0x60, 0x30, 0x00}},
+};
+const uint8_t BACKGROUND_COUNT = sizeof(BACKGROUND_IDS) / sizeof(BACKGROUND_IDS[0]);
+} // namespace sim
+
+class VehicleSim {
+public:
+  explicit VehicleSim(const SimConfig &config = SimConfig())
+      : config_(config), rng_(config.seed ? config.seed : 1) {
+    physicsUs_ = 0;
+    nextBatteryUs_ = 0;
+    nextControllerUs_ = config_.controllerPeriodUs / 2;
+    nextBackgroundUs_ = 0;
+    backgroundIndex_ = 0;
+    segmentEndUs_ = 0;
+    targetThrottle_ = 0.0f;
+    configureBackground();
+    physics_.packVoltage = openCircuitVoltage();
+  }
+
+  /**
+   * @brief Altera a carga alvo do barramento (0..100%)
+   */
+  void setBusLoad(uint8_t percent) {
+    config_.busLoadPercent = percent > 100 ? 100 : percent;
+    configureBackground();
+  }
+
+  /**
+   * @brief Gera o próximo frame em ordem de tempo virtual
+   * @details Integra a física até o instante do frame e codifica os
+   *          valores atuais no layout real do barramento.
+   */
+  void nextFrame(SimFrame &out) {
+    uint64_t t = nextBatteryUs_;
+    uint8_t source = 0;
+    if (nextControllerUs_ < t) { t = nextControllerUs_; source = 1; }
+    if (backgroundPeriodUs_ && nextBackgroundUs_ < t) { t = nextBackgroundUs_; source = 2; }
+
+    advanceTo(t);
+    out.timeUs = t;
+    out.length = 8;
+    out.isExtended = false;
+
+    if (source == 0) {
+      encodeBattery(out);
+      nextBatteryUs_ += config_.batteryPeriodUs;
+    } else if (source == 1) {
+      encodeController(out);
+      nextControllerUs_ += config_.controllerPeriodUs;
+    } else {
+      const sim::BackgroundId &bg = sim::BACKGROUND_IDS[backgroundIndex_];
+      out.id = bg.id;
+      out.isExtended = bg.isExtended;
+      memcpy(out.data, bg.data, 8);
+      out.data[7] = (uint8_t)(t / 1000); // Contador para variar o payload
+      backgroundIndex_ = (backgroundIndex_ + 1) % sim::BACKGROUND_COUNT;
+      nextBackgroundUs_ += backgroundPeriodUs_;
+    }
+  }
+
+  const SimPhysics &physics() const { return physics_; }
+  uint64_t nowUs() const { return physicsUs_; }
+
+private:
+  /**
+   * @brief Período do tráfego de fundo para atingir a carga alvo
+   */
+  void configureBackground() {
+    float framesPerSecond =
+        (float)config_.bitrate * config_.busLoadPercent / 100.0f / SIM_FRAME_BITS;
+    float ownFramesPerSecond = 1e6f / config_.batteryPeriodUs +
+                               1e6f / config_.controllerPeriodUs;
+    float backgroundFps = framesPerSecond - ownFramesPerSecond;
+    backgroundPeriodUs_ = backgroundFps > 0.5f ? (uint32_t)(1e6f / backgroundFps) : 0;
+    nextBackgroundUs_ = physicsUs_;
+  }
+
+  // xorshift32: determinístico e barato (mesma sequência no host e no ESP32)
+  float random01() {
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 17;
+    rng_ ^= rng_ << 5;
+    return (rng_ >> 8) * (1.0f / 16777216.0f);
+  }
+
+  /**
+   * @brief Sorteia o próximo trecho do percurso (aceleração, cruzeiro, frenagem, parada)
+   */
+  void nextSegment() {
+    float r = random01();
+    uint32_t durationMs;
+    if (physics_.speedMps < 1.0f || r < 0.35f) {
+      targetThrottle_ = 0.5f + 0.5f * random01();     // Aceleração
+      durationMs = 3000 + (uint32_t)(random01() * 7000);
+    } else if (r < 0.7f) {
+      targetThrottle_ = 0.08f + 0.17f * random01();   // Cruzeiro
+      durationMs = 5000 + (uint32_t)(random01() * 20000);
+    } else if (r < 0.9f) {
+      targetThrottle_ = -0.3f - 0.7f * random01();    // Frenagem regenerativa
+      durationMs = 2000 + (uint32_t)(random01() * 4000);
+    } else {
+      targetThrottle_ = 0.0f;                         // Rolagem / parada
+      durationMs = 2000 + (uint32_t)(random01() * 8000);
+    }
+
+    // Troca ocasional de modo de condução
+    if (random01() < 0.1f) {
+      static const uint8_t MODES[] = {RIDE_MODE_ECO, RIDE_MODE_STD, RIDE_MODE_TURBO};
+      physics_.mode = MODES[(uint8_t)(random01() * 3) % 3];
+    }
+    segmentEndUs_ = physicsUs_ + (uint64_t)durationMs * 1000ULL;
+  }
+
+  float openCircuitVoltage() const {
+    return sim::PACK_V_EMPTY + (sim::PACK_V_FULL - sim::PACK_V_EMPTY) * physics_.soc;
+  }
+
+  void advanceTo(uint64_t t) {
+    while (physicsUs_ + SIM_PHYSICS_STEP_US <= t) {
+      if (physicsUs_ >= segmentEndUs_) nextSegment();
+      step(SIM_PHYSICS_STEP_US * 1e-6f);
+      physicsUs_ += SIM_PHYSICS_STEP_US;
+    }
+  }
+
+  void step(float dt) {
+    SimPhysics &p = physics_;
+
+    // Acelerador segue o alvo com resposta de primeira ordem (~0,5 s)
+    p.throttle += (targetThrottle_ - p.throttle) * (dt / 0.5f);
+
+    // Torque: tração limitada pelo modo (torque e potência); regeneração só em movimento
+    float omega = p.speedMps / sim::WHEEL_RADIUS_M;   // rad/s
+    if (p.throttle >= 0.0f) {
+      p.torqueNm = p.throttle * sim::maxTorque(p.mode);
+      float maxMech = sim::maxPower(p.mode) * sim::DRIVE_EFFICIENCY;
+      if (omega > 0.1f && p.torqueNm * omega > maxMech) p.torqueNm = maxMech / omega;
+    } else {
+      p.torqueNm = p.speedMps > 0.5f ? p.throttle * sim::MAX_REGEN_TORQUE : 0.0f;
+    }
+
+    // Dinâmica longitudinal: força no pneu - arrasto - rolagem
+    float wheelForce = p.torqueNm / sim::WHEEL_RADIUS_M;
+    float drag = sim::DRAG_COEFF * p.speedMps * p.speedMps;
+    float rolling = p.speedMps > 0.05f ? sim::ROLLING_COEFF * sim::MASS_KG * 9.81f : 0.0f;
+    p.speedMps += (wheelForce - drag - rolling) / sim::MASS_KG * dt;
+    if (p.speedMps < 0.0f) p.speedMps = 0.0f;
+
+    omega = p.speedMps / sim::WHEEL_RADIUS_M;
+    p.motorRpm = omega * 60.0f / (2.0f * (float)M_PI);
+
+    // Potência elétrica e corrente do pack (com queda pela resistência interna)
+    float mechPower = p.torqueNm * omega;
+    float elecPower = mechPower >= 0.0f ? mechPower / sim::DRIVE_EFFICIENCY
+                                        : mechPower * sim::DRIVE_EFFICIENCY;
+    elecPower += 30.0f; // Consumo auxiliar (painel, controlador, luzes)
+    float ocv = openCircuitVoltage();
+    p.currentA = elecPower / (ocv > 1.0f ? ocv : 1.0f);
+    p.packVoltage = ocv - p.currentA * sim::PACK_RESISTANCE;
+
+    // Contagem de Coulomb
+    p.soc -= p.currentA * dt / (sim::PACK_CAPACITY_AH * 3600.0f);
+    if (p.soc < 0.0f) p.soc = 0.0f;
+    if (p.soc > 1.0f) p.soc = 1.0f;
+
+    // Térmica de primeira ordem: aquecimento I²R x dissipação para o ambiente
+    float i2 = p.currentA * p.currentA;
+    p.motorTempC += (i2 * 0.004f - (p.motorTempC - sim::AMBIENT_C) * 0.8f) / 400.0f * dt;
+    p.controllerTempC += (i2 * 0.002f - (p.controllerTempC - sim::AMBIENT_C) * 0.6f) / 250.0f * dt;
+    p.batteryTempC += (i2 * sim::PACK_RESISTANCE - (p.batteryTempC - sim::AMBIENT_C) * 10.0f) / 20000.0f * dt;
+  }
+
+  /**
+   * @brief Layout do frame da bateria (mesmo decodificado por applyFrame)
+   */
+  void encodeBattery(SimFrame &out) const {
+    const SimPhysics &p = physics_;
+    uint16_t voltage = (uint16_t)lroundf(p.packVoltage * 10.0f);
+    int16_t current = (int16_t)lroundf(p.currentA * 10.0f);
+    out.id = BASE_BATTERY_ID;
+    out.data[0] = voltage >> 8;
+    out.data[1] = voltage & 0xFF;
+    out.data[2] = (uint16_t)current >> 8;
+    out.data[3] = (uint16_t)current & 0xFF;
+    out.data[4] = (uint8_t)lroundf(p.batteryTempC);
+    out.data[5] = 0;
+    out.data[6] = (uint8_t)lroundf(p.soc * 100.0f);
+    out.data[7] = 100; // SoH
+  }
+
+  /**
+   * @brief Layout do frame do controlador (config/voltz.dbc)
+   */
+  void encodeController(SimFrame &out) const {
+    const SimPhysics &p = physics_;
+    uint16_t rpm = (uint16_t)lroundf(p.motorRpm);
+    float torque = p.torqueNm > 0.0f ? p.torqueNm : 0.0f;
+    uint16_t torqueDeci = (uint16_t)lroundf(torque * 10.0f);
+    out.id = BASE_CONTROLLER_ID;
+    out.data[0] = rpm >> 8;
+    out.data[1] = rpm & 0xFF;
+    out.data[2] = torqueDeci >> 8;
+    out.data[3] = torqueDeci & 0xFF;
+    out.data[4] = 0;
+    out.data[5] = p.mode;
+    out.data[6] = (uint8_t)lroundf(p.controllerTempC + 40.0f);
+    out.data[7] = (uint8_t)lroundf(p.motorTempC / 2.0f); // Passo de 2 °C (config/voltz.dbc)
+  }
+
+  SimConfig config_;
+  SimPhysics physics_;
+  uint32_t rng_;
+  uint64_t physicsUs_;
+  uint64_t nextBatteryUs_;
+  uint64_t nextControllerUs_;
+  uint64_t nextBackgroundUs_;
+  uint32_t backgroundPeriodUs_;
+  uint8_t backgroundIndex_;
+  uint64_t segmentEndUs_;
+  float targetThrottle_;
+};
+
+#endif // VEHICLE_SIM_H
@@ -0,0 +1,133 @@
+#ifndef VEHICLE_STATE_H
+#define VEHICLE_STATE_H
+
+// ------------------------------------------------------------------
+// --- ÚLTIMOS VALORES DECODIFICADOS (BATERIA / CONTROLADOR) ---
+// ------------------------------------------------------------------
+// Mantém o valor mais recente de cada sinal em ponto fixo (décimos),
+// sem String nem alocação. Usado pelo painel ao vivo e pelos publishers.
+// O layout dos sinais vem de config/voltz.dbc (voltz_signals.h, gerado); os
+// IDs continuam em constants.h, que muda de uma moto para outra.
+
+#include <stdint.h>
+#include <stdio.h>
+#include "../../config/constants.h"
+#include "csv_writer.h"
+#include "json_writer.h"
+#include "voltz_signals.h"
+
+// Bytes do modo de condução (byte 5 do frame do controlador, VAL_ do DBC)
+#define RIDE_MODE_ECO 0x45
+#define RIDE_MODE_STD 0x4D
+#define RIDE_MODE_TURBO 0x55
+
+struct BatteryState {
+  int32_t voltageDeci = 0;   // Tensão (0,1 V)
+  int32_t currentDeci = 0;   // Corrente (0,1 A, negativo = carga/regeneração)
+  int32_t soc = 0;           // State of Charge (%)
+  int32_t soh = 0;           // State of Health (%)
+  int32_t temperature = 0;   // °C
+  bool valid = false;
+};
+
+struct MotorState {
+  int32_t rpm = 0;
+  int32_t torqueDeci = 0;    // Torque (0,1 Nm)
+  int32_t motorTemp = 0;     // °C
+  int32_t controllerTemp = 0;// °C
+  uint8_t mode = 0;          // RIDE_MODE_*
+  bool valid = false;
+};
+
+struct VehicleState {
+  BatteryState battery;
+  MotorState motor;
+  uint32_t lastUpdateMs = 0; // millis() do último frame aplicado
+  uint32_t frameCount = 0;   // Frames de bateria/controlador aplicados
+};
+
+/**
+ * @brief Nome do modo de condução (mesmos rótulos do backend)
+ */
+inline const char *rideModeName(uint8_t mode) {
+  const char *name = voltz_dbc::Controller::modeName(mode);
+  return name ? name : "DESCONHECIDO";
+}
+
+/**
+ * @brief Decodifica o frame e atualiza o estado, se o ID for conhecido
+ * @return true se o frame pertence à bateria ou ao controlador
+ */
+inline bool applyFrame(VehicleState &state, uint32_t id, const uint8_t *data,
+                       uint8_t length, uint32_t nowMs) {
+  namespace battery = voltz_dbc::Battery;
+  namespace controller = voltz_dbc::Controller;
+
+  if (id == BASE_BATTERY_ID) {
+    if (length < battery::DLC) return false;
+    BatteryState &b = state.battery;
+    b.voltageDeci = dbcValue<battery::voltage, 10>(data);
+    b.currentDeci = dbcValue<battery::current, 10>(data);
+    b.temperature = dbcValue<battery::temperature>(data);
+    b.soc = dbcValue<battery::soc>(data);
+    b.soh = dbcValue<battery::soh>(data);
+    b.valid = true;
+  } else if (id == BASE_CONTROLLER_ID) {
+    if (length < controller::DLC) return false;
+    MotorState &m = state.motor;
+    m.rpm = dbcValue<controller::rpm>(data);
+    m.torqueDeci = dbcValue<controller::torque, 10>(data);
+    m.mode = (uint8_t)dbcValue<controller::mode>(data);
+    m.controllerTemp = dbcValue<controller::controlTemp>(data);
+    m.motorTemp = dbcValue<controller::motorTemp>(data);
+    m.valid = true;
+  } else {
+    return false;
+  }
+
+  state.lastUpdateMs = nowMs;
+  state.frameCount++;
+  return true;
+}
+
+/**
+ * @brief Serializa o estado no formato compacto da telemetria
+ * @details Mesmos nomes de campo do payload MQTT (v, a, soc, rpm, tq, mod,
+ *          tB, tM, tC). "age" é o tempo (ms) desde o último frame.
+ * @return Número de bytes escritos (sem o terminador), ou size se não coube
+ */
+inline int vehicleStateToJson(const VehicleState &s, uint32_t nowMs, char *out,
+                              size_t size) {
+  JsonWriter json(out, size);
+  json.raw("{\"v\":").deci(s.battery.voltageDeci)
+      .raw(",\"a\":").deci(s.battery.currentDeci)
+      .raw(",\"soc\":").i32(s.battery.soc)
+      .raw(",\"soh\":").i32(s.battery.soh)
+      .raw(",\"tB\":").i32(s.battery.temperature)
+      .raw(",\"rpm\":").i32(s.motor.rpm)
+      .raw(",\"tq\":").deci(s.motor.torqueDeci)
+      .raw(",\"tM\":").i32(s.motor.motorTemp)
+      .raw(",\"tC\":").i32(s.motor.controllerTemp)
+      .raw(",\"mod\":").str(rideModeName(s.motor.mode))
+      .raw(",\"age\":").u32(nowMs - s.lastUpdateMs)
+      .raw(",\"n\":").u32(s.frameCount)
+      .raw("}");
+  return json.finish();
+}
+
+/**
+ * @brief Linha do CSV decodificado do cartão (colunas do SDRecorder)
+ * @details timestamp,modo,rpm,torque,tensao,corrente,soc,tBat,tMotor,tCtrl,
+ *          byte a byte igual a "%lu,%s,%d,%.1f,%.1f,%.1f,%d,%d,%d,%d\n"
+ * @return Tamanho escrito (com '\n', sem terminador), ou 0 se não coube
+ */
+inline int vehicleStateToCsv(const VehicleState &s, uint32_t ms, char *out, size_t size) {
+  CsvWriter csv(out, size);
+  csv.u32(ms).str(rideModeName(s.motor.mode)).i32(s.motor.rpm)
+      .deci(s.motor.torqueDeci).deci(s.battery.voltageDeci).deci(s.battery.currentDeci)
+      .i32(s.battery.soc).i32(s.battery.temperature)
+      .i32(s.motor.motorTemp).i32(s.motor.controllerTemp);
+  return csv.finish();
+}
+
+#endif // VEHICLE_STATE_H
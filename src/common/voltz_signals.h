@@ -0,0 +1,167 @@
+#ifndef VOLTZ_SIGNALS_H
+#define VOLTZ_SIGNALS_H
+
+// ------------------------------------------------------------------
+// --- SINAIS DO BARRAMENTO VOLTZ (config/voltz.dbc) ---
+// ------------------------------------------------------------------
+// Gerado por tools/dbc_codegen.js a partir de config/voltz.dbc: não editar.
+// Altere o DBC e rode `node tools/dbc_codegen.js`.
+//
+// Uso: dbcValue<voltz_dbc::Battery::voltage, 10>(data) devolve a tensão em
+// décimos de V; as tabelas SIGNALS/MESSAGES servem a quem percorre os
+// sinais em tempo de execução (dbcFixed).
+
+#include <stdint.h>
+#include "can_signal.h"
+
+namespace voltz_dbc {
+
+// --- Battery: 0x120, 8 bytes (BMS) ---
+namespace Battery {
+static const uint32_t ID = 0x120;
+static const bool EXTENDED = false;
+static const uint8_t DLC = 8;
+
+struct voltage { // BE uint16 bit 7 × 0.1 V
+  static const uint8_t START_BIT = 7;
+  static const uint8_t LENGTH = 16;
+  static const bool MOTOROLA = true;
+  static const bool IS_SIGNED = false;
+  static const int32_t FACTOR_NUM = 1;
+  static const int32_t OFFSET_NUM = 0;
+  static const int32_t DEN = 10;
+};
+struct current { // BE int16 bit 23 × 0.1 A
+  static const uint8_t START_BIT = 23;
+  static const uint8_t LENGTH = 16;
+  static const bool MOTOROLA = true;
+  static const bool IS_SIGNED = true;
+  static const int32_t FACTOR_NUM = 1;
+  static const int32_t OFFSET_NUM = 0;
+  static const int32_t DEN = 10;
+};
+struct temperature { // BE uint8 bit 39 C
+  static const uint8_t START_BIT = 39;
+  static const uint8_t LENGTH = 8;
+  static const bool MOTOROLA = true;
+  static const bool IS_SIGNED = false;
+  static const int32_t FACTOR_NUM = 1;
+  static const int32_t OFFSET_NUM = 0;
+  static const int32_t DEN = 1;
+};
+struct soc { // BE uint8 bit 55 %
+  static const uint8_t START_BIT = 55;
+  static const uint8_t LENGTH = 8;
+  static const bool MOTOROLA = true;
+  static const bool IS_SIGNED = false;
+  static const int32_t FACTOR_NUM = 1;
+  static const int32_t OFFSET_NUM = 0;
+  static const int32_t DEN = 1;
+};
+struct soh { // BE uint8 bit 63 %
+  static const uint8_t START_BIT = 63;
+  static const uint8_t LENGTH = 8;
+  static const bool MOTOROLA = true;
+  static const bool IS_SIGNED = false;
+  static const int32_t FACTOR_NUM = 1;
+  static const int32_t OFFSET_NUM = 0;
+  static const int32_t DEN = 1;
+};
+
+static const DbcSignalSpec SIGNALS[] = {
+  {"voltage", 7, 16, true, false, 1, 0, 10, "V"},
+  {"current", 23, 16, true, true, 1, 0, 10, "A"},
+  {"temperature", 39, 8, true, false, 1, 0, 1, "C"},
+  {"soc", 55, 8, true, false, 1, 0, 1, "%"},
+  {"soh", 63, 8, true, false, 1, 0, 1, "%"},
+};
+} // namespace Battery
+
+// --- Controller: 0x300, 8 bytes (MCU) ---
+namespace Controller {
+static const uint32_t ID = 0x300;
+static const bool EXTENDED = false;
+static const uint8_t DLC = 8;
+
+struct rpm { // BE uint16 bit 7 rpm
+  static const uint8_t START_BIT = 7;
+  static const uint8_t LENGTH = 16;
+  static const bool MOTOROLA = true;
+  static const bool IS_SIGNED = false;
+  static const int32_t FACTOR_NUM = 1;
+  static const int32_t OFFSET_NUM = 0;
+  static const int32_t DEN = 1;
+};
+struct torque { // BE uint16 bit 23 × 0.1 Nm
+  static const uint8_t START_BIT = 23;
+  static const uint8_t LENGTH = 16;
+  static const bool MOTOROLA = true;
+  static const bool IS_SIGNED = false;
+  static const int32_t FACTOR_NUM = 1;
+  static const int32_t OFFSET_NUM = 0;
+  static const int32_t DEN = 10;
+};
+struct mode { // BE uint8 bit 47
+  static const uint8_t START_BIT = 47;
+  static const uint8_t LENGTH = 8;
+  static const bool MOTOROLA = true;
+  static const bool IS_SIGNED = false;
+  static const int32_t FACTOR_NUM = 1;
+  static const int32_t OFFSET_NUM = 0;
+  static const int32_t DEN = 1;
+};
+struct controlTemp { // BE uint8 bit 55 − 40 C
+  static const uint8_t START_BIT = 55;
+  static const uint8_t LENGTH = 8;
+  static const bool MOTOROLA = true;
+  static const bool IS_SIGNED = false;
+  static const int32_t FACTOR_NUM = 1;
+  static const int32_t OFFSET_NUM = -40;
+  static const int32_t DEN = 1;
+};
+struct motorTemp { // BE uint8 bit 63 × 2 C
+  static const uint8_t START_BIT = 63;
+  static const uint8_t LENGTH = 8;
+  static const bool MOTOROLA = true;
+  static const bool IS_SIGNED = false;
+  static const int32_t FACTOR_NUM = 2;
+  static const int32_t OFFSET_NUM = 0;
+  static const int32_t DEN = 1;
+};
+
+static const DbcSignalSpec SIGNALS[] = {
+  {"rpm", 7, 16, true, false, 1, 0, 1, "rpm"},
+  {"torque", 23, 16, true, false, 1, 0, 10, "Nm"},
+  {"mode", 47, 8, true, false, 1, 0, 1, ""},
+  {"controlTemp", 55, 8, true, false, 1, -40, 1, "C"},
+  {"motorTemp", 63, 8, true, false, 2, 0, 1, "C"},
+};
+
+/** @brief Rótulo do valor de mode (VAL_), ou nullptr */
+inline const char *modeName(int32_t value) {
+  switch (value) {
+    case 69: return "ECO";
+    case 77: return "STD";
+    case 85: return "TURBO";
+    default: return nullptr;
+  }
+}
+} // namespace Controller
+
+static const DbcMessageSpec MESSAGES[] = {
+  {Battery::ID, Battery::EXTENDED, "Battery", Battery::DLC, Battery::SIGNALS, 5},
+  {Controller::ID, Controller::EXTENDED, "Controller", Controller::DLC, Controller::SIGNALS, 5},
+};
+static const uint8_t MESSAGE_COUNT = 2;
+
+/** @brief Mensagem do DBC com este ID, ou nullptr */
+inline const DbcMessageSpec *findMessage(uint32_t id, bool extended) {
+  for (uint8_t i = 0; i < MESSAGE_COUNT; i++) {
+    if (MESSAGES[i].id == id && MESSAGES[i].extended == extended) return &MESSAGES[i];
+  }
+  return nullptr;
+}
+
+} // namespace voltz_dbc
+
+#endif // VOLTZ_SIGNALS_H
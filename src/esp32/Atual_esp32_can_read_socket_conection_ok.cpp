@@ -1,3 +1,8 @@
+// ------------------------------------------------------------------
+// LEGADO, CONGELADO: substituído por src/sketch_def (VOLTZ_PROFILE_WEBSOCKET).
+// Não estender; mudanças vão no sketch_def. Fica só como referência.
+// ------------------------------------------------------------------
+
 // Necessário baixar
 #include <ArduinoJson.h>
 #include <ESP32-TWAI-CAN.hpp>
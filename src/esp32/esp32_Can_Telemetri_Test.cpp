@@ -1,3 +1,9 @@
+// ------------------------------------------------------------------
+// LEGADO, CONGELADO: sem perfil equivalente em src/sketch_def (saída HTTP).
+// Não estender: a saída nova entra no sketch_def como sink (sink_*.h +
+// profiles.h), reaproveitando src/common. Fica só como referência.
+// ------------------------------------------------------------------
+
 #include <HTTPClient.h>
 #include <WiFi.h>
 #include <Arduino.h>
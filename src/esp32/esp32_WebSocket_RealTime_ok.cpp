@@ -1,3 +1,8 @@
+// ------------------------------------------------------------------
+// LEGADO, CONGELADO: substituído por src/sketch_def (VOLTZ_PROFILE_WEBSOCKET).
+// Não estender; mudanças vão no sketch_def. Fica só como referência.
+// ------------------------------------------------------------------
+
 // Necessário baixar
 #include <ArduinoJson.h>        // ArduinJson by Benoit Blanchon
 #include <ESP32-TWAI-CAN.hpp>   // ESP32-TWAI-CAN by sorek.uk
@@ -10,6 +15,10 @@
 #include <string.h>
 #include <stdarg.h> // para logMessage
 #include "../config/constants.h"
+#include "../common/boot_timeline.h"
+#include "../common/can_batch_codec.h"
+#include "../common/vehicle_sim.h"
+#include "../common/voltz_signals.h"
 
 // ------------------------------------------------------------------
 // --- CONFIGURAÇÃO DE PINOS E VELOCIDADE ---
@@ -20,6 +29,10 @@ const TwaiSpeed CAN_SPEED = TWAI_SPEED_250KBPS;
 // Flags
 #define TESTMODE false
 #define DEBUGMODE false
+#define SIM_BUS_LOAD_PERCENT 5 // Carga do barramento simulado (0..100%)
+// Uplink: true = lote binário (sendBIN) por ciclo, false = um JSON por frame
+#define WS_BINARY_BATCH true
+#define WS_BATCH_MAX_FRAMES 100 // Frames por mensagem binária (1305 bytes)
 // Estrutura para armazenar frames CAN genéricos
 struct CanMessage {
   uint32_t id;
@@ -67,6 +80,9 @@ const uint16_t serverPort = 3001;
 
 WebSocketsClient webSocket;
 
+// Tempo do boot até a captura, o primeiro frame, a rede e o primeiro envio
+BootTimeline bootTimeline;
+
 // ------------------------------------------------------------------
 // --- FUNÇÃO DE LOG THREAD-SAFE ---
 // ------------------------------------------------------------------
@@ -108,6 +124,21 @@ void enviarFrameViaWebSocket(const CanMessage &frame) {
   }
 }
 
+// Buffer do lote binário (reaproveitado a cada envio, sem alocação)
+uint8_t wsBatchBuffer[CAN_BATCH_BUFFER_SIZE(WS_BATCH_MAX_FRAMES)];
+CanBatchWriter wsBatch(wsBatchBuffer, sizeof(wsBatchBuffer));
+
+/**
+ * @brief Envia o lote binário acumulado (se houver) e reinicia o buffer
+ */
+void enviarLoteViaWebSocket() {
+  if (wsBatch.empty()) return;
+  if (webSocket.isConnected()) {
+    webSocket.sendBIN(wsBatch.data(), wsBatch.length());
+  }
+  wsBatch.reset();
+}
+
 void webSocketEvent(WStype_t type, uint8_t *payload, size_t length) {
   switch (type) {
     case WStype_DISCONNECTED:
@@ -148,23 +179,30 @@ void serialLoggerTask(void *pvParameters) {
 
 
 void canSimTask(void *pvParameters) {
-  const unsigned long SIM_INTERVAL_MS = 15; // ~66 frames/segundo
+  // Percurso simulado com física da moto (tensão, SoC, RPM coerentes)
+  VehicleSim sim;
+  sim.setBusLoad(SIM_BUS_LOAD_PERCENT);
+  const TickType_t start = xTaskGetTickCount();
   while (true) {
-    // Gera frame simulado
+    SimFrame simFrame;
+    sim.nextFrame(simFrame);
+
+    // Aguarda até o instante virtual do frame
+    TickType_t due = start + (TickType_t)(simFrame.timeUs / 1000 / portTICK_PERIOD_MS);
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(due - now) > 0) vTaskDelay(due - now);
+
     CanMessage frame;
-    frame.id = (random(1, 100) < 70)
-        ? (random(0, 2) == 0 ? BASE_BATTERY_ID : BASE_CONTROLLER_ID)
-        : random(0x000, 0x7FF + 1);
-    frame.length = 8;
-    frame.isExtended = false;
-    for (int i = 0; i < 8; i++) {
-      frame.data[i] = random(0, 256);
-    }
+    frame.id = simFrame.id;
+    frame.length = simFrame.length;
+    frame.isExtended = simFrame.isExtended;
+    memcpy(frame.data, simFrame.data, sizeof(frame.data));
+
     // Envia diretamente para a fila CAN
+    bootTimeline.mark(BOOT_FIRST_FRAME);
     if (xQueueSend(canFrameQueue, &frame, 10 / portTICK_PERIOD_MS) != pdTRUE) {
       logMessage("Fila CAN cheia (simulação)");
     }
-    vTaskDelay(SIM_INTERVAL_MS / portTICK_PERIOD_MS);
   }
 }
 
@@ -196,6 +234,7 @@ void canTask(void* pv) {
   twai_message_t rx;
   while (1) {
     if (ESP32Can.readFrame(&rx)) {
+      bootTimeline.mark(BOOT_FIRST_FRAME);
       CanMessage frame;
       frame.id = rx.identifier;
       frame.length = rx.data_length_code;
@@ -204,13 +243,13 @@ void canTask(void* pv) {
       memcpy(frame.data, rx.data, rx.data_length_code);
 
       if (frame.id == BASE_BATTERY_ID) {
-        // Decodifica os dados recebidos em uma variável temporária
+        // Decodifica os dados recebidos em uma variável temporária (layout de config/voltz.dbc)
         BatteryData tempBattery;
-        tempBattery.current = (int)((frame.data[2] * 256 + frame.data[3]) * 0.1);
-        tempBattery.voltage = (int)((frame.data[0] * 256 + frame.data[1]) * 0.1);
-        tempBattery.soc = (int)frame.data[6];
-        tempBattery.soh = (int)frame.data[7];
-        tempBattery.temperature = (int)frame.data[4];
+        tempBattery.current = dbcValue<voltz_dbc::Battery::current, 10>(frame.data) / 10;
+        tempBattery.voltage = dbcValue<voltz_dbc::Battery::voltage, 10>(frame.data) / 10;
+        tempBattery.soc = dbcValue<voltz_dbc::Battery::soc>(frame.data);
+        tempBattery.soh = dbcValue<voltz_dbc::Battery::soh>(frame.data);
+        tempBattery.temperature = dbcValue<voltz_dbc::Battery::temperature>(frame.data);
         tempBattery.valid = true;
 
         bool dadosAtualizados = false;                   // Flag para saber se houve alguma mudança
@@ -249,10 +288,10 @@ void canTask(void* pv) {
       } else if (frame.id == BASE_CONTROLLER_ID) {
         // Decodifica os dados recebidos em uma variável temporária
         MotorControllerData tempMotorController;
-        tempMotorController.motorSpeedRpm = (int)(frame.data[0] * 256 + frame.data[1]);
-        tempMotorController.motorTorque = (float)((frame.data[2] * 256 + frame.data[3]) * 0.1);
-        tempMotorController.motorTemperature = (int)(frame.data[7] - 40);
-        tempMotorController.controllerTemperature = (int)(frame.data[6] - 40);
+        tempMotorController.motorSpeedRpm = dbcValue<voltz_dbc::Controller::rpm>(frame.data);
+        tempMotorController.motorTorque = dbcValue<voltz_dbc::Controller::torque, 10>(frame.data) / 10.0f;
+        tempMotorController.motorTemperature = dbcValue<voltz_dbc::Controller::motorTemp>(frame.data);
+        tempMotorController.controllerTemperature = dbcValue<voltz_dbc::Controller::controlTemp>(frame.data);
         tempMotorController.valid = true;
 
         bool dadosAtualizados = false;                             // Flag para saber se houve alguma mudança
@@ -294,15 +333,58 @@ void canTask(void* pv) {
   }
 }
 
+/**
+ * @brief Rede e envio: a captura já roda desde o boot
+ * @details Sem WiFi o WebSocket nem tenta conectar; sem WebSocket a fila
+ *          não é drenada e guarda os primeiros BUFFER_LENGTH frames até a
+ *          conexão (depois disso a captura descarta os novos)
+ */
 void webSocketTask(void *pvParameters) {
+  bool wifiWasConnected = false;
+  uint32_t bootReported = 0;
   while (true) {
+    bool wifiConnected = WiFi.status() == WL_CONNECTED;
+    if (wifiConnected != wifiWasConnected) {
+      wifiWasConnected = wifiConnected;
+      if (wifiConnected) {
+        bootTimeline.mark(BOOT_LINK_UP);
+        logMessage("WiFi connected! IP: %s", WiFi.localIP().toString().c_str());
+      } else {
+        logMessage("WiFi desconectado");
+      }
+    }
+    if (bootTimeline.count() != bootReported) {
+      bootReported = bootTimeline.count();
+      char timeline[96];
+      bootTimeline.format(timeline, sizeof(timeline));
+      logMessage("[BOOT] %s", timeline);
+    }
+    if (!wifiConnected) {
+      vTaskDelay(50 / portTICK_PERIOD_MS);
+      continue;
+    }
+
     webSocket.loop();
+    if (!webSocket.isConnected()) {
+      vTaskDelay(50 / portTICK_PERIOD_MS);
+      continue;
+    }
 
     // Processa todos os frames na fila
     CanMessage frame;
     while (xQueueReceive(canFrameQueue, &frame, 0) == pdTRUE) {
-      enviarFrameViaWebSocket(frame);
+      bootTimeline.mark(BOOT_FIRST_UPLINK);
+      if (WS_BINARY_BATCH) {
+        // Agrupa os frames drenados em uma única mensagem binária
+        if (!wsBatch.add(frame.id, frame.isExtended, frame.data, frame.length)) {
+          enviarLoteViaWebSocket();
+          wsBatch.add(frame.id, frame.isExtended, frame.data, frame.length);
+        }
+      } else {
+        enviarFrameViaWebSocket(frame);
+      }
     }
+    enviarLoteViaWebSocket();
 
     vTaskDelay(50 / portTICK_PERIOD_MS); 
   }
@@ -342,19 +424,7 @@ void setup() {
     while (1) delay(100);
   }
 
-  WiFi.begin(ssid, password);
-  while (WiFi.status() != WL_CONNECTED) {
-    delay(1000);
-    Serial.println("Connecting to WiFi...");
-  }
-  logMessage("WiFi connected!");
-  logMessage("IP: %s", WiFi.localIP().toString().c_str());
-
-    // Configuração WebSocket
-  webSocket.begin(serverAddress, serverPort, "/");
-  webSocket.onEvent(webSocketEvent);
-  
-  // Cria tasks com base no modo
+  // Captura antes da rede: o começo da corrida não espera o WiFi
   if (TESTMODE) {
     logMessage("[INFO] Modo de simulação ativo");
     xTaskCreate(canSimTask, "CAN Sim Task", 4096, NULL, 2, NULL);
@@ -362,6 +432,17 @@ void setup() {
     logMessage("[INFO] Modo CAN real ativo");
     xTaskCreate(canTask, "CAN Task", 4096, NULL, 2, NULL);
   }
+  bootTimeline.mark(BOOT_CAPTURE_STARTED);
+
+  // WiFi em segundo plano (a reconexão automática do core cuida das
+  // novas tentativas); a webSocketTask só usa a rede quando ela subir
+  WiFi.begin(ssid, password);
+  logMessage("Conectando ao WiFi em segundo plano...");
+
+  // Configuração WebSocket
+  webSocket.begin(serverAddress, serverPort, "/");
+  webSocket.onEvent(webSocketEvent);
+  
   if( DEBUGMODE ){
     xTaskCreate(debugTask, "Debug Task", 2048, NULL, 0, NULL); 
   }
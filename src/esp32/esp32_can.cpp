@@ -1,3 +1,10 @@
+// ------------------------------------------------------------------
+// LEGADO, CONGELADO: substituído por src/sketch_def (sink serial, qualquer perfil com DEBUGMODE).
+// Não estender; mudanças vão no sketch_def. Fica só como referência.
+// As tabelas de bits de falha (ControllerErrorInfo, BMSErrorInfo) ainda
+// são a referência das lanes de falha (src/common/priority_lanes.h).
+// ------------------------------------------------------------------
+
 #include <Arduino.h>
 #include <driver/twai.h>
 #include "../../config/constants.h"
@@ -1,3 +1,9 @@
+// ------------------------------------------------------------------
+// LEGADO, CONGELADO: sem perfil equivalente em src/sketch_def (saída em página web).
+// Não estender: a saída nova entra no sketch_def como sink (sink_*.h +
+// profiles.h), reaproveitando src/common. Fica só como referência.
+// ------------------------------------------------------------------
+
 #include <ESP32-TWAI-CAN.hpp>
 #include <WiFi.h>
 #include <WebServer.h>
@@ -1,9 +1,19 @@
+// ------------------------------------------------------------------
+// LEGADO, CONGELADO: sem perfil equivalente em src/sketch_def (saída em página web).
+// Não estender: a saída nova entra no sketch_def como sink (sink_*.h +
+// profiles.h), reaproveitando src/common. Fica só como referência.
+// ------------------------------------------------------------------
+
 #include <WiFi.h>
 #include <WebServer.h>
 #include <ESP32-TWAI-CAN.hpp> 
 #include <FS.h>           // Necessário para o sistema de arquivos
 #include <LittleFS.h>     // Necessário para o LittleFS
 #include "../../config/constants.h"
+#include "../common/capture_csv.h"
+#include "../common/vehicle_state.h"
+#include "../common/segment_log.h"
+#include "../common/sse_hub.h"
 
 // ------------------------------------------------------------------
 // 1. CONFIGURAÇÕES DE REDE
@@ -11,71 +21,140 @@
 const char* ssid = "CINGUESTS";         // Credenciais preenchidas
 const char* password = "acessocin";       // Credenciais preenchidas
 
+// Ponto de acesso próprio: a equipe de box conecta o celular direto no ESP32
+const char* AP_SSID = "Voltz-Telemetria";
+const char* AP_PASSWORD = "voltz1234";
+
 // ------------------------------------------------------------------
 // 2. CONFIGURAÇÕES GERAIS
 // ------------------------------------------------------------------
 #define CAN_TX_PIN 5
 #define CAN_RX_PIN 4
 const TwaiSpeed CAN_SPEED = TWAI_SPEED_250KBPS;
-const char* LOG_FILE_NAME = "/can_log.csv"; // Arquivo salvo na memória Flash
+const char* LOG_FILE_NAME = "/can_log.csv"; // Nome do arquivo baixado
+
+// Log circular na Flash: LOG_SEGMENTS arquivos de até LOG_SEGMENT_BYTES,
+// o mais antigo reaproveitado (LittleFS montado em /littlefs)
+const char* LOG_SEGMENT_PATTERN = "/littlefs/can_%02u.csv";
+const uint8_t LOG_SEGMENTS = 8;
+const uint32_t LOG_SEGMENT_BYTES = 128 * 1024;  // 1 MB no total
+const uint32_t LOG_SYNC_INTERVAL_MS = 1000;     // Gravações agrupadas na Flash
 twai_message_t rxFrame; 
 
+// Painel ao vivo (Server-Sent Events em /events)
+const uint32_t LIVE_STREAM_INTERVAL_MS = 200;  // Taxa dos snapshots (5 Hz)
+const uint32_t LOG_INFO_INTERVAL_MS = 5000;    // Taxa das informações do log
+
 WebServer server(80);
 
+// Últimos valores decodificados e clientes do stream
+VehicleState vehicleState;
+SseHub<WiFiClient> liveHub;
+
+SegmentLog<> canLog;
+
+// Contadores do log mantidos em memória (evita reler o arquivo a cada consulta)
+// Linhas guardadas = bytes guardados × linhas/byte já gravados
+uint32_t logLinesWritten = 0;
+uint32_t logBytesWritten = 0;
+
 // ------------------------------------------------------------------
 // 3. FUNÇÕES DE SUPORTE
 // ------------------------------------------------------------------
 
 /**
- * @brief Conecta o ESP32 à rede Wi-Fi e mostra apenas o IP no terminal.
+ * @brief Sobe o AP e inicia a conexão à rede Wi-Fi em segundo plano.
+ * @details Não espera a associação: o log começa no boot e o IP aparece
+ *          no terminal quando a rede subir (ver reportWiFi()).
  */
 void setupWiFi() {
+  // AP + estação: o painel ao vivo fica acessível mesmo sem rede externa
+  WiFi.mode(WIFI_AP_STA);
+  WiFi.softAP(AP_SSID, AP_PASSWORD);
+  Serial.print("AP ");
+  Serial.print(AP_SSID);
+  Serial.print(": ");
+  Serial.println(WiFi.softAPIP());
+
   Serial.print("Conectando a ");
   Serial.print(ssid);
-  WiFi.mode(WIFI_STA);
+  Serial.println(" em segundo plano...");
   WiFi.begin(ssid, password);
-  while (WiFi.status() != WL_CONNECTED) {
-    delay(500);
-    Serial.print(".");
+}
+
+/**
+ * @brief Mostra o IP quando a conexão sobe (chamada no loop).
+ */
+void reportWiFi() {
+  static bool wasConnected = false;
+  bool connected = WiFi.status() == WL_CONNECTED;
+  if (connected == wasConnected) return;
+  wasConnected = connected;
+  if (connected) {
+    Serial.print("WiFi conectado em ");
+    Serial.print(millis());
+    Serial.print(" ms: ");
+    Serial.println(WiFi.localIP());
   }
-  
-  // Apenas a linha do IP no terminal
-  Serial.println(); 
-  Serial.println(WiFi.localIP()); 
 }
 
 /**
- * @brief Formata o frame CAN em uma linha CSV e salva na Flash.
+ * @brief Formata um tamanho em bytes como texto (bytes/KB/MB).
  */
-void logCanFrame(const twai_message_t& rx) {
-    File file = LittleFS.open(LOG_FILE_NAME, FILE_APPEND);
-    if (!file) {
-        Serial.println("ERRO: Falha ao abrir arquivo para escrita.");
-        return;
+String formatBytes(uint32_t bytes) {
+  if (bytes > 1024 * 1024) {
+    return String((float)bytes / (1024.0 * 1024.0), 2) + " MB";
+  } else if (bytes > 1024) {
+    return String((float)bytes / 1024.0, 1) + " KB";
+  }
+  return String(bytes) + " bytes";
+}
+
+/**
+ * @brief Conta linhas e tamanho do log uma única vez no boot.
+ */
+void scanLogFile() {
+  logLinesWritten = 0;
+  logBytesWritten = 0;
+  canLog.readAll([](const char* data, size_t length) {
+    logBytesWritten += length;
+    for (size_t i = 0; i < length; i++) {
+      if (data[i] == '\n') logLinesWritten++;
     }
+  });
+}
 
-    String logLine = "";
-    logLine += String(millis()); logLine += ",";
-    
-    bool isExtended = (rx.flags & TWAI_MSG_FLAG_EXTD);
-    char idHex[10];
-    sprintf(idHex, "0x%lX", rx.identifier);
-    logLine += idHex; logLine += ",";
-    logLine += isExtended ? "E" : "S"; logLine += ",";
-    logLine += String(rx.data_length_code); logLine += ",";
-
-    for (int i = 0; i < rx.data_length_code; i++) {
-        char byteHex[3];
-        sprintf(byteHex, "%02X", rx.data[i]); 
-        logLine += byteHex;
+/**
+ * @brief Linhas guardadas (estimadas quando o log já deu a volta).
+ */
+uint32_t storedLogLines() {
+  if (logBytesWritten == 0) return 0;
+  return (uint32_t)((uint64_t)canLog.storedBytes() * logLinesWritten / logBytesWritten);
+}
+
+/**
+ * @brief Formata o frame CAN em uma linha CSV e acrescenta ao log.
+ * @details O segmento atual fica aberto; a Flash recebe os dados a cada
+ *          LOG_SYNC_INTERVAL_MS (loop), não a cada linha.
+ */
+void logCanFrame(const twai_message_t& rx) {
+    CaptureLine row;
+    row.ms = millis();
+    row.id = rx.identifier;
+    row.isExtended = (rx.flags & TWAI_MSG_FLAG_EXTD);
+    row.length = rx.data_length_code < 8 ? rx.data_length_code : 8;
+    memcpy(row.data, rx.data, sizeof(row.data));
+    char logLine[CAPTURE_LINE_MAX];
+    int length = formatCaptureLine(row, logLine, sizeof(logLine));
+    if (length == 0) return;
+
+    if (!canLog.write(logLine, length)) {
+        Serial.println("ERRO: Falha ao gravar no log.");
+        return;
     }
-    logLine += "\n";
 
-    file.print(logLine);
-    file.close();
-    
-    // Serial.print("Log salvo: ");
-    // Serial.print(logLine); // Comentado para otimizar o desempenho do log
+    logLinesWritten++;
+    logBytesWritten += length;
 }
 
 // ------------------------------------------------------------------
@@ -156,6 +235,10 @@ void handleRoot() {
       background: #f44336; /* Vermelho suave */
     }
 
+    #live-btn {
+      background: #4CAF50; /* Verde */
+    }
+
     .btn:hover {
       transform: translateY(-2px);
       box-shadow: 0 4px 10px rgba(0, 0, 0, 0.15);
@@ -217,6 +300,10 @@ void handleRoot() {
     📥 BAIXAR ARQUIVO DE LOG (can_log.csv)
   </a>
 
+  <a href="/live" class="btn" id="live-btn">
+    📡 PAINEL AO VIVO
+  </a>
+
   <button class="btn" id="delete-btn" onclick="confirmDelete()">
     🗑️ APAGAR LOG E LIBERAR ESPAÇO
   </button>
@@ -230,7 +317,7 @@ void handleRoot() {
   </div>
 
   <div class="warning">
-    <small>A gravação constante na memória flash tem vida útil limitada. Use com moderação.</small>
+    <small>Log circular de 1 MB: guarda sempre os dados mais recentes. As gravações na flash são agrupadas a cada 1 s.</small>
   </div>
 </div>
 
@@ -267,8 +354,17 @@ function confirmDelete() {
     }
 }
 
-window.onload = getInfo;
-setInterval(getInfo, 5000);
+function showInfo(info) {
+    document.getElementById("free-space").innerHTML = "💾 Espaço Livre Restante: <b>" + info.free + "</b>";
+    document.getElementById("log-count-info").innerHTML = "📊 Frames Registrados: <b>" + info.frames + "</b> | 📏 Tamanho Total: <b>" + info.size + "</b>";
+}
+
+window.onload = function() {
+    getInfo();
+    // Atualizações enviadas pelo ESP32 (SSE) em vez de polling
+    var source = new EventSource("/events");
+    source.addEventListener("log", function(e) { showInfo(JSON.parse(e.data)); });
+};
 </script>
 
 </body>
@@ -278,23 +374,114 @@ setInterval(getInfo, 5000);
 }
 
 /**
- * @brief Implementação de handleDownload e handleDelete (sem mudanças)
+ * @brief Página leve com os valores ao vivo (não carrega o datalogger).
+ */
+const char LIVE_PAGE[] PROGMEM = R"rawliteral(
+<!DOCTYPE html>
+<html lang="pt-BR">
+<head>
+  <meta charset="UTF-8" />
+  <meta name="viewport" content="width=device-width, initial-scale=1">
+  <title>Voltz - Ao Vivo</title>
+  <style>
+    body { font-family: system-ui, Arial, sans-serif; background: #1e272e; color: #ecf0f1; margin: 0; padding: 12px; }
+    h1 { font-size: 1.3rem; margin: 4px 0 12px; }
+    .grid { display: grid; grid-template-columns: repeat(auto-fill, minmax(140px, 1fr)); gap: 10px; }
+    .card { background: #2f3a45; border-radius: 10px; padding: 12px; }
+    .label { font-size: 0.8rem; color: #95a5a6; }
+    .value { font-size: 1.8rem; font-weight: 700; }
+    #status { font-size: 0.85rem; margin-bottom: 10px; color: #e67e22; }
+  </style>
+</head>
+<body>
+  <h1>🏍️ Voltz - Telemetria ao Vivo</h1>
+  <div id="status">Conectando...</div>
+  <div class="grid">
+    <div class="card"><div class="label">Tensão (V)</div><div class="value" id="v">--</div></div>
+    <div class="card"><div class="label">Corrente (A)</div><div class="value" id="a">--</div></div>
+    <div class="card"><div class="label">SoC (%)</div><div class="value" id="soc">--</div></div>
+    <div class="card"><div class="label">Temp. Bateria (°C)</div><div class="value" id="tB">--</div></div>
+    <div class="card"><div class="label">RPM</div><div class="value" id="rpm">--</div></div>
+    <div class="card"><div class="label">Torque (Nm)</div><div class="value" id="tq">--</div></div>
+    <div class="card"><div class="label">Temp. Motor (°C)</div><div class="value" id="tM">--</div></div>
+    <div class="card"><div class="label">Temp. Controlador (°C)</div><div class="value" id="tC">--</div></div>
+    <div class="card"><div class="label">Modo</div><div class="value" id="mod">--</div></div>
+  </div>
+<script>
+var fields = ["v", "a", "soc", "tB", "rpm", "tq", "tM", "tC", "mod"];
+var source = new EventSource("/events");
+source.addEventListener("live", function(e) {
+  var d = JSON.parse(e.data);
+  fields.forEach(function(k) { document.getElementById(k).textContent = d[k]; });
+  document.getElementById("status").textContent =
+    d.age > 2000 ? "⚠️ Sem dados CAN há " + Math.round(d.age / 1000) + " s" : "🟢 " + d.n + " frames";
+});
+source.onerror = function() { document.getElementById("status").textContent = "🔴 Reconectando..."; };
+</script>
+</body>
+</html>
+)rawliteral";
+
+void handleLive() {
+  server.send_P(200, "text/html", LIVE_PAGE);
+}
+
+/**
+ * @brief Abre o stream SSE: a conexão passa a ser mantida pelo liveHub.
+ */
+void handleEvents() {
+  if (!liveHub.subscribe(server.client())) {
+    Serial.println("SSE: limite de clientes atingido.");
+  }
+}
+
+/**
+ * @brief Envia o snapshot dos sinais a todos os clientes (serializado uma vez).
+ */
+void broadcastLiveSnapshot() {
+  if (liveHub.clientCount() == 0) return;
+
+  char json[256];
+  int len = vehicleStateToJson(vehicleState, millis(), json, sizeof(json));
+  if (len > 0 && len < (int)sizeof(json)) {
+    liveHub.broadcast("live", json, len);
+  }
+}
+
+/**
+ * @brief Envia contagem de frames, tamanho do log e espaço livre.
+ */
+void broadcastLogInfo() {
+  if (liveHub.clientCount() == 0) return;
+
+  String json = "{\"frames\":" + String(storedLogLines()) +
+                ",\"size\":\"" + formatBytes(canLog.storedBytes()) +
+                "\",\"free\":\"" + formatBytes(LittleFS.totalBytes() - LittleFS.usedBytes()) + "\"}";
+  liveHub.broadcast("log", json.c_str(), json.length());
+}
+
+/**
+ * @brief Envia os segmentos do log, do mais antigo ao mais recente, como um CSV
  */
 void handleDownload() {
-  File downloadFile = LittleFS.open(LOG_FILE_NAME, FILE_READ);
-  if (!downloadFile) {
+  if (canLog.storedBytes() == 0) {
     server.send(404, "text/plain", "Arquivo de log não encontrado ou vazio.");
     return;
   }
-  server.sendHeader("Content-Type", "text/csv");
   server.sendHeader("Content-Disposition", "attachment; filename=" + String(LOG_FILE_NAME));
   server.sendHeader("Connection", "close");
-  server.streamFile(downloadFile, "application/octet-stream");
-  downloadFile.close();
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/csv", "");
+  canLog.readAll([](const char* data, size_t length) {
+    server.sendContent(data, length);
+  });
+  server.sendContent("");
 }
 
 void handleDelete() {
-    if (LittleFS.remove(LOG_FILE_NAME)) {
+    if (canLog.clear()) {
+        logLinesWritten = 0;
+        logBytesWritten = 0;
         server.send(200, "text/plain", "Arquivo de log apagado com sucesso! Redirecionando...");
     } else {
         server.send(500, "text/plain", "Falha ao apagar o arquivo de log.");
@@ -310,60 +497,17 @@ void handleFreeSpace() {
     uint32_t usedBytes = LittleFS.usedBytes();
     uint32_t freeBytes = totalBytes - usedBytes;
 
-    String freeSpaceString = "";
-    
-    if (freeBytes > 1024 * 1024) { 
-        freeSpaceString += String((float)freeBytes / (1024.0 * 1024.0), 2); 
-        freeSpaceString += " MB";
-    } else if (freeBytes > 1024) { 
-        freeSpaceString += String((float)freeBytes / 1024.0, 1);
-        freeSpaceString += " KB";
-    } else {
-        freeSpaceString += String(freeBytes);
-        freeSpaceString += " bytes";
-    }
-    
-    server.send(200, "text/plain", freeSpaceString);
+    server.send(200, "text/plain", formatBytes(freeBytes));
 }
 
 
 /**
- * @brief NOVO HANDLER: Retorna a contagem de linhas e o tamanho do arquivo log.
+ * @brief Retorna a contagem de linhas e o tamanho do arquivo log.
+ * @details Usa os contadores mantidos por logCanFrame (sem reler os segmentos).
  */
 void handleLogInfo() {
-    File file = LittleFS.open(LOG_FILE_NAME, FILE_READ);
-    if (!file) {
-        server.send(200, "text/plain", "0,0 bytes");
-        return;
-    }
-
-    // 1. Obter o tamanho do arquivo
-    size_t fileSize = file.size();
-    
-    // 2. Contar linhas (logs)
-    int lineCount = 0;
-    while (file.available()) {
-        if (file.read() == '\n') {
-            lineCount++;
-        }
-    }
-    file.close();
-
-    // 3. Formatar o tamanho do arquivo
-    String fileSizeString = "";
-    if (fileSize > 1024 * 1024) { 
-        fileSizeString += String((float)fileSize / (1024.0 * 1024.0), 2); 
-        fileSizeString += " MB";
-    } else if (fileSize > 1024) { 
-        fileSizeString += String((float)fileSize / 1024.0, 1);
-        fileSizeString += " KB";
-    } else {
-        fileSizeString += String(fileSize);
-        fileSizeString += " bytes";
-    }
-
     // Retorna no formato "LINHAS,TAMANHO_FORMATADO"
-    String response = String(lineCount) + "," + fileSizeString;
+    String response = String(storedLogLines()) + "," + formatBytes(canLog.storedBytes());
     server.send(200, "text/plain", response);
 }
 
@@ -381,11 +525,14 @@ void setup() {
       Serial.println("ERRO: Falha ao montar o LittleFS! Verifique as partições.");
       while(true);
   }
-  
-  // 2. Conexão Wi-Fi (mostrará apenas o IP no final)
-  setupWiFi();
+  // LittleFS: segmentos só recebem appends (preallocate = false)
+  if (!canLog.begin(LOG_SEGMENT_PATTERN, LOG_SEGMENTS, LOG_SEGMENT_BYTES, false)) {
+      Serial.println("ERRO: Falha ao abrir o log na Flash.");
+  }
+  scanLogFile();
 
-  // 3. Inicializa o controlador CAN.
+  // 2. Inicializa o controlador CAN antes da rede: a fila de recepção do
+  //    TWAI já guarda os frames enquanto o resto do setup roda.
   ESP32Can.setPins(CAN_TX_PIN, CAN_RX_PIN);
   if (ESP32Can.begin(CAN_SPEED)) {
      Serial.println("CAN iniciado.");
@@ -394,21 +541,58 @@ void setup() {
     while (1) delay(100); 
   }
 
+  // 3. Conexão Wi-Fi em segundo plano (o IP aparece quando conectar)
+  setupWiFi();
+
   // 4. Configuração do Servidor Web
   server.on("/", handleRoot);
   server.on("/download", handleDownload);      
   server.on("/delete", handleDelete);          
   server.on("/freespace", handleFreeSpace);    
   server.on("/loginfo", handleLogInfo);        // NOVO endpoint para informações do log
+  server.on("/live", handleLive);              // Painel ao vivo (celular no AP)
+  server.on("/events", handleEvents);          // Stream SSE dos snapshots
   server.begin();
 }
 
 void loop() {
+  static uint32_t lastLivePush = 0;
+  static uint32_t lastLogInfoPush = 0;
+  static uint32_t lastLogSync = 0;
+  static bool firstFrameSeen = false;
+
   // 1. Processa requisições Web
   server.handleClient();
+  reportWiFi();
   
-  // 2. Leitura CAN e Log na Flash
+  // 2. Leitura CAN, atualização dos últimos valores e Log na Flash
   if (ESP32Can.readFrame(&rxFrame)) {
+    if (!firstFrameSeen) {
+      // Tempo do boot até o primeiro frame (não depende mais da rede)
+      firstFrameSeen = true;
+      Serial.print("Primeiro frame CAN em ");
+      Serial.print(millis());
+      Serial.println(" ms");
+    }
+    applyFrame(vehicleState, rxFrame.identifier, rxFrame.data,
+               rxFrame.data_length_code, millis());
     logCanFrame(rxFrame);
   }
+
+  // 3. Push para os clientes conectados em /events
+  uint32_t now = millis();
+  if (now - lastLivePush >= LIVE_STREAM_INTERVAL_MS) {
+    lastLivePush = now;
+    broadcastLiveSnapshot();
+  }
+  if (now - lastLogInfoPush >= LOG_INFO_INTERVAL_MS) {
+    lastLogInfoPush = now;
+    broadcastLogInfo();
+  }
+
+  // 4. Linhas acumuladas vão para a Flash de uma vez
+  if (now - lastLogSync >= LOG_SYNC_INTERVAL_MS) {
+    lastLogSync = now;
+    canLog.flush();
+  }
 }
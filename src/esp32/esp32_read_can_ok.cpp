@@ -1,3 +1,8 @@
+// ------------------------------------------------------------------
+// LEGADO, CONGELADO: substituído por src/sketch_def (sink serial, qualquer perfil com DEBUGMODE).
+// Não estender; mudanças vão no sketch_def. Fica só como referência.
+// ------------------------------------------------------------------
+
 #include <ESP32-TWAI-CAN.hpp> // Biblioteca ESP32-TWAI-CAN
 
 // ------------------------------------------------------------------
@@ -0,0 +1,132 @@
+#ifndef FIRMWARE_CONFIG_H
+#define FIRMWARE_CONFIG_H
+
+// ------------------------------------------------------------------
+// --- CONFIGURAÇÕES DE PINOS E REDE ---
+// ------------------------------------------------------------------
+// Compartilhadas por todos os perfis (ver profiles.h). Cada estágio só
+// usa o que precisa; o resto não entra no binário.
+
+#include <ESP32-TWAI-CAN.hpp>
+
+#define CAN_TX_PIN 2
+#define CAN_RX_PIN 15
+#define SD_CS_PIN 5
+#define ledCAN 16
+#define ledMQTT 17
+
+// Pinos I2C para o MPU-6050 (ESP32 padrão: SDA=21, SCL=22)
+// Altere conforme sua ligação física
+#define I2C_SDA 16
+#define I2C_SCL 17
+
+#ifndef TESTMODE
+#define TESTMODE true  // Se true, gera dados simulados (vehicle_sim.h) para teste sem hardware CAN
+#endif
+#ifndef DEBUGMODE
+#define DEBUGMODE false
+#endif
+#define SIM_BUS_LOAD_PERCENT 30 // Carga do barramento simulado no TESTMODE (0..100%)
+#define BufferSize 250  // Buffer aumentado para evitar perda em latências de rede
+#define CAPTURE_RING_SIZE 256 // Captura → decodificação (potência de 2, lock-free)
+// Slots de frame (frame_pool.h, ~23 B cada) para as lanes, que só levam
+// handles: telemetria (BufferSize + OVERLOAD_LATEST_SLOTS por ID), falhas
+// (LANE_HIGH_CAPACITY) e folga para o frame em entrega e a releitura do spill
+#define FRAME_POOL_SIZE 384
+
+// Política da fila de telemetria cheia (overload_queue.h):
+// OVERLOAD_DROP_NEWEST, OVERLOAD_DROP_OLDEST, OVERLOAD_LATEST_PER_ID ou
+// OVERLOAD_SPILL (só em perfis com SD; sem SD vira DROP_NEWEST)
+#define OVERLOAD_POLICY OVERLOAD_LATEST_PER_ID
+#define SPILL_FILE_PATH "/sd/spill.bin" // SD.begin() monta o cartão em /sd
+#define SPILL_MAX_FRAMES 100000         // Região circular pré-alocada (~2 MB, blocos de 2560 B)
+#define QUEUE_REPORT_INTERVAL_MS 10000  // Relatório dos contadores das filas
+
+// Estatística por ID e ausência de mensagens (src/common/bus_stats.h)
+#define BUS_STATS_CAPACITY 64      // IDs acompanhados (potência de 2, ~32 IDs)
+#define BUS_MISS_PERIODS 5         // Períodos aprendidos sem o ID até o alarme
+#define BUS_SILENT_MS 2000         // Barramento inteiro calado até o alarme
+#define BUS_CHECK_INTERVAL_MS 100  // Verificação dos prazos (também sem frames)
+
+// Agregados da viagem no ESP32 (src/common/trip_stats.h): energia,
+// potência, distância e tempo por modo, publicados no key-off. false: os
+// perfis MQTT voltam a só repassar frames brutos
+#define TRIP_STATS true
+#define TRIP_KEY_OFF_MS 5000              // Bateria e controlador calados: fim da viagem
+#define TRIP_MAX_HOLD_MS 30000            // BMS da captura: ~5 s, pausas de até 26 s
+#define TRIP_WHEEL_CIRCUMFERENCE_MM 1759  // Motor de cubo: RPM do motor = RPM da roda
+
+// Janelas por sinal (src/common/signal_window.h): mín/máx/média/último de
+// cada sinal decodificado, um registro {"type":"win"} por janela. Com
+// SIGNAL_WINDOW_RAW false os frames de bateria/controlador deixam de ser
+// publicados um a um no MQTT e só as janelas sobem (as falhas continuam)
+#define SIGNAL_WINDOWS true
+#define SIGNAL_WINDOW_SHORT_MS 1000   // Painel
+#define SIGNAL_WINDOW_LONG_MS 10000   // Histórico
+#define SIGNAL_WINDOW_RAW true        // Também publica os frames brutos
+#define SIGNAL_WINDOW_QUEUE 16        // Janelas entre decodificação e envio
+
+// Regras de limiar/alarme (src/common/rule_engine.h), avaliadas a cada
+// frame decodificado. As regras são texto: RULES_DEFAULT, substituído por
+// RULES_FILE quando o cartão SD o tiver (trocar regras não exige reflash)
+#define RULE_ENGINE true
+#define RULE_CAPACITY 32         // Regras por programa (dois programas em RAM)
+#define RULE_EVENT_QUEUE 16      // Transições entre decodificação e envio
+#define RULES_TEXT_MAX 1024      // Maior texto de regras aceito
+const char *const RULES_DEFAULT =
+    "1 tM > 90 h5 t2000\n"     // Motor acima de 90 °C por 2 s
+    "2 tC > 80 h5 t2000\n"     // Controlador acima de 80 °C por 2 s
+    "3 tB > 55 h3 t5000\n"     // Bateria acima de 55 °C por 5 s
+    "4 soc < 10 h2 t10000\n";  // SoC abaixo de 10 % por 10 s
+
+const char *const ssid = "Salvacao_2_conto";
+const char *const password = "mimda2conto";
+const char *const serverAddress = "192.168.1.47";
+const char *const MQTT_TOPIC = "moto/telemetria";
+const char *const MQTT_FAULT_TOPIC = "moto/telemetria/falhas"; // Lane de falhas
+const int mqtt_port = 31883;
+const uint16_t wsPort = 3001;
+// Log CSV circular no SD em blocos com CRC (src/common/block_log.h): um
+// arquivo pré-alocado de SD_LOG_BLOCKS blocos de 512 B, o mais antigo
+// reaproveitado. Extração do CSV: node tools/blocklog.js datalog.vzl --csv
+const char *const SD_LOG_FILE = "/sd/datalog.vzl"; // SD.begin() monta em /sd
+#define SD_LOG_BLOCKS 98304UL                   // 48 MB: ~7 h a 40 linhas/s
+#define SD_LOG_SYNC_INTERVAL_MS 1000            // Grava no cartão a cada 1 s (falhas: na hora)
+const char *const SD_TRIP_FILE = "/sd/viagens.csv"; // Uma linha por viagem (TRIP_STATS)
+const char *const SD_ALARM_FILE = "/sd/alarmes.csv"; // Uma linha por transição (RULE_ENGINE)
+const char *const RULES_FILE = "/sd/regras.txt";     // Regras no cartão (RULE_ENGINE)
+
+const TwaiSpeed CAN_SPEED = TWAI_SPEED_250KBPS;
+#define CAN_BITRATE 250000 // O mesmo de CAN_SPEED, para a carga do barramento
+
+// Configurações do Fuso Horário (Brasil - Pernambuco)
+const char *const ntpServer = "pool.ntp.org";
+const long gmtOffset_sec = -3 * 3600;
+const int daylightOffset_sec = 0;
+
+// Intervalo que a task de envio acorda para limpar a fila (50ms)
+#define TRANSMIT_INTERVAL_MS 50
+
+// Lote e intervalo de envio ajustados pela latência/recusas dos sinks
+// (src/common/adaptive_batch.h). false: esvazia a fila a cada
+// TRANSMIT_INTERVAL_MS, como antes. Perfis com SD sempre esvaziam a
+// fila (o cartão não dá retorno do enlace e não pode ficar para trás)
+#define ADAPTIVE_BATCH true
+
+// Intervalo entre tentativas de reconexão (WiFi / MQTT / WebSocket)
+#define RECONNECT_INTERVAL_MS 2000
+
+// Cliente MQTT não bloqueante (src/common/mqtt_lite.h)
+#define MQTT_OUTBOX_BYTES 16384        // Mensagens aguardando envio/PUBACK (~85 frames JSON)
+#define MQTT_INFLIGHT_WINDOW 8         // QoS1 em voo sem PUBACK (1..32)
+#define MQTT_FAULT_RESERVE_BYTES 2048  // Parte da outbox que a telemetria não ocupa
+#define MQTT_KEEPALIVE_S 15
+#define MQTT_CONNECT_TIMEOUT_MS 1000   // Handshake TCP (única etapa que bloqueia)
+
+// Configuração em campo (src/common/runtime_config.h): JSON retido em
+// MQTT_CONFIG_TOPIC/<MAC do ESP32> muda filtro de IDs, intervalos, lote,
+// dead-bands e regras sem reflash. Os #defines acima são o ponto de partida
+const char *const MQTT_CONFIG_TOPIC = "moto/config";
+#define MQTT_LITE_RX_BYTES 1536        // Maior mensagem de configuração (regras inclusas)
+
+#endif // FIRMWARE_CONFIG_H
@@ -0,0 +1,72 @@
+#ifndef IMU_MPU6050_H
+#define IMU_MPU6050_H
+
+// ------------------------------------------------------------------
+// --- SENSOR INERCIAL MPU-6050 (ANEXADO AOS PACOTES MQTT) ---
+// ------------------------------------------------------------------
+
+#include <Arduino.h>
+#include <Wire.h>              // Biblioteca I2C para o MPU-6050
+#include <MPU6050.h>           // Biblioteca do MPU-6050 (instale via Library Manager)
+#include "firmware_config.h"
+#include "../common/json_writer.h"
+
+class Mpu6050Imu {
+public:
+  void begin() {
+    // Inicializa barramento I2C para o MPU-6050
+    Wire.begin(I2C_SDA, I2C_SCL);
+    Serial.println("Inicializando MPU-6050...");
+    mpu_.initialize();
+
+    // Verifica comunicação com o sensor
+    if (mpu_.testConnection()) {
+      Serial.println("MPU-6050 conectado com sucesso!");
+
+      // Configurações opcionais do sensor (ajuste conforme necessidade)
+      mpu_.setFullScaleAccelRange(MPU6050_ACCEL_FS_2);   // ±2g (maior precisão)
+      mpu_.setFullScaleGyroRange(MPU6050_GYRO_FS_250);   // ±250°/s (maior precisão)
+      mpu_.setDLPFMode(MPU6050_DLPF_BW_98);              // Filtro digital: 98Hz
+    } else {
+      Serial.println("ERRO: Falha na comunicação com MPU-6050. Verifique conexões I2C.");
+      // Sistema continua sem o sensor (modo degradado)
+    }
+  }
+
+  /**
+   * @brief Lê o sensor e acrescenta o campo "mpu" ao JSON do frame
+   * @note Chamado apenas pela task de envio para evitar conflito no barramento I2C
+   */
+  void appendTo(JsonWriter &json) {
+    int16_t ax, ay, az, gx, gy, gz;
+    mpu_.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
+
+    // Acelerômetro: raw / 16384 = g (escala ±2g), 4 casas (1 LSB ≈ 0,00006 g)
+    // Giroscópio: raw / 131 = °/s (escala ±250°/s), 2 casas (1 LSB ≈ 0,008 °/s)
+    json.raw(",\"mpu\":{\"ax_g\":").fixed(accelTenThousandths(ax), 4)
+        .raw(",\"ay_g\":").fixed(accelTenThousandths(ay), 4)
+        .raw(",\"az_g\":").fixed(accelTenThousandths(az), 4)
+        .raw(",\"gx_dps\":").fixed(gyroHundredths(gx), 2)
+        .raw(",\"gy_dps\":").fixed(gyroHundredths(gy), 2)
+        .raw(",\"gz_dps\":").fixed(gyroHundredths(gz), 2)
+        .raw(",\"ts_mpu\":").u32(millis())  // Timestamp relativo da leitura do MPU
+        .raw("}");
+  }
+
+private:
+  /** @brief raw / 16384 em 0,0001 g, arredondado (10000 / 16384 = 625 / 1024) */
+  static int32_t accelTenThousandths(int16_t raw) {
+    int32_t scaled = (int32_t)raw * 625;
+    return (scaled + (scaled < 0 ? -512 : 512)) / 1024;
+  }
+
+  /** @brief raw / 131 em 0,01 °/s, arredondado */
+  static int32_t gyroHundredths(int16_t raw) {
+    int32_t scaled = (int32_t)raw * 100;
+    return (scaled + (scaled < 0 ? -65 : 65)) / 131;
+  }
+
+  MPU6050 mpu_;
+};
+
+#endif // IMU_MPU6050_H
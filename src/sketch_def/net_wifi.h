@@ -0,0 +1,111 @@
+#ifndef NET_WIFI_H
+#define NET_WIFI_H
+
+// ------------------------------------------------------------------
+// --- ENLACE DE REDE (WiFi + NTP) ---
+// ------------------------------------------------------------------
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <errno.h>
+#include <lwip/sockets.h>
+#include "time.h"
+#include "firmware_config.h"
+
+// Associação + DHCP num AP lento passam de 5 s: recomeçar antes disso
+// faria a tentativa nunca terminar. Cada tentativa que falha dobra o
+// prazo da seguinte, até o máximo
+#define WIFI_RETRY_INTERVAL_MS 10000
+#define WIFI_RETRY_MAX_MS 60000
+
+/**
+ * @brief WiFi em segundo plano: o boot não espera a rede
+ * @details begin() só dispara a associação e o NTP (que sincroniza sozinho
+ *          quando a rede subir); maintain(), chamado pela task de envio,
+ *          acompanha a conexão e recomeça a tentativa se ela não completar
+ */
+class WifiLink {
+public:
+  void begin() {
+    Serial.print("Conectando ao WiFi ");
+    Serial.print(ssid);
+    Serial.println(" em segundo plano...");
+    WiFi.begin(ssid, password);
+
+    // NTP configurado já: o SNTP do lwIP aguarda a interface subir
+    configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
+    lastAttemptMs_ = millis();
+  }
+
+  /**
+   * @brief Acompanha a conexão e reinicia se caiu, sem bloquear a task de envio
+   */
+  void maintain() {
+    bool up = WiFi.status() == WL_CONNECTED;
+    if (up != wasConnected_) {
+      wasConnected_ = up;
+      if (up) {
+        Serial.print("WiFi conectado: ");
+        Serial.println(WiFi.localIP());
+      } else {
+        Serial.println("WiFi desconectado");
+      }
+      lastAttemptMs_ = millis();
+      retryMs_ = WIFI_RETRY_INTERVAL_MS;
+    }
+    if (up) return;
+    uint32_t now = millis();
+    if (now - lastAttemptMs_ < retryMs_) return;
+    lastAttemptMs_ = now;
+    if (retryMs_ < WIFI_RETRY_MAX_MS) retryMs_ *= 2;
+    WiFi.disconnect();
+    WiFi.begin(ssid, password);
+  }
+
+  bool connected() const { return WiFi.status() == WL_CONNECTED; }
+
+private:
+  uint32_t lastAttemptMs_ = 0;
+  uint32_t retryMs_ = WIFI_RETRY_INTERVAL_MS;
+  bool wasConnected_ = false;
+};
+
+/**
+ * @brief Transporte TCP do MqttLite sobre o WiFiClient
+ * @details Só o connect() usa o WiFiClient (bloqueia até
+ *          MQTT_CONNECT_TIMEOUT_MS); leitura e escrita vão direto ao
+ *          socket do lwIP com MSG_DONTWAIT, sem as esperas internas do
+ *          WiFiClient::write quando o buffer de envio enche
+ */
+class WifiTransport {
+public:
+  bool connect(const char *host, uint16_t port) {
+    if (WiFi.status() != WL_CONNECTED) return false;
+    if (!client_.connect(host, port, MQTT_CONNECT_TIMEOUT_MS)) return false;
+    client_.setNoDelay(true); // Pacotes pequenos saem na hora (sem Nagle)
+    return true;
+  }
+
+  bool connected() { return client_.fd() >= 0 && WiFi.status() == WL_CONNECTED; }
+
+  int write(const uint8_t *data, size_t len) {
+    int n = send(client_.fd(), data, len, MSG_DONTWAIT);
+    if (n >= 0) return n;
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+  }
+
+  int read(uint8_t *data, size_t len) {
+    if (len == 0) return 0;
+    int n = recv(client_.fd(), data, len, MSG_DONTWAIT);
+    if (n > 0) return n;
+    if (n == 0) return -1; // Fechado pelo broker
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+  }
+
+  void stop() { client_.stop(); }
+
+private:
+  WiFiClient client_;
+};
+
+#endif // NET_WIFI_H
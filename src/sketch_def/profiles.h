@@ -0,0 +1,140 @@
+#ifndef PROFILES_H
+#define PROFILES_H
+
+// ------------------------------------------------------------------
+// --- PERFIS DO FIRMWARE ---
+// ------------------------------------------------------------------
+// Um único firmware; o perfil escolhe, em tempo de compilação, os tipos
+// de cada estágio do pipeline (fonte → filtro → decodificador → sinks).
+// Só os cabeçalhos dos estágios usados são incluídos, então bibliotecas
+// de perfis desabilitados (SD, WebSockets, MPU6050...) nem são linkadas.
+//
+// Selecione com -DVOLTZ_PROFILE=VOLTZ_PROFILE_xxx (ou edite o padrão):
+//
+//   VOLTZ_PROFILE_MQTT_MPU  frames brutos JSON via MQTT + MPU-6050 (padrão)
+//                           substitui acele_esp32_mqtt_mpu_led_can.cpp
+//   VOLTZ_PROFILE_MQTT      frames brutos JSON via MQTT
+//                           substitui esp32_mqtt*.cpp
+//   VOLTZ_PROFILE_MQTT_SD   MQTT + CSV decodificado no cartão SD
+//                           substitui esp32_mqtt_sd_.cpp
+//   VOLTZ_PROFILE_WEBSOCKET bateria/controlador em lote binário via WebSocket
+//                           substitui *_socket_*.cpp / esp32_WebSocket_RealTime_ok.cpp
+//   VOLTZ_PROFILE_SD        registrador offline (sem rede), CSV no SD
+//
+// TESTMODE troca a fonte TWAI pelo simulador; DEBUGMODE acrescenta o sink
+// de depuração na serial; TRIP_STATS troca o decodificador dos perfis MQTT
+// e SD pelo que também agrega a viagem (o WebSocket só repassa frames).
+
+#include "firmware_config.h"
+#include "../common/pipeline.h"
+
+#define VOLTZ_PROFILE_MQTT_MPU 1
+#define VOLTZ_PROFILE_MQTT 2
+#define VOLTZ_PROFILE_MQTT_SD 3
+#define VOLTZ_PROFILE_WEBSOCKET 4
+#define VOLTZ_PROFILE_SD 5
+
+#ifndef VOLTZ_PROFILE
+#define VOLTZ_PROFILE VOLTZ_PROFILE_MQTT_MPU
+#endif
+
+// --- Fonte ---
+#if TESTMODE
+#include "source_sim.h"
+typedef SimSource ProfileSource;
+#else
+#include "source_twai.h"
+typedef TwaiSource ProfileSource;
+#endif
+
+// --- Sink de depuração (apêndice da lista de sinks) ---
+#if DEBUGMODE
+#include "sink_serial.h"
+#define PROFILE_DEBUG_SINKS , SerialDebugSink
+#else
+#define PROFILE_DEBUG_SINKS
+#endif
+
+// --- Decodificador: com TRIP_STATS/SIGNAL_WINDOWS/RULE_ENGINE, estado + agregados ---
+#if TRIP_STATS || SIGNAL_WINDOWS || RULE_ENGINE
+#define PROFILE_DECODER(Plain) AggregateDecoder<TRIP_STATS, SIGNAL_WINDOWS, RULE_ENGINE>
+#else
+#define PROFILE_DECODER(Plain) Plain
+#endif
+
+// --- Enlace de rede ---
+#if VOLTZ_PROFILE == VOLTZ_PROFILE_SD
+/**
+ * @brief Perfil offline: nenhuma chamada à pilha WiFi é compilada
+ */
+struct NullLink {
+  void begin() {}
+  void maintain() {}
+  bool connected() const { return false; }
+};
+#else
+#include "net_wifi.h"
+#endif
+
+// ------------------------------------------------------------------
+// --- COMPOSIÇÃO ---
+// ------------------------------------------------------------------
+
+#if VOLTZ_PROFILE == VOLTZ_PROFILE_MQTT_MPU
+#include "imu_mpu6050.h"
+#include "sink_mqtt.h"
+struct ActiveProfile {
+  static const char *name() { return "MQTT+MPU"; }
+  typedef WifiLink Link;
+  typedef Pipeline<ProfileSource, PassFilter, PROFILE_DECODER(NullDecoder),
+                   MqttJsonSink<Mpu6050Imu> PROFILE_DEBUG_SINKS> Pipe;
+};
+
+#elif VOLTZ_PROFILE == VOLTZ_PROFILE_MQTT
+#include "sink_mqtt.h"
+struct ActiveProfile {
+  static const char *name() { return "MQTT"; }
+  typedef WifiLink Link;
+  typedef Pipeline<ProfileSource, PassFilter, PROFILE_DECODER(NullDecoder),
+                   MqttJsonSink<NullImu> PROFILE_DEBUG_SINKS> Pipe;
+};
+
+#elif VOLTZ_PROFILE == VOLTZ_PROFILE_MQTT_SD
+#include "sink_mqtt.h"
+#include "sink_sd.h"
+#define PROFILE_HAS_SD 1
+struct ActiveProfile {
+  static const char *name() { return "MQTT+SD"; }
+  typedef WifiLink Link;
+  typedef Pipeline<ProfileSource, PassFilter, PROFILE_DECODER(StateDecoder),
+                   MqttJsonSink<NullImu>, SdCsvSink PROFILE_DEBUG_SINKS> Pipe;
+};
+
+#elif VOLTZ_PROFILE == VOLTZ_PROFILE_WEBSOCKET
+#include "sink_websocket.h"
+struct ActiveProfile {
+  static const char *name() { return "WebSocket"; }
+  typedef WifiLink Link;
+  typedef Pipeline<ProfileSource, TelemetryIdFilter, NullDecoder,
+                   WebSocketBatchSink PROFILE_DEBUG_SINKS> Pipe;
+};
+
+#elif VOLTZ_PROFILE == VOLTZ_PROFILE_SD
+#include "sink_sd.h"
+#define PROFILE_HAS_SD 1
+struct ActiveProfile {
+  static const char *name() { return "SD"; }
+  typedef NullLink Link;
+  typedef Pipeline<ProfileSource, PassFilter, PROFILE_DECODER(StateDecoder),
+                   SdCsvSink PROFILE_DEBUG_SINKS> Pipe;
+};
+
+#else
+#error "VOLTZ_PROFILE desconhecido (ver src/sketch_def/profiles.h)"
+#endif
+
+#ifndef PROFILE_HAS_SD
+#define PROFILE_HAS_SD 0 // Sem cartão: OVERLOAD_SPILL indisponível
+#endif
+
+#endif // PROFILES_H
@@ -0,0 +1,414 @@
+#ifndef SINK_MQTT_H
+#define SINK_MQTT_H
+
+// ------------------------------------------------------------------
+// --- SINK: PUBLICAÇÃO MQTT (JSON POR FRAME) ---
+// ------------------------------------------------------------------
+// Frames, falhas e âncoras saem em QoS1 pelo MqttLite: publicar só copia
+// para a outbox e a task de envio nunca espera o TCP nem o broker. O que
+// estava em voo numa queda é retransmitido ao reconectar (o backend pode
+// receber duplicatas, semântica "ao menos uma vez" do QoS1).
+//
+// O sink também assina MQTT_CONFIG_TOPIC/<MAC>: a configuração retida lá
+// chega a cada conexão e é entregue à task de envio por receiveConfig()
+// (formato em runtime_config.h e no README).
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <WiFi.h>
+#include "firmware_config.h"
+#include "net_wifi.h"
+#include "../common/can_message.h"
+#include "../common/json_writer.h"
+#include "../common/mqtt_lite.h"
+#include "../common/priority_lanes.h"
+#include "../common/rule_engine.h"
+#include "../common/runtime_config.h"
+#include "../common/signal_window.h"
+#include "../common/time_base.h"
+#include "../common/trip_stats.h"
+#include "../common/vehicle_state.h"
+
+/**
+ * @brief Perfil sem sensor inercial: nada é lido nem serializado
+ */
+struct NullImu {
+  void begin() {}
+  void appendTo(JsonWriter &) {}
+};
+
+/**
+ * @brief Publica cada frame bruto como JSON em MQTT_TOPIC
+ * @tparam Imu Mpu6050Imu para anexar o objeto "mpu", ou NullImu
+ */
+template <class Imu>
+class MqttJsonSink {
+public:
+  bool begin() {
+    pinMode(ledMQTT, OUTPUT);
+    imu_.begin();
+
+    char clientId[24];
+    snprintf(clientId, sizeof(clientId), "ESP32-Voltz-%lx", (unsigned long)random(0xffff));
+    mqtt_.setServer(serverAddress, mqtt_port);
+    mqtt_.setClientId(clientId);
+    mqtt_.setWindow(MQTT_INFLIGHT_WINDOW);
+    mqtt_.setKeepAlive(MQTT_KEEPALIVE_S);
+    mqtt_.setReconnectInterval(RECONNECT_INTERVAL_MS);
+
+    // MAC da estação na ordem de transmissão (o efuse em uint64_t sai
+    // com os bytes invertidos no printf)
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    char topic[MQTT_LITE_TOPIC_BYTES];
+    snprintf(topic, sizeof(topic), "%s/%02x%02x%02x%02x%02x%02x", MQTT_CONFIG_TOPIC,
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    mqtt_.setSubscription(topic, &MqttJsonSink::onConfig, this);
+    Serial.printf("Configuração em campo: %s\n", topic);
+
+    // Âncora do boot, na outbox antes de qualquer frame: o que for
+    // capturado antes da primeira conexão já tem "as" conhecido
+    advanceAnchor();
+    return true;
+  }
+
+  void poll() {
+    // --- CONEXÃO, PUBACKs E ENVIO DA OUTBOX (não bloqueia) ---
+    mqtt_.loop();
+    if (mqtt_.connected() != wasConnected_) {
+      wasConnected_ = mqtt_.connected();
+      Serial.println(wasConnected_ ? "MQTT conectado!" : "MQTT desconectado");
+    }
+
+    // --- ÂNCORA DE TEMPO: associa o contador monotônico ao UTC ---
+    // Conectado, a cada TIME_ANCHOR_INTERVAL_MS; desconectado, só antes de
+    // o "dt" dos frames se aproximar do estouro (sem encher a outbox)
+    if (mqtt_.connected() ? timeBase_.anchorDue() : timeBase_.anchorExpiring()) {
+      advanceAnchor();
+    }
+
+    // Falhas que não couberam na outbox, na ordem em que ocorreram
+    CanMessage fault;
+    while (!faultBacklog_.empty() && publishFrame(MQTT_FAULT_TOPIC, *faultBacklog_.front(), 0)) {
+      faultBacklog_.pop(fault);
+    }
+  }
+
+  /**
+   * @brief Telemetria: entra na outbox se sobrar a reserva das falhas
+   * @details Durante uma queda curta os frames ficam na outbox e saem na
+   *          reconexão; com a outbox cheia são descartados (contador "mrj")
+   */
+  void write(const CanMessage &frame, const VehicleState &) {
+    // Sem SIGNAL_WINDOW_RAW, bateria e controlador só saem nas janelas
+    if (SIGNAL_WINDOWS && !SIGNAL_WINDOW_RAW &&
+        (frame.id == BASE_BATTERY_ID || frame.id == BASE_CONTROLLER_ID)) {
+      return;
+    }
+    publishFrame(MQTT_TOPIC, frame, MQTT_FAULT_RESERVE_BYTES);
+    mqtt_.loop();
+    vTaskDelay(0); // Cede tempo para a stack Wi-Fi processar
+  }
+
+  /**
+   * @brief Falha: QoS1 no tópico de falhas, pode usar a reserva da outbox
+   * @details Se nem a reserva couber, fica no backlog até o próximo poll()
+   */
+  void writeUrgent(const CanMessage &frame, const VehicleState &) {
+    if (!faultBacklog_.empty() || !publishFrame(MQTT_FAULT_TOPIC, frame, 0)) {
+      faultBacklog_.push(frame);
+    }
+    mqtt_.loop();
+  }
+
+  /**
+   * @brief Resumo da viagem ({"type":"trip"}), QoS1 no tópico principal
+   * @details Vai para a outbox mesmo desconectado: no key-off o Wi-Fi
+   *          costuma estar longe e o resumo sai quando a moto voltar
+   */
+  void writeTrip(const TripSummary &trip) {
+    char buffer[384];
+    int length = tripSummaryToJson(trip, buffer, sizeof(buffer));
+    if (length > 0 && length < (int)sizeof(buffer)) {
+      mqtt_.publish(MQTT_TOPIC, (const uint8_t *)buffer, length, 1);
+    }
+    mqtt_.loop();
+  }
+
+  /**
+   * @brief Janela mín/máx/média/último ({"type":"win"}), como a telemetria
+   * @details Também respeita a reserva das falhas; "dt"/"as" marcam o início
+   */
+  void writeWindow(const WindowRecord &record) {
+    char buffer[384];
+    int length = windowRecordToJson(record, timeBase_.deltaUs(record.startUs),
+                                     timeBase_.anchor().seq, buffer, sizeof(buffer));
+    if (length > 0 && length < (int)sizeof(buffer)) {
+      mqtt_.publish(MQTT_TOPIC, (const uint8_t *)buffer, length, 1, MQTT_FAULT_RESERVE_BYTES);
+    }
+    mqtt_.loop();
+  }
+
+  /**
+   * @brief Alarme de regra ({"type":"alarm"}): QoS1 no tópico de falhas
+   * @details Como as falhas, pode usar a reserva e vai para a outbox mesmo
+   *          desconectado
+   */
+  void writeAlarm(const RuleEvent &event) {
+    char buffer[192];
+    int length = ruleEventToJson(event, timeBase_.deltaUs(event.timestampUs),
+                                 timeBase_.anchor().seq, buffer, sizeof(buffer));
+    if (length > 0 && length < (int)sizeof(buffer)) {
+      mqtt_.publish(MQTT_FAULT_TOPIC, (const uint8_t *)buffer, length, 1);
+    }
+    mqtt_.loop();
+  }
+
+  void flush() { mqtt_.loop(); }
+
+  /**
+   * @brief Publica os contadores das filas e da outbox ({"type":"queue"})
+   */
+  void report(const LaneStatus &status) {
+    reportBus(status.bus); // Alarme de ausência fica na outbox mesmo desconectado
+    if (!mqtt_.connected()) return;
+
+    StaticJsonDocument<512> doc;
+    char buffer[448];
+    doc["type"] = "queue";
+    doc["pol"] = overloadPolicyName(status.policy);
+    doc["acc"] = status.telemetry.accepted;
+    doc["dn"] = status.telemetry.droppedNewest;
+    doc["do"] = status.telemetry.droppedOldest;
+    doc["sup"] = status.telemetry.superseded;
+    doc["sp"] = status.telemetry.spilled;
+    doc["spl"] = status.telemetry.spillLost;
+    doc["pend"] = status.telemetryPending;
+    doc["fd"] = status.faultDropped;
+    doc["mob"] = mqtt_.pending();              // Mensagens na outbox
+    doc["mrj"] = mqtt_.stats().rejected;       // Descartadas: outbox cheia
+    doc["mrt"] = mqtt_.stats().retransmitted;  // Reenviadas após queda
+    doc["bf"] = status.batch.batchFrames;      // Lote adaptativo (frames/ciclo)
+    doc["bi"] = status.batch.intervalMs;       // Intervalo entre ciclos
+    doc["br"] = status.batch.rateFps;          // Taxa limite do AIMD
+    doc["lat"] = status.batch.latencyUs / 1000; // Latência publish → PUBACK (ms)
+    doc["cfg"] = status.configVersion;         // Configuração em uso
+    doc["cfr"] = status.configRejected;        // Configurações recusadas
+    doc["flt"] = status.configFiltered;        // Fora do filtro de IDs
+    doc["db"] = status.deadbandHeld;           // Segurados pelo dead-band
+
+    size_t length = serializeJson(doc, buffer, sizeof(buffer));
+    mqtt_.publish(MQTT_TOPIC, (const uint8_t *)buffer, length, 0); // QoS0: só informativo
+  }
+
+  /**
+   * @brief Latência publish → PUBACK e frames recusados pela outbox cheia
+   */
+  void feedback(LinkFeedback &link) {
+    uint32_t latencyUs = mqtt_.latencyMs() * 1000UL;
+    if (latencyUs > link.latencyUs) link.latencyUs = latencyUs;
+    link.rejected += mqtt_.stats().rejected;
+  }
+
+  /**
+   * @brief Última configuração recebida, sobreposta à atual em update.config
+   * @details Campos ausentes mantêm o valor atual; "ids" e "db" presentes
+   *          substituem a lista inteira ([] / {} desligam o filtro)
+   * @return false se nada chegou desde a última chamada
+   */
+  bool receiveConfig(ConfigUpdate &update) {
+    if (configLength_ == 0) return false;
+    update.error = parseConfig((char *)configRx_, configLength_, update);
+    configLength_ = 0;
+    if (!update.error) validateRuntimeConfig(update.config, update.error);
+    return true;
+  }
+
+private:
+  /**
+   * @brief Handler da assinatura (dentro de mqtt_.loop()): guarda para
+   *        receiveConfig(); uma mensagem nova substitui a não lida
+   */
+  static void onConfig(void *context, const char *, size_t, const uint8_t *payload,
+                       size_t length) {
+    MqttJsonSink *self = static_cast<MqttJsonSink *>(context);
+    if (length == 0 || length >= sizeof(self->configRx_)) return; // Retido apagado
+    memcpy(self->configRx_, payload, length);
+    self->configRx_[length] = '\0';
+    self->configLength_ = length;
+  }
+
+  /**
+   * @brief JSON de configuração → update (sem validar limites)
+   * @return Campo recusado, ou NULL
+   */
+  const char *parseConfig(char *json, size_t length, ConfigUpdate &update) {
+    update.rules[0] = '\0';
+    // char*: zero-copy, as strings ficam em json e o documento só guarda os nós
+    if (deserializeJson(configDoc_, json, length)) return "json";
+    JsonObject root = configDoc_.as<JsonObject>();
+    if (root.isNull()) return "json";
+
+    RuntimeConfig &c = update.config;
+    // "ver" obrigatório: sem ele (ou 0) a configuração seria ignorada em
+    // silêncio como versão não maior; recusada, entra nas recusas
+    JsonVariant ver = root["ver"];
+    if (!ver.is<uint32_t>() || ver.as<uint32_t>() == 0) return "ver";
+    c.version = ver.as<uint32_t>();
+    c.transmitIntervalMs = root["tx"] | c.transmitIntervalMs;
+    c.batchFrames = root["batch"] | c.batchFrames;
+    c.reportIntervalMs = root["rep"] | c.reportIntervalMs;
+    c.heartbeatMs = root["hb"] | c.heartbeatMs;
+
+    if (root.containsKey("ids")) {
+      JsonArray ids = root["ids"];
+      if (ids.isNull() || ids.size() > CONFIG_MAX_FILTER_IDS) return "ids";
+      c.filterCount = 0;
+      for (JsonVariant id : ids) {
+        if (!id.is<uint32_t>()) return "ids";
+        c.filterIds[c.filterCount++] = id.as<uint32_t>();
+      }
+    }
+
+    if (root.containsKey("db")) {
+      JsonObject db = root["db"];
+      if (db.isNull()) return "db";
+      c.deadbandOn = false;
+      for (uint8_t s = 0; s < WINDOW_SIGNAL_COUNT; s++) c.deadband[s] = 0;
+      for (JsonPair band : db) {
+        uint8_t s = 0;
+        while (s < WINDOW_SIGNAL_COUNT && strcmp(band.key().c_str(), windowSignalName(s)) != 0) s++;
+        if (s == WINDOW_SIGNAL_COUNT || !band.value().is<float>()) return "db";
+        float scale = ruleSignalIsDeci(s) ? 10.0f : 1.0f;
+        c.deadband[s] = (int32_t)(band.value().as<float>() * scale + 0.5f);
+        c.deadbandOn = true;
+      }
+    }
+
+    const char *rules = root["rules"] | (const char *)NULL;
+    if (rules) {
+      size_t rulesLength = strlen(rules);
+      if (rulesLength == 0 || rulesLength > RULES_TEXT_MAX) return "rules";
+      memcpy(update.rules, rules, rulesLength + 1);
+    }
+    return NULL;
+  }
+
+  /**
+   * @brief Resumo do barramento; com ID ausente ou barramento calado vai
+   *        pelo tópico de falhas (QoS1, reserva da outbox)
+   */
+  void reportBus(const BusSummary &bus) {
+    if (bus.windowMs == 0) return; // Decodificação ainda sem resumo
+
+    StaticJsonDocument<1024> doc; // ~50 slots de 16 B (campos + 9 arrays de 3)
+    char buffer[512];
+    doc["type"] = "bus";
+    doc["load"] = bus.loadDeci;   // Carga (0,1%, sem bit stuffing)
+    doc["fps"] = bus.fps;
+    doc["ids"] = bus.ids;
+    doc["win"] = bus.windowMs;
+    doc["al"] = bus.alarms;       // Alarmes de ausência desde o boot
+    doc["rec"] = bus.recoveries;
+    doc["sil"] = bus.busSilent;
+    doc["sils"] = bus.silences;
+    doc["full"] = bus.tableFull;
+    JsonArray top = doc.createNestedArray("top"); // [id, frames/s, parcela 0,1%]
+    for (uint8_t i = 0; i < bus.topCount; i++) {
+      JsonArray talker = top.createNestedArray();
+      talker.add(bus.top[i].id);
+      talker.add(bus.top[i].fps);
+      talker.add(bus.top[i].shareDeci);
+    }
+    doc["nmiss"] = bus.missingCount;
+    JsonArray missing = doc.createNestedArray("miss"); // [id, ms sem o ID, período ms]
+    for (uint8_t i = 0; i < bus.missingCount && i < BUS_SUMMARY_MISSING; i++) {
+      JsonArray entry = missing.createNestedArray();
+      entry.add(bus.missing[i].id);
+      entry.add(bus.missing[i].silentMs);
+      entry.add(bus.missing[i].periodMs);
+    }
+
+    size_t length = serializeJson(doc, buffer, sizeof(buffer));
+    if (bus.missingCount > 0 || bus.busSilent) {
+      mqtt_.publish(MQTT_FAULT_TOPIC, (const uint8_t *)buffer, length, 1);
+    } else if (mqtt_.connected()) {
+      mqtt_.publish(MQTT_TOPIC, (const uint8_t *)buffer, length, 0, MQTT_FAULT_RESERVE_BYTES);
+    }
+  }
+
+  /**
+   * @brief Serializa o frame bruto (+ MPU) e coloca na outbox (QoS1)
+   * @param reserve Bytes da outbox que devem continuar livres
+   * @return false se não coube na outbox
+   */
+  bool publishFrame(const char *topic, const CanMessage &frame, size_t reserve) {
+    digitalWrite(ledMQTT, HIGH);
+
+    // Formato fixo, escrito direto no buffer (json_writer.h): dados do
+    // barramento CAN, bytes em hexadecimal ("AA BB ...") e o momento da
+    // captura como delta (µs) em relação à âncora "as", de onde o backend
+    // reconstrói o UTC
+    JsonWriter json(jsonBuffer_, sizeof(jsonBuffer_));
+    json.raw("{\"canId\":").u32(frame.id)
+        .raw(",\"ide\":").boolean(frame.isExtended)
+        .raw(",\"dlc\":").u32(frame.length)
+        .raw(",\"data\":").hex(frame.data, frame.length)
+        .raw(",\"dt\":").i32(timeBase_.deltaUs(frame.timestampUs))
+        .raw(",\"as\":").u32(timeBase_.anchor().seq);
+
+    // Dados do MPU-6050 no mesmo pacote (NullImu: nada)
+    imu_.appendTo(json);
+    json.raw("}");
+
+    int length = json.finish();
+    bool queued = length < (int)sizeof(jsonBuffer_) &&
+                  mqtt_.publish(topic, (const uint8_t *)jsonBuffer_, length, 1, reserve);
+
+    digitalWrite(ledMQTT, LOW);
+    return queued;
+  }
+
+  /**
+   * @brief Gera a próxima âncora e a coloca na outbox
+   * @details Só passa a valer se coube: a outbox é FIFO, então todo "as"
+   *          de um frame chega ao backend depois da própria âncora
+   */
+  void advanceAnchor() {
+    TimeAnchor next = timeBase_.nextAnchor();
+    if (publishTimeAnchor(next)) timeBase_.setAnchor(next);
+  }
+
+  /**
+   * @brief Publica uma âncora de tempo (contador monotônico → UTC)
+   * @details Vai no mesmo tópico dos frames, permitindo ao backend converter
+   *          os deltas "dt" em horário absoluto
+   * @return false se não coube na outbox
+   */
+  bool publishTimeAnchor(const TimeAnchor &anchor) {
+    StaticJsonDocument<192> doc;
+    char buffer[192];
+    doc["type"] = "anchor";
+    doc["as"] = anchor.seq;
+    doc["mono"] = anchor.monoUs;           // µs desde o boot
+    doc["utc"] = anchor.utcUs / 1000LL;    // ms desde epoch
+    doc["ppm"] = anchor.driftPpm;          // Desvio estimado (slew do NTP)
+    doc["sync"] = anchor.synced;
+    doc["step"] = anchor.stepped;
+
+    size_t length = serializeJson(doc, buffer, sizeof(buffer));
+    return mqtt_.publish(MQTT_TOPIC, (const uint8_t *)buffer, length, 1);
+  }
+
+  MqttLite<WifiTransport, MQTT_OUTBOX_BYTES> mqtt_;
+  bool wasConnected_ = false;
+  TimeBase timeBase_; // Frames levam apenas o delta em relação à última âncora UTC
+  Imu imu_;
+  FaultBacklog faultBacklog_;
+  char jsonBuffer_[512];
+  uint8_t configRx_[MQTT_LITE_RX_BYTES + 1]; // Configuração recebida, ainda não lida
+  size_t configLength_ = 0;
+  StaticJsonDocument<1024> configDoc_; // ~60 nós de 16 B (16 IDs + 8 faixas + campos)
+};
+
+#endif // SINK_MQTT_H
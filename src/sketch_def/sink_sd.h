@@ -0,0 +1,151 @@
+#ifndef SINK_SD_H
+#define SINK_SD_H
+
+// ------------------------------------------------------------------
+// --- SINK: CSV DECODIFICADO NO CARTÃO SD ---
+// ------------------------------------------------------------------
+// Mesmas colunas do SDRecorder de esp32_mqtt_sd_.cpp:
+// timestamp,modo,rpm,torque,tensao,corrente,soc,tBat,tMotor,tCtrl
+//
+// As linhas vão para um log circular em blocos com sequência e CRC
+// (block_log.h): o cartão nunca enche, guarda as horas mais recentes e um
+// corte de energia perde no máximo o bloco que estava sendo gravado.
+// Os resumos de viagem (TRIP_STATS) vão para SD_TRIP_FILE, uma linha por
+// viagem, e os alarmes das regras (RULE_ENGINE) para SD_ALARM_FILE, fora
+// do log circular para não serem sobrescritos. As linhas saem por
+// CsvWriter (csv_writer.h), iguais byte a byte às do printf de antes; a
+// do estado é formatada direto no bloco em montagem do log.
+
+#include <Arduino.h>
+#include "FS.h"
+#include "SD.h"
+#include "SPI.h"
+#include "firmware_config.h"
+#include "../common/can_message.h"
+#include "../common/priority_lanes.h"
+#include "../common/block_log.h"
+#include "../common/csv_writer.h"
+#include "../common/rule_engine.h"
+#include "../common/runtime_config.h"
+#include "../common/time_base.h"
+#include "../common/trip_stats.h"
+#include "../common/vehicle_state.h"
+
+#define SD_STATE_LINE_MAX 128 // Linha do estado com todos os campos no extremo
+#define SD_TRIP_LINE_MAX 256
+#define SD_ALARM_LINE_MAX 96
+
+class SdCsvSink {
+public:
+  bool begin() {
+    if (!SD.begin(SD_CS_PIN)) {
+      Serial.println("ERRO: Falha ao montar cartão SD");
+      return false;
+    }
+    // Arquivo alocado no primeiro boot; nos seguintes só o fim é conferido
+    uint32_t start = millis();
+    if (!log_.begin(SD_LOG_FILE, SD_LOG_BLOCKS)) {
+      Serial.println("ERRO: Falha ao abrir o log em blocos no SD");
+      return false;
+    }
+    const BlockLogStats &s = log_.stats();
+    Serial.printf("Log SD: bloco %lu retomado em %lu ms (%lu leituras, %lu descartados%s)\n",
+                  (unsigned long)log_.lastSequence(), (unsigned long)(millis() - start),
+                  (unsigned long)s.recoveryReads, (unsigned long)s.recoveryDropped,
+                  s.recoveryFullScan ? ", varredura completa" : "");
+    return true;
+  }
+
+  void poll() {}
+
+  /**
+   * @brief Grava o estado após cada frame de bateria/controlador
+   */
+  void write(const CanMessage &frame, const VehicleState &state) {
+    if (frame.id != BASE_BATTERY_ID && frame.id != BASE_CONTROLLER_ID) return;
+
+    uint32_t ms = TimeBase::stampMillis(frame.timestampUs); // millis() da captura
+    if (log_.available() >= SD_STATE_LINE_MAX) {
+      int length = vehicleStateToCsv(state, ms, log_.cursor(), SD_STATE_LINE_MAX);
+      if (length > 0) log_.commit(length);
+      return;
+    }
+    // Fim do bloco: pela cópia, que grava o bloco e começa outro
+    char line[SD_STATE_LINE_MAX];
+    int length = vehicleStateToCsv(state, ms, line, sizeof(line));
+    if (length > 0) log_.write(line, length);
+  }
+
+  /**
+   * @brief Falha: garante no cartão o que foi gravado até ela
+   * @note O CSV decodificado não tem colunas de falha
+   */
+  void writeUrgent(const CanMessage &frame, const VehicleState &state) {
+    write(frame, state);
+    sync();
+  }
+
+  /**
+   * @brief Fim do lote: garante os dados no cartão a cada SD_LOG_SYNC_INTERVAL_MS
+   * @details Cada sync fecha o bloco em montagem e regrava a entrada de
+   *          diretório; a cada ciclo de envio (50 ms) isso multiplicava as
+   *          gravações e deixaria blocos quase vazios
+   */
+  void flush() {
+    if (millis() - lastSyncMs_ >= SD_LOG_SYNC_INTERVAL_MS) sync();
+  }
+
+  /**
+   * @brief Acrescenta a viagem em SD_TRIP_FILE (cabeçalho no arquivo novo)
+   */
+  void writeTrip(const TripSummary &t) {
+    bool fresh = !SD.exists(SD_TRIP_FILE);
+    File file = SD.open(SD_TRIP_FILE, FILE_APPEND);
+    if (!file) {
+      Serial.println("ERRO: Falha ao abrir o arquivo de viagens no SD");
+      return;
+    }
+    if (fresh) {
+      file.println("viagem,fim_ms,duracao_ms,consumo_mwh,regen_mwh,pico_w,pico_regen_w,media_w,"
+                   "distancia_m,rpm_max,tMotor_max,tCtrl_max,tBat_max,tensao_min,soc_ini,soc_fim,"
+                   "eco_ms,std_ms,turbo_ms,outro_ms");
+    }
+    char line[SD_TRIP_LINE_MAX];
+    int length = tripSummaryToCsv(t, millis(), line, sizeof(line));
+    if (length > 0) file.write((const uint8_t *)line, length);
+    file.close();
+  }
+
+  void writeWindow(const WindowRecord &) {} // O cartão já guarda todos os frames brutos
+
+  /**
+   * @brief Acrescenta a transição em SD_ALARM_FILE (cabeçalho no arquivo novo)
+   */
+  void writeAlarm(const RuleEvent &e) {
+    bool fresh = !SD.exists(SD_ALARM_FILE);
+    File file = SD.open(SD_ALARM_FILE, FILE_APPEND);
+    if (!file) {
+      Serial.println("ERRO: Falha ao abrir o arquivo de alarmes no SD");
+      return;
+    }
+    if (fresh) file.println("ms,regra,sinal,ativo,valor,limiar");
+    char line[SD_ALARM_LINE_MAX];
+    int length = ruleEventToCsv(e, millis(), line, sizeof(line));
+    if (length > 0) file.write((const uint8_t *)line, length);
+    file.close();
+  }
+  void report(const LaneStatus &) {}
+  void feedback(LinkFeedback &) {}
+  bool receiveConfig(ConfigUpdate &) { return false; }
+
+private:
+  void sync() {
+    log_.flush();
+    lastSyncMs_ = millis();
+  }
+
+  BlockLog<> log_;
+  uint32_t lastSyncMs_ = 0;
+};
+
+#endif // SINK_SD_H
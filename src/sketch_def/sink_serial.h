@@ -0,0 +1,120 @@
+#ifndef SINK_SERIAL_H
+#define SINK_SERIAL_H
+
+// ------------------------------------------------------------------
+// --- SINK: DEPURAÇÃO NA SERIAL (DEBUGMODE) ---
+// ------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "../common/can_message.h"
+#include "../common/hex_codec.h"
+#include "../common/priority_lanes.h"
+#include "../common/rule_engine.h"
+#include "../common/runtime_config.h"
+#include "../common/signal_window.h"
+#include "../common/trip_stats.h"
+#include "../common/vehicle_state.h"
+
+class SerialDebugSink {
+public:
+  bool begin() { return true; }
+  void poll() {}
+
+  void write(const CanMessage &frame, const VehicleState &) {
+    print("", frame);
+  }
+
+  void writeUrgent(const CanMessage &frame, const VehicleState &) {
+    print("[FALHA] ", frame);
+  }
+
+  void writeTrip(const TripSummary &t) {
+    Serial.printf("[VIAGEM] #%lu %lus consumo=%lu.%03luWh regen=%lu.%03luWh pico=%ldW "
+                  "pico_regen=%ldW media=%ldW dist=%lum rpm_max=%ld tM=%ld tC=%ld tB=%ld "
+                  "soc=%ld->%ld ECO=%lus STD=%lus TURBO=%lus\n",
+                  (unsigned long)t.number, (unsigned long)(t.durationMs / 1000),
+                  (unsigned long)(t.consumedMilliWh / 1000), (unsigned long)(t.consumedMilliWh % 1000),
+                  (unsigned long)(t.regenMilliWh / 1000), (unsigned long)(t.regenMilliWh % 1000),
+                  (long)t.peakPowerW, (long)t.peakRegenW, (long)t.avgPowerW,
+                  (unsigned long)t.distanceM, (long)t.maxRpm, (long)t.maxMotorTemp,
+                  (long)t.maxControllerTemp, (long)t.maxBatteryTemp, (long)t.socStart,
+                  (long)t.socEnd, (unsigned long)(t.modeMs[TRIP_MODE_ECO] / 1000),
+                  (unsigned long)(t.modeMs[TRIP_MODE_STD] / 1000),
+                  (unsigned long)(t.modeMs[TRIP_MODE_TURBO] / 1000));
+  }
+
+  void writeWindow(const WindowRecord &w) {
+    Serial.printf("[JANELA] %lums modo=%u", (unsigned long)w.periodMs, (unsigned)w.mode);
+    for (uint8_t s = 0; s < WINDOW_SIGNAL_COUNT; s++) {
+      const WindowStats &x = w.signals[s];
+      if (x.count == 0) continue;
+      Serial.printf(" %s=%ld/%ld/%ld/%ld", windowSignalName(s), (long)x.min, (long)x.max,
+                    (long)x.mean, (long)x.last);
+    }
+    Serial.println();
+  }
+
+  void writeAlarm(const RuleEvent &e) {
+    Serial.printf("[ALARME] regra %u %s %s valor=%ld limiar=%ld\n", (unsigned)e.ruleId,
+                  windowSignalName(e.signal), e.active ? "ATIVO" : "normalizado",
+                  (long)e.value, (long)e.threshold);
+  }
+
+  void flush() {}
+
+  void feedback(LinkFeedback &) {}
+  bool receiveConfig(ConfigUpdate &) { return false; }
+
+  void report(const LaneStatus &status) {
+    const OverloadStats &t = status.telemetry;
+    Serial.printf("[FILA] %s recebidos=%lu perdidos=%lu (novos=%lu antigos=%lu "
+                  "substituidos=%lu spill_falha=%lu) spill=%lu pendentes=%lu falhas_perdidas=%lu\n",
+                  overloadPolicyName(status.policy), (unsigned long)t.accepted,
+                  (unsigned long)t.lost(), (unsigned long)t.droppedNewest,
+                  (unsigned long)t.droppedOldest, (unsigned long)t.superseded,
+                  (unsigned long)t.spillLost, (unsigned long)t.spilled,
+                  (unsigned long)status.telemetryPending,
+                  (unsigned long)status.faultDropped);
+    const BatchMetrics &b = status.batch;
+    Serial.printf("[ENVIO] lote=%u intervalo=%lums taxa=%lu/s entregues=%lu/s "
+                  "latencia=%lums base=%lums reducoes=%lu\n",
+                  b.batchFrames, (unsigned long)b.intervalMs, (unsigned long)b.rateFps,
+                  (unsigned long)b.throughputFps, (unsigned long)(b.latencyUs / 1000),
+                  (unsigned long)(b.baseLatencyUs / 1000), (unsigned long)b.decreases);
+    Serial.printf("[CONFIG] versao=%lu recusadas=%lu fora_do_filtro=%lu deadband=%lu\n",
+                  (unsigned long)status.configVersion, (unsigned long)status.configRejected,
+                  (unsigned long)status.configFiltered, (unsigned long)status.deadbandHeld);
+    const BusSummary &bus = status.bus;
+    if (bus.windowMs == 0) return; // Decodificação ainda sem resumo
+    Serial.printf("[BARRAMENTO] carga=%u.%u%% taxa=%lu/s ids=%u alarmes=%lu voltaram=%lu%s top:",
+                  bus.loadDeci / 10, bus.loadDeci % 10, (unsigned long)bus.fps, bus.ids,
+                  (unsigned long)bus.alarms, (unsigned long)bus.recoveries,
+                  bus.busSilent ? " CALADO" : "");
+    for (uint8_t i = 0; i < bus.topCount; i++) {
+      Serial.printf(" 0x%lX=%lu/s", (unsigned long)bus.top[i].id, (unsigned long)bus.top[i].fps);
+    }
+    for (uint8_t i = 0; i < bus.missingCount && i < BUS_SUMMARY_MISSING; i++) {
+      Serial.printf(" AUSENTE 0x%lX ha %lums (periodo %lums)", (unsigned long)bus.missing[i].id,
+                    (unsigned long)bus.missing[i].silentMs, (unsigned long)bus.missing[i].periodMs);
+    }
+    Serial.println();
+  }
+
+private:
+  void print(const char *prefix, const CanMessage &frame) {
+    char data[1 + sizeof(frame.data) * 3];
+    uint8_t length = 0;
+    if (frame.length > 0) {
+      data[length++] = ' ';
+      length += hexEncodeSpaced(data + length, frame.data,
+                                frame.length < sizeof(frame.data) ? frame.length : sizeof(frame.data));
+    }
+    data[length] = '\0';
+    Serial.printf("%s[%lu] ID: 0x%lX %s DLC: %u Data:%s",
+                  prefix, (unsigned long)frame.timestampUs, (unsigned long)frame.id,
+                  frame.isExtended ? "E" : "S", frame.length, data);
+    Serial.println();
+  }
+};
+
+#endif // SINK_SERIAL_H
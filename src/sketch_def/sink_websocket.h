@@ -0,0 +1,126 @@
+#ifndef SINK_WEBSOCKET_H
+#define SINK_WEBSOCKET_H
+
+// ------------------------------------------------------------------
+// --- SINK: WEBSOCKET EM LOTE BINÁRIO ---
+// ------------------------------------------------------------------
+// Mesmo formato do esp32_WebSocket_RealTime_ok.cpp (can_batch_codec.h),
+// decodificado no backend por utils/canBatchCodec.js.
+
+#include <Arduino.h>
+#include <WebSocketsClient.h>   // WebSockets by Markus Sattler
+#include "firmware_config.h"
+#include "../common/can_batch_codec.h"
+#include "../common/can_message.h"
+#include "../common/priority_lanes.h"
+#include "../common/runtime_config.h"
+#include "../common/vehicle_state.h"
+
+#define WS_BATCH_MAX_FRAMES 100 // Frames por mensagem binária (1305 bytes)
+
+class WebSocketBatchSink {
+public:
+  WebSocketBatchSink()
+      : batch_(batchBuffer_, sizeof(batchBuffer_)),
+        urgent_(urgentBuffer_, sizeof(urgentBuffer_)) {}
+
+  bool begin() {
+    webSocket_.begin(serverAddress, wsPort, "/");
+    webSocket_.onEvent([this](WStype_t type, uint8_t *payload, size_t length) {
+      onEvent(type, payload, length);
+    });
+    webSocket_.setReconnectInterval(RECONNECT_INTERVAL_MS);
+    return true;
+  }
+
+  void poll() {
+    webSocket_.loop();
+
+    // Falhas ocorridas durante a desconexão
+    CanMessage fault;
+    while (webSocket_.isConnected() && faultBacklog_.pop(fault)) {
+      sendUrgent(fault);
+    }
+  }
+
+  void write(const CanMessage &frame, const VehicleState &) {
+    if (!webSocket_.isConnected()) return;
+    if (!batch_.add(frame.id, frame.isExtended, frame.data, frame.length)) {
+      // Lote cheio: envia e recomeça com o frame atual
+      flush();
+      batch_.add(frame.id, frame.isExtended, frame.data, frame.length);
+    }
+  }
+
+  /**
+   * @brief Falha: enviada na hora em um lote próprio de um frame
+   */
+  void writeUrgent(const CanMessage &frame, const VehicleState &) {
+    if (!webSocket_.isConnected()) {
+      faultBacklog_.push(frame);
+      return;
+    }
+    sendUrgent(frame);
+  }
+
+  /**
+   * @brief Envia o lote acumulado como uma única mensagem binária
+   */
+  void flush() {
+    if (batch_.empty()) return;
+    if (webSocket_.isConnected()) {
+      // sendBIN só retorna com o lote entregue ao TCP: a duração é a
+      // latência de envio (média móvel com peso 1/4)
+      uint32_t start = micros();
+      webSocket_.sendBIN(batch_.data(), batch_.length());
+      int32_t delta = (int32_t)(micros() - start) - (int32_t)sendLatencyUs_;
+      sendLatencyUs_ = (uint32_t)((int32_t)sendLatencyUs_ + delta / 4);
+    }
+    batch_.reset();
+  }
+
+  void writeTrip(const TripSummary &) {} // Painel ao vivo: sem resumo de viagem
+  void writeWindow(const WindowRecord &) {} // Nem janelas: o painel recebe os frames
+  void writeAlarm(const RuleEvent &) {}      // Perfil sem decodificação: sem regras
+  void report(const LaneStatus &) {}
+
+  void feedback(LinkFeedback &link) {
+    if (sendLatencyUs_ > link.latencyUs) link.latencyUs = sendLatencyUs_;
+  }
+
+  bool receiveConfig(ConfigUpdate &) { return false; } // Configuração só pelo MQTT
+
+private:
+  void sendUrgent(const CanMessage &frame) {
+    urgent_.reset();
+    urgent_.add(frame.id, frame.isExtended, frame.data, frame.length);
+    webSocket_.sendBIN(urgent_.data(), urgent_.length());
+  }
+
+  void onEvent(WStype_t type, uint8_t *payload, size_t length) {
+    switch (type) {
+      case WStype_DISCONNECTED:
+        Serial.println("[WSc] Disconnected!");
+        break;
+      case WStype_CONNECTED:
+        Serial.printf("[WSc] Connected to url: %s\n", (char *)payload);
+        webSocket_.sendTXT("ESP32 Conectado ao WebSocket!");
+        break;
+      case WStype_ERROR:
+        Serial.printf("[WSc] Error: %.*s\n", (int)length, (char *)payload);
+        break;
+      default:
+        break;
+    }
+  }
+
+  WebSocketsClient webSocket_;
+  uint8_t batchBuffer_[CAN_BATCH_BUFFER_SIZE(WS_BATCH_MAX_FRAMES)];
+  CanBatchWriter batch_;
+  uint8_t urgentBuffer_[CAN_BATCH_BUFFER_SIZE(1)];
+  CanBatchWriter urgent_;
+  FaultBacklog faultBacklog_;
+  uint32_t sendLatencyUs_ = 0;
+};
+
+#endif // SINK_WEBSOCKET_H
@@ -1,268 +1,377 @@
 // ------------------------------------------------------------------
 // --- BIBLIOTECAS ---
 // ------------------------------------------------------------------
-#include <ESP32-TWAI-CAN.hpp> 
-#include <PubSubClient.h>      
-#include <WiFi.h>              
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
 #include <freertos/task.h>
-#include <ArduinoJson.h>  
-#include "time.h"
-#include <Wire.h>              // Biblioteca I2C para o MPU-6050
-#include <MPU6050.h>           // Biblioteca do MPU-6050 (instale via Library Manager)
 #include "../../config/constants.h"
-
-// ------------------------------------------------------------------
-// --- CONFIGURAÇÕES DE PINOS E REDE ---
-// ------------------------------------------------------------------
-#define CAN_TX_PIN 2
-#define CAN_RX_PIN 15
-#define ledCAN 16
-#define ledMQTT 17
-
-// Pinos I2C para o MPU-6050 (ESP32 padrão: SDA=21, SCL=22)
-// Altere conforme sua ligação física
-#define I2C_SDA 16
-#define I2C_SCL 17
-
-#define TESTMODE true  // Se true, gera dados aleatórios para teste sem hardware CAN
-#define DEBUGMODE false
-#define BufferSize 250  // Buffer aumentado para evitar perda em latências de rede
-
-const char *ssid = "Salvacao_2_conto";
-const char *password = "mimda2conto";
-const char *serverAddress = "192.168.1.47";
-const char* MQTT_TOPIC = "moto/telemetria";
-const int mqtt_port = 31883;
-
-const TwaiSpeed CAN_SPEED = TWAI_SPEED_250KBPS;
-
-// Configurações do Fuso Horário (Brasil - Pernambuco)
-const char* ntpServer = "pool.ntp.org";
-const long gmtOffset_sec = -3 * 3600; 
-const int daylightOffset_sec = 0;      
-
-// Intervalo que a Task MQTT acorda para limpar a fila (50ms)
-const TickType_t TRANSMIT_INTERVAL = pdMS_TO_TICKS(50);
+#include "firmware_config.h"
+#include "profiles.h"  // Escolhe fonte, filtro, decodificador e sinks (VOLTZ_PROFILE)
+#include "../common/adaptive_batch.h"
+#include "../common/boot_timeline.h"
+#include "../common/bus_stats.h"
+#include "../common/frame_pool.h"
+#include "../common/priority_lanes.h"
+#include "../common/rcu_cell.h"
+#include "../common/rule_engine.h"
+#include "../common/runtime_config.h"
+#include "../common/spsc_ring.h"
+#include "../common/time_base.h"
+#if PROFILE_HAS_SD
+#include "../common/file_spill.h"
+#endif
+
+// O lote adaptativo só vale quando todos os sinks dão retorno do enlace.
+// O SD não dá: limitado pelo MQTT, o cartão perderia para a política de
+// sobrecarga justo as linhas de quando a rede cai. Com SD a fila é
+// esvaziada a cada ciclo e o excesso do MQTT fica nas recusas da outbox
+#define UPLINK_ADAPTIVE (ADAPTIVE_BATCH && !PROFILE_HAS_SD)
 
 // ------------------------------------------------------------------
 // --- ESTRUTURAS E VARIÁVEIS GLOBAIS ---
 // ------------------------------------------------------------------
 
-struct CanMessage {
-  uint32_t id;
-  uint8_t data[8];
-  uint8_t length;
-  bool isExtended;
-  int64_t timestamp; // Armazena o momento exato da leitura do CAN
-};
-
-WiFiClient espClient;
-PubSubClient client(espClient);
-QueueHandle_t canRawQueue;
-
-// Instância do MPU-6050
-MPU6050 mpu;
-
-// Variáveis para armazenar leituras do MPU-6050
-int16_t ax, ay, az;  // Acelerômetro (raw)
-int16_t gx, gy, gz;  // Giroscópio (raw)
-float ax_g, ay_g, az_g;  // Acelerômetro em g (gravidade)
-float gx_dps, gy_dps, gz_dps;  // Giroscópio em graus/segundo
+// Pipeline do perfil ativo: chamadas entre estágios resolvidas na compilação
+ActiveProfile::Pipe pipeline;
+ActiveProfile::Link networkLink;
+
+// Frames aceitos pela decodificação, alocados no boot: as lanes (filas do
+// FreeRTOS) levam só o handle, e o envio devolve o slot (release())
+StaticFramePool<FRAME_POOL_SIZE> framePool;
+
+// Captura → decodificação: ring lock-free (um produtor, um consumidor).
+// Leva o frame por cópia: 20 B sem trava custam menos que os dois CAS do pool
+SpscRing<CanMessage, CAPTURE_RING_SIZE> captureRing;
+volatile uint32_t captureOverruns = 0; // Frames perdidos com o ring cheio
+TaskHandle_t decodeTaskHandle = NULL;
+
+// Duas lanes da decodificação ao envio: falhas (sempre primeiro) e telemetria
+PriorityLanes canLanes;
+#if PROFILE_HAS_SD
+FileSpill canSpill; // Excesso da fila de telemetria no cartão (OVERLOAD_SPILL)
+#endif
+
+// Lote e intervalo da task de envio (UPLINK_ADAPTIVE)
+AdaptiveBatch uplinkBatch;
+
+// Tempo do boot até a captura, o primeiro frame, a rede e o primeiro envio
+BootTimeline bootTimeline;
+
+// Estatística por ID (só a task de decodificação mexe; ~3 KB, fora da stack)
+// e o último resumo, copiado para a task de envio
+BusStats<BUS_STATS_CAPACITY> busStats;
+SeqLockValue<BusSummary> busSummary;
+volatile uint32_t busSummaryCount = 0; // Resumos publicados
+volatile uint32_t busAlarmCount = 0;   // Resumos publicados por alarme/recuperação
+
+// Regras de alarme: dois programas alternados, recompila-se o que a task
+// de decodificação não está usando (RULE_ENGINE)
+RuleProgram<RULE_CAPACITY> rulePrograms[2];
+
+// Configuração em campo: lida sem lock pelas tasks de decodificação e de
+// envio (um leitor cada), trocada pela de envio quando chega pelo MQTT
+enum ConfigReader { CONFIG_READER_DECODE, CONFIG_READER_UPLINK, CONFIG_READERS };
+RcuCell<RuntimeConfig, CONFIG_READERS> runtimeConfig;
+ConfigUpdate configUpdate; // ~1 KB de regras: fora da stack da task de envio
+uint32_t configRejected = 0;
+volatile uint32_t configFiltered = 0; // Escritos pela decodificação
+volatile uint32_t deadbandHeld = 0;
 
 // ------------------------------------------------------------------
-// --- FUNÇÕES AUXILIARES ---
+// --- TAREFAS (FREERTOS) ---
 // ------------------------------------------------------------------
 
 /**
- * @brief Reconecta ao broker MQTT caso a conexão seja perdida
+ * @brief Estágio 1, Core 0: Leitura de Alta Velocidade do barramento CAN
+ * @details Só lê e carimba o timestamp monotônico; o frame segue sem
+ *          trava pelo ring e a task de decodificação é acordada
  */
-void reconnectMQTT() {
-  if (WiFi.status() != WL_CONNECTED) return;
-
-  while (!client.connected()) {
-    Serial.print("Tentando conectar MQTT...");
-    String clientId = "ESP32-Voltz-";
-    clientId += String(random(0xffff), HEX);
-    
-    if (client.connect(clientId.c_str())) {
-      Serial.println("Conectado!");
-    } else {
-      Serial.print("falha, rc=");
-      Serial.print(client.state());
-      Serial.println(" tentando novamente em 2s");
-      vTaskDelay(pdMS_TO_TICKS(2000));
+void canSourceTask(void* pvParameters) {
+  bool firstFrame = true;
+  for (;;) {
+    CanMessage frame;
+
+    if (pipeline.capture(frame)) {
+      if (firstFrame) {
+        bootTimeline.mark(BOOT_FIRST_FRAME);
+        firstFrame = false;
+      }
+      if (captureRing.push(frame)) {
+        xTaskNotifyGive(decodeTaskHandle);
+      } else {
+        captureOverruns++;
+      }
     }
+    vTaskDelay(0); // Cede tempo para o IDLE do Core 0 (evita starvation)
   }
 }
 
 /**
- * @brief Lê os dados do MPU-6050 e converte para unidades físicas
- * @note Deve ser chamado apenas pela task MQTT para evitar conflito no barramento I2C
+ * @brief Estágio 2: decodifica o frame e decide se ele segue para o envio
+ * @details Filtro e dead-band da configuração só limitam o envio: viagem,
+ *          janelas e regras já viram o frame
  */
-void readMPU6050() {
-  // Lê valores brutos do sensor
-  mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
-  
-  // Converte acelerômetro: raw (±2g padrão) → valor em g (gravidade)
-  // Fórmula: valor_raw / 16384 = g (para escala ±2g)
-  ax_g = ax / 16384.0;
-  ay_g = ay / 16384.0;
-  az_g = az / 16384.0;
-  
-  // Converte giroscópio: raw (±250°/s padrão) → graus por segundo
-  // Fórmula: valor_raw / 131 = °/s (para escala ±250°/s)
-  gx_dps = gx / 131.0;
-  gy_dps = gy / 131.0;
-  gz_dps = gz / 131.0;
+bool forwardFrame(const CanMessage& frame, const RuntimeConfig& config, DeadbandGate& deadband) {
+  if (!pipeline.prepare(frame)) return false;
+  if (!runtimeConfigAccepts(config, frame)) {
+    configFiltered++;
+    return false;
+  }
+  if (!deadband.pass(config, frame, pipeline.decodedState())) {
+    deadbandHeld = deadband.suppressed();
+    return false;
+  }
+  return true;
 }
 
-// ------------------------------------------------------------------
-// --- TAREFAS (FREERTOS) ---
-// ------------------------------------------------------------------
-
 /**
- * @brief Task Core 0: Leitura de Alta Velocidade do barramento CAN
- * @details Captura frames CAN e os envia para a fila com timestamp preciso
+ * @brief Estágio 2, Core 0: filtro + decodificador do perfil
+ * @details Esvazia o ring a cada notificação da captura; frames aceitos
+ *          vão para a lane da sua prioridade (falhas / telemetria). Todo
+ *          frame capturado (antes do filtro) alimenta a estatística do
+ *          barramento; a espera tem prazo para que um barramento mudo
+ *          também seja cobrado (e a viagem encerrada no key-off). Um
+ *          alarme ou recuperação publica o resumo na hora; fora isso, a
+ *          cada reportIntervalMs. O filtro de IDs e o dead-band da
+ *          configuração em campo valem a partir do despertar seguinte à troca.
+ *          Só o frame aceito ganha um slot do pool, e o handle passa às lanes
  */
-void canSourceTask(void* pvParameters) {
+void decodeTask(void* pvParameters) {
+  CanMessage frame;
+  DeadbandGate deadband;
+  BusStatsConfig busConfig;
+  busConfig.bitrate = CAN_BITRATE;
+  busConfig.missPeriods = BUS_MISS_PERIODS;
+  busConfig.busSilentUs = BUS_SILENT_MS * 1000UL;
+  busStats.begin(busConfig);
+  uint32_t lastCheckUs = TimeBase::stamp();
+  uint32_t lastSummaryUs = lastCheckUs;
+
   for (;;) {
-    CanMessage frame;
-    bool hasData = false;
-
-    if (TESTMODE) {
-      // --- MODO SIMULAÇÃO: Gera dados aleatórios para teste ---
-      frame.id = (random(0, 2) == 0) ? BASE_BATTERY_ID : BASE_CONTROLLER_ID;
-      frame.length = 8;
-      frame.isExtended = false;
-      for (int i = 0; i < 8; i++) {
-        if (i == 5) {
-          int choice = random(0, 3);  
-          switch (choice) {
-            case 0: frame.data[i] = 0x45; break;
-            case 1: frame.data[i] = 0x4D; break;
-            case 2: frame.data[i] = 0x55; break;
-          }
-        } else {
-          frame.data[i] = random(0, 255);
-        }
-      }
-      
-      // Timestamp da simulação usando gettimeofday
-      struct timeval tv_now;
-      gettimeofday(&tv_now, NULL);
-      frame.timestamp = (int64_t)tv_now.tv_sec * 1000LL + (tv_now.tv_usec / 1000LL);
-      
-      hasData = true;
-      vTaskDelay(pdMS_TO_TICKS(20)); // Simula intervalo entre frames
-    } else {
-      CanFrame rx;
-      // Tenta ler um frame CAN com timeout de 10ms
-      if (ESP32Can.readFrame(rx, 10)) {
-        digitalWrite(ledCAN, !digitalRead(ledCAN)); 
-        
-        // CAPTURA DO TIMESTAMP NO MOMENTO EXATO DA CHEGADA DO FRAME
-        struct timeval tv_now;
-        gettimeofday(&tv_now, NULL);
-        frame.timestamp = (int64_t)tv_now.tv_sec * 1000LL + (tv_now.tv_usec / 1000LL);
-
-        frame.id = rx.identifier;
-        frame.length = rx.data_length_code;
-        frame.isExtended = rx.extd;
-        memcpy(frame.data, rx.data, rx.data_length_code);
-        hasData = true;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(BUS_CHECK_INTERVAL_MS));
+    const RuntimeConfig& config = *runtimeConfig.read(CONFIG_READER_DECODE);
+    bool busEvent = false;
+    while (captureRing.pop(frame)) {
+      if (busStats.record(frame) == BUS_EVENT_RECOVERED) busEvent = true;
+      if (!forwardFrame(frame, config, deadband)) continue;
+      FrameHandle handle = framePool.acquire();
+      if (handle == FRAME_NONE) continue; // Pool esgotado (exhausted())
+      framePool.frame(handle) = frame;
+      if (!canLanes.push(handle)) {
+        if (DEBUGMODE) Serial.println("Fila de processamento cheia!");
       }
     }
 
-    // Envia frame para a fila de processamento (Core 1)
-    if (hasData) {
-      if (xQueueSend(canRawQueue, &frame, 0) != pdTRUE) {
-        if (DEBUGMODE) Serial.println("Fila de processamento cheia!");
-      }
+    uint32_t nowUs = TimeBase::stamp();
+    if (nowUs - lastCheckUs >= BUS_CHECK_INTERVAL_MS * 1000UL) {
+      lastCheckUs = nowUs;
+      if (busStats.checkMissing(nowUs) > 0) busEvent = true;
+      pipeline.tick(nowUs); // Key-off e janelas encerradas sem frames novos
+    }
+    if (busEvent || nowUs - lastSummaryUs >= config.reportIntervalMs * 1000UL) {
+      lastSummaryUs = nowUs;
+      BusSummary summary;
+      busStats.summarize(nowUs, summary);
+      busSummary.write(summary);
+      busSummaryCount++;
+      if (busEvent) busAlarmCount++;
     }
-    vTaskDelay(0); // Cede tempo para o IDLE do Core 0 (evita starvation)
   }
 }
 
 /**
- * @brief Task Core 1: Gestão Wi-Fi, Leitura MPU-6050 e Publicação MQTT em Lote
- * @details Processa frames da fila CAN, lê sensor MPU-6050 e publica JSON no MQTT
+ * @brief Entrega imediata de todas as falhas e alarmes de regras pendentes
  */
-void mqttPublisherTask(void* pvParameters) {
-  CanMessage rawFrame;
-  char jsonBuffer[512];  // Buffer aumentado para incluir dados do MPU-6050
-  TickType_t xLastWakeTime = xTaskGetTickCount();
+void drainFaults() {
+  FrameHandle fault;
+  while (canLanes.popHigh(fault)) {
+    pipeline.processUrgent(framePool.frame(fault));
+    framePool.release(fault);
+  }
+  pipeline.processAlarms();
+}
 
-  client.setServer(serverAddress, mqtt_port);
+/**
+ * @brief Compila as regras no programa livre e o entrega à decodificação
+ * @return false com erro de sintaxe (as regras atuais continuam valendo)
+ *         ou com a troca anterior ainda não adotada
+ */
+bool updateRules(const char* text) {
+  for (RuleProgram<RULE_CAPACITY>& program : rulePrograms) {
+    if (!pipeline.rulesWritable(&program)) continue;
+    if (!program.compile(text)) {
+      Serial.printf("Regras: erro na linha %u\n", (unsigned)program.errorLine());
+      return false;
+    }
+    if (!pipeline.publishRules(&program)) return false;
+    Serial.printf("Regras: %u ativas\n", (unsigned)program.count());
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Regras do boot: RULES_FILE no cartão, se houver, senão RULES_DEFAULT
+ */
+void loadBootRules() {
+  if (!RULE_ENGINE) return;
+#if PROFILE_HAS_SD
+  if (SD.exists(RULES_FILE)) {
+    File file = SD.open(RULES_FILE, FILE_READ);
+    static char text[RULES_TEXT_MAX + 1];
+    size_t length = file ? file.read((uint8_t*)text, RULES_TEXT_MAX) : 0;
+    if (file) file.close();
+    text[length] = '\0';
+    if (length > 0 && updateRules(text)) return;
+    Serial.println("Regras do cartão inválidas, usando as padrão");
+  }
+#endif
+  updateRules(RULES_DEFAULT);
+}
+
+/**
+ * @brief Configuração do boot: os valores de firmware_config.h
+ */
+RuntimeConfig bootConfig() {
+  RuntimeConfig config;
+  config.transmitIntervalMs = TRANSMIT_INTERVAL_MS;
+  config.batchFrames = CONFIG_MAX_BATCH_FRAMES; // Só o lote adaptativo limita
+  config.reportIntervalMs = QUEUE_REPORT_INTERVAL_MS;
+  config.heartbeatMs = TRANSMIT_INTERVAL_MS * 20;
+  return config;
+}
+
+/**
+ * @brief Aplica a configuração recebida por um sink, se houver
+ * @details Tudo ou nada: recusada pela validação ou com regras que não
+ *          compilam, a atual continua valendo. Versão não maior que a
+ *          atual (o retido reentregue a cada conexão) é ignorada
+ * @return true se uma configuração foi recusada (relatório na hora)
+ */
+bool applyConfig() {
+  configUpdate.config = runtimeConfig.current();
+  if (!pipeline.receiveConfig(configUpdate)) return false;
+  if (!configUpdate.error && configUpdate.config.version <= runtimeConfig.current().version) {
+    return false;
+  }
+  if (!configUpdate.error && configUpdate.rules[0] != '\0' && !updateRules(configUpdate.rules)) {
+    configUpdate.error = "rules";
+  }
+  if (configUpdate.error) {
+    configRejected++;
+    Serial.printf("Configuração recusada: campo \"%s\"\n", configUpdate.error);
+    return true;
+  }
+  RuntimeConfig* next = runtimeConfig.prepare();
+  *next = configUpdate.config;
+  runtimeConfig.publish(next);
+  Serial.printf("Configuração %lu aplicada\n", (unsigned long)next->version);
+  return false;
+}
+
+/**
+ * @brief Estágio 3, Core 1: Gestão da rede e entrega em lote aos sinks do perfil
+ * @details A cada ciclo entrega a telemetria acumulada (decodificador →
+ *          sinks) e fecha o lote com flush(). Com UPLINK_ADAPTIVE o lote e o
+ *          intervalo seguem o enlace (latência e recusas medidas pelos
+ *          sinks); o que não sai fica na fila, sob a política de sobrecarga.
+ *          A lane de falhas é verificada antes de cada frame de telemetria
+ *          e, entre ciclos, a task dorme esperando nela: uma falha espera
+ *          no máximo o frame em andamento. Intervalo, lote máximo e
+ *          relatório seguem a configuração em campo (applyConfig()).
+ */
+void uplinkTask(void* pvParameters) {
+  FrameHandle rawFrame;
+  TickType_t xLastWakeTime = xTaskGetTickCount();
+  uint32_t lastReportMs = millis();
+  uint32_t lastCycleUs = micros();
+  uint32_t rejectedBefore = pipeline.feedback().rejected;
+  uint32_t bootReported = 0;
+  uint32_t busAlarmReported = 0;
+  bool reportNow = false;
+  uplinkBatch.begin();
 
   for (;;) {
-    // --- MANUTENÇÃO DA CONEXÃO WiFi ---
-    if (WiFi.status() != WL_CONNECTED) {
-      WiFi.begin(ssid, password);
-      int timeout = 0;
-      while (WiFi.status() != WL_CONNECTED && timeout < 10) {
-        vTaskDelay(pdMS_TO_TICKS(500));
-        timeout++;
-      }
+    // --- MANUTENÇÃO DAS CONEXÕES (WiFi e sinks) ---
+    networkLink.maintain();
+    if (networkLink.connected()) bootTimeline.mark(BOOT_LINK_UP);
+    pipeline.poll();
+    if (applyConfig()) reportNow = true;
+    const RuntimeConfig& config = *runtimeConfig.read(CONFIG_READER_UPLINK);
+
+    // --- TEMPOS DO BOOT: relatados a cada marco atingido ---
+    if (bootTimeline.count() != bootReported) {
+      bootReported = bootTimeline.count();
+      char timeline[96];
+      bootTimeline.format(timeline, sizeof(timeline));
+      Serial.print("[BOOT] ");
+      Serial.println(timeline);
     }
 
-    // --- MANUTENÇÃO DA CONEXÃO MQTT ---
-    if (WiFi.status() == WL_CONNECTED && !client.connected()) {
-      reconnectMQTT();
-    }
-    client.loop();
-
-    // --- PROCESSAMENTO EM LOTE: Esvazia toda a fila acumulada ---
-    while (xQueueReceive(canRawQueue, &rawFrame, 0) == pdTRUE) {
-      digitalWrite(ledMQTT, HIGH);
-
-      // Lê dados do MPU-6050 ANTES de montar o JSON
-      // (Importante: leitura feita apenas nesta task para evitar conflito I2C)
-      readMPU6050();
-
-      // Monta documento JSON com dados CAN + MPU-6050
-      StaticJsonDocument<512> doc;  // Aumentado para comportar mais campos
-      
-      // Dados do barramento CAN
-      doc["canId"] = rawFrame.id;
-      doc["ide"] = rawFrame.isExtended;
-      doc["dlc"] = rawFrame.length;
-      
-      // Converte dados CAN para string hexadecimal formatada
-      char dataHex[25]; 
-      char* ptr = dataHex;
-      for (int i = 0; i < rawFrame.length; i++) {
-        ptr += sprintf(ptr, i == 0 ? "%02X" : " %02X", rawFrame.data[i]);
+    // --- CONTADORES DAS FILAS E DO BARRAMENTO: periódicos, ou na hora
+    // em que um ID some / volta ---
+    if (millis() - lastReportMs >= config.reportIntervalMs || busAlarmCount != busAlarmReported ||
+        reportNow) {
+      lastReportMs = millis();
+      busAlarmReported = busAlarmCount;
+      reportNow = false;
+      LaneStatus status = canLanes.status();
+      status.batch = uplinkBatch.metrics();
+      if (busSummaryCount > 0) busSummary.read(status.bus);
+      status.configVersion = config.version;
+      status.configRejected = configRejected;
+      status.configFiltered = configFiltered;
+      status.deadbandHeld = deadbandHeld;
+      pipeline.report(status);
+      if (DEBUGMODE && captureOverruns > 0) {
+        Serial.print("Ring de captura cheio, frames perdidos: ");
+        Serial.println(captureOverruns);
       }
-      doc["data"] = dataHex;
-      
-      // Timestamp original da captura do frame CAN (em ms desde epoch)
-      doc["ts"] = rawFrame.timestamp; 
-
-      // --- DADOS DO MPU-6050 (adicionados ao mesmo pacote) ---
-      doc["mpu"]["ax_g"] = ax_g;        // Aceleração X em g
-      doc["mpu"]["ay_g"] = ay_g;        // Aceleração Y em g
-      doc["mpu"]["az_g"] = az_g;        // Aceleração Z em g
-      doc["mpu"]["gx_dps"] = gx_dps;    // Velocidade angular X em °/s
-      doc["mpu"]["gy_dps"] = gy_dps;    // Velocidade angular Y em °/s
-      doc["mpu"]["gz_dps"] = gz_dps;    // Velocidade angular Z em °/s
-      doc["mpu"]["ts_mpu"] = millis();  // Timestamp relativo da leitura do MPU
-
-      // Serializa o JSON para o buffer de envio
-      serializeJson(doc, jsonBuffer, sizeof(jsonBuffer));
-
-      // Publica no tópico MQTT se estiver conectado
-      if (client.connected()) {
-        client.publish(MQTT_TOPIC, jsonBuffer);
+      if (DEBUGMODE && framePool.exhausted() > 0) {
+        Serial.print("Pool de frames esgotado, frames perdidos: ");
+        Serial.println(framePool.exhausted());
       }
-      
-      digitalWrite(ledMQTT, LOW);
-      vTaskDelay(0); // Cede tempo para a stack Wi-Fi processar
     }
 
-    // Aguarda até o próximo ciclo de transmissão (controla a taxa de publicação)
-    vTaskDelayUntil(&xLastWakeTime, TRANSMIT_INTERVAL);
+    // --- PROCESSAMENTO EM LOTE: falhas primeiro, depois a telemetria ---
+    drainFaults();
+    pipeline.processTrip(); // Viagem encerrada no key-off (TRIP_STATS)
+    pipeline.processWindows(); // Janelas mín/máx/média (SIGNAL_WINDOWS)
+    uint32_t budget = config.batchFrames;
+    if (UPLINK_ADAPTIVE && uplinkBatch.batchFrames() < budget) budget = uplinkBatch.batchFrames();
+    uint32_t sent = 0;
+    while (sent < budget && canLanes.popLow(rawFrame)) {
+      pipeline.process(framePool.frame(rawFrame));
+      framePool.release(rawFrame);
+      sent++;
+      drainFaults();
+    }
+    pipeline.flush();
+    if (sent > 0 && networkLink.connected()) bootTimeline.mark(BOOT_FIRST_UPLINK);
+
+    uint32_t intervalMs = config.transmitIntervalMs;
+    if (UPLINK_ADAPTIVE) {
+      LinkFeedback link = pipeline.feedback();
+      uint32_t nowUs = micros();
+      uplinkBatch.update(sent, nowUs - lastCycleUs, link.latencyUs,
+                         canLanes.telemetryBacklog(), link.rejected - rejectedBefore);
+      lastCycleUs = nowUs;
+      rejectedBefore = link.rejected;
+      if (uplinkBatch.intervalMs() > intervalMs) intervalMs = uplinkBatch.intervalMs();
+    }
+    TickType_t interval = pdMS_TO_TICKS(intervalMs);
+
+    // Aguarda o próximo ciclo de transmissão, acordando a cada falha
+    xLastWakeTime += interval;
+    for (;;) {
+      TickType_t now = xTaskGetTickCount();
+      if ((int32_t)(xLastWakeTime - now) <= 0) break;
+      uint32_t waitUs = (xLastWakeTime - now) * portTICK_PERIOD_MS * 1000UL;
+      if (canLanes.popHigh(rawFrame, waitUs)) {
+        pipeline.processUrgent(framePool.frame(rawFrame));
+        framePool.release(rawFrame);
+      }
+    }
   }
 }
 
@@ -271,76 +380,55 @@ void mqttPublisherTask(void* pvParameters) {
 // ------------------------------------------------------------------
 void setup() {
   Serial.begin(115200);
-  Serial.println("=== Iniciando Sistema ESP32 + CAN + MPU-6050 + MQTT ===");
-
-  // Configura LEDs de status
-  pinMode(ledCAN, OUTPUT);
-  pinMode(ledMQTT, OUTPUT);
-
-  // Criação da fila de mensagens CAN (BufferSize x tamanho da struct)
-  canRawQueue = xQueueCreate(BufferSize, sizeof(CanMessage));
-
-  // Inicializa barramento I2C para o MPU-6050
-  Wire.begin(I2C_SDA, I2C_SCL);
-  Serial.println("Inicializando MPU-6050...");
-  
-  // Inicializa o sensor MPU-6050
-  mpu.initialize();
-  
-  // Verifica comunicação com o sensor
-  if (mpu.testConnection()) {
-    Serial.println("MPU-6050 conectado com sucesso!");
-    
-    // Configurações opcionais do sensor (ajuste conforme necessidade)
-    mpu.setFullScaleAccelRange(MPU6050_ACCEL_FS_2);   // ±2g (maior precisão)
-    mpu.setFullScaleGyroRange(MPU6050_GYRO_FS_250);   // ±250°/s (maior precisão)
-    mpu.setDLPFMode(MPU6050_DLPF_BW_98);              // Filtro digital: 98Hz
-  } else {
-    Serial.println("ERRO: Falha na comunicação com MPU-6050. Verifique conexões I2C.");
-    // Sistema continua sem o sensor (modo degradado)
+  Serial.print("=== Iniciando Sistema ESP32 + CAN | perfil ");
+  Serial.print(ActiveProfile::name());
+  Serial.println(" ===");
+
+  // Sinks e fonte primeiro: a captura começa sem esperar a rede
+  // (NullLink no perfil offline)
+  if (!pipeline.begin()) {
+    while (1) {
+      digitalWrite(ledCAN, HIGH);
+      delay(200);
+      digitalWrite(ledCAN, LOW);
+      delay(200);
+    }
   }
 
-  // Início da conexão WiFi
-  Serial.print("Conectando ao WiFi ");
-  Serial.print(ssid);
-  Serial.print("... ");
-  WiFi.begin(ssid, password);
-  
-  // Aguarda conexão WiFi com timeout
-  int wifiTimeout = 0;
-  while (WiFi.status() != WL_CONNECTED && wifiTimeout < 20) {
-    delay(500);
-    Serial.print(".");
-    wifiTimeout++;
-  }
-  Serial.println(WiFi.status() == WL_CONNECTED ? "Conectado!" : "Falha!");
-
-  // Configuração do NTP para sincronizar timestamp real (UTC)
-  configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
-  Serial.println("Sincronizando horário com NTP...");
-
-  // Inicialização do Driver CAN (TWAI)
-  ESP32Can.setPins(CAN_TX_PIN, CAN_RX_PIN);
-  if (!TESTMODE) {
-    if (!ESP32Can.begin(CAN_SPEED)) {
-      Serial.println("CRÍTICO: Falha ao iniciar barramento CAN");
-      while (1) {
-        digitalWrite(ledCAN, HIGH);
-        delay(200);
-        digitalWrite(ledCAN, LOW);
-        delay(200);
-      }
-    }
-    Serial.println("Barramento CAN inicializado com sucesso!");
-  } else {
-    Serial.println("MODO TESTE ATIVADO: Dados CAN simulados");
+  // Criação das lanes de mensagens CAN (telemetria: BufferSize handles)
+  // O excesso em arquivo só existe com o cartão já montado pelo sink SD
+  FrameSpill* spill = NULL;
+#if PROFILE_HAS_SD
+  if (OVERLOAD_POLICY == OVERLOAD_SPILL && canSpill.begin(SPILL_FILE_PATH, SPILL_MAX_FRAMES)) {
+    spill = &canSpill;
   }
+#endif
+  canLanes.begin(framePool, BufferSize, OVERLOAD_POLICY, spill);
+  RuntimeConfig* boot = runtimeConfig.prepare();
+  *boot = bootConfig();
+  runtimeConfig.publish(boot);
+  loadBootRules(); // Antes da captura: os primeiros frames já são avaliados
+  Serial.print("Política de sobrecarga: ");
+  Serial.println(overloadPolicyName(canLanes.telemetry().policy()));
 
   // ----------------------------------------------------------------
   // --- CRIAÇÃO DAS TASKS COM PINO EM NÚCLEOS ESPECÍFICOS ---
   // ----------------------------------------------------------------
-  
-  // Task de leitura CAN no Core 0 
+
+  // Task de decodificação no Core 0, criada antes da captura (que a notifica)
+  // Prioridade 2: abaixo da captura, acima do IDLE
+  xTaskCreatePinnedToCore(
+    decodeTask,         // Função da task
+    "CAN_Decode",       // Nome para debug
+    4096,               // Stack size
+    NULL,               // Parâmetro
+    2,                  // Prioridade intermediária
+    &decodeTaskHandle,  // Handle (notificado pela captura)
+    0                   // Núcleo 0 (junto da captura, longe da pilha WiFi)
+  );
+  Serial.println("Task CAN_Decode criada no Core 0");
+
+  // Task de leitura CAN no Core 0
   // Prioridade 3 (alta) para garantir baixa latência na captura
   xTaskCreatePinnedToCore(
     canSourceTask,      // Função da task
@@ -350,31 +438,37 @@ void setup() {
     3,                  // Prioridade (0-24, quanto maior = mais prioridade)
     NULL,               // Handle da task (não usado)
     0                   // Núcleo 0 (responsável por periféricos de tempo real)
-  ); 
+  );
   Serial.println("Task CAN_Source criada no Core 0");
-  
-  // Task de Wi-Fi/MQTT/MPU no Core 1 
+  bootTimeline.mark(BOOT_CAPTURE_STARTED);
+
+  // Rede em segundo plano, antes da task que a mantém. Até ela subir, a
+  // telemetria fica nas filas (política de sobrecarga) e na outbox do
+  // MQTT; o SD grava desde o primeiro frame
+  networkLink.begin();
+
+  // Task de rede/sinks no Core 1
   // Prioridade 1 (menor) pois tolera pequenas latências
   xTaskCreatePinnedToCore(
-    mqttPublisherTask,  // Função da task
-    "MQTT_Pub",         // Nome para debug
+    uplinkTask,         // Função da task
+    "Uplink",           // Nome para debug
     8192,               // Stack maior para JSON + WiFi + I2C
     NULL,               // Parâmetro
     1,                  // Prioridade baixa
     NULL,               // Handle
     1                   // Núcleo 1 (responsável por WiFi e tarefas de rede)
   );
-  Serial.println("Task MQTT_Pub criada no Core 1");
-  
+  Serial.println("Task Uplink criada no Core 1");
+
   Serial.println("=== Sistema inicializado. Tasks rodando. ===");
 }
 
 /**
  * @brief Função loop principal
- * @details Deletada para economizar recursos. Todo o processamento 
+ * @details Deletada para economizar recursos. Todo o processamento
  *          é feito nas tasks do FreeRTOS.
  */
 void loop() {
   // Deleta a task padrão do Arduino para liberar stack e CPU
-  vTaskDelete(NULL); 
-}
\ No newline at end of file
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,48 @@
+#ifndef SOURCE_SIM_H
+#define SOURCE_SIM_H
+
+// ------------------------------------------------------------------
+// --- FONTE: SIMULADOR FÍSICO (TESTMODE) ---
+// ------------------------------------------------------------------
+
+#include <Arduino.h>
+#include <string.h>
+#include "firmware_config.h"
+#include "../common/can_message.h"
+#include "../common/time_base.h"
+#include "../common/vehicle_sim.h"
+
+/**
+ * @brief Percurso simulado com física da moto (TESTMODE)
+ */
+class SimSource {
+public:
+  bool begin() {
+    sim_.setBusLoad(SIM_BUS_LOAD_PERCENT);
+    startUs_ = monoMicros();
+    Serial.println("MODO TESTE ATIVADO: Dados CAN simulados");
+    return true;
+  }
+
+  bool read(CanMessage &frame) {
+    SimFrame simFrame;
+    sim_.nextFrame(simFrame);
+
+    // Ritmo em tempo real: aguarda até o instante virtual do frame
+    int64_t waitUs = startUs_ + (int64_t)simFrame.timeUs - monoMicros();
+    if (waitUs >= 1000) vTaskDelay(pdMS_TO_TICKS(waitUs / 1000));
+
+    frame.id = simFrame.id;
+    frame.length = simFrame.length;
+    frame.isExtended = simFrame.isExtended;
+    memcpy(frame.data, simFrame.data, sizeof(frame.data));
+    frame.timestampUs = TimeBase::stamp();
+    return true;
+  }
+
+private:
+  VehicleSim sim_;
+  int64_t startUs_ = 0;
+};
+
+#endif // SOURCE_SIM_H
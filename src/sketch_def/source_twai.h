@@ -0,0 +1,50 @@
+#ifndef SOURCE_TWAI_H
+#define SOURCE_TWAI_H
+
+// ------------------------------------------------------------------
+// --- FONTE: BARRAMENTO CAN (TWAI) ---
+// ------------------------------------------------------------------
+
+#include <Arduino.h>
+#include <string.h>
+#include "firmware_config.h"
+#include "../common/can_message.h"
+#include "../common/time_base.h"
+
+/**
+ * @brief Barramento CAN real via driver TWAI
+ */
+class TwaiSource {
+public:
+  bool begin() {
+    pinMode(ledCAN, OUTPUT);
+    ESP32Can.setPins(CAN_TX_PIN, CAN_RX_PIN);
+    if (!ESP32Can.begin(CAN_SPEED)) {
+      Serial.println("CRÍTICO: Falha ao iniciar barramento CAN");
+      return false;
+    }
+    Serial.println("Barramento CAN inicializado com sucesso!");
+    return true;
+  }
+
+  /**
+   * @brief Lê um frame CAN com timeout de 10ms
+   */
+  bool read(CanMessage &frame) {
+    CanFrame rx;
+    if (!ESP32Can.readFrame(rx, 10)) return false;
+
+    // CAPTURA DO TIMESTAMP NO MOMENTO EXATO DA CHEGADA DO FRAME
+    // (contador monotônico: barato e imune a ajustes do NTP)
+    frame.timestampUs = TimeBase::stamp();
+    digitalWrite(ledCAN, !digitalRead(ledCAN));
+
+    frame.id = rx.identifier;
+    frame.length = rx.data_length_code;
+    frame.isExtended = rx.extd;
+    memcpy(frame.data, rx.data, rx.data_length_code);
+    return true;
+  }
+};
+
+#endif // SOURCE_TWAI_H
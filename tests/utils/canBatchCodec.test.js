@@ -0,0 +1,44 @@
+/**
+ * @fileoverview Testes do codec de lote binário de frames CAN (WebSocket sendBIN)
+ */
+
+const { isCanBatch, decodeCanBatch, encodeCanBatch } = require('../../utils/canBatchCodec');
+
+const sampleFrames = [
+  { canId: 0x120, dlc: 8, ide: false, data: [0x02, 0x73, 0x00, 0x02, 0x1C, 0x1B, 0x2E, 0x64] },
+  { canId: 0x6F2020, dlc: 8, ide: true, data: [0xFE, 0xFF, 0x73, 0x02, 0x2E, 0x60, 0x30, 0x00] },
+  { canId: 0x301, dlc: 2, ide: false, data: [0x00, 0x0E] }
+];
+
+describe('canBatchCodec', () => {
+
+  it('deve decodificar o layout gerado pelo firmware', () => {
+    // Bytes exatamente como CanBatchWriter monta (little-endian)
+    const buffer = Buffer.from([
+      0x56, 0x42, 0x01, 0x01, 0x00,             // 'V' 'B' v1, 1 frame
+      0x00, 0x03, 0x00, 0x00, 0x03,             // id 0x300, dlc 3
+      0x0B, 0xB8, 0x45
+    ]);
+
+    expect(decodeCanBatch(buffer)).toEqual([
+      { canId: 0x300, dlc: 3, ide: false, data: [0x0B, 0xB8, 0x45] }
+    ]);
+  });
+
+  it('deve preservar IDs estendidos e frames curtos (ida e volta)', () => {
+    const buffer = encodeCanBatch(sampleFrames);
+
+    expect(isCanBatch(buffer)).toBe(true);
+    expect(buffer.length).toBe(5 + 13 + 13 + 7);
+    expect(decodeCanBatch(buffer)).toEqual(sampleFrames);
+  });
+
+  it('deve rejeitar lotes truncados ou sem cabeçalho', () => {
+    const buffer = encodeCanBatch(sampleFrames);
+
+    expect(() => decodeCanBatch(buffer.subarray(0, buffer.length - 1))).toThrow();
+    expect(() => decodeCanBatch(Buffer.from('{"type":"canFrame"}'))).toThrow();
+    expect(isCanBatch(Buffer.from('ESP32 Conectado ao WebSocket!'))).toBe(false);
+  });
+
+});
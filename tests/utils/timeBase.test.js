@@ -0,0 +1,76 @@
+/**
+ * @fileoverview Testes da reconstrução de horário a partir das âncoras do ESP32
+ */
+
+const { isAnchor, updateAnchor, resolveTimestamp, resetAnchors } = require('../../utils/timeBase');
+
+const SOURCE = 'moto/telemetria';
+const UTC_BASE = 1717789234567;
+
+beforeEach(() => {
+  resetAnchors();
+});
+
+describe('timeBase', () => {
+
+  it('deve identificar mensagens de âncora', () => {
+    expect(isAnchor({ type: 'anchor', as: 1, utc: UTC_BASE })).toBe(true);
+    expect(isAnchor({ canId: 288, dt: 10, as: 1 })).toBe(false);
+  });
+
+  it('deve reconstruir o horário a partir do delta (inclusive negativo)', () => {
+    updateAnchor(SOURCE, { type: 'anchor', as: 7, mono: 5000000, utc: UTC_BASE, ppm: 0, sync: true });
+
+    expect(resolveTimestamp(SOURCE, { dt: 250000, as: 7 }).getTime()).toBe(UTC_BASE + 250);
+    expect(resolveTimestamp(SOURCE, { dt: -3000, as: 7 }).getTime()).toBe(UTC_BASE - 3);
+  });
+
+  it('deve aplicar a correção de desvio (ppm) da âncora', () => {
+    updateAnchor(SOURCE, { type: 'anchor', as: 1, utc: UTC_BASE, ppm: 100, sync: true });
+
+    // 10 s monotônicos com +100 ppm → 10,001 s de UTC
+    expect(resolveTimestamp(SOURCE, { dt: 10000000, as: 1 }).getTime()).toBe(UTC_BASE + 10001);
+  });
+
+  it('deve usar a âncora referenciada pelo frame, não apenas a mais recente', () => {
+    updateAnchor(SOURCE, { type: 'anchor', as: 1, utc: UTC_BASE, sync: true });
+    updateAnchor(SOURCE, { type: 'anchor', as: 2, utc: UTC_BASE + 1000, sync: true });
+
+    expect(resolveTimestamp(SOURCE, { dt: 500000, as: 1 }).getTime()).toBe(UTC_BASE + 500);
+  });
+
+  it('deve descartar as âncoras do boot anterior quando o seq recomeça', () => {
+    for (let seq = 0; seq < 8; seq++) {
+      updateAnchor(SOURCE, { type: 'anchor', as: seq, utc: UTC_BASE + seq * 1000, sync: true });
+    }
+    // Reinício: seq volta a 0 com outro horário
+    const REBOOT_UTC = UTC_BASE + 3600000;
+    updateAnchor(SOURCE, { type: 'anchor', as: 0, utc: REBOOT_UTC, sync: true });
+    updateAnchor(SOURCE, { type: 'anchor', as: 1, utc: REBOOT_UTC + 1000, sync: true });
+
+    expect(resolveTimestamp(SOURCE, { dt: 0, as: 0 }).getTime()).toBe(REBOOT_UTC);
+    expect(resolveTimestamp(SOURCE, { dt: 0, as: 1 }).getTime()).toBe(REBOOT_UTC + 1000);
+    expect(resolveTimestamp(SOURCE, { dt: 0, as: 5 })).toBeNull();
+  });
+
+  it('deve manter a âncora reenviada como a mais recente no descarte', () => {
+    for (let seq = 1; seq <= 8; seq++) {
+      updateAnchor(SOURCE, { type: 'anchor', as: seq, utc: UTC_BASE + seq * 1000, sync: true });
+    }
+    // A 8 reenviada (retransmissão QoS1) não pode ser a próxima a sair
+    updateAnchor(SOURCE, { type: 'anchor', as: 8, utc: UTC_BASE + 8000, sync: true });
+    updateAnchor(SOURCE, { type: 'anchor', as: 9, utc: UTC_BASE + 9000, sync: true });
+
+    expect(resolveTimestamp(SOURCE, { dt: 0, as: 8 }).getTime()).toBe(UTC_BASE + 8000);
+    expect(resolveTimestamp(SOURCE, { dt: 0, as: 1 })).toBeNull();
+  });
+
+  it('deve retornar null para âncora desconhecida ou sem NTP', () => {
+    updateAnchor(SOURCE, { type: 'anchor', as: 3, utc: 42, sync: false });
+
+    expect(resolveTimestamp(SOURCE, { dt: 10, as: 3 })).toBeNull();
+    expect(resolveTimestamp(SOURCE, { dt: 10, as: 99 })).toBeNull();
+    expect(resolveTimestamp('outro/topico', { dt: 10, as: 3 })).toBeNull();
+  });
+
+});
@@ -0,0 +1,213 @@
+// ------------------------------------------------------------------
+// Simulação no PC do lote adaptativo (src/common/adaptive_batch.h)
+// ------------------------------------------------------------------
+// Tempo virtual, determinístico. A captura produz frames de SIM_IDS IDs
+// a taxa fixa na fila de telemetria real (OverloadQueue, BufferSize,
+// OVERLOAD_LATEST_PER_ID como no firmware); a cada ciclo a task de envio
+// entrega frames à outbox do MQTT (~85 frames), que os transmite por um
+// enlace com banda e RTT que mudam por fase. Compara o envio fixo (tudo a
+// cada 50 ms, como antes) com o controlador AIMD e mostra, por fase, a
+// vazão, as perdas e a idade dos dados ao chegar ao broker.
+//
+// Com "spill" a fila usa OVERLOAD_SPILL (excesso em memória, no lugar do
+// cartão): nada é substituído e só a outbox pode perder frames.
+//
+// Compilação:
+//   g++ -std=c++11 -O2 -pthread tools/adaptive_batch_sim.cpp -o .build/adaptive_batch_sim
+// Uso:
+//   .build/adaptive_batch_sim [frames/s da captura] [latest|spill]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "../src/common/adaptive_batch.h"
+#include "../src/common/frame_pool.h"
+#include "../src/common/overload_queue.h"
+
+#define SIM_QUEUE_FRAMES 250  // BufferSize
+#define SIM_IDS 8             // IDs distintos no barramento
+#define SIM_OUTBOX_FRAMES 85  // MQTT_OUTBOX_BYTES / frame JSON (~190 B)
+#define SIM_PHASE_US 20000000 // 20 s por fase
+
+struct LinkPhase {
+  const char *name;
+  uint32_t framesPerSecond; // Banda do enlace em frames
+  uint32_t rttUs;
+};
+
+static const LinkPhase PHASES[] = {
+  {"bom", 3000, 20000},
+  {"congestionado", 400, 120000},
+  {"lento", 150, 300000},
+  {"médio", 1000, 60000},
+  {"bom", 3000, 20000},
+};
+static const size_t PHASE_COUNT = sizeof(PHASES) / sizeof(PHASES[0]);
+
+/**
+ * @brief Excesso da fila em memória (o FileSpill do firmware grava no SD)
+ */
+class MemorySpill : public FrameSpill {
+public:
+  bool write(const CanMessage &frame) {
+    frames_.push_back(frame);
+    return true;
+  }
+  bool read(CanMessage &frame) {
+    if (frames_.empty()) return false;
+    frame = frames_.front();
+    frames_.pop_front();
+    return true;
+  }
+  bool empty() { return frames_.empty(); }
+
+private:
+  std::deque<CanMessage> frames_;
+};
+
+struct InFlight {
+  uint32_t captureUs;
+  int64_t sendUs;
+  int64_t ackUs;
+};
+
+struct PhaseResult {
+  uint32_t delivered = 0;
+  uint32_t superseded = 0;  // Substituídos por um valor mais novo do mesmo ID
+  uint32_t outboxDrops = 0;
+  std::vector<uint32_t> agesMs;
+  uint16_t batch = 0;
+  uint32_t intervalMs = 0;
+};
+
+/**
+ * @brief Roda todas as fases com envio fixo (adaptive = false) ou AIMD
+ */
+static void simulate(bool adaptive, uint32_t captureFps, OverloadPolicy policy,
+                     PhaseResult results[]) {
+  AdaptiveBatch batcher;
+  batcher.begin();
+
+  MemorySpill spill;
+  StaticFramePool<SIM_QUEUE_FRAMES + OVERLOAD_LATEST_SLOTS + 1> pool;
+  OverloadQueue queue; // timestampUs = instante virtual da captura
+  queue.begin(pool, SIM_QUEUE_FRAMES, policy, &spill);
+  uint32_t capturedCount = 0;
+  uint32_t supersededBefore = 0;
+  std::deque<InFlight> inFlight; // Na outbox até o PUBACK
+  int64_t linkFreeUs = 0;
+  int64_t ackRttUs = 0;
+  int64_t captureStepUs = 1000000 / captureFps;
+  int64_t nextCaptureUs = 0;
+  int64_t now = 0;
+  int64_t lastCycleUs = 0;
+  int64_t endUs = (int64_t)SIM_PHASE_US * PHASE_COUNT;
+
+  while (now < endUs) {
+    size_t phaseIndex = (size_t)(now / SIM_PHASE_US);
+    const LinkPhase &phase = PHASES[phaseIndex];
+    PhaseResult &result = results[phaseIndex];
+
+    // Captura até o instante do ciclo
+    for (; nextCaptureUs <= now; nextCaptureUs += captureStepUs) {
+      FrameHandle handle = pool.acquire();
+      CanMessage &frame = pool.frame(handle);
+      memset(&frame, 0, sizeof(frame));
+      frame.id = 0x100 + capturedCount++ % SIM_IDS;
+      frame.length = 8;
+      frame.timestampUs = (uint32_t)nextCaptureUs;
+      queue.push(handle);
+    }
+    result.superseded += queue.stats().superseded - supersededBefore;
+    supersededBefore = queue.stats().superseded;
+
+    // PUBACKs recebidos: libera a outbox e mede a latência
+    while (!inFlight.empty() && inFlight.front().ackUs <= now) {
+      const InFlight &done = inFlight.front();
+      ackRttUs += (done.ackUs - done.sendUs - ackRttUs) / 4;
+      uint32_t ageMs = (uint32_t)((done.ackUs - (int64_t)phase.rttUs / 2 - (int64_t)done.captureUs) / 1000);
+      results[(size_t)std::min<int64_t>(done.ackUs / SIM_PHASE_US, PHASE_COUNT - 1)].agesMs.push_back(ageMs);
+      results[(size_t)std::min<int64_t>(done.ackUs / SIM_PHASE_US, PHASE_COUNT - 1)].delivered++;
+      inFlight.pop_front();
+    }
+
+    // Entrega do ciclo: tudo (fixo) ou o lote do controlador
+    uint32_t budget = adaptive ? batcher.batchFrames() : SIM_QUEUE_FRAMES;
+    uint32_t sent = 0;
+    uint32_t rejected = 0;
+    FrameHandle handle;
+    while (sent < budget && queue.pop(handle)) {
+      uint32_t captureUs = pool.frame(handle).timestampUs;
+      pool.release(handle);
+      sent++;
+      if (inFlight.size() >= SIM_OUTBOX_FRAMES) {
+        result.outboxDrops++; // Outbox cheia: publish() recusa
+        rejected++;
+        continue;
+      }
+      linkFreeUs = std::max(linkFreeUs, now) + 1000000 / phase.framesPerSecond;
+      InFlight message = {captureUs, now, linkFreeUs + phase.rttUs};
+      inFlight.push_back(message);
+    }
+
+    // Latência do sink: média do RTT ou idade da mensagem mais antiga em voo
+    int64_t latencyUs = ackRttUs;
+    if (!inFlight.empty()) latencyUs = std::max(latencyUs, now - inFlight.front().sendUs);
+
+    uint32_t intervalMs = 50;
+    if (adaptive) {
+      uint32_t backlog = (uint32_t)queue.size() + (queue.overflowing() ? 1 : 0);
+      batcher.update(sent, (uint32_t)(now - lastCycleUs), (uint32_t)latencyUs, backlog,
+                     rejected);
+      intervalMs = batcher.intervalMs();
+    }
+    result.batch = adaptive ? batcher.batchFrames() : 0;
+    result.intervalMs = intervalMs;
+
+    lastCycleUs = now;
+    now += intervalMs * 1000LL;
+  }
+}
+
+static uint32_t percentile(std::vector<uint32_t> &values, uint32_t pct) {
+  if (values.empty()) return 0;
+  std::sort(values.begin(), values.end());
+  return values[(values.size() - 1) * pct / 100];
+}
+
+int main(int argc, char **argv) {
+  uint32_t captureFps = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 600;
+  OverloadPolicy policy = OVERLOAD_LATEST_PER_ID;
+  if (argc > 2 && strcmp(argv[2], "spill") == 0) policy = OVERLOAD_SPILL;
+  if (captureFps == 0) return 1;
+  printf("captura: %lu frames/s | fila %d (%s) | outbox %d frames | fases de %d s\n\n",
+         (unsigned long)captureFps, SIM_QUEUE_FRAMES, overloadPolicyName(policy),
+         SIM_OUTBOX_FRAMES, SIM_PHASE_US / 1000000);
+
+  for (int adaptive = 0; adaptive <= 1; adaptive++) {
+    PhaseResult results[PHASE_COUNT];
+    simulate(adaptive != 0, captureFps, policy, results);
+
+    printf("%s\n", adaptive ? "AIMD (adaptive_batch.h)" : "fixo (tudo a cada 50 ms)");
+    printf("%-14s %6s %6s %8s %11s %12s %9s %6s %9s\n", "fase", "banda", "RTT", "entreg/s",
+           "substituído", "perda outbox", "idade p50", "p99", "lote/int");
+    for (size_t p = 0; p < PHASE_COUNT; p++) {
+      PhaseResult &r = results[p];
+      char point[24] = "-";
+      if (adaptive) snprintf(point, sizeof(point), "%u/%lums", r.batch, (unsigned long)r.intervalMs);
+      uint32_t p50 = percentile(r.agesMs, 50);
+      uint32_t p99 = percentile(r.agesMs, 99);
+      printf("%-14s %6lu %4lums %8lu %11lu %12lu %7lums %4lums %9s\n", PHASES[p].name,
+             (unsigned long)PHASES[p].framesPerSecond, (unsigned long)(PHASES[p].rttUs / 1000),
+             (unsigned long)(r.delivered / (SIM_PHASE_US / 1000000)), (unsigned long)r.superseded,
+             (unsigned long)r.outboxDrops, (unsigned long)p50, (unsigned long)p99, point);
+    }
+    printf("\n");
+  }
+  return 0;
+}
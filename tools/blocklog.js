@@ -0,0 +1,62 @@
+#!/usr/bin/env node
+// ------------------------------------------------------------------
+// Validação do log em blocos do cartão SD (datalog.vzl) e extração do CSV
+// ------------------------------------------------------------------
+// Confere o CRC de todos os blocos, a continuidade das sequências e o que
+// a recuperação do firmware encontraria no próximo boot. Blocos inválidos
+// logo após o fim são o que uma queda de energia pode deixar; inválidos
+// em outro lugar indicam cartão danificado (código de saída 1).
+//
+// Uso:
+//   node tools/blocklog.js <datalog.vzl> [--csv saida.csv]
+//   (--csv sem nome grava ao lado do arquivo, com extensão .csv)
+
+const fs = require('fs');
+const path = require('path');
+const { parseBlockLog } = require('../utils/blockLog');
+
+const CSV_HEADER = 'timestamp,modo,rpm,torque,tensao,corrente,soc,tBat,tMotor,tCtrl\n';
+
+function main(argv) {
+  const file = argv[0];
+  if (!file) {
+    console.error('uso: node tools/blocklog.js <datalog.vzl> [--csv saida.csv]');
+    return 2;
+  }
+  const csvFlag = argv.indexOf('--csv');
+  const image = fs.readFileSync(file);
+  const log = parseBlockLog(image);
+  const { tail } = log;
+
+  // Inválidos esperados: logo depois do fim, até onde o firmware descarta
+  const expected = new Set();
+  for (let back = 1; back <= tail.dropped; back++) {
+    expected.add((tail.index + back) % log.blocks);
+  }
+  const damaged = log.corrupt.filter((index) => !expected.has(index));
+
+  console.log(`${file}: ${log.blocks} blocos, ${log.valid} válidos (seq ${log.firstSeq}..${log.lastSeq})`);
+  console.log(`fim: seq ${tail.seq} no índice ${tail.index} após ${tail.reads} leituras` +
+    (tail.fullScan ? ' (varredura completa)' : ''));
+  if (tail.dropped > 0) {
+    console.log(`${tail.dropped} bloco(s) do fim descartados (gravação interrompida)`);
+  }
+  if (log.gaps > 0) console.log(`${log.gaps} sequência(s) ausentes`);
+  if (damaged.length > 0) {
+    console.log(`CRC inválido fora do fim nos índices: ${damaged.slice(0, 20).join(', ')}` +
+      (damaged.length > 20 ? ` ... (${damaged.length})` : ''));
+  }
+  console.log(`${log.text.split('\n').length - 1} linhas`);
+
+  if (csvFlag >= 0) {
+    const next = argv[csvFlag + 1];
+    const output = next && !next.startsWith('--')
+      ? next
+      : path.join(path.dirname(file), `${path.basename(file, path.extname(file))}.csv`);
+    fs.writeFileSync(output, CSV_HEADER + log.text, 'latin1');
+    console.log(`CSV: ${output}`);
+  }
+  return damaged.length > 0 || log.gaps > 0 ? 1 : 0;
+}
+
+process.exitCode = main(process.argv.slice(2));
@@ -0,0 +1,156 @@
+// ------------------------------------------------------------------
+// Simulação no PC da ordem do boot com um AP lento (src/common/boot_timeline.h)
+// ------------------------------------------------------------------
+// Tempo virtual em passos de 10 ms, determinístico. O barramento já está
+// ativo quando o ESP32 liga (a moto ligou junto) e gera frames desde o
+// instante 0. Compara:
+//   - antes:     setup() espera o WiFi (até 10 s, 20 × 500 ms) antes de
+//                iniciar o TWAI e criar as tasks; nova tentativa a cada 5 s
+//   - websocket: esp32_WebSocket_RealTime_ok.cpp antigo, espera sem limite
+//   - agora:     TWAI e tasks primeiro, WiFi em segundo plano; nova
+//                tentativa após 10 s, prazo dobrando até 60 s
+// O AP leva `associação` para aceitar uma tentativa; uma nova tentativa
+// (disconnect + begin) antes disso recomeça a associação do zero.
+//
+// Mostra os marcos do BootTimeline e quantos frames do barramento se
+// perderam antes de a captura começar (TWAI ainda não iniciado).
+//
+// Compilação:
+//   g++ -std=c++11 -O2 tools/boot_timing_sim.cpp -o .build/boot_timing_sim
+// Uso:
+//   .build/boot_timing_sim [frames/s do barramento]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/common/boot_timeline.h"
+
+#define SIM_STEP_MS 10
+#define SIM_END_MS 60000
+#define SIM_SD_MOUNT_MS 120     // SD.begin() + abertura do log (perfil MQTT+SD)
+#define SIM_TWAI_BEGIN_MS 5
+#define SIM_BROKER_CONNECT_MS 150
+#define SIM_UPLINK_CYCLE_MS 50
+#define SIM_NEVER UINT32_MAX
+
+enum Ordering { ORDER_BEFORE, ORDER_WEBSOCKET, ORDER_NOW };
+
+/**
+ * @brief AP que leva associationMs para completar uma tentativa
+ */
+struct SimAp {
+  uint32_t associationMs;
+  uint32_t attemptStartMs = SIM_NEVER;
+
+  void begin(uint32_t now) { attemptStartMs = now; }
+  bool connected(uint32_t now) const {
+    return associationMs != SIM_NEVER && attemptStartMs != SIM_NEVER &&
+           now - attemptStartMs >= associationMs;
+  }
+};
+
+struct BootResult {
+  BootTimeline timeline;
+  uint32_t lostFrames = 0;
+};
+
+static void simulate(Ordering ordering, uint32_t associationMs, uint32_t busFps,
+                     BootResult &result) {
+  SimAp ap;
+  ap.associationMs = associationMs;
+  uint32_t retryMs = ordering == ORDER_NOW ? 10000 : 5000;
+
+  // --- setup(): cada etapa avança o relógio virtual ---
+  uint32_t now = 0;
+  uint32_t twaiStartMs = SIM_NEVER;
+  uint32_t captureStartMs = SIM_NEVER;
+  uint32_t lastAttemptMs = 0;
+
+  if (ordering == ORDER_NOW) {
+    now += SIM_SD_MOUNT_MS + SIM_TWAI_BEGIN_MS; // pipeline.begin()
+    twaiStartMs = now;
+    captureStartMs = now;                       // Tasks criadas
+    ap.begin(now);                              // networkLink.begin(): não espera
+    lastAttemptMs = now;
+  } else {
+    ap.begin(now);
+    uint32_t waitLimit = ordering == ORDER_BEFORE ? 10000 : SIM_NEVER;
+    uint32_t waited = 0;
+    uint32_t poll = ordering == ORDER_BEFORE ? 500 : 1000;
+    while (!ap.connected(now) && waited < waitLimit) {
+      now += poll;
+      waited += poll;
+      if (now >= SIM_END_MS) break;
+    }
+    lastAttemptMs = now;
+    if (now < SIM_END_MS) {
+      now += SIM_SD_MOUNT_MS + SIM_TWAI_BEGIN_MS;
+      twaiStartMs = now;
+      captureStartMs = now;
+    }
+  }
+  if (captureStartMs != SIM_NEVER) result.timeline.mark(BOOT_CAPTURE_STARTED, captureStartMs * 1000LL);
+
+  // Frames anteriores ao TWAI se perdem (a task de captura é criada logo
+  // depois dele nas duas ordens)
+  uint32_t beforeTwai = twaiStartMs == SIM_NEVER ? SIM_END_MS : twaiStartMs;
+  result.lostFrames = (uint32_t)((uint64_t)beforeTwai * busFps / 1000);
+  if (captureStartMs == SIM_NEVER) return;
+  // Primeiro frame: o próximo do barramento depois do início da captura
+  uint32_t frameGapMs = busFps > 0 ? (1000 + busFps - 1) / busFps : SIM_NEVER;
+  result.timeline.mark(BOOT_FIRST_FRAME, (int64_t)(captureStartMs + frameGapMs) * 1000LL);
+
+  // --- task de envio: WifiLink::maintain(), broker e ciclos de 50 ms ---
+  uint32_t brokerUpMs = SIM_NEVER;
+  uint32_t nextCycleMs = now;
+  for (; now < SIM_END_MS; now += SIM_STEP_MS) {
+    if (now < nextCycleMs) continue;
+    nextCycleMs = now + SIM_UPLINK_CYCLE_MS;
+
+    bool up = ap.connected(now);
+    if (!up && now - lastAttemptMs >= retryMs) {
+      lastAttemptMs = now;
+      if (ordering == ORDER_NOW && retryMs < 60000) retryMs *= 2;
+      ap.begin(now); // disconnect() + begin(): a associação recomeça
+    }
+    if (!up) continue;
+    result.timeline.mark(BOOT_LINK_UP, (int64_t)now * 1000);
+    if (brokerUpMs == SIM_NEVER) brokerUpMs = now + SIM_BROKER_CONNECT_MS;
+    if (now >= brokerUpMs) {
+      result.timeline.mark(BOOT_FIRST_UPLINK, (int64_t)now * 1000);
+      break;
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t busFps = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 400;
+  if (busFps == 0) return 1;
+  printf("barramento: %lu frames/s desde o instante 0 | SD %d ms | broker %d ms | "
+         "%d s simulados\n\n",
+         (unsigned long)busFps, SIM_SD_MOUNT_MS, SIM_BROKER_CONNECT_MS, SIM_END_MS / 1000);
+
+  static const uint32_t ASSOCIATION_MS[] = {800, 4000, 8000, 12000, SIM_NEVER};
+  static const char *const ORDER_NAMES[] = {"antes", "websocket", "agora"};
+
+  printf("%-12s %-10s %-60s %s\n", "associação", "ordem", "marcos (ms desde o boot)",
+         "frames perdidos");
+  for (size_t a = 0; a < sizeof(ASSOCIATION_MS) / sizeof(ASSOCIATION_MS[0]); a++) {
+    char label[16];
+    if (ASSOCIATION_MS[a] == SIM_NEVER) {
+      snprintf(label, sizeof(label), "AP fora");
+    } else {
+      snprintf(label, sizeof(label), "%.1f s", ASSOCIATION_MS[a] / 1000.0);
+    }
+    for (int o = ORDER_BEFORE; o <= ORDER_NOW; o++) {
+      BootResult result;
+      simulate((Ordering)o, ASSOCIATION_MS[a], busFps, result);
+      char timeline[96];
+      result.timeline.format(timeline, sizeof(timeline));
+      printf("%-12s %-10s %-60s %lu\n", o == ORDER_BEFORE ? label : "", ORDER_NAMES[o],
+             timeline, (unsigned long)result.lostFrames);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,291 @@
+// ------------------------------------------------------------------
+// Reprodução no PC da captura pelo detector de ausência (src/common/bus_stats.h)
+// ------------------------------------------------------------------
+// Passa a captura do barramento (_can_log.csv, "ms,0xID,S|E,dlc,HEX") pelo
+// BusStats no tempo da própria captura, chamando checkMissing() a cada
+// 100 ms como a task de decodificação. A captura tem duas sessões (o ms
+// volta a zero); a segunda é deslocada para continuar a primeira.
+//
+// Cenários:
+//   original:   captura intacta; alarmes aqui são falsos positivos
+//   lacuna:     o controlador (0x300) some por LACUNA_MS no meio da sessão
+//               e volta: alarme e recuperação obrigatórios
+//   corte:      a bateria (0x120) para de vez a CORTE_MS do fim: alarme
+//               obrigatório, dentro do prazo aprendido, sem recuperação
+//   silêncio:   o barramento inteiro cala depois do último frame: um
+//               alarme de barramento calado e nenhum alarme por ID
+//   volta:      a captura repetida por VOLTA_TOTAL_MS (mais que os
+//               ~71,6 min em que o carimbo de 32 bits dá a volta); o
+//               controlador (0x300) some VOLTA_CORTE_MS depois de o
+//               carimbo repassar o do seu primeiro frame, ainda dentro
+//               do learnUs contado a partir dele: alarme obrigatório e
+//               nenhum alarme falso dos IDs rápidos na volta
+// Termina com código 2 se algum cenário não se comportar assim.
+//
+// Compilação:
+//   g++ -std=c++11 -O2 -Wall tools/bus_stats_replay.cpp -o .build/bus_stats_replay
+// Uso:
+//   .build/bus_stats_replay ["src/esp32/_can_log (2).csv"]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "../src/common/bus_stats.h"
+#include "../src/common/capture_replay.h"
+
+#define CHECK_INTERVAL_US 100000UL   // BUS_CHECK_INTERVAL_MS do firmware
+#define SUMMARY_INTERVAL_US 10000000UL // QUEUE_REPORT_INTERVAL_MS
+#define SESSION_GAP_US 100000UL      // Entre o fim de uma sessão e o início da outra
+#define LACUNA_MS 3000UL
+#define CORTE_MS 60000UL
+#define SILENCIO_MS 12000UL
+#define VOLTA_TOTAL_MS 4500000ULL // 75 min
+#define VOLTA_CORTE_MS 5000ULL
+
+struct Alarm {
+  uint32_t id;
+  uint64_t atUs;
+  uint32_t silentUs;
+  uint32_t timeoutUs;
+};
+
+struct Recovery {
+  uint32_t id;
+  uint64_t atUs;
+};
+
+struct ReplayResult {
+  std::vector<Alarm> alarms;
+  std::vector<Recovery> recoveries;
+  BusSummary last;
+  uint16_t summaries;
+  uint32_t maxLoadDeci;
+};
+
+/**
+ * @brief Reproduz os frames em ordem; checkMissing() a cada 100 ms de captura
+ * @param tailUs Tempo extra depois do último frame (silêncio total)
+ */
+static ReplayResult replay(const std::vector<CaptureFrame> &frames, BusStats<64> &stats,
+                           uint64_t tailUs, bool verbose) {
+  ReplayResult result;
+  result.summaries = 0;
+  result.maxLoadDeci = 0;
+  stats.begin();
+
+  uint64_t start = frames.front().us;
+  uint64_t nextCheck = start + CHECK_INTERVAL_US, nextSummary = start + SUMMARY_INTERVAL_US;
+  uint64_t end = frames.back().us + tailUs;
+  size_t next = 0;
+  uint64_t nowUs = start;
+
+  while (nowUs <= end) {
+    uint64_t tick = nextCheck < nextSummary ? nextCheck : nextSummary;
+    while (next < frames.size() && frames[next].us <= tick) {
+      CanMessage message = frames[next].message;
+      message.timestampUs = (uint32_t)frames[next].us;
+      if (stats.record(message) == BUS_EVENT_RECOVERED) {
+        Recovery recovery = {message.id, frames[next].us};
+        result.recoveries.push_back(recovery);
+      }
+      next++;
+    }
+    nowUs = tick;
+
+    if (nowUs == nextCheck) {
+      nextCheck += CHECK_INTERVAL_US;
+      stats.checkMissing((uint32_t)nowUs, [&](const BusIdStats &entry, uint32_t silentUs) {
+        Alarm alarm = {entry.id(), nowUs, silentUs, stats.timeoutUs(entry)};
+        result.alarms.push_back(alarm);
+      });
+    }
+    if (nowUs == nextSummary) {
+      nextSummary += SUMMARY_INTERVAL_US;
+      stats.summarize((uint32_t)nowUs, result.last);
+      result.summaries++;
+      if (result.last.loadDeci > result.maxLoadDeci) result.maxLoadDeci = result.last.loadDeci;
+      if (verbose) {
+        printf("  t=%6.1fs carga=%u.%u%% %lu frames/s ids=%u top:", (nowUs - start) / 1e6,
+               result.last.loadDeci / 10, result.last.loadDeci % 10, (unsigned long)result.last.fps,
+               result.last.ids);
+        for (uint8_t i = 0; i < result.last.topCount; i++) {
+          printf(" 0x%lX(%u.%u%%)", (unsigned long)result.last.top[i].id,
+                 result.last.top[i].shareDeci / 10, result.last.top[i].shareDeci % 10);
+        }
+        printf("\n");
+      }
+    }
+  }
+  return result;
+}
+
+static void printAlarms(const ReplayResult &result) {
+  for (size_t i = 0; i < result.alarms.size(); i++) {
+    const Alarm &a = result.alarms[i];
+    printf("  alarme 0x%lX: %lu ms sem frame (prazo %lu ms)\n", (unsigned long)a.id,
+           (unsigned long)(a.silentUs / 1000), (unsigned long)(a.timeoutUs / 1000));
+  }
+  for (size_t i = 0; i < result.recoveries.size(); i++) {
+    printf("  voltou 0x%lX\n", (unsigned long)result.recoveries[i].id);
+  }
+}
+
+static size_t countAlarms(const ReplayResult &result, uint32_t id) {
+  size_t n = 0;
+  for (size_t i = 0; i < result.alarms.size(); i++) n += result.alarms[i].id == id;
+  return n;
+}
+
+static size_t countRecoveries(const ReplayResult &result, uint32_t id) {
+  size_t n = 0;
+  for (size_t i = 0; i < result.recoveries.size(); i++) n += result.recoveries[i].id == id;
+  return n;
+}
+
+int main(int argc, char **argv) {
+  const char *path = argc > 1 ? argv[1] : "src/esp32/_can_log (2).csv";
+  std::vector<CaptureFrame> frames;
+  if (!loadCapture(path, frames, SESSION_GAP_US)) {
+    fprintf(stderr, "uso: bus_stats_replay [captura.csv]\n");
+    return 1;
+  }
+  uint64_t duration = frames.back().us - frames.front().us;
+  printf("%s: %lu frames em %.1f s\n", path, (unsigned long)frames.size(), duration / 1e6);
+
+  BusStats<64> stats;
+  bool ok = true;
+
+  // --- ORIGINAL: estatística por ID e falsos positivos ---
+  printf("\n[original]\n");
+  ReplayResult original = replay(frames, stats, 0, true);
+  printf("\n  %-10s %6s %9s %9s %9s %9s %9s\n", "ID", "frames", "período", "jitter", "mín", "máx",
+         "prazo");
+  std::vector<uint32_t> seen;
+  for (size_t i = 0; i < frames.size(); i++) {
+    bool known = false;
+    for (size_t j = 0; j < seen.size() && !known; j++) known = seen[j] == frames[i].message.id;
+    if (known) continue;
+    seen.push_back(frames[i].message.id);
+    const BusIdStats *entry = stats.find(frames[i].message.id, frames[i].message.isExtended);
+    if (!entry) continue;
+    printf("  0x%-8lX %6lu %7lums %7lums %7lums %7lums %7lums\n", (unsigned long)entry->id(),
+           (unsigned long)entry->count, (unsigned long)(entry->periodUs / 1000),
+           (unsigned long)(entry->jitterUs / 1000), (unsigned long)(entry->minGapUs / 1000),
+           (unsigned long)(entry->maxGapUs / 1000), (unsigned long)(stats.timeoutUs(*entry) / 1000));
+  }
+  printf("  carga máxima %u.%u%%, %lu alarmes\n", original.maxLoadDeci / 10, original.maxLoadDeci % 10,
+         (unsigned long)original.alarms.size());
+  printAlarms(original);
+  // Os IDs rápidos (controlador e BMS, ~150 ms) não podem dar alarme falso
+  if (countAlarms(original, 0x300) || countAlarms(original, 0x301)) {
+    printf("  FALHA: alarme falso em ID rápido\n");
+    ok = false;
+  }
+
+  // --- LACUNA: 0x300 some por LACUNA_MS e volta ---
+  printf("\n[lacuna] 0x300 ausente por %lu ms\n", LACUNA_MS);
+  uint64_t gapStart = frames.front().us + duration / 2;
+  std::vector<CaptureFrame> withGap;
+  for (size_t i = 0; i < frames.size(); i++) {
+    bool dropped = frames[i].message.id == 0x300 && frames[i].us >= gapStart &&
+                   frames[i].us < gapStart + LACUNA_MS * 1000ULL;
+    if (!dropped) withGap.push_back(frames[i]);
+  }
+  ReplayResult gap = replay(withGap, stats, 0, false);
+  printAlarms(gap);
+  if (countAlarms(gap, 0x300) != countAlarms(original, 0x300) + 1 ||
+      countRecoveries(gap, 0x300) != countRecoveries(original, 0x300) + 1) {
+    printf("  FALHA: esperado um alarme e uma recuperação de 0x300\n");
+    ok = false;
+  }
+
+  // --- CORTE: 0x120 para de vez ---
+  printf("\n[corte] 0x120 ausente nos últimos %lu ms\n", CORTE_MS);
+  uint64_t cut = frames.back().us - CORTE_MS * 1000ULL;
+  std::vector<CaptureFrame> withCut;
+  uint64_t lastBattery = 0;
+  for (size_t i = 0; i < frames.size(); i++) {
+    if (frames[i].message.id == 0x120 && frames[i].us >= cut) continue;
+    if (frames[i].message.id == 0x120) lastBattery = frames[i].us;
+    withCut.push_back(frames[i]);
+  }
+  ReplayResult cutResult = replay(withCut, stats, 0, false);
+  printAlarms(cutResult);
+  bool raised = false;
+  for (size_t i = 0; i < cutResult.alarms.size(); i++) {
+    const Alarm &a = cutResult.alarms[i];
+    if (a.id != 0x120 || a.atUs < cut) continue;
+    raised = true;
+    printf("  0x120 cobrado %.1f s depois do último frame\n", (a.atUs - lastBattery) / 1e6);
+  }
+  bool stillMissing = false;
+  for (uint8_t i = 0; i < cutResult.last.missingCount && i < BUS_SUMMARY_MISSING; i++) {
+    stillMissing |= cutResult.last.missing[i].id == 0x120;
+  }
+  if (!raised || !stillMissing) {
+    printf("  FALHA: 0x120 deveria estar em alarme no último resumo\n");
+    ok = false;
+  }
+
+  // --- SILÊNCIO: nada chega depois do último frame ---
+  printf("\n[silêncio] barramento calado por %lu ms no fim\n", SILENCIO_MS);
+  ReplayResult silence = replay(frames, stats, SILENCIO_MS * 1000ULL, false);
+  printAlarms(silence);
+  printf("  barramento calado=%s, alarmes de silêncio=%lu\n", silence.last.busSilent ? "sim" : "não",
+         (unsigned long)silence.last.silences);
+  if (!silence.last.busSilent || silence.last.silences != 1 ||
+      silence.alarms.size() != original.alarms.size()) {
+    printf("  FALHA: esperado só o alarme de barramento calado\n");
+    ok = false;
+  }
+
+  // --- VOLTA: o carimbo de 32 bits dá a volta durante a captura ---
+  printf("\n[volta] captura repetida por %.0f min, 0x300 some depois da volta\n",
+         VOLTA_TOTAL_MS / 60000.0);
+  std::vector<CaptureFrame> looped;
+  uint64_t lap = duration + SESSION_GAP_US;
+  for (uint64_t offset = 0; offset < VOLTA_TOTAL_MS * 1000ULL; offset += lap) {
+    for (size_t i = 0; i < frames.size(); i++) {
+      CaptureFrame frame = frames[i];
+      frame.us += offset;
+      looped.push_back(frame);
+    }
+  }
+  ReplayResult lapped = replay(looped, stats, 0, false);
+  printf("  sem corte: %lu alarmes (0x300: %lu, 0x301: %lu)\n", (unsigned long)lapped.alarms.size(),
+         (unsigned long)countAlarms(lapped, 0x300), (unsigned long)countAlarms(lapped, 0x301));
+  if (countAlarms(lapped, 0x300) || countAlarms(lapped, 0x301)) {
+    printf("  FALHA: alarme falso em ID rápido depois da volta\n");
+    ok = false;
+  }
+
+  uint64_t firstController = 0;
+  for (size_t i = 0; i < looped.size() && !firstController; i++) {
+    if (looped[i].message.id == 0x300) firstController = looped[i].us;
+  }
+  uint64_t wrapCut = (1ULL << 32) + (uint32_t)firstController + VOLTA_CORTE_MS * 1000ULL;
+  std::vector<CaptureFrame> wrapped;
+  for (size_t i = 0; i < looped.size(); i++) {
+    if (looped[i].message.id == 0x300 && looped[i].us >= wrapCut) continue;
+    wrapped.push_back(looped[i]);
+  }
+  ReplayResult wrapResult = replay(wrapped, stats, 0, false);
+  bool wrapRaised = false;
+  for (size_t i = 0; i < wrapResult.alarms.size(); i++) {
+    const Alarm &a = wrapResult.alarms[i];
+    if (a.id != 0x300 || a.atUs < wrapCut || wrapRaised) continue;
+    wrapRaised = true;
+    printf("  0x300 cobrado %.1f s depois do corte (prazo %lu ms)\n", (a.atUs - wrapCut) / 1e6,
+           (unsigned long)(a.timeoutUs / 1000));
+  }
+  if (!wrapRaised) {
+    printf("  FALHA: 0x300 sumiu depois da volta do carimbo e não foi cobrado\n");
+    ok = false;
+  }
+
+  printf("\n%s\n", ok ? "OK" : "FALHOU");
+  return ok ? 0 : 2;
+}
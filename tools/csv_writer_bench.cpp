@@ -0,0 +1,387 @@
+// ------------------------------------------------------------------
+// Benchmark e validação no PC das linhas CSV sem printf
+// (src/common/csv_writer.h e as funções *ToCsv / formatCaptureLine)
+// ------------------------------------------------------------------
+// Confere byte a byte contra os printf de antes:
+//   estado  : "%lu,%s,%d,%.1f,%.1f,%.1f,%d,%d,%d,%d\n" (SdCsvSink)
+//   viagem  : a linha de SD_TRIP_FILE (tensao_min em %.1f)
+//   alarme  : "%lu,%u,%s,%d,%ld,%ld\n" (SD_ALARM_FILE)
+//   captura : "%lu,0x%lX,%s,%u," e "%02X" por byte (logCanFrame)
+// com os estados do simulador e com valores aleatórios em toda a faixa
+// de int32 (inclusive INT32_MIN/MAX). Termina com código 2 se divergir.
+//
+// Mede linhas/s da linha de estado no log em blocos (BlockLog sobre um
+// arquivo em RAM, sem o custo do cartão), como o SdCsvSink grava:
+//   snprintf + write : o caminho de antes (linha na pilha, cópia no bloco)
+//   CsvWriter + write: mesma cópia, formatação sem printf
+//   CsvWriter no bloco: direto em cursor(), sem cópia (o caminho de agora)
+// Antes, a linha de estado só formatada (sem o log, cujo CRC por bloco
+// pesa no total), e no fim as linhas de captura (snprintf contra
+// formatCaptureLine).
+//
+// Compilação (precisa de config/constants.h):
+//   g++ -std=c++11 -O2 tools/csv_writer_bench.cpp -o .build/csv_writer_bench
+// Uso:
+//   .build/csv_writer_bench [linhas] [repetições]
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "../src/common/block_log.h"
+#include "../src/common/capture_csv.h"
+#include "../src/common/rule_engine.h"
+#include "../src/common/trip_stats.h"
+#include "../src/common/vehicle_sim.h"
+#include "../src/common/vehicle_state.h"
+
+#define BENCH_LINE_BYTES 256
+#define BENCH_LOG_BLOCKS 64
+#define BENCH_STATE_LINE_MAX 128 // SD_STATE_LINE_MAX de sink_sd.h
+
+struct Row {
+  VehicleState state;
+  uint32_t ms;
+};
+
+// ------------------------------------------------------------------
+// --- OS PRINTF DE ANTES ---
+// ------------------------------------------------------------------
+
+static int statePrintf(const VehicleState &s, uint32_t ms, char *out, size_t size) {
+  const BatteryState &b = s.battery;
+  const MotorState &m = s.motor;
+  return snprintf(out, size, "%lu,%s,%d,%.1f,%.1f,%.1f,%d,%d,%d,%d\n",
+                  (unsigned long)ms, rideModeName(m.mode),
+                  (int)m.rpm, m.torqueDeci / 10.0, b.voltageDeci / 10.0,
+                  b.currentDeci / 10.0, (int)b.soc, (int)b.temperature,
+                  (int)m.motorTemp, (int)m.controllerTemp);
+}
+
+static int tripPrintf(const TripSummary &t, uint32_t endMs, char *out, size_t size) {
+  return snprintf(out, size,
+                  "%lu,%lu,%lu,%lu,%lu,%ld,%ld,%ld,%lu,%ld,%ld,%ld,%ld,%.1f,%ld,%ld,%lu,%lu,%lu,%lu\n",
+                  (unsigned long)t.number, (unsigned long)endMs, (unsigned long)t.durationMs,
+                  (unsigned long)t.consumedMilliWh, (unsigned long)t.regenMilliWh,
+                  (long)t.peakPowerW, (long)t.peakRegenW, (long)t.avgPowerW,
+                  (unsigned long)t.distanceM, (long)t.maxRpm, (long)t.maxMotorTemp,
+                  (long)t.maxControllerTemp, (long)t.maxBatteryTemp, t.minVoltageDeci / 10.0,
+                  (long)t.socStart, (long)t.socEnd, (unsigned long)t.modeMs[TRIP_MODE_ECO],
+                  (unsigned long)t.modeMs[TRIP_MODE_STD], (unsigned long)t.modeMs[TRIP_MODE_TURBO],
+                  (unsigned long)t.modeMs[TRIP_MODE_OTHER]);
+}
+
+static int alarmPrintf(const RuleEvent &e, uint32_t ms, char *out, size_t size) {
+  return snprintf(out, size, "%lu,%u,%s,%d,%ld,%ld\n", (unsigned long)ms, (unsigned)e.ruleId,
+                  windowSignalName(e.signal), e.active ? 1 : 0, (long)e.value,
+                  (long)e.threshold);
+}
+
+static int capturePrintf(const CaptureLine &row, char *out, size_t size) {
+  int length = snprintf(out, size, "%lu,0x%lX,%s,%u,", (unsigned long)row.ms,
+                        (unsigned long)row.id, row.isExtended ? "E" : "S", (unsigned)row.length);
+  for (int i = 0; i < row.length && i < 8; i++) {
+    length += snprintf(out + length, size - length, "%02X", row.data[i]);
+  }
+  out[length++] = '\n';
+  return length;
+}
+
+// ------------------------------------------------------------------
+// --- DADOS E CONFERÊNCIA ---
+// ------------------------------------------------------------------
+
+/**
+ * @brief Arquivo do BlockLog em RAM: mede a formatação, não o cartão
+ */
+class MemoryLogFile {
+public:
+  bool open(const char *, bool) {
+    open_ = true;
+    return true;
+  }
+  void close() { open_ = false; }
+  bool isOpen() const { return open_; }
+  uint32_t size() { return (uint32_t)data_.size(); }
+  bool reserve(uint32_t bytes) {
+    if (data_.size() < bytes) data_.resize(bytes);
+    return true;
+  }
+  bool seek(uint32_t offset) {
+    position_ = offset;
+    return offset <= data_.size();
+  }
+  size_t read(void *data, size_t length) {
+    memcpy(data, &data_[position_], length);
+    position_ += (uint32_t)length;
+    return length;
+  }
+  size_t write(const void *data, size_t length) {
+    memcpy(&data_[position_], data, length);
+    position_ += (uint32_t)length;
+    return length;
+  }
+  bool sync() { return true; }
+
+private:
+  std::vector<uint8_t> data_;
+  uint32_t position_ = 0;
+  bool open_ = false;
+};
+
+typedef BlockLog<MemoryLogFile> BenchLog;
+
+static uint32_t nextRandom(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+/** @brief Aleatório em toda a faixa, com os extremos de vez em quando */
+static int32_t randomI32(uint32_t &state) {
+  switch (nextRandom(state) % 16) {
+    case 0: return INT32_MIN;
+    case 1: return INT32_MAX;
+    case 2: return 0;
+    case 3: return -(int32_t)(nextRandom(state) % 20);
+    default: return (int32_t)nextRandom(state) >> (nextRandom(state) % 32);
+  }
+}
+
+/**
+ * @brief Estado depois de cada frame de bateria/controlador do simulador
+ */
+static void buildRows(uint32_t count, std::vector<Row> &rows) {
+  VehicleSim sim;
+  sim.setBusLoad(0);
+  VehicleState state;
+  SimFrame frame;
+  rows.reserve(count);
+  while (rows.size() < count) {
+    sim.nextFrame(frame);
+    uint32_t ms = (uint32_t)(frame.timeUs / 1000);
+    if (!applyFrame(state, frame.id, frame.data, frame.length, ms)) continue;
+    Row row;
+    row.state = state;
+    row.ms = ms;
+    rows.push_back(row);
+  }
+}
+
+static bool same(const char *what, uint32_t index, const char *expected, int expectedLength,
+                 const char *actual, int actualLength) {
+  if (expectedLength == actualLength && memcmp(expected, actual, actualLength) == 0) return true;
+  printf("DIVERGE %s %lu:\n  printf : %.*s  writer : %.*s", what, (unsigned long)index,
+         expectedLength, expected, actualLength, actual);
+  return false;
+}
+
+static bool checkRows(const std::vector<Row> &rows, uint32_t count) {
+  char expected[BENCH_LINE_BYTES], actual[BENCH_LINE_BYTES];
+  for (uint32_t i = 0; i < rows.size(); i++) {
+    int a = statePrintf(rows[i].state, rows[i].ms, expected, sizeof(expected));
+    int b = vehicleStateToCsv(rows[i].state, rows[i].ms, actual, sizeof(actual));
+    if (!same("estado do simulador", i, expected, a, actual, b)) return false;
+  }
+
+  static const uint8_t MODES[] = {RIDE_MODE_ECO, RIDE_MODE_STD, RIDE_MODE_TURBO, 0};
+  uint32_t state = 0x1234567;
+  for (uint32_t i = 0; i < count; i++) {
+    VehicleState s;
+    s.battery.voltageDeci = randomI32(state);
+    s.battery.currentDeci = randomI32(state);
+    s.battery.soc = randomI32(state);
+    s.battery.temperature = randomI32(state);
+    s.motor.rpm = randomI32(state);
+    s.motor.torqueDeci = randomI32(state);
+    s.motor.motorTemp = randomI32(state);
+    s.motor.controllerTemp = randomI32(state);
+    s.motor.mode = MODES[nextRandom(state) % 4];
+    uint32_t ms = nextRandom(state);
+    int a = statePrintf(s, ms, expected, sizeof(expected));
+    int b = vehicleStateToCsv(s, ms, actual, sizeof(actual));
+    if (!same("estado aleatório", i, expected, a, actual, b)) return false;
+
+    TripSummary t;
+    t.number = nextRandom(state);
+    t.durationMs = nextRandom(state);
+    t.consumedMilliWh = nextRandom(state);
+    t.regenMilliWh = nextRandom(state);
+    t.peakPowerW = randomI32(state);
+    t.peakRegenW = randomI32(state);
+    t.avgPowerW = randomI32(state);
+    t.distanceM = nextRandom(state);
+    t.maxRpm = randomI32(state);
+    t.maxMotorTemp = randomI32(state);
+    t.maxControllerTemp = randomI32(state);
+    t.maxBatteryTemp = randomI32(state);
+    t.minVoltageDeci = randomI32(state);
+    t.socStart = randomI32(state);
+    t.socEnd = randomI32(state);
+    for (uint8_t m = 0; m < TRIP_MODE_COUNT; m++) t.modeMs[m] = nextRandom(state);
+    a = tripPrintf(t, ms, expected, sizeof(expected));
+    b = tripSummaryToCsv(t, ms, actual, sizeof(actual));
+    if (!same("viagem", i, expected, a, actual, b)) return false;
+
+    RuleEvent e;
+    e.timestampUs = 0;
+    e.ruleId = (uint16_t)nextRandom(state);
+    e.signal = (uint8_t)(nextRandom(state) % WINDOW_SIGNAL_COUNT);
+    e.active = nextRandom(state) & 1;
+    e.value = randomI32(state);
+    e.threshold = randomI32(state);
+    a = alarmPrintf(e, ms, expected, sizeof(expected));
+    b = ruleEventToCsv(e, ms, actual, sizeof(actual));
+    if (!same("alarme", i, expected, a, actual, b)) return false;
+
+    CaptureLine row;
+    row.ms = ms;
+    row.id = nextRandom(state) >> (nextRandom(state) % 32);
+    row.isExtended = nextRandom(state) & 1;
+    row.length = (uint8_t)(nextRandom(state) % 9);
+    for (uint8_t d = 0; d < 8; d++) row.data[d] = d < row.length ? (uint8_t)nextRandom(state) : 0;
+    a = capturePrintf(row, expected, sizeof(expected));
+    b = formatCaptureLine(row, actual, sizeof(actual));
+    if (!same("captura", i, expected, a, actual, b)) return false;
+    expected[a] = '\0';
+    CaptureLine back;
+    if (!parseCaptureLine(expected, back) || back.id != row.id || back.ms != row.ms ||
+        back.length != row.length || memcmp(back.data, row.data, sizeof(row.data)) != 0) {
+      printf("DIVERGE captura %lu não volta por parseCaptureLine: %s", (unsigned long)i, expected);
+      return false;
+    }
+  }
+  return true;
+}
+
+// ------------------------------------------------------------------
+// --- MEDIÇÃO ---
+// ------------------------------------------------------------------
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+enum StatePath { PATH_PRINTF, PATH_WRITER_COPY, PATH_WRITER_DIRECT };
+
+/**
+ * @brief Linhas de estado por segundo no BlockLog, como SdCsvSink::write
+ */
+static double stateRowsPerSecond(const std::vector<Row> &rows, StatePath path,
+                                 uint32_t repetitions, uint32_t &bytes) {
+  BenchLog log;
+  log.begin("ram", BENCH_LOG_BLOCKS);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (uint32_t rep = 0; rep < repetitions; rep++) {
+    for (size_t i = 0; i < rows.size(); i++) {
+      const Row &r = rows[i];
+      if (path == PATH_WRITER_DIRECT && log.available() >= BENCH_STATE_LINE_MAX) {
+        int length = vehicleStateToCsv(r.state, r.ms, log.cursor(), BENCH_STATE_LINE_MAX);
+        if (length > 0) log.commit(length);
+        continue;
+      }
+      char line[BENCH_STATE_LINE_MAX];
+      int length = path == PATH_PRINTF ? statePrintf(r.state, r.ms, line, sizeof(line))
+                                       : vehicleStateToCsv(r.state, r.ms, line, sizeof(line));
+      if (length > 0 && length < (int)sizeof(line)) log.write(line, length);
+    }
+  }
+  double seconds = secondsSince(start);
+  bytes = log.stats().written;
+  return (double)rows.size() * repetitions / seconds;
+}
+
+/**
+ * @brief Só a formatação da linha de estado, sem o log
+ */
+static double stateFormatPerSecond(const std::vector<Row> &rows, bool writer,
+                                   uint32_t repetitions, uint32_t &bytes) {
+  char line[BENCH_STATE_LINE_MAX];
+  bytes = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (uint32_t rep = 0; rep < repetitions; rep++) {
+    for (size_t i = 0; i < rows.size(); i++) {
+      const Row &r = rows[i];
+      bytes += (uint32_t)(writer ? vehicleStateToCsv(r.state, r.ms, line, sizeof(line))
+                                 : statePrintf(r.state, r.ms, line, sizeof(line)));
+    }
+  }
+  return (double)rows.size() * repetitions / secondsSince(start);
+}
+
+static double captureRowsPerSecond(const std::vector<CaptureLine> &lines, bool writer,
+                                   uint32_t repetitions, uint32_t &bytes) {
+  char line[CAPTURE_LINE_MAX];
+  bytes = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (uint32_t rep = 0; rep < repetitions; rep++) {
+    for (size_t i = 0; i < lines.size(); i++) {
+      bytes += (uint32_t)(writer ? formatCaptureLine(lines[i], line, sizeof(line))
+                                 : capturePrintf(lines[i], line, sizeof(line)));
+    }
+  }
+  return (double)lines.size() * repetitions / secondsSince(start);
+}
+
+static void printRow(const char *shape, const char *path, double rowsPerSecond, double base,
+                     uint32_t bytes) {
+  printf("%-9s %-18s %12.0f %9.1f %8.2fx %10lu\n", shape, path, rowsPerSecond,
+         1e9 / rowsPerSecond, rowsPerSecond / base, (unsigned long)bytes);
+}
+
+int main(int argc, char **argv) {
+  uint32_t count = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 200000;
+  uint32_t repetitions = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 5;
+  if (count == 0 || repetitions == 0) return 1;
+
+  std::vector<Row> rows;
+  buildRows(count, rows);
+  bool ok = checkRows(rows, count);
+  printf("linhas = printf byte a byte (%lu estados do simulador, %lu aleatórios x 4 formatos): %s\n\n",
+         (unsigned long)rows.size(), (unsigned long)count, ok ? "OK" : "FALHA");
+
+  printf("%-9s %-18s %12s %9s %9s %10s\n", "linha", "caminho", "linhas/s", "ns/linha",
+         "vs printf", "bytes");
+  uint32_t bytes[3];
+  double base = stateFormatPerSecond(rows, false, repetitions, bytes[0]);
+  printRow("formato", "snprintf", base, base, bytes[0]);
+  double format = stateFormatPerSecond(rows, true, repetitions, bytes[1]);
+  printRow("formato", "vehicleStateToCsv", format, base, bytes[1]);
+
+  base = stateRowsPerSecond(rows, PATH_PRINTF, repetitions, bytes[0]);
+  printRow("estado", "snprintf + write", base, base, bytes[0]);
+  double copy = stateRowsPerSecond(rows, PATH_WRITER_COPY, repetitions, bytes[1]);
+  printRow("estado", "CsvWriter + write", copy, base, bytes[1]);
+  double direct = stateRowsPerSecond(rows, PATH_WRITER_DIRECT, repetitions, bytes[2]);
+  printRow("estado", "CsvWriter no bloco", direct, base, bytes[2]);
+  if (bytes[0] != bytes[1] || bytes[0] != bytes[2]) {
+    printf("DIVERGE bytes gravados no log\n");
+    ok = false;
+  }
+
+  VehicleSim sim;
+  sim.setBusLoad(100);
+  std::vector<CaptureLine> lines(count);
+  for (uint32_t i = 0; i < count; i++) {
+    SimFrame frame;
+    sim.nextFrame(frame);
+    lines[i].ms = (uint32_t)(frame.timeUs / 1000);
+    lines[i].id = frame.id;
+    lines[i].isExtended = frame.isExtended;
+    lines[i].length = frame.length <= 8 ? frame.length : 8;
+    memcpy(lines[i].data, frame.data, sizeof(lines[i].data));
+  }
+  uint32_t captureBytes;
+  base = captureRowsPerSecond(lines, false, repetitions, captureBytes);
+  printRow("captura", "snprintf", base, base, captureBytes);
+  double capture = captureRowsPerSecond(lines, true, repetitions, captureBytes);
+  printRow("captura", "formatCaptureLine", capture, base, captureBytes);
+
+  printf("%s\n", ok ? "OK" : "FALHA");
+  return ok ? 0 : 2;
+}
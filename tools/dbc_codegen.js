@@ -0,0 +1,387 @@
+#!/usr/bin/env node
+// ------------------------------------------------------------------
+// Gerador dos decodificadores CAN a partir do DBC do barramento Voltz
+// ------------------------------------------------------------------
+// Lê config/voltz.dbc e gera:
+//   src/common/voltz_signals.h  tipos por sinal (decodificação especializada
+//                               em tempo de compilação) + tabelas constantes
+//   utils/voltzSignals.js       tabelas e funções decode<Mensagem> do backend
+// Os dois arquivos gerados ficam no repositório (a IDE do Arduino não roda
+// passos de build); tests/utils/voltzSignals.test.js falha se estiverem
+// desatualizados em relação ao DBC.
+//
+// Suporta o subconjunto usado: BO_, SG_ (sem multiplexação), CM_ ignorado,
+// VAL_ para tabelas de valores.
+//
+// Uso:
+//   node tools/dbc_codegen.js            (regrava os dois arquivos)
+//   node tools/dbc_codegen.js --check    (código de saída 1 se desatualizados)
+
+const fs = require('fs');
+const path = require('path');
+
+const ROOT = path.join(__dirname, '..');
+const DBC_FILE = path.join(ROOT, 'config', 'voltz.dbc');
+const HEADER_FILE = path.join(ROOT, 'src', 'common', 'voltz_signals.h');
+const JS_FILE = path.join(ROOT, 'utils', 'voltzSignals.js');
+
+const CAN_EXTENDED_FLAG = 0x80000000;
+
+/**
+ * Interpreta o DBC
+ * @param {string} text - Conteúdo do arquivo .dbc
+ * @returns {Array<object>} Mensagens com {id, extended, name, dlc, sender, signals}
+ */
+function parseDbc(text) {
+  const messages = [];
+  let current = null;
+  const lines = text.split(/\r?\n/);
+
+  lines.forEach((raw, index) => {
+    const line = raw.trim();
+    const where = `linha ${index + 1}`;
+    let match;
+
+    if ((match = /^BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+(\w+)/.exec(line))) {
+      const rawId = Number(match[1]);
+      current = {
+        id: (rawId & ~CAN_EXTENDED_FLAG) >>> 0,
+        extended: (rawId & CAN_EXTENDED_FLAG) !== 0,
+        name: match[2],
+        dlc: Number(match[3]),
+        sender: match[4],
+        signals: []
+      };
+      messages.push(current);
+      return;
+    }
+
+    if (/^SG_\s/.test(line)) {
+      match = /^SG_\s+(\w+)\s*(\S+)?\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*\(([^,]+),([^)]+)\)\s*\[([^|]*)\|([^\]]*)\]\s*"([^"]*)"/.exec(line);
+      if (!match) throw new Error(`${where}: SG_ não reconhecido: ${line}`);
+      if (!current) throw new Error(`${where}: SG_ fora de um BO_`);
+      if (match[2]) throw new Error(`${where}: multiplexação não suportada (${match[1]})`);
+      const signal = {
+        name: match[1],
+        startBit: Number(match[3]),
+        length: Number(match[4]),
+        motorola: match[5] === '0',
+        signed: match[6] === '-',
+        factor: Number(match[7]),
+        offset: Number(match[8]),
+        min: Number(match[9]),
+        max: Number(match[10]),
+        unit: match[11],
+        values: null
+      };
+      checkSignal(signal, current, where);
+      current.signals.push(signal);
+      return;
+    }
+
+    if ((match = /^VAL_\s+(\d+)\s+(\w+)\s+(.*);\s*$/.exec(line))) {
+      const id = (Number(match[1]) & ~CAN_EXTENDED_FLAG) >>> 0;
+      const message = messages.find((m) => m.id === id);
+      const signal = message && message.signals.find((s) => s.name === match[2]);
+      if (!signal) throw new Error(`${where}: VAL_ para sinal desconhecido ${match[1]}.${match[2]}`);
+      signal.values = [];
+      const pair = /(-?\d+)\s+"([^"]*)"/g;
+      let value;
+      while ((value = pair.exec(match[3]))) {
+        signal.values.push({ value: Number(value[1]), label: value[2] });
+      }
+    }
+  });
+
+  return messages;
+}
+
+/** Bits ocupados pelo sinal, na numeração do DBC */
+function signalBits(signal) {
+  const bits = [];
+  let bit = signal.startBit;
+  for (let i = 0; i < signal.length; i++) {
+    bits.push(signal.motorola ? bit : signal.startBit + i);
+    if (signal.motorola) bit = bit % 8 === 0 ? bit + 15 : bit - 1;
+  }
+  return bits;
+}
+
+function checkSignal(signal, message, where) {
+  if (signal.length < 1 || signal.length > 32) {
+    throw new Error(`${where}: ${signal.name} com ${signal.length} bits (1..32)`);
+  }
+  const bits = signalBits(signal);
+  if (bits.some((bit) => bit < 0 || bit >= message.dlc * 8)) {
+    throw new Error(`${where}: ${signal.name} sai dos ${message.dlc} bytes de ${message.name}`);
+  }
+  for (const other of message.signals) {
+    const used = new Set(signalBits(other));
+    if (bits.some((bit) => used.has(bit))) {
+      throw new Error(`${where}: ${signal.name} sobrepõe ${other.name}`);
+    }
+  }
+  if (!(signal.factor > 0)) throw new Error(`${where}: fator inválido em ${signal.name}`);
+  // Fator e offset como frações de denominador potência de 10 (ponto fixo exato)
+  const integral = (value) => Math.abs(value - Math.round(value)) < 1e-9;
+  let den = 1;
+  while (den <= 1e6 && !(integral(signal.factor * den) && integral(signal.offset * den))) den *= 10;
+  if (den > 1e6) throw new Error(`${where}: fator/offset de ${signal.name} sem representação decimal curta`);
+  signal.den = den;
+  signal.factorNum = Math.round(signal.factor * den);
+  signal.offsetNum = Math.round(signal.offset * den);
+}
+
+function hex(id, extended) {
+  const digits = id.toString(16).toUpperCase();
+  return `0x${extended ? digits.padStart(8, '0') : digits}`;
+}
+
+function cString(text) {
+  return `"${text.replace(/\\/g, '\\\\').replace(/"/g, '\\"')}"`;
+}
+
+function jsString(text) {
+  return `'${text.replace(/\\/g, '\\\\').replace(/'/g, "\\'")}'`;
+}
+
+function describeSignal(signal) {
+  const scale = signal.factor === 1 ? '' : `× ${signal.factor}`;
+  const offset = signal.offset === 0 ? '' : ` ${signal.offset > 0 ? '+' : '−'} ${Math.abs(signal.offset)}`;
+  const unit = signal.unit ? ` ${signal.unit}` : '';
+  const kind = `${signal.motorola ? 'BE' : 'LE'} ${signal.signed ? 'int' : 'uint'}${signal.length}`;
+  return `${kind} bit ${signal.startBit}${scale ? ` ${scale}` : ''}${offset}${unit}`.trim();
+}
+
+const GENERATED_NOTE = 'Gerado por tools/dbc_codegen.js a partir de config/voltz.dbc: não editar.\n' +
+  '// Altere o DBC e rode `node tools/dbc_codegen.js`.';
+
+/**
+ * Gera src/common/voltz_signals.h
+ * @param {Array<object>} messages - Saída de parseDbc
+ * @returns {string}
+ */
+function generateHeader(messages) {
+  const out = [];
+  out.push('#ifndef VOLTZ_SIGNALS_H');
+  out.push('#define VOLTZ_SIGNALS_H');
+  out.push('');
+  out.push('// ------------------------------------------------------------------');
+  out.push('// --- SINAIS DO BARRAMENTO VOLTZ (config/voltz.dbc) ---');
+  out.push('// ------------------------------------------------------------------');
+  out.push(`// ${GENERATED_NOTE}`);
+  out.push('//');
+  out.push('// Uso: dbcValue<voltz_dbc::Battery::voltage, 10>(data) devolve a tensão em');
+  out.push('// décimos de V; as tabelas SIGNALS/MESSAGES servem a quem percorre os');
+  out.push('// sinais em tempo de execução (dbcFixed).');
+  out.push('');
+  out.push('#include <stdint.h>');
+  out.push('#include "can_signal.h"');
+  out.push('');
+  out.push('namespace voltz_dbc {');
+
+  for (const message of messages) {
+    out.push('');
+    out.push(`// --- ${message.name}: ${hex(message.id, message.extended)}, ${message.dlc} bytes (${message.sender}) ---`);
+    out.push(`namespace ${message.name} {`);
+    out.push(`static const uint32_t ID = ${hex(message.id, message.extended)};`);
+    out.push(`static const bool EXTENDED = ${message.extended};`);
+    out.push(`static const uint8_t DLC = ${message.dlc};`);
+    out.push('');
+    for (const signal of message.signals) {
+      out.push(`struct ${signal.name} { // ${describeSignal(signal)}`);
+      out.push(`  static const uint8_t START_BIT = ${signal.startBit};`);
+      out.push(`  static const uint8_t LENGTH = ${signal.length};`);
+      out.push(`  static const bool MOTOROLA = ${signal.motorola};`);
+      out.push(`  static const bool IS_SIGNED = ${signal.signed};`);
+      out.push(`  static const int32_t FACTOR_NUM = ${signal.factorNum};`);
+      out.push(`  static const int32_t OFFSET_NUM = ${signal.offsetNum};`);
+      out.push(`  static const int32_t DEN = ${signal.den};`);
+      out.push('};');
+    }
+    out.push('');
+    out.push('static const DbcSignalSpec SIGNALS[] = {');
+    for (const signal of message.signals) {
+      out.push(`  {${cString(signal.name)}, ${signal.startBit}, ${signal.length}, ${signal.motorola}, ` +
+        `${signal.signed}, ${signal.factorNum}, ${signal.offsetNum}, ${signal.den}, ${cString(signal.unit)}},`);
+    }
+    out.push('};');
+    for (const signal of message.signals.filter((s) => s.values)) {
+      out.push('');
+      out.push(`/** @brief Rótulo do valor de ${signal.name} (VAL_), ou nullptr */`);
+      out.push(`inline const char *${signal.name}Name(int32_t value) {`);
+      out.push('  switch (value) {');
+      for (const { value, label } of signal.values) {
+        out.push(`    case ${value}: return ${cString(label)};`);
+      }
+      out.push('    default: return nullptr;');
+      out.push('  }');
+      out.push('}');
+    }
+    out.push(`} // namespace ${message.name}`);
+  }
+
+  out.push('');
+  out.push('static const DbcMessageSpec MESSAGES[] = {');
+  for (const message of messages) {
+    out.push(`  {${message.name}::ID, ${message.name}::EXTENDED, ${cString(message.name)}, ` +
+      `${message.name}::DLC, ${message.name}::SIGNALS, ${message.signals.length}},`);
+  }
+  out.push('};');
+  out.push(`static const uint8_t MESSAGE_COUNT = ${messages.length};`);
+  out.push('');
+  out.push('/** @brief Mensagem do DBC com este ID, ou nullptr */');
+  out.push('inline const DbcMessageSpec *findMessage(uint32_t id, bool extended) {');
+  out.push('  for (uint8_t i = 0; i < MESSAGE_COUNT; i++) {');
+  out.push('    if (MESSAGES[i].id == id && MESSAGES[i].extended == extended) return &MESSAGES[i];');
+  out.push('  }');
+  out.push('  return nullptr;');
+  out.push('}');
+  out.push('');
+  out.push('} // namespace voltz_dbc');
+  out.push('');
+  out.push('#endif // VOLTZ_SIGNALS_H');
+  out.push('');
+  return out.join('\n');
+}
+
+/** Expressão JS dos bits crus do sinal (bytes inteiros viram shifts diretos) */
+function rawExpression(signal) {
+  const bytes = signal.length / 8;
+  const aligned = signal.length % 8 === 0 &&
+    (signal.motorola ? signal.startBit % 8 === 7 : signal.startBit % 8 === 0);
+  if (!aligned) {
+    return `extractBits(data, ${signal.startBit}, ${signal.length}, ${signal.motorola}, ${signal.signed})`;
+  }
+  const first = Math.floor(signal.startBit / 8);
+  const order = [];
+  for (let i = 0; i < bytes; i++) order.push(signal.motorola ? first + i : first + bytes - 1 - i);
+
+  let expression;
+  if (bytes === 1) {
+    expression = `data[${order[0]}]`;
+  } else if (bytes < 4) {
+    expression = order.reduce((acc, index, i) =>
+      (i === 0 ? `(data[${index}] << ${8 * (bytes - 1)})` : `${acc} | ${i === bytes - 1 ? `data[${index}]` : `(data[${index}] << ${8 * (bytes - 1 - i)})`}`), '');
+    expression = `(${expression})`;
+  } else {
+    // 32 bits: multiplicação para não passar pelo int32 com sinal
+    expression = `(data[${order[0]}] * 0x1000000 + ((data[${order[1]}] << 16) | (data[${order[2]}] << 8) | data[${order[3]}]))`;
+  }
+  if (!signal.signed) return expression;
+  if (signal.length === 32) return `(${expression} | 0)`;
+  const shift = 32 - signal.length;
+  return `((${expression} << ${shift}) >> ${shift})`;
+}
+
+function physicalExpression(signal) {
+  let expression = rawExpression(signal);
+  if (signal.factorNum !== 1) expression = `${expression} * ${signal.factorNum}`;
+  if (signal.offsetNum !== 0) {
+    expression = `(${expression} ${signal.offsetNum > 0 ? '+' : '-'} ${Math.abs(signal.offsetNum)})`;
+  }
+  // Divisão no fim: 627 / 10 = 62.7 exato, 627 * 0.1 = 62.7000...01
+  return signal.den === 1 ? expression : `${expression} / ${signal.den}`;
+}
+
+/**
+ * Gera utils/voltzSignals.js
+ * @param {Array<object>} messages - Saída de parseDbc
+ * @returns {string}
+ */
+function generateJs(messages) {
+  const needsExtract = messages.some((message) =>
+    message.signals.some((signal) => rawExpression(signal).startsWith('extractBits')));
+  const out = [];
+  out.push('// utils/voltzSignals.js');
+  out.push(`// ${GENERATED_NOTE}`);
+  out.push('');
+  if (needsExtract) {
+    out.push('/** Bits crus de um sinal fora do alinhamento de bytes (numeração do DBC) */');
+    out.push('function extractBits(data, startBit, length, motorola, signed) {');
+    out.push('  let raw = 0;');
+    out.push('  let bit = startBit;');
+    out.push('  for (let i = 0; i < length; i++) {');
+    out.push('    const position = motorola ? bit : startBit + i;');
+    out.push('    const value = (data[position >> 3] >> (position & 7)) & 1;');
+    out.push('    raw = motorola ? raw * 2 + value : raw + value * 2 ** i;');
+    out.push('    if (motorola) bit = (bit & 7) === 0 ? bit + 15 : bit - 1;');
+    out.push('  }');
+    out.push('  return signed && raw >= 2 ** (length - 1) ? raw - 2 ** length : raw;');
+    out.push('}');
+    out.push('');
+  }
+
+  out.push('/** Layout de cada mensagem, como no DBC */');
+  out.push('const MESSAGES = {');
+  for (const message of messages) {
+    out.push(`  ${message.name}: {`);
+    out.push(`    id: ${hex(message.id, message.extended)},`);
+    out.push(`    extended: ${message.extended},`);
+    out.push(`    dlc: ${message.dlc},`);
+    out.push('    signals: [');
+    for (const signal of message.signals) {
+      const values = signal.values
+        ? `, values: { ${signal.values.map(({ value, label }) => `${value}: ${jsString(label)}`).join(', ')} }`
+        : '';
+      out.push(`      { name: ${jsString(signal.name)}, startBit: ${signal.startBit}, length: ${signal.length}, ` +
+        `motorola: ${signal.motorola}, signed: ${signal.signed}, factor: ${signal.factor}, ` +
+        `offset: ${signal.offset}, unit: ${jsString(signal.unit)}${values} },`);
+    }
+    out.push('    ]');
+    out.push(`  },`);
+  }
+  out.push('};');
+
+  for (const message of messages) {
+    out.push('');
+    out.push('/**');
+    out.push(` * Decodifica ${message.name} (${hex(message.id, message.extended)}) em valores físicos`);
+    out.push(` * @param {number[]|Uint8Array} data - Pelo menos ${message.dlc} bytes`);
+    out.push(' * @returns {object}');
+    out.push(' */');
+    out.push(`function decode${message.name}(data) {`);
+    out.push('  return {');
+    for (const signal of message.signals) {
+      out.push(`    ${signal.name}: ${physicalExpression(signal)}, // ${describeSignal(signal)}`);
+    }
+    out.push('  };');
+    out.push('}');
+  }
+
+  out.push('');
+  out.push('module.exports = {');
+  out.push('  MESSAGES,');
+  for (const message of messages) out.push(`  decode${message.name},`);
+  out.push('};');
+  out.push('');
+  return out.join('\n');
+}
+
+function generate(dbcText) {
+  const messages = parseDbc(dbcText);
+  return { header: generateHeader(messages), js: generateJs(messages) };
+}
+
+function main(argv) {
+  const { header, js } = generate(fs.readFileSync(DBC_FILE, 'utf8'));
+  const outputs = [[HEADER_FILE, header], [JS_FILE, js]];
+
+  if (argv.includes('--check')) {
+    const stale = outputs.filter(([file, text]) =>
+      !fs.existsSync(file) || fs.readFileSync(file, 'utf8') !== text);
+    for (const [file] of stale) console.error(`desatualizado: ${path.relative(ROOT, file)}`);
+    return stale.length > 0 ? 1 : 0;
+  }
+  for (const [file, text] of outputs) {
+    fs.writeFileSync(file, text);
+    console.log(`gerado: ${path.relative(ROOT, file)}`);
+  }
+  return 0;
+}
+
+if (require.main === module) {
+  process.exitCode = main(process.argv.slice(2));
+}
+
+module.exports = { parseDbc, generate, DBC_FILE, HEADER_FILE, JS_FILE };
@@ -0,0 +1,92 @@
+// ------------------------------------------------------------------
+// Decodifica uma captura CSV com as tabelas geradas do DBC (src/common/voltz_signals.h)
+// ------------------------------------------------------------------
+// Lê linhas "ms,0xID,S|E,dlc,HEX" (formato do _can_log.csv) e, para cada
+// frame de uma mensagem do DBC, imprime cada sinal como valor físico × den
+// (inteiro exato; den = 10 para fator 0,1):
+//   4322,Battery,voltage=627,current=2,temperature=28,soc=46,soh=100
+// Cada valor é calculado pela tabela (dbcFixed(spec, data)) e pelo tipo
+// especializado (dbcValue<S, S::DEN>(data)); divergência encerra com código 2.
+// tests/utils/voltzSignals.test.js compara esta saída com utils/voltzSignals.js.
+//
+// Compilação:
+//   g++ -std=c++11 -O2 -Wall tools/dbc_decode_csv.cpp -o .build/dbc_decode_csv
+// Uso:
+//   .build/dbc_decode_csv "src/esp32/_can_log (2).csv"   (sem arquivo: stdin)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/common/hex_codec.h"
+#include "../src/common/voltz_signals.h"
+
+using namespace voltz_dbc;
+
+/** @brief Valores × den pelo caminho especializado, na ordem de SIGNALS */
+static bool decodeSpecialized(const DbcMessageSpec &message, const uint8_t *data,
+                              int32_t *values) {
+  if (message.id == Battery::ID && message.extended == Battery::EXTENDED) {
+    values[0] = dbcValue<Battery::voltage, Battery::voltage::DEN>(data);
+    values[1] = dbcValue<Battery::current, Battery::current::DEN>(data);
+    values[2] = dbcValue<Battery::temperature, Battery::temperature::DEN>(data);
+    values[3] = dbcValue<Battery::soc, Battery::soc::DEN>(data);
+    values[4] = dbcValue<Battery::soh, Battery::soh::DEN>(data);
+    return true;
+  }
+  if (message.id == Controller::ID && message.extended == Controller::EXTENDED) {
+    values[0] = dbcValue<Controller::rpm, Controller::rpm::DEN>(data);
+    values[1] = dbcValue<Controller::torque, Controller::torque::DEN>(data);
+    values[2] = dbcValue<Controller::mode, Controller::mode::DEN>(data);
+    values[3] = dbcValue<Controller::controlTemp, Controller::controlTemp::DEN>(data);
+    values[4] = dbcValue<Controller::motorTemp, Controller::motorTemp::DEN>(data);
+    return true;
+  }
+  return false;
+}
+
+int main(int argc, char **argv) {
+  FILE *input = argc > 1 ? fopen(argv[1], "r") : stdin;
+  if (!input) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  char line[256];
+  unsigned long frames = 0, decoded = 0, mismatches = 0;
+  while (fgets(line, sizeof(line), input)) {
+    char *fields[5];
+    int count = 0;
+    for (char *token = strtok(line, ",\r\n"); token && count < 5; token = strtok(NULL, ",\r\n")) {
+      fields[count++] = token;
+    }
+    if (count < 5) continue;
+    frames++;
+
+    uint32_t id = (uint32_t)strtoul(fields[1], NULL, 16);
+    bool extended = fields[2][0] == 'E';
+    const DbcMessageSpec *message = findMessage(id, extended);
+    int dlc = atoi(fields[3]);
+    if (!message || dlc < message->dlc || (int)strlen(fields[4]) < dlc * 2) continue;
+
+    uint8_t data[8] = {0};
+    if (dlc > 8 || !hexDecode(data, fields[4], (uint8_t)dlc)) continue;
+
+    int32_t specialized[8];
+    bool haveSpecialized = decodeSpecialized(*message, data, specialized);
+    printf("%s,%s", fields[0], message->name);
+    for (uint8_t s = 0; s < message->signalCount; s++) {
+      int32_t value = dbcFixed(message->signals[s], data);
+      if (haveSpecialized && specialized[s] != value) mismatches++;
+      printf(",%s=%ld", message->signals[s].name, (long)value);
+    }
+    printf("\n");
+    decoded++;
+  }
+  if (input != stdin) fclose(input);
+
+  fprintf(stderr, "%lu frames, %lu decodificados, %lu divergências tabela/especializado\n",
+          frames, decoded, mismatches);
+  return mismatches > 0 ? 2 : 0;
+}
@@ -0,0 +1,247 @@
+// ------------------------------------------------------------------
+// Teste e benchmark no PC do spill em arquivo (src/common/file_spill.h)
+// ------------------------------------------------------------------
+// Teste, com uma região de 8 blocos em arquivo (termina com código 1 se
+// falhar):
+//   região  : o arquivo é pré-alocado no begin() e não cresce durante
+//             o uso, nem ao reabrir
+//   ordem   : 50 rodadas de escritas e leituras de tamanhos desiguais,
+//             dando várias voltas na região circular; cada frame volta
+//             uma vez, na ordem de chegada, incluindo o bloco parcial
+//             lido direto da RAM
+//   limite  : cheia, a região recusa a escrita (capacidade + o bloco de
+//             escrita em RAM) e volta a aceitar um bloco depois que um
+//             bloco é lido
+//
+// Benchmark: frames/s de escrita (ingestão durante a sobrecarga) e de
+// releitura, o FileSpill em blocos × o FileSpill anterior (um registro
+// por fwrite/fread, com fseek e fflush a cada troca), reproduzido aqui
+// como RecordSpill.
+//
+// Compilação:
+//   g++ -std=c++11 -O2 tools/file_spill_bench.cpp -o .build/file_spill_bench
+// Uso:
+//   .build/file_spill_bench [diretório dos arquivos, padrão /tmp] [frames]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+
+#include "../src/common/file_spill.h"
+#include "../src/common/platform.h"
+
+#define TEST_REGION_FRAMES 1000 // 8 blocos de 128
+#define TEST_ROUNDS 50
+
+static uint32_t failures = 0;
+
+static void check(bool ok, const char *what) {
+  if (ok) return;
+  printf("  FALHA: %s\n", what);
+  failures++;
+}
+
+static long fileSize(const std::string &path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 ? (long)st.st_size : -1;
+}
+
+static void fillFrame(CanMessage &frame, uint32_t seq) {
+  frame = CanMessage();
+  frame.id = 0x100 + seq % 14;
+  frame.length = 8;
+  frame.timestampUs = seq;
+  for (int i = 0; i < 8; i++) frame.data[i] = (uint8_t)(seq * 31 + i);
+}
+
+static bool frameIs(const CanMessage &frame, uint32_t seq) {
+  CanMessage expected;
+  fillFrame(expected, seq);
+  return frame.id == expected.id && frame.length == expected.length &&
+         frame.timestampUs == expected.timestampUs && memcmp(frame.data, expected.data, 8) == 0;
+}
+
+/**
+ * @brief O FileSpill anterior: um CanMessage por fwrite/fread
+ */
+class RecordSpill : public FrameSpill {
+public:
+  ~RecordSpill() { close(); }
+
+  bool begin(const char *path, uint32_t maxFrames = 0) {
+    close();
+    file_ = fopen(path, "w+b");
+    maxFrames_ = maxFrames;
+    readIndex_ = writeIndex_ = 0;
+    return file_ != NULL;
+  }
+
+  void close() {
+    if (file_ != NULL) fclose(file_);
+    file_ = NULL;
+  }
+
+  bool write(const CanMessage &frame) {
+    if (file_ == NULL) return false;
+    if (maxFrames_ != 0 && writeIndex_ - readIndex_ >= maxFrames_) return false;
+    if (fseek(file_, (long)(writeIndex_ * sizeof(CanMessage)), SEEK_SET) != 0) return false;
+    if (fwrite(&frame, sizeof(CanMessage), 1, file_) != 1) return false;
+    writeIndex_++;
+    return true;
+  }
+
+  bool read(CanMessage &frame) {
+    if (file_ == NULL || readIndex_ == writeIndex_) return false;
+    fflush(file_);
+    if (fseek(file_, (long)(readIndex_ * sizeof(CanMessage)), SEEK_SET) != 0) return false;
+    if (fread(&frame, sizeof(CanMessage), 1, file_) != 1) return false;
+    if (++readIndex_ == writeIndex_) readIndex_ = writeIndex_ = 0;
+    return true;
+  }
+
+  bool empty() { return readIndex_ == writeIndex_; }
+
+private:
+  FILE *file_ = NULL;
+  uint32_t maxFrames_ = 0;
+  uint32_t readIndex_ = 0;
+  uint32_t writeIndex_ = 0;
+};
+
+// ------------------------------------------------------------------
+// --- TESTE ---
+// ------------------------------------------------------------------
+
+static void testSpill(const std::string &dir) {
+  std::string path = dir + "/file_spill_test.bin";
+  remove(path.c_str());
+  FileSpill spill;
+  bool opened = spill.begin(path.c_str(), TEST_REGION_FRAMES);
+  check(opened, "begin() no arquivo");
+  if (!opened) return;
+
+  long regionBytes = (long)(spill.capacity() * sizeof(CanMessage));
+  check(spill.capacity() == 8 * SPILL_BLOCK_FRAMES, "capacidade arredondada para 8 blocos");
+  check(fileSize(path) == regionBytes, "região pré-alocada no begin()");
+
+  // --- Ordem com voltas na região ---
+  uint32_t written = 0;
+  uint32_t readBack = 0;
+  uint32_t wrong = 0;
+  CanMessage frame;
+  for (int round = 0; round < TEST_ROUNDS; round++) {
+    int writes = 300 + (round * 97) % 900;
+    for (int i = 0; i < writes; i++) {
+      fillFrame(frame, written);
+      if (!spill.write(frame)) break;
+      written++;
+    }
+    int reads = 200 + (round * 131) % 1000;
+    for (int i = 0; i < reads && spill.read(frame); i++) {
+      if (!frameIs(frame, readBack)) wrong++;
+      readBack++;
+    }
+  }
+  while (spill.read(frame)) {
+    if (!frameIs(frame, readBack)) wrong++;
+    readBack++;
+  }
+  check(wrong == 0, "frames fora de ordem ou alterados");
+  check(readBack == written, "frames lidos != gravados");
+  check(written > 4 * spill.capacity(), "região não deu voltas");
+  check(spill.empty() && spill.size() == 0, "spill vazio no fim");
+  check(fileSize(path) == regionBytes, "arquivo cresceu durante o uso");
+  printf("ordem  : %u frames em %d rodadas, %u voltas na região, %u fora de ordem\n", written,
+         TEST_ROUNDS, written / spill.capacity(), wrong);
+
+  // --- Limite: região + bloco de escrita em RAM ---
+  uint32_t accepted = 0;
+  for (uint32_t i = 0; i < 2 * spill.capacity(); i++) {
+    fillFrame(frame, readBack + accepted);
+    if (spill.write(frame)) accepted++;
+  }
+  check(accepted == spill.capacity() + SPILL_BLOCK_FRAMES, "capacidade cheia");
+  check(spill.size() == accepted, "size() com a região cheia");
+
+  // Um bloco lido libera um bloco da região
+  for (uint32_t i = 0; i < SPILL_BLOCK_FRAMES; i++) {
+    if (spill.read(frame) && !frameIs(frame, readBack)) wrong++;
+    readBack++;
+  }
+  uint32_t reclaimed = 0;
+  for (uint32_t i = 0; i < 2 * SPILL_BLOCK_FRAMES; i++) {
+    fillFrame(frame, readBack - SPILL_BLOCK_FRAMES + accepted + reclaimed);
+    if (spill.write(frame)) reclaimed++;
+  }
+  check(reclaimed == SPILL_BLOCK_FRAMES, "bloco liberado pela leitura");
+  uint32_t rest = 0;
+  while (spill.read(frame)) {
+    if (!frameIs(frame, readBack)) wrong++;
+    readBack++;
+    rest++;
+  }
+  check(rest == accepted + reclaimed - SPILL_BLOCK_FRAMES, "frames lidos depois de cheio");
+  check(wrong == 0, "ordem depois de cheio");
+  printf("limite : %u aceitos (região %u + bloco em RAM %d), %u depois de ler um bloco\n",
+         accepted, spill.capacity(), SPILL_BLOCK_FRAMES, reclaimed);
+
+  // Reabrir não cresce nem trunca a região
+  check(spill.begin(path.c_str(), TEST_REGION_FRAMES) && spill.empty(), "reabrir o arquivo");
+  check(fileSize(path) == regionBytes, "arquivo mudou ao reabrir");
+  spill.close();
+  remove(path.c_str());
+}
+
+// ------------------------------------------------------------------
+// --- BENCHMARK ---
+// ------------------------------------------------------------------
+
+template <typename Spill>
+static void benchSpill(Spill &spill, const std::string &path, const char *name, uint32_t frames) {
+  if (!spill.begin(path.c_str(), frames + SPILL_BLOCK_FRAMES)) {
+    check(false, "begin() do benchmark");
+    return;
+  }
+  CanMessage frame;
+  fillFrame(frame, 0);
+  int64_t start = monoMicros();
+  uint32_t written = 0;
+  for (; written < frames; written++) {
+    frame.timestampUs = written;
+    if (!spill.write(frame)) break;
+  }
+  int64_t middle = monoMicros();
+  uint32_t readBack = 0;
+  uint32_t wrong = 0;
+  while (spill.read(frame)) {
+    if (frame.timestampUs != readBack) wrong++;
+    readBack++;
+  }
+  int64_t end = monoMicros();
+  check(written == frames && readBack == frames && wrong == 0, "benchmark: frames perdidos ou fora de ordem");
+
+  double writeSeconds = (middle - start) / 1e6;
+  double readSeconds = (end - middle) / 1e6;
+  printf("%-16s %12.2f %12.2f\n", name, frames / writeSeconds / 1e6, frames / readSeconds / 1e6);
+  spill.close();
+  remove(path.c_str());
+}
+
+int main(int argc, char **argv) {
+  std::string dir = argc > 1 ? argv[1] : "/tmp";
+  uint32_t frames = argc > 2 ? (uint32_t)atoi(argv[2]) : 500000;
+
+  testSpill(dir);
+
+  printf("\n%u frames em %s\n", frames, dir.c_str());
+  printf("spill            escrita M/s  leitura M/s\n");
+  FileSpill blocks;
+  benchSpill(blocks, dir + "/file_spill_bench_blocks.bin", "blocos de 128", frames);
+  RecordSpill records;
+  benchSpill(records, dir + "/file_spill_bench_records.bin", "frame a frame", frames);
+
+  printf(failures == 0 ? "OK\n" : "FALHA: %u verificações\n", failures);
+  return failures == 0 ? 0 : 1;
+}
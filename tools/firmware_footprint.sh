@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+# ------------------------------------------------------------------
+# Relatório de flash/RAM por perfil do firmware (src/sketch_def)
+# ------------------------------------------------------------------
+# Compila cada perfil de profiles.h com o arduino-cli e resume o uso
+# de memória. Requer o core esp32 e as bibliotecas usadas pelos perfis
+# (ESP32-TWAI-CAN, ArduinoJson, WebSockets, MPU6050).
+#
+# Uso: tools/firmware_footprint.sh [FQBN] [TESTMODE]
+#   FQBN     padrão esp32:esp32:esp32
+#   TESTMODE true (simulador) ou false (TWAI), padrão false
+
+set -euo pipefail
+
+FQBN="${1:-esp32:esp32:esp32}"
+TESTMODE="${2:-false}"
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+SKETCH="$ROOT/src/sketch_def"
+PROFILES="MQTT_MPU MQTT MQTT_SD WEBSOCKET SD"
+
+if [ ! -f "$ROOT/config/constants.h" ]; then
+  echo "config/constants.h ausente (copie de config/constants_example.h)" >&2
+  exit 1
+fi
+
+printf '%-12s %12s %12s\n' "perfil" "flash (B)" "RAM (B)"
+for profile in $PROFILES; do
+  out="$(arduino-cli compile --fqbn "$FQBN" \
+    --build-path "$ROOT/.build/footprint/$profile" \
+    --build-property "compiler.cpp.extra_flags=-I$SKETCH -DVOLTZ_PROFILE=VOLTZ_PROFILE_$profile -DTESTMODE=$TESTMODE" \
+    "$SKETCH" 2>&1)" || { echo "$out" >&2; echo "falha ao compilar $profile" >&2; exit 1; }
+
+  flash="$(echo "$out" | sed -n 's/^Sketch uses \([0-9]*\) bytes.*/\1/p')"
+  ram="$(echo "$out" | sed -n 's/^Global variables use \([0-9]*\) bytes.*/\1/p')"
+  printf '%-12s %12s %12s\n' "$profile" "${flash:-?}" "${ram:-?}"
+done
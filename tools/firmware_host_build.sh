@@ -0,0 +1,51 @@
+#!/usr/bin/env bash
+# ------------------------------------------------------------------
+# Compila o firmware (src/sketch_def) no host, em todos os perfis
+# ------------------------------------------------------------------
+# Sem o core esp32: o sketch é compilado com o g++ contra os stubs de
+# tools/host_stubs e ligado com um main() que só chama setup(). Cobre
+# cada perfil de profiles.h × TESTMODE × DEBUGMODE com -Wall -Wextra
+# -Werror, e pega erros de tipo/template e #if de perfil esquecidos sem
+# precisar do arduino-cli (para o CI). Flash/RAM reais continuam com
+# tools/firmware_footprint.sh.
+#
+# Uso: tools/firmware_host_build.sh [CXX]
+#   CXX  compilador, padrão g++ (ou a variável CXX)
+
+set -euo pipefail
+
+CXX="${1:-${CXX:-g++}}"
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+SKETCH="$ROOT/src/sketch_def"
+STUBS="$ROOT/tools/host_stubs"
+OUT="$ROOT/.build/host_build"
+PROFILES="MQTT_MPU MQTT MQTT_SD WEBSOCKET SD"
+
+if [ ! -f "$ROOT/config/constants.h" ]; then
+  echo "config/constants.h ausente (copie de config/constants_example.h)" >&2
+  exit 1
+fi
+
+mkdir -p "$OUT"
+"$CXX" -std=gnu++11 -O0 -I"$STUBS" -c "$STUBS/stubs.cpp" -o "$OUT/stubs.o"
+
+failed=0
+for profile in $PROFILES; do
+  for testmode in true false; do
+    for debugmode in true false; do
+      name="$profile-test_$testmode-debug_$debugmode"
+      if out="$("$CXX" -std=gnu++11 -O2 -Wall -Wextra -Wno-unused-parameter -Werror \
+          -I"$STUBS" -I"$SKETCH" -x c++ \
+          -DVOLTZ_PROFILE=VOLTZ_PROFILE_$profile -DTESTMODE=$testmode -DDEBUGMODE=$debugmode \
+          "$SKETCH/sketch_def.ino" -x none "$OUT/stubs.o" -pthread -o "$OUT/$name" 2>&1)"; then
+        printf '%-36s ok\n' "$name"
+      else
+        printf '%-36s FALHA\n' "$name"
+        echo "$out" >&2
+        failed=1
+      fi
+    done
+  done
+done
+
+exit $failed
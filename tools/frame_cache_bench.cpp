@@ -0,0 +1,216 @@
+// ------------------------------------------------------------------
+// Microbenchmark no PC do cache por ID (src/common/frame_cache.h)
+// ------------------------------------------------------------------
+// Reproduz a captura do barramento (_can_log.csv, "ms,0xID,S|E,dlc,HEX")
+// em laço e passa cada frame pelo teste "mudou desde a última vez?" em
+// quatro implementações:
+//   - string_map:    std::map<String, String> do esp32_read_can_ok_wifi_ok
+//                    (ID decimal e payload hex montados a cada frame)
+//   - map:           std::map<uint32_t, entrada>
+//   - unordered_map: std::unordered_map<uint32_t, entrada>
+//   - frame_cache:   FrameCache<64> (endereçamento aberto, sem heap)
+// Mede ns por frame e alocações no heap depois do aquecimento (a primeira
+// passada, que insere os IDs, não conta). As quatro têm de concordar no
+// número de frames mudados.
+//
+// Compilação:
+//   g++ -std=c++11 -O2 tools/frame_cache_bench.cpp -o .build/frame_cache_bench
+// Uso:
+//   .build/frame_cache_bench ["src/esp32/_can_log (2).csv"] [frames]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../src/common/capture_replay.h"
+#include "../src/common/frame_cache.h"
+
+// --- Contagem de alocações (operator new global) ---
+static unsigned long heapAllocations = 0;
+
+void *operator new(size_t size) {
+  heapAllocations++;
+  void *p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+// ------------------------------------------------------------------
+// --- IMPLEMENTAÇÕES COMPARADAS ---
+// ------------------------------------------------------------------
+
+/**
+ * @brief Como no sketch: String(identifier) e o payload em hex com espaços
+ */
+class StringMapCache {
+public:
+  bool changed(const CanMessage &frame) {
+    std::string id = std::to_string(frame.id);
+    std::string data;
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    for (int i = 0; i < frame.length; i++) {
+      data += HEX_DIGITS[frame.data[i] >> 4];
+      data += HEX_DIGITS[frame.data[i] & 0x0F];
+      if (i < frame.length - 1) data += ' ';
+    }
+    std::map<std::string, std::string>::iterator it = cache_.find(id);
+    if (it != cache_.end()) {
+      if (it->second == data) return false;
+      it->second = data;
+      return true;
+    }
+    cache_[id] = data;
+    return true;
+  }
+
+private:
+  std::map<std::string, std::string> cache_;
+};
+
+struct PayloadEntry {
+  uint8_t data[8];
+  uint8_t dlc;
+  uint32_t timestamp;
+  uint32_t changes;
+};
+
+static uint32_t frameKey(const CanMessage &frame) {
+  return frame.id | (frame.isExtended ? FRAME_CACHE_EXTENDED_FLAG : 0);
+}
+
+template <class Map>
+class StdMapCache {
+public:
+  bool changed(const CanMessage &frame, uint32_t now) {
+    // find antes de inserir: insert() monta o nó mesmo quando o ID já existe
+    typename Map::iterator it = cache_.find(frameKey(frame));
+    bool inserted = it == cache_.end();
+    if (inserted) it = cache_.insert(std::make_pair(frameKey(frame), PayloadEntry())).first;
+    PayloadEntry &entry = it->second;
+    entry.timestamp = now;
+    if (!inserted && entry.dlc == frame.length &&
+        memcmp(entry.data, frame.data, frame.length) == 0) {
+      return false;
+    }
+    if (!inserted) entry.changes++;
+    entry.dlc = frame.length;
+    memcpy(entry.data, frame.data, frame.length);
+    return true;
+  }
+
+private:
+  Map cache_;
+};
+
+class OpenAddressingCache {
+public:
+  bool changed(const CanMessage &frame, uint32_t now) {
+    return cache_.update(frame.id, frame.isExtended, frame.data, frame.length, now) !=
+           FRAME_CACHE_SAME;
+  }
+  uint16_t size() const { return cache_.size(); }
+
+private:
+  FrameCache<64> cache_;
+};
+
+// ------------------------------------------------------------------
+// --- MEDIÇÃO ---
+// ------------------------------------------------------------------
+
+struct BenchResult {
+  double nsPerFrame;
+  unsigned long changed;
+  unsigned long allocations;
+};
+
+template <class Fn>
+static BenchResult run(const std::vector<CanMessage> &frames, unsigned long total, Fn changed) {
+  // Aquecimento: uma passada pela captura insere todos os IDs
+  for (size_t i = 0; i < frames.size(); i++) changed(frames[i], (uint32_t)i);
+
+  BenchResult result;
+  result.changed = 0;
+  unsigned long allocationsBefore = heapAllocations;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (unsigned long n = 0; n < total; n++) {
+    if (changed(frames[n % frames.size()], (uint32_t)n)) result.changed++;
+  }
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  result.allocations = heapAllocations - allocationsBefore;
+  result.nsPerFrame = std::chrono::duration<double, std::nano>(end - start).count() / total;
+  return result;
+}
+
+static void print(const char *name, const BenchResult &result, double baseline) {
+  printf("%-14s %9.1f ns/frame %7.1fx %10lu mudados %10lu alocações\n", name, result.nsPerFrame,
+         baseline / result.nsPerFrame, result.changed, result.allocations);
+}
+
+int main(int argc, char **argv) {
+  const char *path = argc > 1 ? argv[1] : "src/esp32/_can_log (2).csv";
+  unsigned long total = argc > 2 ? strtoul(argv[2], NULL, 10) : 5000000UL;
+
+  std::vector<CanMessage> frames;
+  if (!loadCapture(path, frames, 0) || total == 0) {
+    fprintf(stderr, "uso: frame_cache_bench [captura.csv] [frames]\n");
+    return 1;
+  }
+
+  // Distribuição de IDs da captura
+  std::map<uint32_t, unsigned long> perId;
+  for (size_t i = 0; i < frames.size(); i++) perId[frameKey(frames[i])]++;
+  std::vector<std::pair<unsigned long, uint32_t> > ranking;
+  for (std::map<uint32_t, unsigned long>::iterator it = perId.begin(); it != perId.end(); ++it) {
+    ranking.push_back(std::make_pair(it->second, it->first));
+  }
+  std::sort(ranking.rbegin(), ranking.rend());
+  printf("%s: %lu frames, %lu IDs distintos; mais frequentes:", path,
+         (unsigned long)frames.size(), (unsigned long)perId.size());
+  for (size_t i = 0; i < ranking.size() && i < 5; i++) {
+    printf(" 0x%lX (%.0f%%)", (unsigned long)(ranking[i].second & ~FRAME_CACHE_EXTENDED_FLAG),
+           100.0 * ranking[i].first / frames.size());
+  }
+  printf("\n%lu frames por implementação\n\n", total);
+
+  StringMapCache stringMap;
+  StdMapCache<std::map<uint32_t, PayloadEntry> > map;
+  StdMapCache<std::unordered_map<uint32_t, PayloadEntry> > unorderedMap;
+  OpenAddressingCache openAddressing;
+
+  BenchResult stringResult = run(frames, total, [&](const CanMessage &f, uint32_t) {
+    return stringMap.changed(f);
+  });
+  BenchResult mapResult = run(frames, total, [&](const CanMessage &f, uint32_t now) {
+    return map.changed(f, now);
+  });
+  BenchResult unorderedResult = run(frames, total, [&](const CanMessage &f, uint32_t now) {
+    return unorderedMap.changed(f, now);
+  });
+  BenchResult openResult = run(frames, total, [&](const CanMessage &f, uint32_t now) {
+    return openAddressing.changed(f, now);
+  });
+
+  double baseline = stringResult.nsPerFrame;
+  print("string_map", stringResult, baseline);
+  print("map", mapResult, baseline);
+  print("unordered_map", unorderedResult, baseline);
+  print("frame_cache", openResult, baseline);
+  printf("\nframe_cache: %u de %u entradas, %lu bytes no objeto\n", openAddressing.size(),
+         FrameCache<64>::capacity(), (unsigned long)sizeof(FrameCache<64>));
+
+  bool agree = stringResult.changed == openResult.changed && mapResult.changed == openResult.changed &&
+               unorderedResult.changed == openResult.changed;
+  if (!agree) fprintf(stderr, "divergência no número de frames mudados\n");
+  return agree ? 0 : 2;
+}
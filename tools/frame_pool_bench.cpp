@@ -0,0 +1,569 @@
+// ------------------------------------------------------------------
+// Teste e benchmark no PC do pool de frames (src/common/frame_pool.h)
+// ------------------------------------------------------------------
+// Vazamento sob concorrência (termina com código 2 se falhar):
+//   fan-out : P produtores e C consumidores em threads, um SpscRing de
+//             handles por par; cada frame vai a todos os consumidores
+//             (retain(C - 1)), que conferem o conteúdo (id, sequência,
+//             payload) e soltam fora de ordem. Pool pequeno, para
+//             esgotar e disputar a lista livre o tempo todo.
+//   lanes   : decodificação → PriorityLanes → envio, como no firmware,
+//             com cada política de sobrecarga (spill em memória) e um
+//             consumidor lento; todo frame é entregue ou contado como
+//             perdido, exatamente uma vez.
+// No fim de cada caso a lista livre tem de novo todos os slots, cada um
+// uma vez e sem referência (available()).
+//
+// Depois mede frames/s com e sem cópia entre as threads:
+//   cadeia : captura → SpscRing → decodificação → fila com trava → envio
+//            (a fila faz o papel da lane do FreeRTOS, que copia o item
+//            com a seção crítica tomada)
+//   fan-out: captura → 3 consumidores, um SpscRing cada
+// "cópia" leva o CanMessage (20 B) nos dois trechos; "handle" lê o frame
+// uma vez no slot e passa 2 B nos dois; "misto", como o firmware, copia
+// no SpscRing e só o frame aceito pela decodificação ganha um slot.
+// Num SpscRing copiar 20 B custa menos que os dois CAS da lista livre:
+// por isso o ring de captura do firmware leva cópias. O pool fica nas
+// lanes, onde a cópia é feita sob trava, e no fan-out (um slot, N leitores).
+// O mutex do PC não é a seção crítica do ESP32: o ganho nas lanes só se
+// confirma medido na placa.
+//
+// Compilação (precisa de config/constants.h):
+//   g++ -std=c++11 -O2 -pthread tools/frame_pool_bench.cpp -o .build/frame_pool_bench
+// Uso:
+//   .build/frame_pool_bench [frames]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../src/common/frame_pool.h"
+#include "../src/common/priority_lanes.h"
+#include "../src/common/spsc_ring.h"
+
+#define TEST_PRODUCERS 3
+#define TEST_CONSUMERS 3
+#define TEST_POOL_SIZE 48   // Menor que a soma dos rings: o pool esgota
+#define TEST_RING_SIZE 16
+#define TEST_HOLD 4         // Handles que cada consumidor segura antes de soltar
+#define BENCH_RING_SIZE 256 // Igual a CAPTURE_RING_SIZE do firmware
+#define BENCH_QUEUE_SIZE 256 // Potência de 2 perto de BufferSize (lane de telemetria)
+#define BENCH_FANOUT 3
+
+// ------------------------------------------------------------------
+// --- FRAMES DE TESTE ---
+// ------------------------------------------------------------------
+
+static uint32_t mix(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7FEB352DU;
+  x ^= x >> 15;
+  x *= 0x846CA68BU;
+  return x ^ (x >> 16);
+}
+
+/** @brief Frame determinado pelo produtor e pela sequência */
+static void fillFrame(CanMessage &frame, uint32_t id, uint32_t seq) {
+  frame.id = id;
+  frame.isExtended = false;
+  frame.length = 8;
+  frame.timestampUs = seq;
+  uint32_t a = mix(id * 0x9E3779B9U + seq);
+  uint32_t b = mix(a);
+  memcpy(frame.data, &a, 4);
+  memcpy(frame.data + 4, &b, 4);
+}
+
+/** @brief O slot ainda tem o frame que o produtor escreveu */
+static bool frameIntact(const CanMessage &frame) {
+  CanMessage expected;
+  fillFrame(expected, frame.id, frame.timestampUs);
+  return frame.length == 8 && memcmp(frame.data, expected.data, 8) == 0;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ------------------------------------------------------------------
+// --- VAZAMENTO: FAN-OUT ENTRE THREADS ---
+// ------------------------------------------------------------------
+
+static bool testFanout(uint32_t frames) {
+  static StaticFramePool<TEST_POOL_SIZE> pool;
+  static SpscRing<FrameHandle, TEST_RING_SIZE> rings[TEST_PRODUCERS][TEST_CONSUMERS];
+  std::atomic<uint32_t> producing(TEST_PRODUCERS);
+  std::atomic<uint32_t> errors(0);
+  std::atomic<uint64_t> received(0);
+  std::vector<std::thread> threads;
+
+  for (uint32_t p = 0; p < TEST_PRODUCERS; p++) {
+    threads.push_back(std::thread([&, p] {
+      for (uint32_t seq = 0; seq < frames; seq++) {
+        FrameHandle handle;
+        while ((handle = pool.acquire()) == FRAME_NONE) std::this_thread::yield();
+        fillFrame(pool.frame(handle), p, seq);
+        pool.retain(handle, TEST_CONSUMERS - 1);
+        for (uint32_t c = 0; c < TEST_CONSUMERS; c++) {
+          while (!rings[p][c].push(handle)) std::this_thread::yield();
+        }
+      }
+      producing--;
+    }));
+  }
+
+  for (uint32_t c = 0; c < TEST_CONSUMERS; c++) {
+    threads.push_back(std::thread([&, c] {
+      uint32_t nextSeq[TEST_PRODUCERS] = {0};
+      FrameHandle held[TEST_HOLD];
+      uint32_t heldCount = 0;
+      uint32_t turn = c;
+      for (;;) {
+        bool any = false;
+        for (uint32_t p = 0; p < TEST_PRODUCERS; p++) {
+          FrameHandle handle;
+          if (!rings[p][c].pop(handle)) continue;
+          any = true;
+          const CanMessage &frame = pool.frame(handle);
+          if (frame.id != p || frame.timestampUs != nextSeq[p]++ || !frameIntact(frame)) errors++;
+          received++;
+          // Solta fora de ordem: troca com um dos segurados
+          if (heldCount < TEST_HOLD) {
+            held[heldCount++] = handle;
+          } else {
+            uint32_t slot = mix(++turn) % TEST_HOLD;
+            pool.release(held[slot]);
+            held[slot] = handle;
+          }
+        }
+        if (any) continue;
+        // Segurar com os rings vazios pode travar os produtores (pool esgotado)
+        while (heldCount > 0) pool.release(held[--heldCount]);
+        if (producing == 0) {
+          bool empty = true;
+          for (uint32_t p = 0; p < TEST_PRODUCERS; p++) empty = empty && rings[p][c].empty();
+          if (empty) break;
+        }
+        std::this_thread::yield();
+      }
+    }));
+  }
+  for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+
+  uint64_t expected = (uint64_t)frames * TEST_PRODUCERS * TEST_CONSUMERS;
+  bool ok = errors == 0 && received == expected && pool.available() == pool.capacity();
+  printf("fan-out %ux%u, pool %u: %llu entregas, %u corrompidos, livres %u/%u, "
+         "pool esgotado %lu vezes: %s\n",
+         TEST_PRODUCERS, TEST_CONSUMERS, TEST_POOL_SIZE, (unsigned long long)received.load(),
+         errors.load(), pool.available(), pool.capacity(), (unsigned long)pool.exhausted(),
+         ok ? "OK" : "FALHA");
+  return ok;
+}
+
+// ------------------------------------------------------------------
+// --- VAZAMENTO: LANES COM CADA POLÍTICA ---
+// ------------------------------------------------------------------
+
+/**
+ * @brief Excesso da fila em memória (o FileSpill do firmware grava no SD)
+ */
+class MemorySpill : public FrameSpill {
+public:
+  bool write(const CanMessage &frame) {
+    frames_.push_back(frame);
+    return true;
+  }
+  bool read(CanMessage &frame) {
+    if (frames_.empty()) return false;
+    frame = frames_.front();
+    frames_.pop_front();
+    return true;
+  }
+  bool empty() { return frames_.empty(); }
+
+private:
+  std::deque<CanMessage> frames_;
+};
+
+static bool testLanes(OverloadPolicy policy, uint32_t frames) {
+  StaticFramePool<128> pool;
+  MemorySpill spill;
+  PriorityLanes lanes;
+  lanes.begin(pool, 32, policy, &spill, 8);
+  std::atomic<bool> producing(true);
+  std::atomic<uint32_t> errors(0);
+  uint32_t pushed = 0;
+  uint32_t exhausted = 0;
+  uint64_t delivered = 0;
+
+  std::thread decode([&] {
+    for (uint32_t seq = 0; seq < frames; seq++) {
+      FrameHandle handle = pool.acquire();
+      if (handle == FRAME_NONE) {
+        exhausted++; // Como a captura com o pool esgotado: frame perdido
+        std::this_thread::yield();
+        continue;
+      }
+      // 1 em 16 é falha do BMS (lane de falhas); o resto, 8 IDs de telemetria
+      uint32_t id = seq % 16 == 0 ? BASE_BATTERY_ID_2 : 0x100 + seq % 8;
+      fillFrame(pool.frame(handle), id, seq);
+      lanes.push(handle);
+      pushed++;
+      if (seq % 64 == 0) std::this_thread::yield();
+    }
+    producing = false;
+  });
+
+  std::thread uplink([&] {
+    uint32_t cycle = 0;
+    for (;;) {
+      FrameHandle handle;
+      bool any = false;
+      // Consumidor mais lento que o produtor: a lane de telemetria enche
+      for (uint32_t budget = 8; budget > 0; budget--) {
+        if (!lanes.popHigh(handle) && !lanes.popLow(handle)) break;
+        if (!frameIntact(pool.frame(handle))) errors++;
+        pool.release(handle);
+        delivered++;
+        any = true;
+      }
+      if (!any && !producing && lanes.pending(LANE_HIGH) == 0 &&
+          lanes.telemetryBacklog() == 0 && spill.empty()) {
+        break;
+      }
+      if (++cycle % 4 == 0) std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  });
+  decode.join();
+  uplink.join();
+
+  uint64_t lost = lanes.dropped(LANE_HIGH) + lanes.dropped(LANE_LOW);
+  bool ok = errors == 0 && delivered + lost == pushed && pool.available() == pool.capacity();
+  printf("lanes %-14s: %lu enfileirados, %llu entregues, %llu perdidos, %lu sem slot, "
+         "livres %u/%u: %s\n",
+         overloadPolicyName(policy), (unsigned long)pushed, (unsigned long long)delivered,
+         (unsigned long long)lost, (unsigned long)exhausted, pool.available(), pool.capacity(),
+         ok ? "OK" : "FALHA");
+  return ok;
+}
+
+// ------------------------------------------------------------------
+// --- BENCHMARK: CÓPIA × HANDLE ---
+// ------------------------------------------------------------------
+
+template <typename Ring, typename Item>
+static void pushSpin(Ring &ring, const Item &item) {
+  while (!ring.push(item)) std::this_thread::yield();
+}
+
+/** @brief Consome até o produtor terminar e o ring esvaziar */
+template <typename Ring, typename Item, typename Use>
+static void drain(Ring &ring, std::atomic<bool> &done, Use use) {
+  Item item;
+  for (;;) {
+    if (ring.pop(item)) {
+      use(item);
+    } else if (done && ring.empty()) {
+      return;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+/**
+ * @brief Fila de capacidade fixa com trava, no papel da fila do FreeRTOS:
+ *        o item é copiado com a trava tomada, na entrada e na saída
+ */
+template <typename T, uint32_t Capacity>
+class LockedQueue {
+public:
+  bool push(const T &item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (head_ - tail_ == Capacity) return false;
+    items_[head_++ % Capacity] = item;
+    return true;
+  }
+  bool pop(T &item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (head_ == tail_) return false;
+    item = items_[tail_++ % Capacity];
+    return true;
+  }
+  bool empty() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return head_ == tail_;
+  }
+
+private:
+  std::mutex mutex_;
+  T items_[Capacity];
+  uint32_t head_ = 0;
+  uint32_t tail_ = 0;
+};
+
+struct ChainResult {
+  double framesPerSecond;
+  uint64_t checksum;
+};
+
+/**
+ * @brief Captura → decodificação → envio com o frame copiado nos dois trechos
+ */
+static ChainResult chainCopy(uint32_t frames) {
+  static SpscRing<CanMessage, BENCH_RING_SIZE> captureRing;
+  static LockedQueue<CanMessage, BENCH_QUEUE_SIZE> sendRing;
+  std::atomic<bool> captureDone(false);
+  std::atomic<bool> decodeDone(false);
+  uint64_t checksum = 0;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::thread capture([&] {
+    CanMessage frame;
+    for (uint32_t i = 0; i < frames; i++) {
+      fillFrame(frame, 0x100 + i % 8, i);
+      pushSpin(captureRing, frame);
+    }
+    captureDone = true;
+  });
+  std::thread decode([&] {
+    drain<SpscRing<CanMessage, BENCH_RING_SIZE>, CanMessage>(
+        captureRing, captureDone, [&](const CanMessage &frame) {
+          if (frame.data[0] != 0xFF) pushSpin(sendRing, frame);
+        });
+    decodeDone = true;
+  });
+  std::thread uplink([&] {
+    drain<LockedQueue<CanMessage, BENCH_QUEUE_SIZE>, CanMessage>(
+        sendRing, decodeDone, [&](const CanMessage &frame) { checksum += frame.data[7]; });
+  });
+  capture.join();
+  decode.join();
+  uplink.join();
+  ChainResult result = {frames / secondsSince(start), checksum};
+  return result;
+}
+
+/**
+ * @brief A mesma cadeia com o frame no pool e só o handle nos dois trechos
+ */
+static ChainResult chainHandle(uint32_t frames) {
+  static StaticFramePool<BENCH_RING_SIZE + BENCH_QUEUE_SIZE + 4> pool;
+  static SpscRing<FrameHandle, BENCH_RING_SIZE> captureRing;
+  static LockedQueue<FrameHandle, BENCH_QUEUE_SIZE> sendRing;
+  std::atomic<bool> captureDone(false);
+  std::atomic<bool> decodeDone(false);
+  uint64_t checksum = 0;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::thread capture([&] {
+    for (uint32_t i = 0; i < frames; i++) {
+      FrameHandle handle;
+      while ((handle = pool.acquire()) == FRAME_NONE) std::this_thread::yield();
+      fillFrame(pool.frame(handle), 0x100 + i % 8, i);
+      pushSpin(captureRing, handle);
+    }
+    captureDone = true;
+  });
+  std::thread decode([&] {
+    drain<SpscRing<FrameHandle, BENCH_RING_SIZE>, FrameHandle>(
+        captureRing, captureDone, [&](FrameHandle handle) {
+          if (pool.frame(handle).data[0] != 0xFF) {
+            pushSpin(sendRing, handle);
+          } else {
+            pool.release(handle);
+          }
+        });
+    decodeDone = true;
+  });
+  std::thread uplink([&] {
+    drain<LockedQueue<FrameHandle, BENCH_QUEUE_SIZE>, FrameHandle>(
+        sendRing, decodeDone, [&](FrameHandle handle) {
+          checksum += pool.frame(handle).data[7];
+          pool.release(handle);
+        });
+  });
+  capture.join();
+  decode.join();
+  uplink.join();
+  ChainResult result = {frames / secondsSince(start), checksum};
+  if (pool.available() != pool.capacity()) result.checksum = ~0ULL;
+  return result;
+}
+
+/**
+ * @brief A cadeia do firmware: cópia no SpscRing, slot só para o frame
+ *        aceito e handle na fila com trava
+ */
+static ChainResult chainMixed(uint32_t frames) {
+  static StaticFramePool<BENCH_QUEUE_SIZE + 4> pool;
+  static SpscRing<CanMessage, BENCH_RING_SIZE> captureRing;
+  static LockedQueue<FrameHandle, BENCH_QUEUE_SIZE> sendRing;
+  std::atomic<bool> captureDone(false);
+  std::atomic<bool> decodeDone(false);
+  uint64_t checksum = 0;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::thread capture([&] {
+    CanMessage frame;
+    for (uint32_t i = 0; i < frames; i++) {
+      fillFrame(frame, 0x100 + i % 8, i);
+      pushSpin(captureRing, frame);
+    }
+    captureDone = true;
+  });
+  std::thread decode([&] {
+    drain<SpscRing<CanMessage, BENCH_RING_SIZE>, CanMessage>(
+        captureRing, captureDone, [&](const CanMessage &frame) {
+          if (frame.data[0] == 0xFF) return;
+          FrameHandle handle;
+          while ((handle = pool.acquire()) == FRAME_NONE) std::this_thread::yield();
+          pool.frame(handle) = frame;
+          pushSpin(sendRing, handle);
+        });
+    decodeDone = true;
+  });
+  std::thread uplink([&] {
+    drain<LockedQueue<FrameHandle, BENCH_QUEUE_SIZE>, FrameHandle>(
+        sendRing, decodeDone, [&](FrameHandle handle) {
+          checksum += pool.frame(handle).data[7];
+          pool.release(handle);
+        });
+  });
+  capture.join();
+  decode.join();
+  uplink.join();
+  ChainResult result = {frames / secondsSince(start), checksum};
+  if (pool.available() != pool.capacity()) result.checksum = ~0ULL;
+  return result;
+}
+
+/**
+ * @brief Captura → BENCH_FANOUT consumidores, uma cópia por consumidor
+ */
+static ChainResult fanoutCopy(uint32_t frames) {
+  static SpscRing<CanMessage, BENCH_RING_SIZE> rings[BENCH_FANOUT];
+  std::atomic<bool> captureDone(false);
+  uint64_t checksums[BENCH_FANOUT] = {0};
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::thread capture([&] {
+    CanMessage frame;
+    for (uint32_t i = 0; i < frames; i++) {
+      fillFrame(frame, 0x100 + i % 8, i);
+      for (uint32_t c = 0; c < BENCH_FANOUT; c++) pushSpin(rings[c], frame);
+    }
+    captureDone = true;
+  });
+  std::vector<std::thread> consumers;
+  for (uint32_t c = 0; c < BENCH_FANOUT; c++) {
+    consumers.push_back(std::thread([&, c] {
+      drain<SpscRing<CanMessage, BENCH_RING_SIZE>, CanMessage>(
+          rings[c], captureDone, [&](const CanMessage &frame) { checksums[c] += frame.data[7]; });
+    }));
+  }
+  capture.join();
+  for (size_t c = 0; c < consumers.size(); c++) consumers[c].join();
+  ChainResult result = {frames / secondsSince(start), checksums[0]};
+  for (uint32_t c = 1; c < BENCH_FANOUT; c++) {
+    if (checksums[c] != checksums[0]) result.checksum = ~0ULL;
+  }
+  return result;
+}
+
+/**
+ * @brief O mesmo fan-out com um slot por frame e retain(BENCH_FANOUT - 1)
+ */
+static ChainResult fanoutHandle(uint32_t frames) {
+  static StaticFramePool<BENCH_RING_SIZE + 4> pool;
+  static SpscRing<FrameHandle, BENCH_RING_SIZE> rings[BENCH_FANOUT];
+  std::atomic<bool> captureDone(false);
+  uint64_t checksums[BENCH_FANOUT] = {0};
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::thread capture([&] {
+    for (uint32_t i = 0; i < frames; i++) {
+      FrameHandle handle;
+      while ((handle = pool.acquire()) == FRAME_NONE) std::this_thread::yield();
+      fillFrame(pool.frame(handle), 0x100 + i % 8, i);
+      pool.retain(handle, BENCH_FANOUT - 1);
+      for (uint32_t c = 0; c < BENCH_FANOUT; c++) pushSpin(rings[c], handle);
+    }
+    captureDone = true;
+  });
+  std::vector<std::thread> consumers;
+  for (uint32_t c = 0; c < BENCH_FANOUT; c++) {
+    consumers.push_back(std::thread([&, c] {
+      drain<SpscRing<FrameHandle, BENCH_RING_SIZE>, FrameHandle>(
+          rings[c], captureDone, [&](FrameHandle handle) {
+            checksums[c] += pool.frame(handle).data[7];
+            pool.release(handle);
+          });
+    }));
+  }
+  capture.join();
+  for (size_t c = 0; c < consumers.size(); c++) consumers[c].join();
+  ChainResult result = {frames / secondsSince(start), checksums[0]};
+  for (uint32_t c = 1; c < BENCH_FANOUT; c++) {
+    if (checksums[c] != checksums[0]) result.checksum = ~0ULL;
+  }
+  if (pool.available() != pool.capacity()) result.checksum = ~0ULL;
+  return result;
+}
+
+/** @brief Melhor de 3 execuções (threads no PC oscilam) */
+static ChainResult best(ChainResult (*run)(uint32_t), uint32_t frames) {
+  ChainResult result = run(frames);
+  for (int i = 0; i < 2; i++) {
+    ChainResult next = run(frames);
+    if (next.checksum != result.checksum) next.checksum = ~0ULL;
+    if (next.framesPerSecond > result.framesPerSecond || next.checksum == ~0ULL) result = next;
+  }
+  return result;
+}
+
+static void printRow(const char *shape, const char *path, const ChainResult &result,
+                     double base, uint32_t ringBytes) {
+  printf("%-8s %-7s %12.0f %9.1f %8.2fx %10lu\n", shape, path, result.framesPerSecond,
+         1e9 / result.framesPerSecond, result.framesPerSecond / base, (unsigned long)ringBytes);
+}
+
+int main(int argc, char **argv) {
+  uint32_t frames = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 2000000;
+  if (frames == 0) frames = 1;
+
+  bool ok = testFanout(frames / 10 + 1);
+  const OverloadPolicy policies[] = {OVERLOAD_DROP_NEWEST, OVERLOAD_DROP_OLDEST,
+                                     OVERLOAD_LATEST_PER_ID, OVERLOAD_SPILL};
+  for (size_t i = 0; i < sizeof(policies) / sizeof(policies[0]); i++) {
+    ok = testLanes(policies[i], frames / 10 + 1) && ok;
+  }
+
+  printf("\nCanMessage = %u B, FrameHandle = %u B, %lu frames, melhor de 3\n",
+         (unsigned)sizeof(CanMessage), (unsigned)sizeof(FrameHandle), (unsigned long)frames);
+  printf("%-8s %-7s %12s %9s %9s %10s\n", "forma", "caminho", "frames/s", "ns/frame",
+         "vs cópia", "B em filas");
+  ChainResult copy = best(chainCopy, frames);
+  ChainResult handle = best(chainHandle, frames);
+  ChainResult mixed = best(chainMixed, frames);
+  printRow("cadeia", "cópia", copy, copy.framesPerSecond, 2 * sizeof(CanMessage));
+  printRow("cadeia", "handle", handle, copy.framesPerSecond, 2 * sizeof(FrameHandle));
+  printRow("cadeia", "misto", mixed, copy.framesPerSecond, sizeof(CanMessage) + sizeof(FrameHandle));
+  ok = ok && copy.checksum == handle.checksum && copy.checksum == mixed.checksum;
+
+  copy = best(fanoutCopy, frames);
+  handle = best(fanoutHandle, frames);
+  printRow("fan-out", "cópia", copy, copy.framesPerSecond, BENCH_FANOUT * sizeof(CanMessage));
+  printRow("fan-out", "handle", handle, copy.framesPerSecond, BENCH_FANOUT * sizeof(FrameHandle));
+  ok = ok && copy.checksum == handle.checksum;
+
+  printf("%s\n", ok ? "OK" : "FALHA");
+  return ok ? 0 : 2;
+}
@@ -0,0 +1,416 @@
+// ------------------------------------------------------------------
+// Benchmark e validação no PC do hex dos payloads (src/common/hex_codec.h)
+// ------------------------------------------------------------------
+// Codificação, com os payloads do simulador, nos dois formatos:
+//   espaçado : "AA BB CC" (JSON do MQTT, serial) — sprintf por byte como
+//              no mqttPublisherTask, tabela de 16 nibbles (JsonWriter de
+//              antes) e hexEncodeSpaced (tabela de 256 pares)
+//   contínuo : "AABBCC" (CSV da captura) — snprintf por byte como no
+//              logCanFrame, tabela de 256 pares e hexEncode (SWAR/SSE2
+//              no PC); de novo só com payloads cheios (8 bytes)
+// Leitura: strtoul por byte (os loadCapture de antes), tabela de 256
+// entradas e hexDecode (SWAR no PC); e o replay da captura inteira com
+// sscanf contra parseCaptureLine (src/common/capture_csv.h).
+//
+// Confere todos os caminhos contra o sprintf/strtoul: payloads do
+// simulador e aleatórios, texto com caracteres inválidos (inclusive
+// >= 0x80), IDs com e sem "0x" e as linhas da captura. Termina com
+// código 2 se algo divergir.
+//
+// Compilação (precisa de config/constants.h):
+//   g++ -std=c++11 -O2 tools/hex_codec_bench.cpp -o .build/hex_codec_bench
+// Sem SWAR (só as tabelas, como no ESP32), acrescentar -DHEX_CODEC_SWAR=0.
+// Uso:
+//   .build/hex_codec_bench ["src/esp32/_can_log (2).csv"] [payloads] [repetições]
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC 1
+#endif
+
+#include "../src/common/capture_csv.h"
+#include "../src/common/hex_codec.h"
+#include "../src/common/vehicle_sim.h"
+
+#define BENCH_HEX_BYTES 32
+
+struct Payload {
+  uint8_t data[8];
+  uint8_t length;
+};
+
+// ------------------------------------------------------------------
+// --- OS CAMINHOS COMPARADOS ---
+// ------------------------------------------------------------------
+
+typedef int (*Encoder)(const Payload &p, char *out);
+typedef bool (*Decoder)(const char *text, uint8_t length, uint8_t *out);
+
+static int spacedSprintf(const Payload &p, char *out) {
+  char *ptr = out;
+  for (uint8_t i = 0; i < p.length; i++) {
+    ptr += sprintf(ptr, i == 0 ? "%02X" : " %02X", p.data[i]);
+  }
+  *ptr = '\0';
+  return (int)(ptr - out);
+}
+
+static int spacedNibbles(const Payload &p, char *out) {
+  static const char NIBBLES[] = "0123456789ABCDEF";
+  char *ptr = out;
+  for (uint8_t i = 0; i < p.length; i++) {
+    if (i > 0) *ptr++ = ' ';
+    *ptr++ = NIBBLES[p.data[i] >> 4];
+    *ptr++ = NIBBLES[p.data[i] & 0x0F];
+  }
+  *ptr = '\0';
+  return (int)(ptr - out);
+}
+
+static int spacedCodec(const Payload &p, char *out) {
+  uint8_t length = hexEncodeSpaced(out, p.data, p.length);
+  out[length] = '\0';
+  return length;
+}
+
+static int compactSnprintf(const Payload &p, char *out) {
+  int length = 0;
+  for (uint8_t i = 0; i < p.length; i++) {
+    length += snprintf(out + length, BENCH_HEX_BYTES - length, "%02X", p.data[i]);
+  }
+  out[length] = '\0';
+  return length;
+}
+
+static int compactPairs(const Payload &p, char *out) {
+  const char *pairs = hexPairs();
+  for (uint8_t i = 0; i < p.length; i++) memcpy(out + 2 * i, pairs + p.data[i] * 2, 2);
+  out[2 * p.length] = '\0';
+  return 2 * p.length;
+}
+
+static int compactCodec(const Payload &p, char *out) {
+  uint8_t length = hexEncode(out, p.data, p.length);
+  out[length] = '\0';
+  return length;
+}
+
+static bool decodeStrtoul(const char *text, uint8_t length, uint8_t *out) {
+  for (uint8_t i = 0; i < length; i++) {
+    char byteText[3] = {text[2 * i], text[2 * i + 1], 0};
+    out[i] = (uint8_t)strtoul(byteText, NULL, 16);
+  }
+  return true;
+}
+
+static bool decodeTable(const char *text, uint8_t length, uint8_t *out) {
+  const uint8_t *values = hexDigitValues();
+  for (uint8_t i = 0; i < length; i++) {
+    uint8_t high = values[(uint8_t)text[2 * i]];
+    uint8_t low = values[(uint8_t)text[2 * i + 1]];
+    if ((high | low) == HEX_INVALID) return false;
+    out[i] = (uint8_t)(high << 4 | low);
+  }
+  return true;
+}
+
+static bool decodeCodec(const char *text, uint8_t length, uint8_t *out) {
+  return hexDecode(out, text, length);
+}
+
+/**
+ * @brief A leitura de linha dos loadCapture de antes
+ */
+static bool parseSscanf(const char *line, CaptureLine &out) {
+  char idText[16], kind[4], hex[40];
+  unsigned long ms;
+  int dlc;
+  if (sscanf(line, "%lu,%15[^,],%3[^,],%d,%39s", &ms, idText, kind, &dlc, hex) != 5) return false;
+  if (dlc < 0 || dlc > 8 || (int)strlen(hex) < dlc * 2) return false;
+  out.ms = (uint32_t)ms;
+  out.id = (uint32_t)strtoul(idText, NULL, 16);
+  out.isExtended = kind[0] == 'E';
+  out.length = (uint8_t)dlc;
+  memset(out.data, 0, sizeof(out.data));
+  decodeStrtoul(hex, out.length, out.data);
+  return true;
+}
+
+// ------------------------------------------------------------------
+// --- DADOS ---
+// ------------------------------------------------------------------
+
+static void buildPayloads(uint32_t count, std::vector<Payload> &payloads) {
+  VehicleSim sim;
+  sim.setBusLoad(100);
+  payloads.resize(count);
+  for (uint32_t i = 0; i < count; i++) {
+    SimFrame frame;
+    sim.nextFrame(frame);
+    memcpy(payloads[i].data, frame.data, sizeof(payloads[i].data));
+    payloads[i].length = frame.length <= 8 ? frame.length : 8;
+  }
+}
+
+static bool loadLines(const char *path, std::vector<std::string> &lines) {
+  FILE *file = fopen(path, "r");
+  if (!file) return false;
+  char line[128];
+  while (fgets(line, sizeof(line), file)) lines.push_back(line);
+  fclose(file);
+  return !lines.empty();
+}
+
+// ------------------------------------------------------------------
+// --- CONFERÊNCIA ---
+// ------------------------------------------------------------------
+
+static bool sameEncoding(const char *what, const std::vector<Payload> &payloads,
+                         Encoder reference, Encoder candidate) {
+  char expected[BENCH_HEX_BYTES], actual[BENCH_HEX_BYTES];
+  for (size_t i = 0; i < payloads.size(); i++) {
+    int a = reference(payloads[i], expected);
+    int b = candidate(payloads[i], actual);
+    if (a != b || strcmp(expected, actual) != 0) {
+      printf("DIVERGE %s no payload %lu: \"%s\" != \"%s\"\n", what, (unsigned long)i, actual,
+             expected);
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint32_t nextRandom(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+/**
+ * @brief Texto de 16 caracteres, às vezes com um caractere qualquer
+ *        (0x01-0xFF) no lugar de um dígito; confere aceite e valores
+ */
+static bool checkDecoding(uint32_t count) {
+  static const char DIGITS[] = "0123456789ABCDEFabcdef";
+  uint32_t state = 0x2545F491;
+  for (uint32_t n = 0; n < count; n++) {
+    char text[17];
+    for (int i = 0; i < 16; i++) text[i] = DIGITS[nextRandom(state) % 22];
+    text[16] = '\0';
+    if (nextRandom(state) % 4 == 0) text[nextRandom(state) % 16] = (char)(1 + nextRandom(state) % 255);
+    uint8_t length = (uint8_t)(nextRandom(state) % 9);
+
+    bool valid = true;
+    for (int i = 0; i < 2 * length; i++) valid = valid && isxdigit((unsigned char)text[i]);
+    uint8_t expected[8] = {0}, table[8] = {0}, codec[8] = {0};
+    decodeStrtoul(text, length, expected);
+    bool tableOk = decodeTable(text, length, table);
+    bool codecOk = decodeCodec(text, length, codec);
+    if (tableOk != valid || codecOk != valid ||
+        (valid && (memcmp(table, expected, length) != 0 || memcmp(codec, expected, length) != 0))) {
+      printf("DIVERGE leitura de \"%.*s\" (%s)\n", 2 * length, text, valid ? "válido" : "inválido");
+      return false;
+    }
+  }
+
+  for (uint32_t n = 0; n < count; n++) {
+    uint32_t value = nextRandom(state) >> (nextRandom(state) % 32);
+    char text[16];
+    snprintf(text, sizeof(text), n % 2 ? "0x%lX," : "%lx,", (unsigned long)value);
+    uint32_t parsed = 0;
+    const char *end = hexParseU32(text, parsed);
+    if (!end || *end != ',' || parsed != (uint32_t)strtoul(text, NULL, 16)) {
+      printf("DIVERGE hexParseU32(\"%s\")\n", text);
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool sameReplay(const std::vector<std::string> &lines, uint32_t &accepted) {
+  accepted = 0;
+  for (size_t i = 0; i < lines.size(); i++) {
+    CaptureLine expected, actual;
+    bool a = parseSscanf(lines[i].c_str(), expected);
+    bool b = parseCaptureLine(lines[i].c_str(), actual);
+    if (a != b || (a && (expected.ms != actual.ms || expected.id != actual.id ||
+                         expected.isExtended != actual.isExtended ||
+                         expected.length != actual.length ||
+                         memcmp(expected.data, actual.data, sizeof(expected.data)) != 0))) {
+      printf("DIVERGE linha %lu da captura: %s", (unsigned long)i + 1, lines[i].c_str());
+      return false;
+    }
+    if (b) accepted++;
+  }
+  return true;
+}
+
+// ------------------------------------------------------------------
+// --- MEDIÇÃO ---
+// ------------------------------------------------------------------
+
+struct Measure {
+  double nsPerItem;
+  double cyclesPerItem; // 0 sem contador de ciclos
+};
+
+class Stopwatch {
+public:
+  Stopwatch() : start_(std::chrono::steady_clock::now()) {
+#ifdef BENCH_HAS_TSC
+    cycles_ = __rdtsc();
+#endif
+  }
+
+  Measure stop(double items) const {
+    Measure m;
+    m.nsPerItem = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count() *
+                  1e9 / items;
+#ifdef BENCH_HAS_TSC
+    m.cyclesPerItem = (__rdtsc() - cycles_) / items;
+#else
+    m.cyclesPerItem = 0;
+#endif
+    return m;
+  }
+
+private:
+  std::chrono::steady_clock::time_point start_;
+  uint64_t cycles_ = 0;
+};
+
+static volatile uint32_t sink; // Impede que o compilador descarte o trabalho medido
+
+template <Encoder encoder>
+static Measure measureEncoder(const std::vector<Payload> &payloads, uint32_t repetitions) {
+  char buffer[BENCH_HEX_BYTES];
+  uint32_t bytes = 0;
+  Stopwatch watch;
+  for (uint32_t rep = 0; rep < repetitions; rep++) {
+    for (size_t i = 0; i < payloads.size(); i++) bytes += (uint32_t)encoder(payloads[i], buffer);
+  }
+  Measure m = watch.stop((double)payloads.size() * repetitions);
+  sink = bytes;
+  return m;
+}
+
+template <Decoder decoder>
+static Measure measureDecoder(const std::vector<std::string> &texts,
+                              const std::vector<Payload> &payloads, uint32_t repetitions) {
+  uint8_t data[8];
+  uint32_t sum = 0;
+  Stopwatch watch;
+  for (uint32_t rep = 0; rep < repetitions; rep++) {
+    for (size_t i = 0; i < texts.size(); i++) {
+      if (decoder(texts[i].c_str(), payloads[i].length, data)) sum += data[0];
+    }
+  }
+  Measure m = watch.stop((double)texts.size() * repetitions);
+  sink = sum;
+  return m;
+}
+
+typedef bool (*LineParser)(const char *line, CaptureLine &out);
+
+template <LineParser parser>
+static Measure measureReplay(const std::vector<std::string> &lines, uint32_t repetitions) {
+  CaptureLine row;
+  uint32_t sum = 0;
+  Stopwatch watch;
+  for (uint32_t rep = 0; rep < repetitions; rep++) {
+    for (size_t i = 0; i < lines.size(); i++) {
+      if (parser(lines[i].c_str(), row)) sum += row.id;
+    }
+  }
+  Measure m = watch.stop((double)lines.size() * repetitions);
+  sink = sum;
+  return m;
+}
+
+static void printRow(const char *shape, const char *path, const Measure &m, const Measure &base) {
+  printf("%-10s %-16s %9.1f %10.1f %8.2fx\n", shape, path, m.nsPerItem, m.cyclesPerItem,
+         base.nsPerItem / m.nsPerItem);
+}
+
+int main(int argc, char **argv) {
+  const char *path = argc > 1 ? argv[1] : "src/esp32/_can_log (2).csv";
+  uint32_t count = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 200000;
+  uint32_t repetitions = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 10) : 10;
+  if (count == 0 || repetitions == 0) return 1;
+
+  std::vector<Payload> payloads;
+  buildPayloads(count, payloads);
+  std::vector<Payload> random(count);
+  uint32_t state = 0x9E3779B9;
+  for (uint32_t i = 0; i < count; i++) {
+    for (int b = 0; b < 8; b++) random[i].data[b] = (uint8_t)nextRandom(state);
+    random[i].length = (uint8_t)(nextRandom(state) % 9);
+  }
+  std::vector<std::string> lines;
+  if (!loadLines(path, lines)) {
+    fprintf(stderr, "não abriu %s\n", path);
+    return 1;
+  }
+
+  bool ok = sameEncoding("espaçado", payloads, spacedSprintf, spacedCodec) &&
+            sameEncoding("espaçado", random, spacedSprintf, spacedCodec) &&
+            sameEncoding("contínuo", payloads, compactSnprintf, compactCodec) &&
+            sameEncoding("contínuo", random, compactSnprintf, compactCodec);
+  printf("codificação = sprintf byte a byte em %lu payloads x 2 formatos: %s\n",
+         (unsigned long)count * 2, ok ? "OK" : "FALHA");
+  bool decoding = checkDecoding(count);
+  printf("leitura = strtoul (com caracteres inválidos) e IDs = strtoul: %s\n",
+         decoding ? "OK" : "FALHA");
+  uint32_t accepted = 0;
+  bool replay = sameReplay(lines, accepted);
+  printf("parseCaptureLine = sscanf em %lu linhas (%lu frames): %s\n", (unsigned long)lines.size(),
+         (unsigned long)accepted, replay ? "OK" : "FALHA");
+  ok = ok && decoding && replay;
+
+  printf("\nSWAR: %s\n", HEX_CODEC_SWAR ? "sim" : "não (só tabelas)");
+  printf("%-10s %-16s %9s %10s %9s\n", "formato", "caminho", "ns/item", "ciclos", "vs printf");
+  Measure base = measureEncoder<spacedSprintf>(payloads, repetitions);
+  printRow("espaçado", "sprintf", base, base);
+  printRow("espaçado", "16 nibbles", measureEncoder<spacedNibbles>(payloads, repetitions), base);
+  printRow("espaçado", "hexEncodeSpaced", measureEncoder<spacedCodec>(payloads, repetitions), base);
+
+  base = measureEncoder<compactSnprintf>(payloads, repetitions);
+  printRow("contínuo", "snprintf", base, base);
+  printRow("contínuo", "256 pares", measureEncoder<compactPairs>(payloads, repetitions), base);
+  printRow("contínuo", "hexEncode", measureEncoder<compactCodec>(payloads, repetitions), base);
+
+  std::vector<Payload> full(random);
+  for (size_t i = 0; i < full.size(); i++) full[i].length = 8;
+  base = measureEncoder<compactSnprintf>(full, repetitions);
+  printRow("8 bytes", "snprintf", base, base);
+  printRow("8 bytes", "256 pares", measureEncoder<compactPairs>(full, repetitions), base);
+  printRow("8 bytes", "hexEncode", measureEncoder<compactCodec>(full, repetitions), base);
+
+  std::vector<std::string> texts(payloads.size());
+  for (size_t i = 0; i < payloads.size(); i++) {
+    char text[BENCH_HEX_BYTES];
+    compactCodec(payloads[i], text);
+    texts[i] = text;
+  }
+  base = measureDecoder<decodeStrtoul>(texts, payloads, repetitions);
+  printRow("leitura", "strtoul", base, base);
+  printRow("leitura", "256 entradas", measureDecoder<decodeTable>(texts, payloads, repetitions), base);
+  printRow("leitura", "hexDecode", measureDecoder<decodeCodec>(texts, payloads, repetitions), base);
+
+  uint32_t passes = (count * repetitions + (uint32_t)lines.size() - 1) / (uint32_t)lines.size();
+  base = measureReplay<parseSscanf>(lines, passes);
+  printRow("linha CSV", "sscanf", base, base);
+  printRow("linha CSV", "parseCaptureLine", measureReplay<parseCaptureLine>(lines, passes), base);
+
+  printf("%s\n", ok ? "OK" : "FALHA");
+  return ok ? 0 : 2;
+}
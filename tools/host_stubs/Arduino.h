@@ -0,0 +1,52 @@
+#pragma once
+// ------------------------------------------------------------------
+// Stubs mínimos do core Arduino/ESP32 para compilar o sketch no host
+// ------------------------------------------------------------------
+// Só o que src/sketch_def usa, com corpos vazios: servem para o
+// compilador do host checar tipos, templates e os #if de cada perfil
+// (tools/firmware_host_build.sh), não para simular o hardware. Quem
+// precisa de comportamento usa as ferramentas de tools/*.cpp.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <string>
+#include <functional>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define OUTPUT 1
+#define HIGH 1
+#define LOW 0
+#define HEX 16
+
+inline uint32_t millis() { return 0; }
+inline uint32_t micros() { return 0; }
+inline void delay(uint32_t) {}
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return 0; }
+inline long random(long max) { return max / 2; }
+
+struct String {
+  std::string s;
+  String(const char *c = "") : s(c) {}
+  String(long v, int = 10) : s(std::to_string(v)) {}
+  String &operator+=(const String &o) { s += o.s; return *this; }
+  const char *c_str() const { return s.c_str(); }
+};
+
+struct HardwareSerial {
+  void begin(long) {}
+  template <class T> void print(T) {}
+  template <class T> void println(T) {}
+  void println() {}
+  int printf(const char *, ...) { return 0; }
+};
+extern HardwareSerial Serial;
+
+struct EspClass {
+  uint64_t getEfuseMac() { return 0x123456789abcULL; }
+};
+extern EspClass ESP;
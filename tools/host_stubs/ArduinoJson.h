@@ -0,0 +1,40 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+struct JsonObject;
+struct JsonArray;
+struct JsonVariant {
+  template<class T> JsonVariant& operator=(T){return *this;}
+  JsonVariant operator[](const char*) const {return JsonVariant();}
+  template<class T> bool is() const {return false;}
+  template<class T> T as() const {return T();}
+  template<class T> T operator|(T d) const {return d;}
+  bool isNull() const {return true;}
+  template<class T> operator T() const {return T();}
+};
+struct JsonString { const char* c_str() const {return "";} };
+struct JsonPair { JsonString key() const {return JsonString();} JsonVariant value() const {return JsonVariant();} };
+struct JsonObject {
+  JsonVariant operator[](const char*) const {return JsonVariant();}
+  bool isNull() const {return true;}
+  bool containsKey(const char*) const {return false;}
+  const JsonPair* begin() const {return nullptr;} const JsonPair* end() const {return nullptr;}
+};
+struct JsonArray {
+  template<class T> bool add(T){return true;}
+  JsonArray createNestedArray(){return JsonArray();}
+  JsonObject createNestedObject(){return JsonObject();}
+  bool isNull() const {return true;}
+  size_t size() const {return 0;}
+  const JsonVariant* begin() const {return nullptr;} const JsonVariant* end() const {return nullptr;}
+};
+struct DeserializationError { explicit operator bool() const {return false;} const char* c_str() const {return "Ok";} };
+template<int N> struct StaticJsonDocument {
+  JsonVariant operator[](const char*){return JsonVariant();}
+  JsonObject createNestedObject(const char*){return JsonObject();}
+  JsonArray createNestedArray(const char*){return JsonArray();}
+  template<class T> T as() const {return T();}
+  void clear(){}
+};
+template<class D> size_t serializeJson(const D&, char*, size_t){return 0;}
+template<class D> DeserializationError deserializeJson(D&, const char*, size_t){return DeserializationError();}
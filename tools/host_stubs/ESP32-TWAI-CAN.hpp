@@ -0,0 +1,6 @@
+#pragma once
+#include <stdint.h>
+enum TwaiSpeed { TWAI_SPEED_250KBPS };
+struct CanFrame { uint32_t identifier; uint8_t data_length_code; bool extd; uint8_t data[8]; };
+struct Esp32CanCls { void setPins(int,int){} bool begin(TwaiSpeed){return true;} bool readFrame(CanFrame&,int){return false;} };
+extern Esp32CanCls ESP32Can;
@@ -0,0 +1,6 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#define FILE_APPEND "a"
+#define FILE_READ "r"
+struct File { explicit operator bool() const {return false;} int printf(const char*,...){return 0;} size_t println(const char*){return 0;} void flush(){} void close(){} size_t read(uint8_t*,size_t){return 0;} size_t write(const uint8_t*,size_t){return 0;} };
@@ -0,0 +1,3 @@
+#pragma once
+#include "Arduino.h"
+struct HTTPClient { void setTimeout(int){} bool begin(String){return true;} void addHeader(const char*,const char*){} int POST(String){return 200;} void end(){} };
@@ -0,0 +1,3 @@
+#pragma once
+#include "WiFi.h"
+struct PubSubClient { PubSubClient(WiFiClient&){} void setServer(const char*,int){} bool setBufferSize(int){return true;} bool connected(){return false;} bool connect(const char*){return false;} int state(){return 0;} void loop(){} bool publish(const char*,const char*){return true;} };
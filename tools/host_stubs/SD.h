@@ -0,0 +1,4 @@
+#pragma once
+#include "FS.h"
+struct SDCls { bool begin(int){return false;} bool exists(const char*){return false;} File open(const char*,const char*){return File();} };
+extern SDCls SD;
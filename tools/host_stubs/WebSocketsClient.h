@@ -0,0 +1,6 @@
+#pragma once
+#include <functional>
+#include <stdint.h>
+#include <stddef.h>
+enum WStype_t { WStype_DISCONNECTED, WStype_CONNECTED, WStype_ERROR, WStype_TEXT };
+struct WebSocketsClient { void begin(const char*,uint16_t,const char*){} void onEvent(std::function<void(WStype_t,uint8_t*,size_t)>){} void setReconnectInterval(unsigned long){} void loop(){} bool isConnected(){return false;} bool sendBIN(const uint8_t*,size_t){return true;} bool sendTXT(const char*){return true;} };
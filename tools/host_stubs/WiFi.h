@@ -0,0 +1,8 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#define WL_CONNECTED 3
+struct WiFiCls { int status(){return 0;} void begin(const char*,const char*){} void disconnect(){} const char* localIP(){return "0.0.0.0";} uint8_t* macAddress(uint8_t* m){for(int i=0;i<6;i++)m[i]=0;return m;} };
+extern WiFiCls WiFi;
+struct WiFiClient { int connect(const char*,uint16_t,int32_t){return 0;} int connect(const char*,uint16_t){return 0;} int fd() const {return -1;} int setNoDelay(bool){return 0;} uint8_t connected(){return 0;} size_t write(const uint8_t*,size_t){return 0;} void stop(){} };
+inline void configTime(long,int,const char*){}
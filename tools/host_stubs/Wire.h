@@ -0,0 +1,2 @@
+#pragma once
+struct TwoWire { void begin(int,int){} }; extern TwoWire Wire;
@@ -0,0 +1,6 @@
+#pragma once
+#include <stdint.h>
+typedef uint32_t TickType_t; typedef int BaseType_t; typedef void* QueueHandle_t; typedef void* TaskHandle_t;
+#define pdTRUE 1
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(x) ((TickType_t)(x))
@@ -0,0 +1,11 @@
+#pragma once
+#include "FreeRTOS.h"
+inline void vTaskDelay(TickType_t){}
+inline void vTaskDelayUntil(TickType_t*,TickType_t){}
+inline TickType_t xTaskGetTickCount(){return 0;}
+inline void vTaskDelete(void*){}
+typedef void (*TaskFunction_t)(void*);
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t,const char*,uint32_t,void*,int,TaskHandle_t*,int){return 1;}
+#define portMAX_DELAY 0xffffffffUL
+inline BaseType_t xTaskNotifyGive(TaskHandle_t){return 1;}
+inline uint32_t ulTaskNotifyTake(BaseType_t,TickType_t){return 0;}
@@ -0,0 +1,22 @@
+// Objetos globais das bibliotecas e um main() que chama setup() uma vez,
+// para o sketch ligar (link) no host. As tasks não rodam: os stubs do
+// FreeRTOS só aceitam a criação.
+#include "Arduino.h"
+#include "ESP32-TWAI-CAN.hpp"
+#include "WiFi.h"
+#include "SD.h"
+#include "Wire.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+Esp32CanCls ESP32Can;
+WiFiCls WiFi;
+SDCls SD;
+TwoWire Wire;
+
+extern void setup();
+
+int main() {
+  setup();
+  return 0;
+}
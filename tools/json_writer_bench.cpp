@@ -0,0 +1,330 @@
+// ------------------------------------------------------------------
+// Benchmark e validação no PC do JSON de formato fixo
+// (src/common/json_writer.h e src/common/text_format.h)
+// ------------------------------------------------------------------
+// Os mesmos registros (frames do simulador e o estado decodificado
+// depois de cada um) são serializados nos dois formatos da telemetria:
+//   frame : {"canId":..,"ide":..,"dlc":..,"data":"AA BB ..","dt":..,"as":..}
+//           (MqttJsonSink, sem MPU)
+//   estado: vehicleStateToJson (v, a, tq em décimos como %.1f)
+// por três caminhos: snprintf (o formato de antes), ArduinoJson (o
+// StaticJsonDocument de antes, só com -DBENCH_ARDUINOJSON) e JsonWriter.
+//
+// Confere que o JsonWriter sai byte a byte igual ao snprintf em todos
+// os registros (e ao ArduinoJson no formato de frame), e formatI32 /
+// formatFixed contra printf em valores aleatórios e nos extremos.
+// Termina com código 2 se algo divergir.
+//
+// Compilação (precisa de config/constants.h):
+//   g++ -std=c++11 -O2 tools/json_writer_bench.cpp -o .build/json_writer_bench
+// Com ArduinoJson (biblioteca só de headers, compila no PC), acrescentar:
+//   -DBENCH_ARDUINOJSON -I<ArduinoJson>/src
+// Uso:
+//   .build/json_writer_bench [registros] [repetições]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC 1
+#endif
+#ifdef BENCH_ARDUINOJSON
+#include <ArduinoJson.h>
+#endif
+
+#include "../src/common/can_message.h"
+#include "../src/common/json_writer.h"
+#include "../src/common/vehicle_sim.h"
+#include "../src/common/vehicle_state.h"
+
+#define BENCH_JSON_BYTES 256
+
+struct Record {
+  CanMessage frame;
+  VehicleState state;
+  int32_t deltaUs;
+  uint32_t anchorSeq;
+  uint32_t nowMs;
+};
+
+// ------------------------------------------------------------------
+// --- OS TRÊS CAMINHOS ---
+// ------------------------------------------------------------------
+
+static int frameSnprintf(const Record &r, char *out, size_t size) {
+  char dataHex[25];
+  char *ptr = dataHex;
+  dataHex[0] = '\0';
+  for (int i = 0; i < r.frame.length; i++) {
+    ptr += sprintf(ptr, i == 0 ? "%02X" : " %02X", r.frame.data[i]);
+  }
+  return snprintf(out, size, "{\"canId\":%lu,\"ide\":%s,\"dlc\":%u,\"data\":\"%s\",\"dt\":%ld,\"as\":%lu}",
+                  (unsigned long)r.frame.id, r.frame.isExtended ? "true" : "false",
+                  (unsigned)r.frame.length, dataHex, (long)r.deltaUs, (unsigned long)r.anchorSeq);
+}
+
+static int frameWriter(const Record &r, char *out, size_t size) {
+  JsonWriter json(out, size);
+  json.raw("{\"canId\":").u32(r.frame.id)
+      .raw(",\"ide\":").boolean(r.frame.isExtended)
+      .raw(",\"dlc\":").u32(r.frame.length)
+      .raw(",\"data\":").hex(r.frame.data, r.frame.length)
+      .raw(",\"dt\":").i32(r.deltaUs)
+      .raw(",\"as\":").u32(r.anchorSeq)
+      .raw("}");
+  return json.finish();
+}
+
+/** @brief vehicleStateToJson antes do JsonWriter */
+static int stateSnprintf(const Record &r, char *out, size_t size) {
+  const VehicleState &s = r.state;
+  return snprintf(out, size,
+      "{\"v\":%.1f,\"a\":%.1f,\"soc\":%ld,\"soh\":%ld,\"tB\":%ld,"
+      "\"rpm\":%ld,\"tq\":%.1f,\"tM\":%ld,\"tC\":%ld,\"mod\":\"%s\","
+      "\"age\":%lu,\"n\":%lu}",
+      s.battery.voltageDeci / 10.0f, s.battery.currentDeci / 10.0f,
+      (long)s.battery.soc, (long)s.battery.soh, (long)s.battery.temperature,
+      (long)s.motor.rpm, s.motor.torqueDeci / 10.0f, (long)s.motor.motorTemp,
+      (long)s.motor.controllerTemp, rideModeName(s.motor.mode),
+      (unsigned long)(r.nowMs - s.lastUpdateMs), (unsigned long)s.frameCount);
+}
+
+static int stateWriter(const Record &r, char *out, size_t size) {
+  return vehicleStateToJson(r.state, r.nowMs, out, size);
+}
+
+#ifdef BENCH_ARDUINOJSON
+/** @brief publishFrame antes do JsonWriter */
+static int frameArduinoJson(const Record &r, char *out, size_t size) {
+  StaticJsonDocument<512> doc;
+  doc["canId"] = r.frame.id;
+  doc["ide"] = r.frame.isExtended;
+  doc["dlc"] = r.frame.length;
+  char dataHex[25];
+  char *ptr = dataHex;
+  dataHex[0] = '\0';
+  for (int i = 0; i < r.frame.length; i++) {
+    ptr += sprintf(ptr, i == 0 ? "%02X" : " %02X", r.frame.data[i]);
+  }
+  doc["data"] = dataHex;
+  doc["dt"] = r.deltaUs;
+  doc["as"] = r.anchorSeq;
+  return (int)serializeJson(doc, out, size);
+}
+
+/** @brief O estado por documento (floats: não é byte a byte igual ao %.1f) */
+static int stateArduinoJson(const Record &r, char *out, size_t size) {
+  const VehicleState &s = r.state;
+  StaticJsonDocument<384> doc;
+  doc["v"] = s.battery.voltageDeci / 10.0f;
+  doc["a"] = s.battery.currentDeci / 10.0f;
+  doc["soc"] = s.battery.soc;
+  doc["soh"] = s.battery.soh;
+  doc["tB"] = s.battery.temperature;
+  doc["rpm"] = s.motor.rpm;
+  doc["tq"] = s.motor.torqueDeci / 10.0f;
+  doc["tM"] = s.motor.motorTemp;
+  doc["tC"] = s.motor.controllerTemp;
+  doc["mod"] = rideModeName(s.motor.mode);
+  doc["age"] = r.nowMs - s.lastUpdateMs;
+  doc["n"] = s.frameCount;
+  return (int)serializeJson(doc, out, size);
+}
+#endif
+
+typedef int (*Serializer)(const Record &, char *, size_t);
+
+// ------------------------------------------------------------------
+// --- REGISTROS E CONFERÊNCIA ---
+// ------------------------------------------------------------------
+
+/**
+ * @brief Frames do simulador a 100% de carga e o estado depois de cada um
+ */
+static void buildRecords(uint32_t count, std::vector<Record> &records) {
+  VehicleSim sim;
+  sim.setBusLoad(100);
+  VehicleState state;
+  SimFrame simFrame;
+  records.resize(count);
+  for (uint32_t i = 0; i < count; i++) {
+    sim.nextFrame(simFrame);
+    Record &r = records[i];
+    memset(&r.frame, 0, sizeof(r.frame));
+    r.frame.id = simFrame.id;
+    r.frame.length = simFrame.length;
+    r.frame.isExtended = simFrame.isExtended;
+    memcpy(r.frame.data, simFrame.data, sizeof(r.frame.data));
+    r.frame.timestampUs = (uint32_t)simFrame.timeUs;
+    r.nowMs = (uint32_t)(simFrame.timeUs / 1000);
+    applyFrame(state, r.frame.id, r.frame.data, r.frame.length, r.nowMs);
+    r.state = state;
+    r.deltaUs = (int32_t)(simFrame.timeUs % 60000000ULL) - 30000000; // Âncora a cada 60 s
+    r.anchorSeq = (uint32_t)(simFrame.timeUs / 60000000ULL);
+  }
+}
+
+static bool sameOutput(const char *what, const std::vector<Record> &records, Serializer reference,
+                       Serializer candidate) {
+  char expected[BENCH_JSON_BYTES], got[BENCH_JSON_BYTES];
+  for (size_t i = 0; i < records.size(); i++) {
+    int a = reference(records[i], expected, sizeof(expected));
+    int b = candidate(records[i], got, sizeof(got));
+    if (a != b || memcmp(expected, got, a) != 0) {
+      printf("  FALHA %s no registro %lu:\n    esperado %s\n    obtido   %s\n", what,
+             (unsigned long)i, expected, got);
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief formatI32 / formatFixed contra printf
+ */
+static bool checkNumbers() {
+  static const int32_t EDGES[] = {0, 1, -1, 9, 10, -10, 99, 100, 12345, -99999,
+                                  2147483647, -2147483647 - 1, 9999999, -9999999};
+  char expected[32], got[TEXT_NUMBER_MAX + 1];
+  uint32_t seed = 12345;
+  for (uint32_t i = 0; i < 4000000; i++) {
+    int32_t value;
+    if (i < sizeof(EDGES) / sizeof(EDGES[0])) {
+      value = EDGES[i];
+    } else {
+      seed = seed * 1664525u + 1013904223u;
+      value = (int32_t)seed >> (seed & 15); // Magnitudes variadas
+    }
+
+    int n = snprintf(expected, sizeof(expected), "%ld", (long)value);
+    uint8_t length = formatI32(got, value);
+    if (length != n || memcmp(expected, got, n) != 0) {
+      printf("  FALHA formatI32(%ld)\n", (long)value);
+      return false;
+    }
+
+    // Décimos como %.1f de float: vale enquanto o float guarda o décimo
+    if (value > -10000000 && value < 10000000) {
+      n = snprintf(expected, sizeof(expected), "%.1f", value / 10.0f);
+      length = formatFixed(got, value, 1);
+      if (length != n || memcmp(expected, got, n) != 0) {
+        got[length] = '\0';
+        printf("  FALHA formatFixed(%ld, 1): %s, %%.1f: %s\n", (long)value, got, expected);
+        return false;
+      }
+    }
+
+    // Quatro casas (MPU): referência inteira
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    n = snprintf(expected, sizeof(expected), "%s%lu.%04lu", value < 0 ? "-" : "",
+                 (unsigned long)(magnitude / 10000), (unsigned long)(magnitude % 10000));
+    length = formatFixed(got, value, 4);
+    if (length != n || memcmp(expected, got, n) != 0) {
+      printf("  FALHA formatFixed(%ld, 4)\n", (long)value);
+      return false;
+    }
+  }
+
+  // Buffer curto: para e devolve size, sem escrever além
+  char small[16];
+  memset(small, '#', sizeof(small));
+  JsonWriter json(small, 10);
+  json.raw("{\"v\":").i32(-2147483647).raw("}");
+  if (json.finish() != 10 || small[10] != '#') {
+    printf("  FALHA estouro do JsonWriter\n");
+    return false;
+  }
+  return true;
+}
+
+// ------------------------------------------------------------------
+// --- MEDIÇÃO ---
+// ------------------------------------------------------------------
+
+struct Measure {
+  double nsPerRecord;
+  double cyclesPerRecord; // 0 sem contador de ciclos
+  double megabytesPerSecond;
+};
+
+static Measure measure(const std::vector<Record> &records, Serializer serializer,
+                       uint32_t repetitions) {
+  char buffer[BENCH_JSON_BYTES];
+  uint64_t bytes = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#ifdef BENCH_HAS_TSC
+  uint64_t cyclesStart = __rdtsc();
+#endif
+  for (uint32_t rep = 0; rep < repetitions; rep++) {
+    for (size_t i = 0; i < records.size(); i++) {
+      bytes += (uint64_t)serializer(records[i], buffer, sizeof(buffer));
+    }
+  }
+#ifdef BENCH_HAS_TSC
+  uint64_t cycles = __rdtsc() - cyclesStart;
+#endif
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double total = (double)records.size() * repetitions;
+
+  Measure m;
+  m.nsPerRecord = seconds * 1e9 / total;
+#ifdef BENCH_HAS_TSC
+  m.cyclesPerRecord = cycles / total;
+#else
+  m.cyclesPerRecord = 0;
+#endif
+  m.megabytesPerSecond = bytes / seconds / 1e6;
+  return m;
+}
+
+static void printRow(const char *shape, const char *path, const Measure &m, const Measure &base) {
+  printf("%-8s %-12s %10.1f %12.0f %10.1f %8.2fx\n", shape, path, m.nsPerRecord,
+         m.cyclesPerRecord, m.megabytesPerSecond, base.nsPerRecord / m.nsPerRecord);
+}
+
+int main(int argc, char **argv) {
+  uint32_t count = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 200000;
+  uint32_t repetitions = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 5;
+  if (count == 0 || repetitions == 0) return 1;
+
+  std::vector<Record> records;
+  buildRecords(count, records);
+
+  bool ok = checkNumbers();
+  printf("números (formatI32 / formatFixed contra printf, 4M valores): %s\n", ok ? "OK" : "FALHA");
+  bool same = sameOutput("frame", records, frameSnprintf, frameWriter) &&
+              sameOutput("estado", records, stateSnprintf, stateWriter);
+#ifdef BENCH_ARDUINOJSON
+  same = sameOutput("frame ArduinoJson", records, frameArduinoJson, frameWriter) && same;
+#endif
+  printf("JsonWriter = snprintf byte a byte em %lu registros x 2 formatos: %s\n\n",
+         (unsigned long)count, same ? "OK" : "FALHA");
+  ok = ok && same;
+
+  printf("%-8s %-12s %10s %12s %10s %9s\n", "formato", "caminho", "ns/reg", "ciclos/reg",
+         "MB/s", "vs printf");
+  Measure base = measure(records, frameSnprintf, repetitions);
+  printRow("frame", "snprintf", base, base);
+#ifdef BENCH_ARDUINOJSON
+  printRow("frame", "ArduinoJson", measure(records, frameArduinoJson, repetitions), base);
+#endif
+  printRow("frame", "JsonWriter", measure(records, frameWriter, repetitions), base);
+
+  base = measure(records, stateSnprintf, repetitions);
+  printRow("estado", "snprintf", base, base);
+#ifdef BENCH_ARDUINOJSON
+  printRow("estado", "ArduinoJson", measure(records, stateArduinoJson, repetitions), base);
+#endif
+  printRow("estado", "JsonWriter", measure(records, stateWriter, repetitions), base);
+#ifndef BENCH_ARDUINOJSON
+  printf("(ArduinoJson: compilar com -DBENCH_ARDUINOJSON -I<ArduinoJson>/src)\n");
+#endif
+
+  printf("%s\n", ok ? "OK" : "FALHA");
+  return ok ? 0 : 2;
+}
@@ -0,0 +1,241 @@
+// ------------------------------------------------------------------
+// Latência das falhas com a telemetria saturada (priority_lanes.h)
+// ------------------------------------------------------------------
+// Reproduz no PC a captura → PriorityLanes → task de envio do firmware:
+//   produtor : inunda a lane de telemetria (mais frames por ms do que o
+//              envio consegue publicar, então ela enche e descarta) e,
+//              a cada 3–7 ms, coloca um frame de falha
+//              (BASE_CONTROLLER_ID_2 / BASE_BATTERY_ID_2) com a hora
+//              em timestampUs. A telemetria usa IDs próprios (os da
+//              captura), não os de config/constants.h: com os IDs
+//              zerados do constants_example.h ela cairia na lane de
+//              falhas
+//   envio    : o laço de uplinkTask em sketch_def.ino: drainFaults()
+//              no início do ciclo e depois de cada telemetria, até
+//              batchFrames por ciclo, e o resto do ciclo esperando na
+//              lane de falhas (popHigh com espera). Publicar custa
+//              publishUs por frame (sleep, como um publish bloqueado
+//              na rede)
+// A latência é da entrada na lane até a falha ser retirada. Depois roda
+// o mesmo fluxo com uma fila única (a OverloadQueue de BufferSize, como
+// antes das lanes) só para comparação.
+//
+// Termina com código 1 se o p99 ou o máximo das lanes passar dos
+// limites, se alguma falha se perder, se o pool não voltar cheio ou se
+// a telemetria cair na lane de falhas (IDs de falha iguais aos daqui).
+// Os limites padrão (10 e 50 publishUs) cobrem uma publicação em
+// andamento mais o atraso do sleep no PC, que numa VM chega a alguns ms
+// (medido e impresso antes da rodada); uma falha presa atrás da
+// telemetria, como na fila única, espera centenas de publicações.
+//
+// Compilação (precisa de config/constants.h):
+//   g++ -std=c++11 -O2 -pthread tools/lane_flood_bench.cpp -o .build/lane_flood_bench
+// Uso:
+//   .build/lane_flood_bench [falhas] [publishUs] [limite p99 us] [limite máx us]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../src/common/frame_pool.h"
+#include "../src/common/platform.h"
+#include "../src/common/priority_lanes.h"
+
+#define FLOOD_POOL_SIZE 384     // FRAME_POOL_SIZE do firmware
+#define FLOOD_LOW_CAPACITY 250  // BufferSize do firmware
+#define FLOOD_PER_MS 4          // Telemetria por ms (acima da vazão do envio)
+#define FLOOD_CYCLE_MS 50       // transmitIntervalMs padrão
+#define FLOOD_BATCH_FRAMES 1024 // batchFrames padrão
+#define FLOOD_BATTERY_ID 0x120  // Telemetria: bateria e controlador da captura
+#define FLOOD_CONTROLLER_ID 0x300
+
+struct FloodResult {
+  std::vector<uint32_t> latencyUs; // Falhas, ordenadas
+  uint32_t faultsSent = 0;
+  uint32_t telemetrySent = 0;
+  uint32_t telemetryDelivered = 0;
+  uint32_t lowDropped = 0;
+  uint32_t highDropped = 0;
+  bool poolFull = false;
+};
+
+static uint32_t percentile(const std::vector<uint32_t> &sorted, unsigned pct) {
+  if (sorted.empty()) return 0;
+  return sorted[std::min(sorted.size() - 1, sorted.size() * pct / 100)];
+}
+
+// ------------------------------------------------------------------
+// --- FLUXO DO FIRMWARE ---
+// ------------------------------------------------------------------
+
+/**
+ * @brief Uma rodada: lanes separadas (shared = false) ou tudo na fila
+ *        de telemetria (shared = true, a comparação)
+ */
+static FloodResult runFlood(uint32_t faults, uint32_t publishUs, bool shared) {
+  static StaticFramePool<FLOOD_POOL_SIZE> pool;
+  PriorityLanes lanes;
+  OverloadQueue single;
+  lanes.begin(pool, FLOOD_LOW_CAPACITY);
+  single.begin(pool, FLOOD_LOW_CAPACITY);
+
+  FloodResult result;
+  std::atomic<bool> done(false);
+
+  std::thread producer([&] {
+    uint32_t sequence = 0;
+    int64_t nextFault = monoMicros() + 1000;
+    while (result.faultsSent < faults) {
+      for (int i = 0; i < FLOOD_PER_MS; i++) {
+        FrameHandle handle = pool.acquire();
+        if (handle == FRAME_NONE) continue;
+        CanMessage &frame = pool.frame(handle);
+        frame = CanMessage();
+        frame.id = (sequence & 1) ? FLOOD_BATTERY_ID : FLOOD_CONTROLLER_ID;
+        frame.length = 8;
+        frame.data[0] = (uint8_t)sequence++;
+        frame.timestampUs = (uint32_t)monoMicros();
+        if (shared) single.push(handle); else lanes.push(handle);
+        result.telemetrySent++;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(1000));
+
+      int64_t now = monoMicros();
+      if (now < nextFault) continue;
+      FrameHandle handle = pool.acquire();
+      if (handle == FRAME_NONE) continue;
+      CanMessage &frame = pool.frame(handle);
+      frame = CanMessage();
+      frame.id = (result.faultsSent & 1) ? BASE_BATTERY_ID_2 : BASE_CONTROLLER_ID_2;
+      frame.length = 8;
+      frame.timestampUs = (uint32_t)monoMicros();
+      if (shared) single.push(handle); else lanes.push(handle);
+      result.faultsSent++;
+      nextFault = now + 3000 + rand() % 4000;
+    }
+    done = true;
+  });
+
+  auto deliver = [&](FrameHandle handle) {
+    const CanMessage &frame = pool.frame(handle);
+    if (frameLane(frame) == LANE_HIGH) {
+      result.latencyUs.push_back((uint32_t)monoMicros() - frame.timestampUs);
+    } else {
+      result.telemetryDelivered++;
+    }
+    pool.release(handle);
+    std::this_thread::sleep_for(std::chrono::microseconds(publishUs));
+  };
+  auto drainFaults = [&] {
+    FrameHandle handle;
+    while (!shared && lanes.popHigh(handle)) deliver(handle);
+  };
+
+  FrameHandle handle;
+  for (;;) {
+    bool last = done.load();
+    drainFaults();
+    uint32_t sent = 0;
+    while (sent < FLOOD_BATCH_FRAMES && (shared ? single.pop(handle) : lanes.popLow(handle))) {
+      deliver(handle);
+      sent++;
+      drainFaults();
+    }
+    if (last) break;
+
+    int64_t cycleEnd = monoMicros() + FLOOD_CYCLE_MS * 1000;
+    for (int64_t now = monoMicros(); now < cycleEnd; now = monoMicros()) {
+      if (shared) {
+        std::this_thread::sleep_for(std::chrono::microseconds(cycleEnd - now));
+      } else if (lanes.popHigh(handle, (uint32_t)(cycleEnd - now))) {
+        deliver(handle);
+      }
+    }
+  }
+  producer.join();
+
+  std::sort(result.latencyUs.begin(), result.latencyUs.end());
+  result.lowDropped = shared ? single.stats().lost() : lanes.dropped(LANE_LOW);
+  result.highDropped = shared ? 0 : lanes.dropped(LANE_HIGH);
+  result.poolFull = pool.available() == pool.capacity();
+  return result;
+}
+
+static void printRow(const char *name, const FloodResult &r) {
+  printf("%-12s %7zu/%-7u %9u %9u %9u %9u %9u\n", name, r.latencyUs.size(), r.faultsSent,
+         percentile(r.latencyUs, 50), percentile(r.latencyUs, 99),
+         r.latencyUs.empty() ? 0 : r.latencyUs.back(), r.telemetryDelivered, r.lowDropped);
+}
+
+/**
+ * @brief Confere que a telemetria vai para a lane de telemetria
+ */
+static bool telemetryRoutedLow() {
+  CanMessage frame = CanMessage();
+  frame.id = FLOOD_BATTERY_ID;
+  if (frameLane(frame) != LANE_LOW) return false;
+  frame.id = FLOOD_CONTROLLER_ID;
+  return frameLane(frame) == LANE_LOW;
+}
+
+int main(int argc, char **argv) {
+  uint32_t faults = argc > 1 ? (uint32_t)atoi(argv[1]) : 500;
+  uint32_t publishUs = argc > 2 ? (uint32_t)atoi(argv[2]) : 1000;
+  uint32_t p99LimitUs = argc > 3 ? (uint32_t)atoi(argv[3]) : 10 * publishUs;
+  uint32_t maxLimitUs = argc > 4 ? (uint32_t)atoi(argv[4]) : 50 * publishUs;
+
+  if (!telemetryRoutedLow()) {
+    printf("FALHA: 0x%X/0x%X são IDs de falha em config/constants.h, o teste não separa as lanes\n",
+           FLOOD_BATTERY_ID, FLOOD_CONTROLLER_ID);
+    return 1;
+  }
+
+  // Atraso do próprio sleep no PC, para ler os números abaixo
+  std::vector<uint32_t> sleepUs;
+  for (int i = 0; i < 500; i++) {
+    int64_t start = monoMicros();
+    std::this_thread::sleep_for(std::chrono::microseconds(publishUs));
+    sleepUs.push_back((uint32_t)(monoMicros() - start));
+  }
+  std::sort(sleepUs.begin(), sleepUs.end());
+
+  printf("%u falhas, telemetria %d/ms, publicação %u us, ciclo %d ms\n", faults,
+         FLOOD_PER_MS, publishUs, FLOOD_CYCLE_MS);
+  printf("sleep(%u us) no PC: p50 %u us, p99 %u us, máx %u us\n", publishUs,
+         percentile(sleepUs, 50), percentile(sleepUs, 99), sleepUs.back());
+  printf("fila         entregues     p50 us    p99 us    máx us  telem ok  telem perd\n");
+  FloodResult lanes = runFlood(faults, publishUs, false);
+  printRow("lanes", lanes);
+  FloodResult shared = runFlood(faults, publishUs, true);
+  printRow("fila única", shared);
+
+  bool ok = true;
+  if (lanes.latencyUs.size() != lanes.faultsSent || lanes.highDropped != 0) {
+    printf("FALHA: %ld falhas perdidas na lane de falhas (%u descartadas)\n",
+           (long)lanes.faultsSent - (long)lanes.latencyUs.size(), lanes.highDropped);
+    ok = false;
+  }
+  if (lanes.lowDropped == 0) {
+    printf("FALHA: a telemetria não saturou (nenhum descarte), teste sem carga\n");
+    ok = false;
+  }
+  if (percentile(lanes.latencyUs, 99) > p99LimitUs) {
+    printf("FALHA: p99 %u us > limite %u us\n", percentile(lanes.latencyUs, 99), p99LimitUs);
+    ok = false;
+  }
+  if (!lanes.latencyUs.empty() && lanes.latencyUs.back() > maxLimitUs) {
+    printf("FALHA: máximo %u us > limite %u us\n", lanes.latencyUs.back(), maxLimitUs);
+    ok = false;
+  }
+  if (!lanes.poolFull || !shared.poolFull) {
+    printf("FALHA: slots do pool não devolvidos\n");
+    ok = false;
+  }
+  if (ok) printf("OK (limites: p99 %u us, máx %u us)\n", p99LimitUs, maxLimitUs);
+  return ok ? 0 : 1;
+}
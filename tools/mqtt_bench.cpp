@@ -0,0 +1,408 @@
+// ------------------------------------------------------------------
+// Benchmark no PC do cliente MQTT não bloqueante (src/common/mqtt_lite.h)
+// ------------------------------------------------------------------
+// Publica N mensagens QoS1 do tamanho de um frame JSON e mede mensagens/s
+// para janelas em voo de 1 a 32. Por padrão usa um broker falso na mesma
+// aplicação (thread com socket TCP local) que atrasa cada PUBACK pelo RTT
+// simulado; com --broker usa um broker real (ex.: mosquitto local).
+//
+// --drop N faz o broker falso derrubar a conexão a cada N PUBLISH: o
+// cliente deve reconectar e retransmitir o que estava em voo, e o broker
+// confere que toda mensagem chegou ao menos uma vez e em ordem.
+//
+// O cliente também assina um tópico de configuração: a cada SUBSCRIBE o
+// broker falso responde com uma mensagem "retida", que deve chegar ao
+// handler uma vez por conexão (inclusive depois das quedas).
+//
+// Compilação (Linux):
+//   g++ -std=c++11 -O2 -pthread tools/mqtt_bench.cpp -o .build/mqtt_bench
+// Uso:
+//   .build/mqtt_bench [--count N] [--rtt-us U] [--drop N] [--broker host:porta]
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include "../src/common/mqtt_lite.h"
+
+#define BENCH_OUTBOX_BYTES 16384 // Igual a MQTT_OUTBOX_BYTES do firmware
+#define BENCH_PAYLOAD_BYTES 160  // Frame JSON típico do MqttJsonSink
+#define BENCH_CONFIG_TOPIC "moto/config/bench"
+#define BENCH_RETAINED "{\"ver\":2,\"tx\":100}"
+
+// ------------------------------------------------------------------
+// --- TRANSPORTE TCP NÃO BLOQUEANTE (POSIX) ---
+// ------------------------------------------------------------------
+
+class PosixTransport {
+public:
+  bool connect(const char *host, uint16_t port) {
+    stop();
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *result = NULL;
+    if (getaddrinfo(host, service, &hints, &result) != 0) return false;
+
+    fd_ = socket(result->ai_family, result->ai_socktype, 0);
+    bool ok = fd_ >= 0 && ::connect(fd_, result->ai_addr, result->ai_addrlen) == 0;
+    freeaddrinfo(result);
+    if (!ok) {
+      stop();
+      return false;
+    }
+    int one = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+    return true;
+  }
+
+  bool connected() { return fd_ >= 0; }
+
+  int write(const uint8_t *data, size_t len) {
+    ssize_t n = send(fd_, data, len, MSG_NOSIGNAL);
+    if (n >= 0) return (int)n;
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+  }
+
+  int read(uint8_t *data, size_t len) {
+    if (len == 0) return 0;
+    ssize_t n = recv(fd_, data, len, 0);
+    if (n > 0) return (int)n;
+    if (n == 0) return -1; // Fechado pelo broker
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+  }
+
+  void stop() {
+    if (fd_ >= 0) close(fd_);
+    fd_ = -1;
+  }
+
+private:
+  int fd_ = -1;
+};
+
+typedef MqttLite<PosixTransport, BENCH_OUTBOX_BYTES> BenchClient;
+
+// ------------------------------------------------------------------
+// --- BROKER FALSO (RTT SIMULADO, QUEDAS FORÇADAS) ---
+// ------------------------------------------------------------------
+
+static int64_t nowUs() { return monoMicros(); }
+
+class FakeBroker {
+public:
+  FakeBroker(uint32_t rttUs, uint32_t dropEvery, uint32_t expected)
+      : rttUs_(rttUs), dropEvery_(dropEvery), seen_(expected, false) {}
+
+  uint16_t start() {
+    listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    bind(listenFd_, (sockaddr *)&addr, sizeof(addr));
+    listen(listenFd_, 1);
+    socklen_t len = sizeof(addr);
+    getsockname(listenFd_, (sockaddr *)&addr, &len);
+    thread_ = std::thread(&FakeBroker::run, this);
+    return ntohs(addr.sin_port);
+  }
+
+  void stop() {
+    running_ = false;
+    thread_.join();
+    close(listenFd_);
+  }
+
+  uint32_t unique() const { return unique_; }
+  uint32_t duplicates() const { return duplicates_; }
+  uint32_t outOfOrder() const { return outOfOrder_; }
+  uint32_t drops() const { return drops_; }
+  uint32_t subscribes() const { return subscribes_; }
+
+private:
+  struct PendingAck {
+    int64_t dueUs;
+    uint16_t packetId;
+  };
+
+  void run() {
+    while (running_) {
+      int timeout = acks_.empty() ? 5 : 0;
+      pollfd fds[2] = {{listenFd_, POLLIN, 0}, {clientFd_, POLLIN, 0}};
+      poll(fds, clientFd_ >= 0 ? 2 : 1, timeout);
+
+      if (fds[0].revents & POLLIN) {
+        closeClient();
+        clientFd_ = accept(listenFd_, NULL, NULL);
+        int one = 1;
+        setsockopt(clientFd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        rxLen_ = 0;
+      }
+      if (clientFd_ >= 0 && (fds[1].revents & (POLLIN | POLLHUP))) {
+        ssize_t n = recv(clientFd_, rx_ + rxLen_, sizeof(rx_) - rxLen_, 0);
+        if (n <= 0) closeClient();
+        else {
+          rxLen_ += n;
+          parse();
+        }
+      }
+      sendDueAcks();
+    }
+    closeClient();
+  }
+
+  void parse() {
+    for (;;) {
+      size_t remaining = 0, shift = 0, i = 1;
+      for (; i < rxLen_ && i < 5; i++) {
+        remaining |= (size_t)(rx_[i] & 0x7F) << shift;
+        shift += 7;
+        if ((rx_[i] & 0x80) == 0) break;
+      }
+      if (i >= rxLen_) return;
+      size_t total = i + 1 + remaining;
+      if (rxLen_ < total) return;
+      handle(rx_[0], rx_ + i + 1, remaining);
+      if (clientFd_ < 0) return;
+      memmove(rx_, rx_ + total, rxLen_ - total);
+      rxLen_ -= total;
+    }
+  }
+
+  void handle(uint8_t type, const uint8_t *body, size_t length) {
+    switch (type & 0xF0) {
+      case 0x10: { // CONNECT
+        const uint8_t connack[4] = {0x20, 0x02, 0x00, 0x00};
+        reply(connack, sizeof(connack));
+        break;
+      }
+      case 0x30: { // PUBLISH: tópico, id, payload "seq=<n>;..."
+        size_t topicLen = (body[0] << 8) | body[1];
+        uint16_t packetId = (body[2 + topicLen] << 8) | body[3 + topicLen];
+        record(body + 4 + topicLen, length - 4 - topicLen);
+        if (dropEvery_ > 0 && ++sinceDrop_ >= dropEvery_) {
+          sinceDrop_ = 0;
+          drops_++;
+          closeClient(); // Cai antes do PUBACK: o cliente deve retransmitir
+          return;
+        }
+        PendingAck ack = {nowUs() + rttUs_, packetId};
+        acks_.push_back(ack);
+        break;
+      }
+      case 0x80: { // SUBSCRIBE: SUBACK e a mensagem retida do tópico (QoS0)
+        size_t topicLen = (body[2] << 8) | body[3];
+        const uint8_t suback[5] = {0x90, 0x03, body[0], body[1], 0x00};
+        reply(suback, sizeof(suback));
+        uint8_t publish[128];
+        size_t payloadLen = strlen(BENCH_RETAINED);
+        publish[0] = 0x31; // PUBLISH QoS0 retido
+        publish[1] = (uint8_t)(2 + topicLen + payloadLen);
+        memcpy(publish + 2, body + 2, 2 + topicLen);
+        memcpy(publish + 4 + topicLen, BENCH_RETAINED, payloadLen);
+        reply(publish, 4 + topicLen + payloadLen);
+        subscribes_++;
+        break;
+      }
+      case 0xC0: { // PINGREQ
+        const uint8_t pingresp[2] = {0xD0, 0x00};
+        reply(pingresp, sizeof(pingresp));
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  void record(const uint8_t *payload, size_t length) {
+    unsigned long seq = strtoul((const char *)payload + 4, NULL, 10);
+    (void)length;
+    if (seq >= seen_.size()) return;
+    if (seen_[seq]) {
+      duplicates_++;
+      return;
+    }
+    if (seq != nextExpected_) outOfOrder_++;
+    seen_[seq] = true;
+    unique_++;
+    nextExpected_ = seq + 1;
+  }
+
+  void sendDueAcks() {
+    int64_t now = nowUs();
+    while (!acks_.empty() && acks_.front().dueUs <= now) {
+      uint8_t puback[4] = {0x40, 0x02, (uint8_t)(acks_.front().packetId >> 8),
+                           (uint8_t)(acks_.front().packetId & 0xFF)};
+      reply(puback, sizeof(puback));
+      acks_.pop_front();
+    }
+  }
+
+  void reply(const uint8_t *data, size_t len) {
+    if (clientFd_ >= 0) send(clientFd_, data, len, MSG_NOSIGNAL);
+  }
+
+  void closeClient() {
+    if (clientFd_ >= 0) close(clientFd_);
+    clientFd_ = -1;
+    rxLen_ = 0;
+    acks_.clear(); // PUBACKs da conexão perdida nunca chegam
+  }
+
+  uint32_t rttUs_;
+  uint32_t dropEvery_;
+  uint32_t sinceDrop_ = 0;
+  std::atomic<bool> running_{true};
+  std::thread thread_;
+  int listenFd_ = -1;
+  int clientFd_ = -1;
+  uint8_t rx_[65536];
+  size_t rxLen_ = 0;
+  std::deque<PendingAck> acks_;
+  std::vector<bool> seen_;
+  uint32_t nextExpected_ = 0;
+  uint32_t unique_ = 0;
+  uint32_t duplicates_ = 0;
+  uint32_t outOfOrder_ = 0;
+  uint32_t drops_ = 0;
+  uint32_t subscribes_ = 0;
+};
+
+// ------------------------------------------------------------------
+// --- MEDIÇÃO ---
+// ------------------------------------------------------------------
+
+/**
+ * @brief Handler da assinatura: conta as mensagens retidas recebidas
+ */
+static void onConfig(void *context, const char *topic, size_t topicLength,
+                     const uint8_t *payload, size_t length) {
+  bool match = topicLength == strlen(BENCH_CONFIG_TOPIC) &&
+               memcmp(topic, BENCH_CONFIG_TOPIC, topicLength) == 0 &&
+               length == strlen(BENCH_RETAINED) && memcmp(payload, BENCH_RETAINED, length) == 0;
+  if (match) (*static_cast<uint32_t *>(context))++;
+}
+
+/**
+ * @brief Publica count mensagens QoS1 e espera todos os PUBACK
+ * @param configs Mensagens recebidas na assinatura
+ * @return mensagens/s confirmadas (0 se não terminou no prazo)
+ */
+static double runWindow(const char *host, uint16_t port, uint8_t window, uint32_t count,
+                        MqttLiteStats &stats, uint32_t &configs) {
+  static BenchClient client;
+  client = BenchClient();
+  client.setServer(host, port);
+  client.setClientId("voltz-bench");
+  client.setWindow(window);
+  client.setReconnectInterval(10);
+  configs = 0;
+  client.setSubscription(BENCH_CONFIG_TOPIC, &onConfig, &configs);
+
+  char payload[BENCH_PAYLOAD_BYTES + 1];
+  memset(payload, 'x', BENCH_PAYLOAD_BYTES);
+  payload[BENCH_PAYLOAD_BYTES] = '\0';
+
+  uint32_t sent = 0;
+  int64_t start = nowUs();
+  int64_t deadline = start + 60 * 1000000LL;
+  while (client.stats().acked < count && nowUs() < deadline) {
+    while (sent < count) {
+      int n = snprintf(payload, sizeof(payload), "seq=%lu;", (unsigned long)sent);
+      payload[n] = 'x';
+      if (!client.publish("moto/telemetria", (const uint8_t *)payload, BENCH_PAYLOAD_BYTES, 1)) break;
+      sent++;
+    }
+    uint32_t before = client.stats().acked;
+    client.loop();
+    if (client.stats().acked == before) std::this_thread::sleep_for(std::chrono::microseconds(20));
+  }
+  double seconds = (nowUs() - start) / 1e6;
+  int64_t settle = nowUs() + 20000; // Retida da última conexão ainda em trânsito
+  while (nowUs() < settle) client.loop();
+  client.disconnect();
+  stats = client.stats();
+  return stats.acked >= count ? count / seconds : 0;
+}
+
+int main(int argc, char **argv) {
+  uint32_t count = 5000;
+  uint32_t rttUs = 2000;
+  uint32_t dropEvery = 0;
+  const char *brokerArg = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) count = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--rtt-us") == 0 && i + 1 < argc) rttUs = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--drop") == 0 && i + 1 < argc) dropEvery = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--broker") == 0 && i + 1 < argc) brokerArg = argv[++i];
+  }
+
+  char host[64] = "127.0.0.1";
+  uint16_t port = 0;
+  if (brokerArg != NULL) {
+    const char *colon = strrchr(brokerArg, ':');
+    size_t hostLen = colon ? (size_t)(colon - brokerArg) : strlen(brokerArg);
+    if (hostLen >= sizeof(host)) return 1;
+    memcpy(host, brokerArg, hostLen);
+    host[hostLen] = '\0';
+    port = colon ? (uint16_t)atoi(colon + 1) : 1883;
+    printf("broker: %s:%u | mensagens: %lu\n", host, port, (unsigned long)count);
+  } else {
+    printf("broker falso | RTT %lu us | mensagens: %lu | queda a cada %lu PUBLISH\n",
+           (unsigned long)rttUs, (unsigned long)count, (unsigned long)dropEvery);
+  }
+
+  printf("%7s %12s %10s %12s %10s %10s %8s\n", "janela", "msg/s", "reconex.", "retransm.",
+         "duplic.", "fora ord.", "config");
+  bool ok = true;
+  static const uint8_t windows[] = {1, 2, 4, 8, 16, 32};
+  for (size_t w = 0; w < sizeof(windows); w++) {
+    FakeBroker *broker = NULL;
+    uint16_t target = port;
+    if (brokerArg == NULL) {
+      broker = new FakeBroker(rttUs, dropEvery, count);
+      target = broker->start();
+    }
+
+    MqttLiteStats stats;
+    uint32_t configs = 0;
+    double rate = runWindow(host, target, windows[w], count, stats, configs);
+
+    uint32_t duplicates = 0, outOfOrder = 0;
+    if (broker != NULL) {
+      broker->stop();
+      duplicates = broker->duplicates();
+      outOfOrder = broker->outOfOrder();
+      if (broker->unique() != count) ok = false;
+      if (configs != broker->subscribes() || configs != stats.reconnects) ok = false;
+      delete broker;
+    }
+    if (rate == 0) ok = false;
+    printf("%7u %12.0f %10lu %12lu %10lu %10lu %8lu\n", windows[w], rate,
+           (unsigned long)stats.reconnects, (unsigned long)stats.retransmitted,
+           (unsigned long)duplicates, (unsigned long)outOfOrder, (unsigned long)configs);
+  }
+  return ok ? 0 : 2;
+}
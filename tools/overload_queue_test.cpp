@@ -0,0 +1,223 @@
+// ------------------------------------------------------------------
+// Teste no PC da contabilidade da fila de sobrecarga (overload_queue.h)
+// ------------------------------------------------------------------
+// Para cada política, um produtor e um consumidor em threads, como a
+// decodificação e a task de envio do firmware. O produtor manda rajadas
+// de tamanho variado, a maioria maior que a fila, cedendo a CPU a cada
+// poucos frames, e o consumidor para de vez em quando (publicação
+// presa): a fila enche, entra em excesso e volta milhares de vezes. O
+// consumidor roda em SCHED_IDLE, como a task de envio abaixo da captura:
+// o produtor o interrompe em qualquer ponto de pop() ao acordar, também
+// numa máquina de um núcleo. São 80 IDs, mais que os
+// OVERLOAD_LATEST_SLOTS; o spill fica em memória e recusa a escrita
+// acima de SPILL_TEST_CAPACITY frames.
+//
+// Confere, terminando com código 1 se algo falhar:
+//   - accepted = entregues + droppedNewest + droppedOldest + superseded
+//                + spillLost (todo frame entregue ou perdido uma vez)
+//   - nenhum frame entregue duas vezes ou com o conteúdo trocado
+//   - ordem de chegada em DROP_NEWEST, DROP_OLDEST e SPILL, inclusive
+//     na volta do spill (a fila esvazia antes do excesso: pega a corrida
+//     do consumidor em pop() que lia o excesso com frames mais antigos
+//     ainda na fila); em LATEST_PER_ID, ordem dentro de cada ID
+//   - o caminho de perda da política foi exercitado
+//   - todos os slots do pool voltaram no fim
+//
+// Compilação:
+//   g++ -std=c++11 -O2 -pthread tools/overload_queue_test.cpp -o .build/overload_queue_test
+// Uso:
+//   .build/overload_queue_test [frames por política]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+
+#include "../src/common/frame_pool.h"
+#include "../src/common/overload_queue.h"
+
+#define TEST_POOL_SIZE 256
+#define TEST_QUEUE_CAPACITY 64
+#define TEST_IDS 80
+#define TEST_BURST_MIN 50 // Rajadas de 50 a 200 frames (a fila tem 64)
+#define TEST_BURST_MAX 200
+#define TEST_YIELD_EVERY 8
+#define SPILL_TEST_CAPACITY 200
+
+/**
+ * @brief Spill em memória com capacidade (escrita falha quando cheio)
+ */
+class BoundedSpill : public FrameSpill {
+public:
+  bool write(const CanMessage &frame) {
+    if (frames_.size() >= SPILL_TEST_CAPACITY) return false;
+    frames_.push_back(frame);
+    return true;
+  }
+  bool read(CanMessage &frame) {
+    if (frames_.empty()) return false;
+    frame = frames_.front();
+    frames_.pop_front();
+    return true;
+  }
+  bool empty() { return frames_.empty(); }
+
+private:
+  std::deque<CanMessage> frames_;
+};
+
+static void fillFrame(CanMessage &frame, uint32_t seq) {
+  frame = CanMessage();
+  frame.id = 0x100 + seq % TEST_IDS;
+  frame.length = 8;
+  frame.timestampUs = seq;
+  for (int i = 0; i < 8; i++) frame.data[i] = (uint8_t)(seq >> (i % 4 * 8)) ^ (uint8_t)i;
+}
+
+static bool frameValid(const CanMessage &frame) {
+  CanMessage expected;
+  fillFrame(expected, frame.timestampUs);
+  return frame.id == expected.id && frame.length == 8 &&
+         memcmp(frame.data, expected.data, 8) == 0;
+}
+
+static uint32_t nextRandom(uint32_t &state) {
+  state = state * 1664525U + 1013904223U;
+  return state >> 8;
+}
+
+static void spin(int iterations) {
+  for (volatile int i = 0; i < iterations; i++) {
+  }
+}
+
+/**
+ * @brief Uma política; imprime a linha do resultado
+ * @return número de violações
+ */
+static uint32_t testPolicy(OverloadPolicy policy, uint32_t frames) {
+  static StaticFramePool<TEST_POOL_SIZE> pool;
+  BoundedSpill spill;
+  OverloadQueue queue;
+  queue.begin(pool, TEST_QUEUE_CAPACITY, policy, &spill);
+
+  std::atomic<bool> producing(true);
+  uint32_t exhausted = 0;
+
+  std::thread producer([&] {
+    uint32_t random = 1;
+    uint32_t burstLeft = TEST_BURST_MIN;
+    for (uint32_t seq = 0; seq < frames; seq++) {
+      FrameHandle handle = pool.acquire();
+      if (handle == FRAME_NONE) {
+        exhausted++;
+        continue;
+      }
+      fillFrame(pool.frame(handle), seq);
+      queue.push(handle);
+      if (--burstLeft == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        burstLeft = TEST_BURST_MIN + nextRandom(random) % (TEST_BURST_MAX - TEST_BURST_MIN);
+      } else if (seq % TEST_YIELD_EVERY == 0) {
+        std::this_thread::yield();
+      }
+    }
+    producing = false;
+  });
+
+  sched_param priority = {};
+  pthread_setschedparam(pthread_self(), SCHED_IDLE, &priority);
+
+  std::vector<uint8_t> seen(frames, 0);
+  std::vector<int64_t> lastPerId(TEST_IDS, -1);
+  int64_t last = -1;
+  uint32_t delivered = 0;
+  uint32_t duplicates = 0;
+  uint32_t corrupt = 0;
+  uint32_t outOfOrder = 0;
+  uint32_t random = 7;
+  uint32_t stallIn = 1;
+  bool fifo = policy != OVERLOAD_LATEST_PER_ID;
+
+  FrameHandle handle;
+  for (;;) {
+    bool finished = !producing.load();
+    if (!queue.pop(handle)) {
+      if (finished && !queue.overflowing() && queue.size() == 0) break;
+      std::this_thread::yield();
+      continue;
+    }
+    const CanMessage &frame = pool.frame(handle);
+    uint32_t seq = frame.timestampUs;
+    if (seq >= frames || !frameValid(frame)) {
+      corrupt++;
+    } else {
+      if (seen[seq]++) duplicates++;
+      int64_t &previous = fifo ? last : lastPerId[seq % TEST_IDS];
+      if ((int64_t)seq <= previous) outOfOrder++;
+      previous = seq;
+    }
+    pool.release(handle);
+    delivered++;
+    spin(200); // Publicação mais lenta que a decodificação
+    if (--stallIn == 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(300));
+      stallIn = 1 + nextRandom(random) % 300;
+    }
+  }
+  producer.join();
+  pthread_setschedparam(pthread_self(), SCHED_OTHER, &priority);
+
+  const OverloadStats &s = queue.stats();
+  uint32_t accounted = delivered + s.droppedNewest + s.droppedOldest + s.superseded + s.spillLost;
+  uint32_t exercised = 0;
+  switch (policy) {
+    case OVERLOAD_DROP_NEWEST: exercised = s.droppedNewest; break;
+    case OVERLOAD_DROP_OLDEST: exercised = s.droppedOldest; break;
+    case OVERLOAD_LATEST_PER_ID: exercised = s.superseded; break;
+    case OVERLOAD_SPILL: exercised = s.spilled > 0 && s.spillLost > 0; break;
+  }
+  bool poolFull = pool.available() == pool.capacity();
+
+  printf("%-14s %8u %8u %7u %7u %7u %7u %7u %6u %6u %6u %s\n", overloadPolicyName(policy),
+         s.accepted, delivered, s.droppedNewest, s.droppedOldest, s.superseded, s.spilled,
+         s.spillLost, duplicates + corrupt, outOfOrder, exhausted,
+         s.accepted == accounted ? "ok" : "DIVERGE");
+
+  uint32_t violations = duplicates + corrupt + outOfOrder;
+  if (s.accepted != accounted) {
+    printf("  FALHA: accepted %u != contabilizados %u\n", s.accepted, accounted);
+    violations++;
+  }
+  if (exercised == 0) {
+    printf("  FALHA: caminho de perda/excesso de %s não exercitado\n", overloadPolicyName(policy));
+    violations++;
+  }
+  if (!poolFull) {
+    printf("  FALHA: slots do pool não devolvidos\n");
+    violations++;
+  }
+  return violations;
+}
+
+int main(int argc, char **argv) {
+  uint32_t frames = argc > 1 ? (uint32_t)atoi(argv[1]) : 200000;
+  const OverloadPolicy policies[] = {OVERLOAD_DROP_NEWEST, OVERLOAD_DROP_OLDEST,
+                                     OVERLOAD_LATEST_PER_ID, OVERLOAD_SPILL};
+
+  printf("%u frames por política, fila %d, %d IDs, spill %d\n", frames, TEST_QUEUE_CAPACITY,
+         TEST_IDS, SPILL_TEST_CAPACITY);
+  printf("política       accepted entregue newest  oldest  superse spilled splLost  erros  ordem esgot  conta\n");
+  uint32_t violations = 0;
+  for (OverloadPolicy policy : policies) violations += testPolicy(policy, frames);
+
+  printf(violations == 0 ? "OK\n" : "FALHA: %u violações\n", violations);
+  return violations == 0 ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+// ------------------------------------------------------------------
+// Benchmark no PC dos estágios do pipeline (src/common/pipeline.h)
+// ------------------------------------------------------------------
+// Roda os mesmos três estágios do firmware (captura → decodificação →
+// serialização) primeiro isolados, para medir o custo de cada um, e
+// depois em threads ligadas por SpscRing, como as tasks do ESP32.
+// O estágio mais caro limita a vazão do pipeline em threads.
+//
+// A fonte é o simulador do TESTMODE sem ritmo de tempo real e o sink
+// serializa o JSON do MqttJsonSink (o envio pela rede não é medido).
+//
+// Compilação (precisa de config/constants.h):
+//   g++ -std=c++11 -O2 -pthread tools/pipeline_bench.cpp -o .build/pipeline_bench
+// Uso:
+//   .build/pipeline_bench [frames] [--pin]
+//   --pin  fixa cada thread em um núcleo (Linux), como xTaskCreatePinnedToCore
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+#include "../src/common/json_writer.h"
+#include "../src/common/pipeline.h"
+#include "../src/common/spsc_ring.h"
+#include "../src/common/time_base.h"
+#include "../src/common/vehicle_sim.h"
+
+#define BENCH_RING_SIZE 256 // Igual a CAPTURE_RING_SIZE do firmware
+
+// ------------------------------------------------------------------
+// --- ESTÁGIOS DO HOST ---
+// ------------------------------------------------------------------
+
+/**
+ * @brief Simulador sem ritmo: gera frames o mais rápido possível
+ */
+class BenchSource {
+public:
+  bool begin() {
+    sim_.setBusLoad(100);
+    return true;
+  }
+
+  bool read(CanMessage &frame) {
+    SimFrame simFrame;
+    sim_.nextFrame(simFrame);
+    frame.id = simFrame.id;
+    frame.length = simFrame.length;
+    frame.isExtended = simFrame.isExtended;
+    memcpy(frame.data, simFrame.data, sizeof(frame.data));
+    frame.timestampUs = TimeBase::stamp();
+    return true;
+  }
+
+private:
+  VehicleSim sim_;
+};
+
+/**
+ * @brief Serializa cada frame no mesmo JSON publicado pelo MqttJsonSink
+ */
+class JsonBenchSink {
+public:
+  bool begin() { return true; }
+  void poll() {}
+  void flush() {}
+  void report(const LaneStatus &) {}
+  void writeTrip(const TripSummary &) {}
+  void writeWindow(const WindowRecord &) {}
+  void writeAlarm(const RuleEvent &) {}
+  void feedback(LinkFeedback &) {}
+  bool receiveConfig(ConfigUpdate &) { return false; }
+
+  void write(const CanMessage &frame, const VehicleState &state) {
+    JsonWriter json(buffer_, sizeof(buffer_));
+    json.raw("{\"canId\":").u32(frame.id)
+        .raw(",\"ide\":").boolean(frame.isExtended)
+        .raw(",\"dlc\":").u32(frame.length)
+        .raw(",\"data\":").hex(frame.data, frame.length)
+        .raw(",\"dt\":").i32((int32_t)frame.timestampUs)
+        .raw(",\"as\":").u32(0)
+        .raw(",\"soc\":").i32(state.battery.soc)
+        .raw("}");
+    int n = json.finish();
+    if (n > 0) bytes_ += (uint64_t)n;
+    frames_++;
+  }
+
+  void writeUrgent(const CanMessage &frame, const VehicleState &state) {
+    write(frame, state);
+  }
+
+  uint64_t bytes() const { return bytes_; }
+  uint64_t frames() const { return frames_; }
+
+private:
+  char buffer_[256];
+  uint64_t bytes_ = 0;
+  uint64_t frames_ = 0;
+};
+
+typedef Pipeline<BenchSource, PassFilter, StateDecoder, JsonBenchSink> BenchPipe;
+
+// ------------------------------------------------------------------
+// --- MEDIÇÃO ---
+// ------------------------------------------------------------------
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void pinToCore(std::thread &thread, unsigned core) {
+#ifdef __linux__
+  unsigned cores = std::thread::hardware_concurrency();
+  if (cores == 0) return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core % cores, &set);
+  pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#endif
+}
+
+/**
+ * @brief Custo de cada estágio rodando sozinho (ns/frame)
+ */
+static void measureStages(uint32_t frames, double nsPerFrame[3]) {
+  BenchPipe pipe;
+  pipe.begin();
+  std::vector<CanMessage> batch(frames);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < frames; i++) pipe.capture(batch[i]);
+  nsPerFrame[0] = secondsSince(start) * 1e9 / frames;
+
+  start = std::chrono::steady_clock::now();
+  uint32_t accepted = 0;
+  for (uint32_t i = 0; i < frames; i++) {
+    if (pipe.prepare(batch[i])) batch[accepted++] = batch[i];
+  }
+  nsPerFrame[1] = secondsSince(start) * 1e9 / frames;
+
+  start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < accepted; i++) pipe.process(batch[i]);
+  nsPerFrame[2] = secondsSince(start) * 1e9 / frames;
+}
+
+/**
+ * @brief Os três estágios em sequência na mesma thread (frames/s)
+ */
+static double runSequential(uint32_t frames) {
+  BenchPipe pipe;
+  pipe.begin();
+  CanMessage frame;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < frames; i++) {
+    pipe.capture(frame);
+    if (pipe.prepare(frame)) pipe.process(frame);
+  }
+  return frames / secondsSince(start);
+}
+
+/**
+ * @brief Um estágio por thread, ligados por SpscRing (frames/s)
+ */
+static double runThreaded(uint32_t frames, bool pin, uint32_t &delivered) {
+  static BenchPipe pipe;
+  static SpscRing<CanMessage, BENCH_RING_SIZE> captureRing;
+  static SpscRing<CanMessage, BENCH_RING_SIZE> sendRing;
+  std::atomic<bool> captureDone(false);
+  std::atomic<bool> decodeDone(false);
+  pipe.begin();
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  std::thread capture([&] {
+    CanMessage frame;
+    for (uint32_t i = 0; i < frames; i++) {
+      pipe.capture(frame);
+      while (!captureRing.push(frame)) std::this_thread::yield();
+    }
+    captureDone = true;
+  });
+
+  std::thread decode([&] {
+    CanMessage frame;
+    for (;;) {
+      if (!captureRing.pop(frame)) {
+        if (captureDone && captureRing.empty()) break;
+        std::this_thread::yield();
+        continue;
+      }
+      if (!pipe.prepare(frame)) continue;
+      while (!sendRing.push(frame)) std::this_thread::yield();
+    }
+    decodeDone = true;
+  });
+
+  std::thread send([&] {
+    CanMessage frame;
+    for (;;) {
+      if (!sendRing.pop(frame)) {
+        if (decodeDone && sendRing.empty()) break;
+        std::this_thread::yield();
+        continue;
+      }
+      pipe.process(frame);
+    }
+  });
+
+  if (pin) {
+    pinToCore(capture, 0);
+    pinToCore(decode, 1);
+    pinToCore(send, 2);
+  }
+  capture.join();
+  decode.join();
+  send.join();
+
+  delivered = (uint32_t)pipe.sinks().head().frames();
+  return frames / secondsSince(start);
+}
+
+int main(int argc, char **argv) {
+  uint32_t frames = 2000000;
+  bool pin = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--pin") == 0) pin = true;
+    else frames = (uint32_t)strtoul(argv[i], NULL, 10);
+  }
+  if (frames == 0) return 1;
+
+  static const char *const names[3] = {"captura", "decodificação", "serialização"};
+  double ns[3];
+  measureStages(frames, ns);
+
+  printf("núcleos: %u | frames: %lu | afinidade: %s\n",
+         std::thread::hardware_concurrency(), (unsigned long)frames, pin ? "sim" : "não");
+  printf("%-16s %10s %14s\n", "estágio", "ns/frame", "limite (f/s)");
+  uint8_t slowest = 0;
+  for (uint8_t s = 0; s < 3; s++) {
+    printf("%-16s %10.1f %14.0f\n", names[s], ns[s], 1e9 / ns[s]);
+    if (ns[s] > ns[slowest]) slowest = s;
+  }
+
+  double sequential = runSequential(frames);
+  uint32_t delivered = 0;
+  double threaded = runThreaded(frames, pin, delivered);
+
+  printf("\nsequencial (1 thread) : %12.0f frames/s\n", sequential);
+  printf("pipeline (3 threads)  : %12.0f frames/s  (%.2fx, %lu entregues)\n",
+         threaded, threaded / sequential, (unsigned long)delivered);
+  printf("gargalo: %s (teto de %.0f frames/s)\n", names[slowest], 1e9 / ns[slowest]);
+  return delivered == frames ? 0 : 2;
+}
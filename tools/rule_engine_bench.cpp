@@ -0,0 +1,467 @@
+// ------------------------------------------------------------------
+// Benchmark e validação no PC das regras de alarme (src/common/rule_engine.h)
+// ------------------------------------------------------------------
+// 1. Compilador: textos válidos e inválidos (linha do erro), operadores
+//    inclusivos, decimais em v/a/tq.
+// 2. Semântica: conjuntos aleatórios de regras (limiares sorteados na
+//    faixa real de cada sinal) avaliados pelo RuleEngine e por um
+//    interpretador ingênuo, que testa o operador original de cada regra
+//    em todo frame; os eventos precisam ser idênticos, na mesma ordem.
+// 3. Custo por frame (applyFrame + regras) com 0 a 1024 regras, contra o
+//    interpretador ingênuo, que percorre todas as regras em todo frame.
+// 4. Troca: uma thread recompila e publica programas enquanto a principal
+//    avalia, alternando os dois programas como o firmware.
+// Frames: a captura _can_log.csv e 20 min do simulador.
+// Termina com código 2 se algo divergir.
+//
+// IDs da bateria e do controlador: os da captura (capture_ids.h), não os
+// de config/constants.h.
+//
+// Compilação:
+//   g++ -std=c++11 -O2 -Wall -pthread tools/rule_engine_bench.cpp -o .build/rule_engine_bench
+// Uso:
+//   .build/rule_engine_bench ["src/esp32/_can_log (2).csv"]
+
+#include "../src/common/capture_ids.h" // Antes de tudo: fixa os IDs
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/common/can_message.h"
+#include "../src/common/capture_replay.h"
+#include "../src/common/rule_engine.h"
+#include "../src/common/vehicle_sim.h"
+
+#define BENCH_CAPACITY 1024
+#define SESSION_GAP_US 10000000U   // Pausa entre as sessões da captura
+#define SIM_RIDE_US (20U * 60 * 1000000)
+
+typedef RuleProgram<BENCH_CAPACITY> Program;
+typedef RuleEngine<BENCH_CAPACITY> Engine;
+
+static void simulateRide(std::vector<CanMessage> &frames) {
+  SimConfig config;
+  config.busLoadPercent = 0;
+  VehicleSim sim(config);
+  sim.setBusLoad(0);
+  uint32_t startUs = frames.empty() ? 0 : frames.back().timestampUs + SESSION_GAP_US;
+  SimFrame simFrame;
+  do {
+    sim.nextFrame(simFrame);
+    CanMessage frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.timestampUs = startUs + (uint32_t)simFrame.timeUs;
+    frame.id = simFrame.id;
+    frame.length = simFrame.length;
+    frame.isExtended = simFrame.isExtended;
+    memcpy(frame.data, simFrame.data, sizeof(frame.data));
+    frames.push_back(frame);
+  } while (simFrame.timeUs < SIM_RIDE_US);
+}
+
+static int32_t signalValue(const VehicleState &state, uint8_t signal) {
+  switch (signal) {
+    case WINDOW_VOLTAGE: return state.battery.voltageDeci;
+    case WINDOW_CURRENT: return state.battery.currentDeci;
+    case WINDOW_SOC: return state.battery.soc;
+    case WINDOW_BATTERY_TEMP: return state.battery.temperature;
+    case WINDOW_RPM: return state.motor.rpm;
+    case WINDOW_TORQUE: return state.motor.torqueDeci;
+    case WINDOW_MOTOR_TEMP: return state.motor.motorTemp;
+    default: return state.motor.controllerTemp;
+  }
+}
+
+// ------------------------------------------------------------------
+// --- INTERPRETADOR INGÊNUO (REFERÊNCIA) ---
+// ------------------------------------------------------------------
+
+struct PlainRule {
+  uint16_t id;
+  uint8_t signal;
+  char op[3];          // ">", ">=", "<", "<="
+  int32_t threshold;   // Unidades de VehicleState
+  int32_t hysteresis;
+  uint32_t holdMs;
+  // Estado
+  bool pending, active;
+  uint32_t sinceUs;
+};
+
+class PlainEngine {
+public:
+  explicit PlainEngine(const std::vector<PlainRule> &rules) : rules_(rules) {}
+
+  void evaluate(const VehicleState &state, bool battery, uint32_t nowUs,
+                std::vector<RuleEvent> &out) {
+    for (size_t i = 0; i < rules_.size(); i++) {
+      PlainRule &r = rules_[i];
+      if ((r.signal <= WINDOW_BATTERY_TEMP) != battery) continue;
+      int32_t v = signalValue(state, r.signal);
+      bool above = r.op[0] == '>';
+      bool condition;
+      if (strcmp(r.op, ">") == 0) condition = v > r.threshold;
+      else if (strcmp(r.op, ">=") == 0) condition = v >= r.threshold;
+      else if (strcmp(r.op, "<") == 0) condition = v < r.threshold;
+      else condition = v <= r.threshold;
+      if (r.active) {
+        bool clear = above ? v < r.threshold - r.hysteresis : v > r.threshold + r.hysteresis;
+        if (clear) {
+          r.active = false;
+          out.push_back(event(r, v, nowUs, false));
+        }
+      } else if (condition) {
+        if (!r.pending) {
+          r.pending = true;
+          r.sinceUs = nowUs;
+        }
+        if (nowUs - r.sinceUs >= r.holdMs * 1000U) {
+          r.pending = false;
+          r.active = true;
+          out.push_back(event(r, v, nowUs, true));
+        }
+      } else {
+        r.pending = false;
+      }
+    }
+  }
+
+private:
+  static RuleEvent event(const PlainRule &r, int32_t v, uint32_t nowUs, bool active) {
+    RuleEvent e;
+    e.timestampUs = nowUs;
+    e.ruleId = r.id;
+    e.signal = r.signal;
+    e.active = active;
+    e.value = v;
+    e.threshold = r.threshold;
+    return e;
+  }
+
+  std::vector<PlainRule> rules_;
+};
+
+// ------------------------------------------------------------------
+// --- REGRAS ALEATÓRIAS ---
+// ------------------------------------------------------------------
+
+struct Range {
+  int32_t min, max;
+};
+
+static uint32_t rngState = 12345;
+static uint32_t nextRandom() {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+/** @brief Unidades de VehicleState → texto da regra (uma casa em v/a/tq) */
+static void formatValue(char *out, size_t size, uint8_t signal, int32_t value) {
+  if (ruleSignalIsDeci(signal)) {
+    snprintf(out, size, "%s%ld.%ld", value < 0 ? "-" : "", (long)(labs(value) / 10),
+             (long)(labs(value) % 10));
+  } else {
+    snprintf(out, size, "%ld", (long)value);
+  }
+}
+
+/**
+ * @brief Sorteia count regras e devolve o texto delas
+ * @details rules volta ordenado por sinal (estável), a ordem de avaliação
+ *          da tabela compilada
+ */
+static std::string randomRules(size_t count, const Range *ranges, std::vector<PlainRule> &rules) {
+  static const char *const OPS[] = {">", ">=", "<", "<="};
+  std::string text = "# regras sorteadas\n";
+  rules.clear();
+  for (size_t i = 0; i < count; i++) {
+    PlainRule r;
+    memset(&r, 0, sizeof(r));
+    r.id = (uint16_t)(i + 1);
+    r.signal = (uint8_t)(nextRandom() % WINDOW_SIGNAL_COUNT);
+    strcpy(r.op, OPS[nextRandom() % 4]);
+    const Range &range = ranges[r.signal];
+    int32_t span = range.max - range.min + 1;
+    r.threshold = range.min + (int32_t)(nextRandom() % (uint32_t)span);
+    r.hysteresis = (int32_t)(nextRandom() % (uint32_t)(span / 8 + 1));
+    r.holdMs = (nextRandom() % 4) * 1000;
+    rules.push_back(r);
+
+    char threshold[16], hysteresis[16], line[96];
+    formatValue(threshold, sizeof(threshold), r.signal, r.threshold);
+    formatValue(hysteresis, sizeof(hysteresis), r.signal, r.hysteresis);
+    snprintf(line, sizeof(line), "%u %s %s %s h%s t%lu%s", (unsigned)r.id,
+             windowSignalName(r.signal), r.op, threshold, hysteresis, (unsigned long)r.holdMs,
+             i % 3 == 0 ? " # comentário\n" : (i % 3 == 1 ? ";" : "\n"));
+    text += line;
+  }
+  // Ordem de avaliação da tabela: por sinal, estável
+  std::vector<PlainRule> sorted;
+  for (uint8_t s = 0; s < WINDOW_SIGNAL_COUNT; s++) {
+    for (size_t i = 0; i < rules.size(); i++) {
+      if (rules[i].signal == s) sorted.push_back(rules[i]);
+    }
+  }
+  rules.swap(sorted);
+  return text;
+}
+
+static bool sameEvent(const RuleEvent &a, const RuleEvent &b) {
+  return a.timestampUs == b.timestampUs && a.ruleId == b.ruleId && a.signal == b.signal &&
+         a.active == b.active && a.value == b.value && a.threshold == b.threshold;
+}
+
+// ------------------------------------------------------------------
+// --- TESTES ---
+// ------------------------------------------------------------------
+
+static unsigned failures = 0;
+
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FALHA: %s\n", what);
+    failures++;
+  }
+}
+
+static void testCompiler() {
+  static Program program;
+  check(program.compile("1 tM > 90 h5 t2000\n2 v < 60.5 h1 t5000; 3 a >= 150 t500 # fim"),
+        "texto válido");
+  check(program.count() == 3, "três regras");
+  // Ordem por sinal: v, a, tM
+  check(program.slot(0).id == 2 && program.slot(1).id == 3 && program.slot(2).id == 1,
+        "tabela ordenada por sinal");
+  check(program.slot(0).threshold == 605 && program.slot(0).exit == -615,
+        "decimal e histerese em v");
+  check(program.slot(1).enter == 1499 && program.slot(1).holdUs == 500000, "a >= 150.0");
+  check(program.first(WINDOW_RPM) == 2 && program.first(WINDOW_SIGNAL_COUNT) == 3,
+        "faixas por sinal");
+
+  check(!program.compile("1 tM > 90\n\n3 xyz > 1") && program.errorLine() == 3,
+        "sinal desconhecido na linha 3");
+  check(program.count() == 0, "programa vazio após erro");
+  check(!program.compile("1 rpm > 10.5") && program.errorLine() == 1, "decimal em rpm");
+  check(!program.compile("1 v > 60.55"), "duas casas decimais");
+  check(!program.compile("1 tM = 90"), "operador inválido");
+  check(!program.compile("1 tM > 90 x"), "lixo no fim da regra");
+  check(!program.compile("1 tM > 90 h-1"), "histerese negativa");
+  check(program.compile("") && program.count() == 0, "texto vazio");
+  check(program.compile("# só comentário\n\n;;") && program.count() == 0, "só comentários");
+  check(program.compile("7 a < -12.3 h0.5") && program.slot(0).threshold == -123 &&
+            program.slot(0).exit == 118,
+        "limiar negativo");
+}
+
+/**
+ * @brief RuleEngine contra o interpretador ingênuo sobre todos os frames
+ */
+static void testSemantics(const std::vector<CanMessage> &frames, const Range *ranges) {
+  static Program program;
+  for (int round = 0; round < 20; round++) {
+    std::vector<PlainRule> rules;
+    std::string text = randomRules(16 + nextRandom() % 200, ranges, rules);
+    if (!program.compile(text.c_str())) {
+      printf("FALHA: compilação (linha %u)\n", (unsigned)program.errorLine());
+      failures++;
+      return;
+    }
+    Engine engine;
+    engine.publish(&program);
+    PlainEngine plain(rules);
+
+    VehicleState state;
+    std::vector<RuleEvent> got, expected;
+    for (size_t i = 0; i < frames.size(); i++) {
+      const CanMessage &frame = frames[i];
+      if (!applyFrame(state, frame.id, frame.data, frame.length, frame.timestampUs / 1000)) {
+        continue;
+      }
+      bool battery = frame.id == BASE_BATTERY_ID;
+      if (battery) {
+        engine.evaluateBattery(state.battery, frame.timestampUs,
+                               [&](const RuleEvent &e) { got.push_back(e); });
+      } else {
+        engine.evaluateMotor(state.motor, frame.timestampUs,
+                             [&](const RuleEvent &e) { got.push_back(e); });
+      }
+      plain.evaluate(state, battery, frame.timestampUs, expected);
+    }
+    bool same = got.size() == expected.size();
+    for (size_t i = 0; same && i < got.size(); i++) same = sameEvent(got[i], expected[i]);
+    if (!same) {
+      printf("FALHA: rodada %d, %zu regras: %zu eventos (referência %zu)\n", round,
+             rules.size(), got.size(), expected.size());
+      failures++;
+    } else if (round == 0) {
+      printf("Semântica: %zu regras, %zu eventos idênticos à referência\n", rules.size(),
+             got.size());
+    }
+  }
+}
+
+static double nsPerFrame(std::chrono::steady_clock::time_point start, size_t frames) {
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+             .count() / frames;
+}
+
+static void benchmark(const std::vector<CanMessage> &frames, const Range *ranges) {
+  static Program program;
+  static const size_t COUNTS[] = {0, 8, 32, 128, 256, 512, 1024};
+  printf("%8s %16s %16s %10s\n", "regras", "tabela ns/frame", "ingênuo ns/frame", "eventos");
+  for (size_t c = 0; c < sizeof(COUNTS) / sizeof(COUNTS[0]); c++) {
+    std::vector<PlainRule> rules;
+    std::string text = randomRules(COUNTS[c], ranges, rules);
+    program.compile(text.c_str());
+    int repeats = COUNTS[c] >= 256 ? 3 : 10;
+
+    uint64_t events = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+      Engine engine;
+      engine.publish(&program);
+      VehicleState state;
+      for (size_t i = 0; i < frames.size(); i++) {
+        const CanMessage &frame = frames[i];
+        if (!applyFrame(state, frame.id, frame.data, frame.length, frame.timestampUs / 1000)) {
+          continue;
+        }
+        if (frame.id == BASE_BATTERY_ID) {
+          engine.evaluateBattery(state.battery, frame.timestampUs,
+                                 [&](const RuleEvent &) { events++; });
+        } else {
+          engine.evaluateMotor(state.motor, frame.timestampUs,
+                               [&](const RuleEvent &) { events++; });
+        }
+      }
+    }
+    double tableNs = nsPerFrame(start, frames.size() * repeats);
+
+    std::vector<RuleEvent> sink;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+      PlainEngine plain(rules);
+      VehicleState state;
+      for (size_t i = 0; i < frames.size(); i++) {
+        const CanMessage &frame = frames[i];
+        if (!applyFrame(state, frame.id, frame.data, frame.length, frame.timestampUs / 1000)) {
+          continue;
+        }
+        plain.evaluate(state, frame.id == BASE_BATTERY_ID, frame.timestampUs, sink);
+        sink.clear();
+      }
+    }
+    double plainNs = nsPerFrame(start, frames.size() * repeats);
+    printf("%8zu %16.1f %16.1f %10llu\n", COUNTS[c], tableNs, plainNs,
+           (unsigned long long)(events / repeats));
+  }
+}
+
+/**
+ * @brief Publicadora em outra thread, como a task de envio no firmware
+ */
+static void testSwap(const std::vector<CanMessage> &frames, const Range *ranges) {
+  static Program programs[2];
+  Engine engine;
+  std::atomic<bool> done(false);
+  std::atomic<uint32_t> published(0);
+  std::vector<std::string> texts;
+  for (int i = 0; i < 8; i++) {
+    std::vector<PlainRule> rules;
+    texts.push_back(randomRules(64 + i * 64, ranges, rules));
+  }
+
+  std::thread publisher([&] {
+    size_t next = 0;
+    while (!done.load()) {
+      for (Program &program : programs) {
+        if (!engine.canWrite(&program)) continue;
+        program.compile(texts[next++ % texts.size()].c_str());
+        if (engine.publish(&program)) published++;
+        break;
+      }
+      std::this_thread::yield();
+    }
+  });
+
+  uint64_t events = 0;
+  uint32_t adopted = 0;
+  const Program *last = NULL;
+  for (int r = 0; r < 20; r++) {
+    VehicleState state;
+    for (size_t i = 0; i < frames.size(); i++) {
+      const CanMessage &frame = frames[i];
+      if (!applyFrame(state, frame.id, frame.data, frame.length, frame.timestampUs / 1000)) {
+        continue;
+      }
+      if (frame.id == BASE_BATTERY_ID) {
+        engine.evaluateBattery(state.battery, frame.timestampUs, [&](const RuleEvent &e) {
+          events++;
+          if (e.ruleId == 0 || e.ruleId > 512) failures++; // Programa corrompido
+        });
+      } else {
+        engine.evaluateMotor(state.motor, frame.timestampUs, [&](const RuleEvent &e) {
+          events++;
+          if (e.ruleId == 0 || e.ruleId > 512) failures++;
+        });
+      }
+      if (engine.active() != last) {
+        last = engine.active();
+        adopted++;
+      }
+    }
+  }
+  done = true;
+  publisher.join();
+  printf("Troca: %u programas publicados, %u adotados durante a avaliação, %llu eventos\n",
+         (unsigned)published.load(), (unsigned)adopted, (unsigned long long)events);
+  check(adopted > 1, "programas trocados durante a avaliação");
+}
+
+int main(int argc, char **argv) {
+  const char *path = argc > 1 ? argv[1] : "src/esp32/_can_log (2).csv";
+  std::vector<CanMessage> frames;
+  if (!loadCapture(path, frames, SESSION_GAP_US)) {
+    fprintf(stderr, "Captura %s não encontrada; só o simulador\n", path);
+  }
+  size_t captureFrames = frames.size();
+  simulateRide(frames);
+  printf("Frames: %zu (captura %zu, simulador %zu)\n", frames.size(), captureFrames,
+         frames.size() - captureFrames);
+
+  // Faixa real de cada sinal: os limiares sorteados caem onde há transições
+  Range ranges[WINDOW_SIGNAL_COUNT];
+  for (uint8_t s = 0; s < WINDOW_SIGNAL_COUNT; s++) ranges[s] = Range{INT32_MAX, INT32_MIN};
+  VehicleState state;
+  for (size_t i = 0; i < frames.size(); i++) {
+    const CanMessage &frame = frames[i];
+    if (!applyFrame(state, frame.id, frame.data, frame.length, 0)) continue;
+    uint8_t base = frame.id == BASE_BATTERY_ID ? WINDOW_VOLTAGE : WINDOW_RPM;
+    for (uint8_t s = base; s < base + 4; s++) {
+      int32_t v = signalValue(state, s);
+      if (v < ranges[s].min) ranges[s].min = v;
+      if (v > ranges[s].max) ranges[s].max = v;
+    }
+  }
+
+  testCompiler();
+  testSemantics(frames, ranges);
+  benchmark(frames, ranges);
+  testSwap(frames, ranges);
+
+  if (failures) {
+    printf("FALHA: %u verificações\n", failures);
+    return 2;
+  }
+  printf("OK\n");
+  return 0;
+}
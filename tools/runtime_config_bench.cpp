@@ -0,0 +1,453 @@
+// ------------------------------------------------------------------
+// Teste no PC da configuração em campo (src/common/runtime_config.h e
+// src/common/rcu_cell.h)
+// ------------------------------------------------------------------
+// 1. Validação: configurações fora dos limites são recusadas, com o
+//    campo certo apontado.
+// 2. Dead-band: frames sem mudança além da faixa são segurados até o
+//    heartbeat.
+// 3. Troca sob carga: captura → decodificação (filtro + dead-band da
+//    configuração) → envio em threads, como as tasks do firmware, sem
+//    ritmo de tempo real, enquanto outra thread troca a configuração
+//    milhares de vezes por segundo. Cada configuração é derivada da
+//    própria versão, então uma leitura rasgada ou um slot reaproveitado
+//    enquanto um leitor o usa aparece na conferência. A vazão é comparada
+//    com a mesma carga sem trocas.
+//
+// IDs da bateria, do controlador e das falhas: os da captura
+// (capture_ids.h), não os de config/constants.h, para que o filtro e a
+// dead-band sejam testados com IDs distintos.
+//
+// Compilação (precisa de config/constants.h):
+//   g++ -std=c++11 -O2 -pthread tools/runtime_config_bench.cpp -o .build/runtime_config_bench
+// Uso:
+//   .build/runtime_config_bench [frames] [trocas/s]
+
+#include "../src/common/capture_ids.h" // Antes de tudo: fixa os IDs
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "../src/common/pipeline.h"
+#include "../src/common/rcu_cell.h"
+#include "../src/common/runtime_config.h"
+#include "../src/common/spsc_ring.h"
+#include "../src/common/time_base.h"
+#include "../src/common/vehicle_sim.h"
+
+#define BENCH_RING_SIZE 256   // Igual a CAPTURE_RING_SIZE do firmware
+#define BENCH_WAKE_FRAMES 32  // Frames por despertar da decodificação
+#define BENCH_CYCLE_FRAMES 64 // Frames por ciclo da task de envio
+
+// ------------------------------------------------------------------
+// --- ESTÁGIOS DO HOST ---
+// ------------------------------------------------------------------
+
+/**
+ * @brief Simulador sem ritmo: gera frames o mais rápido possível
+ */
+class BenchSource {
+public:
+  bool begin() {
+    sim_.setBusLoad(100);
+    return true;
+  }
+
+  bool read(CanMessage &frame) {
+    SimFrame simFrame;
+    sim_.nextFrame(simFrame);
+    frame.id = simFrame.id;
+    frame.length = simFrame.length;
+    frame.isExtended = simFrame.isExtended;
+    memcpy(frame.data, simFrame.data, sizeof(frame.data));
+    frame.timestampUs = TimeBase::stamp();
+    return true;
+  }
+
+private:
+  VehicleSim sim_;
+};
+
+/**
+ * @brief Só conta o que chegou ao envio
+ */
+class CountSink {
+public:
+  bool begin() { return true; }
+  void poll() {}
+  void write(const CanMessage &, const VehicleState &) { frames_++; }
+  void writeUrgent(const CanMessage &, const VehicleState &) { frames_++; }
+  void writeTrip(const TripSummary &) {}
+  void writeWindow(const WindowRecord &) {}
+  void writeAlarm(const RuleEvent &) {}
+  void flush() {}
+  void report(const LaneStatus &) {}
+  void feedback(LinkFeedback &) {}
+  bool receiveConfig(ConfigUpdate &) { return false; }
+
+  uint64_t frames() const { return frames_; }
+
+private:
+  uint64_t frames_ = 0;
+};
+
+typedef Pipeline<BenchSource, PassFilter, StateDecoder, CountSink> BenchPipe;
+typedef RcuCell<RuntimeConfig, 2> ConfigCell;
+
+// ------------------------------------------------------------------
+// --- CONFIGURAÇÕES DERIVADAS DA VERSÃO ---
+// ------------------------------------------------------------------
+
+/**
+ * @brief Configuração válida cujos campos dependem todos de version
+ * @details Filtro com 14 IDs estendidos que o simulador não gera mais
+ *          bateria e controlador; faixas pequenas no dead-band
+ */
+static RuntimeConfig makeConfig(uint32_t version) {
+  RuntimeConfig c;
+  c.version = version;
+  c.transmitIntervalMs = 10 + version % 1000;
+  c.batchFrames = 1 + version % CONFIG_MAX_BATCH_FRAMES;
+  c.reportIntervalMs = 1000 + version % 100000;
+  c.heartbeatMs = c.transmitIntervalMs + version % 5000;
+  c.filterCount = CONFIG_MAX_FILTER_IDS;
+  for (uint8_t i = 0; i < CONFIG_MAX_FILTER_IDS - 2; i++) {
+    c.filterIds[i] = 0x10000000UL | ((version * CONFIG_MAX_FILTER_IDS + i) & 0xFFFFFF);
+  }
+  c.filterIds[CONFIG_MAX_FILTER_IDS - 2] = BASE_BATTERY_ID;
+  c.filterIds[CONFIG_MAX_FILTER_IDS - 1] = BASE_CONTROLLER_ID;
+  c.deadbandOn = true;
+  for (uint8_t s = 0; s < WINDOW_SIGNAL_COUNT; s++) c.deadband[s] = (version + s) % 4;
+  return c;
+}
+
+/** @brief c é exatamente makeConfig(c.version) */
+static bool intact(const RuntimeConfig &c) {
+  RuntimeConfig e = makeConfig(c.version);
+  bool same = c.transmitIntervalMs == e.transmitIntervalMs && c.batchFrames == e.batchFrames &&
+              c.reportIntervalMs == e.reportIntervalMs && c.heartbeatMs == e.heartbeatMs &&
+              c.filterCount == e.filterCount && c.deadbandOn == e.deadbandOn;
+  for (uint8_t i = 0; same && i < CONFIG_MAX_FILTER_IDS; i++) same = c.filterIds[i] == e.filterIds[i];
+  for (uint8_t s = 0; same && s < WINDOW_SIGNAL_COUNT; s++) same = c.deadband[s] == e.deadband[s];
+  return same;
+}
+
+// ------------------------------------------------------------------
+// --- 1. VALIDAÇÃO ---
+// ------------------------------------------------------------------
+
+static bool checkValidation() {
+  struct Case {
+    const char *name;
+    RuntimeConfig config;
+    const char *error;
+  };
+  Case cases[12];
+  uint8_t n = 0;
+  RuntimeConfig base = makeConfig(7);
+
+  cases[n++] = {"válida", base, NULL};
+  cases[n] = {"tx baixo", base, "tx"};
+  cases[n++].config.transmitIntervalMs = 5;
+  cases[n] = {"tx alto", base, "tx"};
+  cases[n++].config.transmitIntervalMs = 6000;
+  cases[n] = {"lote zero", base, "batch"};
+  cases[n++].config.batchFrames = 0;
+  cases[n] = {"lote grande", base, "batch"};
+  cases[n++].config.batchFrames = CONFIG_MAX_BATCH_FRAMES + 1;
+  cases[n] = {"relatório curto", base, "rep"};
+  cases[n++].config.reportIntervalMs = 500;
+  cases[n] = {"heartbeat < tx", base, "hb"};
+  cases[n].config.heartbeatMs = base.transmitIntervalMs - 1;
+  n++;
+  cases[n] = {"IDs demais", base, "ids"};
+  cases[n++].config.filterCount = CONFIG_MAX_FILTER_IDS + 1;
+  cases[n] = {"ID de 30 bits", base, "ids"};
+  cases[n++].config.filterIds[3] = 0x20000000UL;
+  cases[n] = {"faixa negativa", base, "db"};
+  cases[n++].config.deadband[WINDOW_RPM] = -1;
+  cases[n] = {"faixa enorme", base, "db"};
+  cases[n++].config.deadband[WINDOW_SOC] = 200000;
+  cases[n] = {"sem filtro", base, NULL};
+  cases[n++].config.filterCount = 0;
+
+  bool ok = true;
+  for (uint8_t i = 0; i < n; i++) {
+    const char *error;
+    validateRuntimeConfig(cases[i].config, error);
+    bool match = (error == NULL && cases[i].error == NULL) ||
+                 (error && cases[i].error && strcmp(error, cases[i].error) == 0);
+    if (!match) {
+      printf("  FALHA %-16s esperado %s, obtido %s\n", cases[i].name,
+             cases[i].error ? cases[i].error : "aceita", error ? error : "aceita");
+      ok = false;
+    }
+  }
+  for (uint32_t v = 1; v < 100000; v++) {
+    const char *error;
+    if (!validateRuntimeConfig(makeConfig(v), error)) {
+      printf("  FALHA makeConfig(%lu) recusada em %s\n", (unsigned long)v, error);
+      ok = false;
+      break;
+    }
+  }
+  printf("validação: %u casos + 99999 configurações geradas: %s\n", n, ok ? "OK" : "FALHA");
+  return ok;
+}
+
+// ------------------------------------------------------------------
+// --- 2. DEAD-BAND ---
+// ------------------------------------------------------------------
+
+static bool checkDeadband() {
+  RuntimeConfig c;
+  c.heartbeatMs = 1000;
+  c.deadbandOn = true;
+  c.deadband[WINDOW_VOLTAGE] = 5; // 0,5 V
+  c.deadband[WINDOW_SOC] = 2;
+
+  DeadbandGate gate;
+  VehicleState state;
+  CanMessage frame;
+  frame.id = BASE_BATTERY_ID;
+  frame.timestampUs = 0;
+  state.battery.voltageDeci = 720;
+  state.battery.soc = 80;
+
+  struct Step {
+    uint32_t ms;
+    int32_t voltageDeci, soc, currentDeci;
+    bool pass;
+  };
+  static const Step steps[] = {
+      {0, 720, 80, 0, true},      // Primeiro frame sempre passa
+      {50, 724, 80, 0, false},    // 0,4 V: dentro da faixa
+      {100, 726, 80, 0, true},    // 0,6 V desde o último enviado
+      {150, 726, 79, 0, false},   // SoC −1: dentro da faixa
+      {200, 726, 77, 0, true},    // SoC −3
+      {250, 726, 77, 1, true},    // Corrente sem faixa: qualquer mudança
+      {300, 726, 77, 1, false},   // Nada mudou
+      {1250, 726, 77, 1, true},   // Heartbeat
+  };
+
+  bool ok = true;
+  for (const Step &step : steps) {
+    frame.timestampUs = step.ms * 1000UL;
+    state.battery.voltageDeci = step.voltageDeci;
+    state.battery.soc = step.soc;
+    state.battery.currentDeci = step.currentDeci;
+    if (gate.pass(c, frame, state) != step.pass) {
+      printf("  FALHA dead-band em %lu ms: esperado %s\n", (unsigned long)step.ms,
+             step.pass ? "enviar" : "segurar");
+      ok = false;
+    }
+  }
+
+  // Falhas nunca são seguradas, nem ficam fora do filtro de IDs
+  frame.id = BASE_BATTERY_ID_2;
+  frame.isExtended = false;
+  if (!gate.pass(c, frame, state) || !gate.pass(c, frame, state)) ok = false;
+  c.filterCount = 1;
+  c.filterIds[0] = BASE_CONTROLLER_ID;
+  if (!runtimeConfigAccepts(c, frame)) ok = false;
+  frame.id = BASE_BATTERY_ID;
+  if (runtimeConfigAccepts(c, frame)) ok = false;
+
+  printf("dead-band: %u passos, %lu segurados: %s\n", (unsigned)(sizeof(steps) / sizeof(steps[0])),
+         (unsigned long)gate.suppressed(), ok ? "OK" : "FALHA");
+  return ok;
+}
+
+// ------------------------------------------------------------------
+// --- 3. TROCA SOB CARGA ---
+// ------------------------------------------------------------------
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct RunResult {
+  double fps;
+  uint32_t swaps;
+  uint64_t reads;
+  uint64_t delivered;
+  uint64_t held; // Filtro + dead-band
+  uint64_t corrupt;
+  uint64_t reordered;
+};
+
+/**
+ * @brief Pipeline em threads; com swapsPerSecond > 0, uma quarta thread
+ *        troca a configuração nesse ritmo
+ */
+static RunResult runPipeline(uint32_t frames, uint32_t swapsPerSecond) {
+  static BenchPipe pipe;
+  static SpscRing<CanMessage, BENCH_RING_SIZE> captureRing;
+  static SpscRing<CanMessage, BENCH_RING_SIZE> sendRing;
+  ConfigCell *cell = new ConfigCell(makeConfig(1));
+  std::atomic<bool> captureDone(false);
+  std::atomic<bool> decodeDone(false);
+  std::atomic<bool> sendDone(false);
+  std::atomic<uint64_t> corrupt(0);
+  std::atomic<uint64_t> reordered(0);
+  std::atomic<uint64_t> reads(0);
+  uint64_t held = 0;
+  uint64_t sentBefore = pipe.sinks().head().frames();
+  pipe.begin();
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  std::thread capture([&] {
+    CanMessage frame;
+    for (uint32_t i = 0; i < frames; i++) {
+      pipe.capture(frame);
+      while (!captureRing.push(frame)) std::this_thread::yield();
+    }
+    captureDone = true;
+  });
+
+  // Decodificação: relê a configuração a cada despertar, como decodeTask
+  std::thread decode([&] {
+    CanMessage frame;
+    DeadbandGate deadband;
+    uint32_t lastVersion = 0;
+    uint64_t localReads = 0, localHeld = 0;
+    for (;;) {
+      const RuntimeConfig &config = *cell->read(0);
+      localReads++;
+      if (!intact(config)) corrupt++;
+      if (config.version < lastVersion) reordered++;
+      lastVersion = config.version;
+
+      uint32_t woken = 0;
+      while (woken < BENCH_WAKE_FRAMES && captureRing.pop(frame)) {
+        woken++;
+        if (!pipe.prepare(frame)) continue;
+        if (!runtimeConfigAccepts(config, frame) ||
+            !deadband.pass(config, frame, pipe.decodedState())) {
+          localHeld++;
+          continue;
+        }
+        while (!sendRing.push(frame)) std::this_thread::yield();
+      }
+      if (!intact(config)) corrupt++; // Slot reaproveitado durante o uso
+      if (woken == 0) {
+        if (captureDone && captureRing.empty()) break;
+        std::this_thread::yield();
+      }
+    }
+    cell->release(0);
+    reads += localReads;
+    held = localHeld;
+    decodeDone = true;
+  });
+
+  // Envio: lote máximo da configuração a cada ciclo, como uplinkTask
+  std::thread send([&] {
+    CanMessage frame;
+    uint64_t localReads = 0;
+    for (;;) {
+      const RuntimeConfig &config = *cell->read(1);
+      localReads++;
+      if (!intact(config)) corrupt++;
+      uint32_t budget = config.batchFrames < BENCH_CYCLE_FRAMES ? config.batchFrames
+                                                                 : BENCH_CYCLE_FRAMES;
+      uint32_t sent = 0;
+      while (sent < budget && sendRing.pop(frame)) {
+        pipe.process(frame);
+        sent++;
+      }
+      if (!intact(config)) corrupt++;
+      if (sent == 0) {
+        if (decodeDone && sendRing.empty()) break;
+        std::this_thread::yield();
+      }
+    }
+    cell->release(1);
+    reads += localReads;
+    sendDone = true;
+  });
+
+  // Escritor: prepara, preenche e publica, no ritmo pedido
+  std::thread writer([&] {
+    if (swapsPerSecond == 0) return;
+    std::chrono::nanoseconds period(1000000000LL / swapsPerSecond);
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    uint32_t version = 1;
+    while (!sendDone) {
+      RuntimeConfig *slot = cell->prepare();
+      *slot = makeConfig(++version);
+      cell->publish(slot);
+      next += period;
+      while (std::chrono::steady_clock::now() < next && !sendDone) std::this_thread::yield();
+    }
+  });
+
+  capture.join();
+  decode.join();
+  send.join();
+  writer.join();
+
+  RunResult result;
+  result.fps = frames / secondsSince(start);
+  result.swaps = cell->swaps();
+  result.reads = reads;
+  result.delivered = pipe.sinks().head().frames() - sentBefore;
+  result.held = held;
+  result.corrupt = corrupt;
+  result.reordered = reordered;
+  delete cell;
+  return result;
+}
+
+/**
+ * @brief Custo de uma leitura sem concorrência (ns)
+ */
+static double measureRead() {
+  ConfigCell cell(makeConfig(1));
+  const uint32_t rounds = 20000000;
+  uint32_t sum = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < rounds; i++) sum += cell.read(0)->batchFrames;
+  double ns = secondsSince(start) * 1e9 / rounds;
+  if (sum == 0) printf(" ");
+  return ns;
+}
+
+int main(int argc, char **argv) {
+  uint32_t frames = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 2000000;
+  uint32_t rate = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 10000;
+  if (frames == 0 || rate == 0) return 1;
+
+  bool ok = checkValidation();
+  ok = checkDeadband() && ok;
+
+  printf("\nleitura sem concorrência: %.1f ns\n", measureRead());
+  RunResult fixed = runPipeline(frames, 0);
+  RunResult swapped = runPipeline(frames, rate);
+  double seconds = frames / swapped.fps;
+
+  printf("%-22s %12s %10s %10s %12s %10s\n", "", "frames/s", "trocas", "trocas/s",
+         "entregues", "segurados");
+  printf("%-22s %12.0f %10lu %10s %12llu %10llu\n", "configuração fixa", fixed.fps,
+         (unsigned long)fixed.swaps, "-", (unsigned long long)fixed.delivered,
+         (unsigned long long)fixed.held);
+  printf("%-22s %12.0f %10lu %10.0f %12llu %10llu\n", "trocando", swapped.fps,
+         (unsigned long)swapped.swaps, swapped.swaps / seconds,
+         (unsigned long long)swapped.delivered, (unsigned long long)swapped.held);
+  printf("leituras: %llu | rasgadas/reaproveitadas: %llu | versão voltou: %llu\n",
+         (unsigned long long)swapped.reads, (unsigned long long)(fixed.corrupt + swapped.corrupt),
+         (unsigned long long)swapped.reordered);
+  printf("vazão com trocas: %.1f%% da fixa\n", 100.0 * swapped.fps / fixed.fps);
+
+  bool lossless = fixed.delivered + fixed.held == frames &&
+                  swapped.delivered + swapped.held == frames;
+  ok = ok && lossless && fixed.corrupt == 0 && swapped.corrupt == 0 && swapped.reordered == 0 &&
+       swapped.swaps / seconds >= 1000;
+  printf("%s\n", ok ? "OK" : "FALHA");
+  return ok ? 0 : 2;
+}
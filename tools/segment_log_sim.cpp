@@ -0,0 +1,290 @@
+// ------------------------------------------------------------------
+// Simulação no PC do log circular em segmentos (src/common/segment_log.h)
+// ------------------------------------------------------------------
+// Sistema de arquivos simulado com o comportamento do FatFs (FAT do
+// cartão SD no ESP-IDF), contando o que de fato seria gravado no cartão:
+//   - setor de dados de 512 B (um setor parcial é regravado inteiro);
+//   - arquivo que cresce aloca clusters de 4 KB: setor da FAT (2 cópias)
+//     e FSInfo gravados no próximo sync;
+//   - todo sync de um arquivo alterado regrava a entrada de diretório.
+// Compara o log de um arquivo que cresce (como antes) com os segmentos
+// pré-alocados, num volume com pouco espaço livre, e mostra a
+// amplificação de escrita (bytes no cartão / bytes de log), as gravações
+// de metadados, as linhas perdidas com o volume cheio e quanto do fim
+// do log fica guardado. O conteúdo lido de volta é conferido linha a linha.
+//
+// Compilação:
+//   g++ -std=c++11 -O2 tools/segment_log_sim.cpp -o .build/segment_log_sim
+// Uso:
+//   .build/segment_log_sim [minutos simulados]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../src/common/segment_log.h"
+
+#define SIM_SECTOR 512
+#define SIM_CLUSTER 4096
+#define SIM_FREE_BYTES (8UL * 1024 * 1024) // Espaço livre no volume
+#define SIM_LINES_PER_S 40                 // Frames de bateria + controlador
+#define SIM_CYCLE_MS 50                    // TRANSMIT_INTERVAL_MS
+#define SIM_SEGMENTS 6
+#define SIM_SEGMENT_BYTES (1024UL * 1024)
+
+// ------------------------------------------------------------------
+// --- SISTEMA DE ARQUIVOS SIMULADO ---
+// ------------------------------------------------------------------
+
+struct SimNode {
+  std::vector<uint8_t> data;
+  uint32_t clusters = 0;
+};
+
+struct SimVolume {
+  std::map<std::string, SimNode> files;
+  uint32_t freeClusters = SIM_FREE_BYTES / SIM_CLUSTER;
+  uint64_t dataBytes = 0;   // Setores de dados gravados
+  uint64_t metaBytes = 0;   // FAT, FSInfo e entradas de diretório
+  uint32_t metaWrites = 0;
+
+  void reset() { *this = SimVolume(); }
+};
+
+static SimVolume volume;
+
+/**
+ * @brief Arquivo do volume simulado (interface de StdioSegmentFile)
+ */
+class SimFile {
+public:
+  bool open(const char *path, bool truncate) {
+    close();
+    node_ = &volume.files[path];
+    if (truncate && (!node_->data.empty() || node_->clusters > 0)) {
+      volume.freeClusters += node_->clusters;
+      fatDirty_ += fatSectors(node_->clusters);
+      node_->clusters = 0;
+      node_->data.clear();
+      modified_ = true;
+    }
+    position_ = 0;
+    return true;
+  }
+
+  void close() {
+    if (node_ != NULL) sync();
+    node_ = NULL;
+  }
+
+  bool isOpen() const { return node_ != NULL; }
+  uint32_t size() { return node_ ? (uint32_t)node_->data.size() : 0; }
+
+  bool reserve(uint32_t bytes) {
+    if (size() >= bytes) return true;
+    const uint8_t zero = 0;
+    return seek(bytes - 1) && write(&zero, 1) == 1 && sync();
+  }
+
+  bool seek(uint32_t offset) {
+    position_ = offset;
+    return true;
+  }
+
+  size_t read(void *data, size_t length) {
+    if (position_ >= node_->data.size()) return 0;
+    size_t n = std::min(length, node_->data.size() - position_);
+    memcpy(data, &node_->data[position_], n);
+    position_ += (uint32_t)n;
+    return n;
+  }
+
+  size_t write(const void *data, size_t length) {
+    if (length == 0) return 0;
+    uint32_t end = position_ + (uint32_t)length;
+    uint32_t needed = (end + SIM_CLUSTER - 1) / SIM_CLUSTER;
+    if (needed > node_->clusters) {
+      uint32_t extra = needed - node_->clusters;
+      if (extra > volume.freeClusters) return 0; // Volume cheio
+      volume.freeClusters -= extra;
+      node_->clusters = needed;
+      fatDirty_ = std::max<uint32_t>(fatDirty_, 1);
+      fsInfoDirty_ = true;
+    }
+    if (end > node_->data.size()) node_->data.resize(end);
+    memcpy(&node_->data[position_], data, length);
+
+    // Buffer de um setor por arquivo, como o FatFs
+    for (uint32_t sector = position_ / SIM_SECTOR; sector <= (end - 1) / SIM_SECTOR; sector++) {
+      if (bufferDirty_ && sector != bufferSector_) volume.dataBytes += SIM_SECTOR;
+      bufferSector_ = sector;
+      bufferDirty_ = true;
+    }
+    position_ = end;
+    modified_ = true;
+    return length;
+  }
+
+  bool sync() {
+    if (bufferDirty_) volume.dataBytes += SIM_SECTOR;
+    bufferDirty_ = false;
+    uint32_t meta = (modified_ ? 1 : 0) + fatDirty_ * 2 + (fsInfoDirty_ ? 1 : 0);
+    volume.metaBytes += meta * SIM_SECTOR;
+    volume.metaWrites += meta;
+    modified_ = fsInfoDirty_ = false;
+    fatDirty_ = 0;
+    return true;
+  }
+
+private:
+  static uint32_t fatSectors(uint32_t clusters) { return (clusters * 4 + SIM_SECTOR - 1) / SIM_SECTOR; }
+
+  SimNode *node_ = NULL;
+  uint32_t position_ = 0;
+  uint32_t bufferSector_ = UINT32_MAX;
+  bool bufferDirty_ = false;
+  bool modified_ = false;
+  uint32_t fatDirty_ = 0; // Setores da FAT alterados (por cópia)
+  bool fsInfoDirty_ = false;
+};
+
+// ------------------------------------------------------------------
+// --- CENÁRIOS ---
+// ------------------------------------------------------------------
+
+enum Mode { SINGLE_OPEN_CLOSE, SINGLE_FLUSH_CYCLE, SEGMENTS_FLUSH_CYCLE, SEGMENTS_FLUSH_1S };
+
+struct Result {
+  uint64_t logBytes = 0;
+  uint32_t lost = 0;
+  uint32_t retainedLines = 0;
+  uint32_t firstRetainedMs = 0;
+  bool ordered = true;
+};
+
+/**
+ * @brief Linha no formato do SdCsvSink; o timestamp identifica a linha
+ */
+static int formatLine(char *line, size_t size, uint32_t index) {
+  return snprintf(line, size, "%lu,%s,%d,%.1f,%.1f,%.1f,%d,%d,%d,%d\n",
+                  (unsigned long)(index * (1000 / SIM_LINES_PER_S)), "SPORT",
+                  3000 + (int)(index % 900), 12.5, 72.3, -15.2, 87, 31, 45, 39);
+}
+
+/**
+ * @brief Confere o que foi lido de volta: linhas consecutivas até a última
+ */
+struct Checker {
+  explicit Checker(Result &target) : result(&target) {}
+
+  Result *result;
+  std::string pending;
+  int64_t lastMs = -1;
+
+  void operator()(const char *data, size_t length) {
+    pending.append(data, length);
+    size_t start = 0, end;
+    while ((end = pending.find('\n', start)) != std::string::npos) {
+      unsigned long ms = strtoul(pending.c_str() + start, NULL, 10);
+      if (lastMs < 0) {
+        result->firstRetainedMs = (uint32_t)ms;
+      } else if ((int64_t)ms != lastMs + 1000 / SIM_LINES_PER_S) {
+        result->ordered = false;
+      }
+      lastMs = (int64_t)ms;
+      result->retainedLines++;
+      start = end + 1;
+    }
+    pending.erase(0, start);
+  }
+};
+
+static Result run(Mode mode, uint32_t minutes) {
+  volume.reset();
+  Result result;
+  uint32_t totalLines = minutes * 60 * SIM_LINES_PER_S;
+  uint32_t linesPerCycle = SIM_LINES_PER_S * SIM_CYCLE_MS / 1000;
+  char line[96];
+
+  if (mode == SINGLE_OPEN_CLOSE || mode == SINGLE_FLUSH_CYCLE) {
+    SimFile file;
+    if (mode == SINGLE_FLUSH_CYCLE) file.open("/datalog.csv", false);
+    for (uint32_t i = 0; i < totalLines; i++) {
+      int n = formatLine(line, sizeof(line), i);
+      if (mode == SINGLE_OPEN_CLOSE) file.open("/datalog.csv", false);
+      file.seek(file.size());
+      if (file.write(line, n) == (size_t)n) {
+        result.logBytes += n;
+      } else {
+        result.lost++;
+      }
+      if (mode == SINGLE_OPEN_CLOSE) file.close();
+      else if ((i + 1) % linesPerCycle == 0) file.sync();
+    }
+    file.close();
+
+    // Leitura de volta: o arquivo inteiro
+    Checker checker(result);
+    const SimNode &node = volume.files["/datalog.csv"];
+    checker((const char *)node.data.data(), node.data.size());
+    return result;
+  }
+
+  SegmentLog<SimFile> log;
+  log.begin("/datalog_%02u.csv", SIM_SEGMENTS, SIM_SEGMENT_BYTES, true);
+  uint64_t setupData = volume.dataBytes, setupMeta = volume.metaBytes;
+  uint32_t setupWrites = volume.metaWrites;
+  uint32_t syncEvery = mode == SEGMENTS_FLUSH_1S ? SIM_LINES_PER_S : linesPerCycle;
+  for (uint32_t i = 0; i < totalLines; i++) {
+    int n = formatLine(line, sizeof(line), i);
+    if (log.write(line, n)) {
+      result.logBytes += n;
+    } else {
+      result.lost++;
+    }
+    if ((i + 1) % syncEvery == 0) log.flush();
+  }
+  log.flush();
+  // A pré-alocação acontece uma vez na vida do cartão: fora da conta
+  volume.dataBytes -= setupData;
+  volume.metaBytes -= setupMeta;
+  volume.metaWrites -= setupWrites;
+
+  Checker checker(result);
+  log.readAll(checker);
+  return result;
+}
+
+int main(int argc, char **argv) {
+  uint32_t minutes = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 120;
+  if (minutes == 0) return 1;
+  printf("%lu min | %d linhas/s | ciclo %d ms | volume com %lu MB livres | "
+         "%d segmentos de %lu KB\n\n",
+         (unsigned long)minutes, SIM_LINES_PER_S, SIM_CYCLE_MS,
+         (unsigned long)(SIM_FREE_BYTES >> 20), SIM_SEGMENTS,
+         (unsigned long)(SIM_SEGMENT_BYTES >> 10));
+
+  static const char *const NAMES[] = {
+    "arquivo único, abre/fecha por linha",
+    "arquivo único, flush por ciclo",
+    "segmentos, flush por ciclo",
+    "segmentos, flush a cada 1 s",
+  };
+  printf("%-36s %8s %9s %6s %12s %8s %10s %s\n", "modo", "log MB", "cartão MB", "WA",
+         "metadados/MB", "perdidas", "guardado", "ordem");
+  for (int mode = SINGLE_OPEN_CLOSE; mode <= SEGMENTS_FLUSH_1S; mode++) {
+    Result r = run((Mode)mode, minutes);
+    double logMb = r.logBytes / 1048576.0;
+    double cardMb = (volume.dataBytes + volume.metaBytes) / 1048576.0;
+    uint32_t retainedMin = r.retainedLines / SIM_LINES_PER_S / 60;
+    printf("%-36s %8.1f %9.1f %6.1f %12lu %8lu %6lu min %s\n", NAMES[mode], logMb, cardMb,
+           logMb > 0 ? cardMb / logMb : 0.0,
+           (unsigned long)(logMb > 0 ? volume.metaWrites / logMb : 0),
+           (unsigned long)r.lost, (unsigned long)retainedMin, r.ordered ? "ok" : "ERRO");
+  }
+  return 0;
+}
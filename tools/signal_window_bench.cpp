@@ -0,0 +1,277 @@
+// ------------------------------------------------------------------
+// Benchmark e validação no PC das janelas por sinal (src/common/signal_window.h)
+// ------------------------------------------------------------------
+// Passa os frames pelo decodificador do firmware com janelas
+// (AggregateDecoder<false, true>, pipeline.h), com tick() a cada 100 ms
+// como a task de decodificação, e:
+//   1. compara cada janela com um recálculo ingênuo sobre todas as
+//      amostras guardadas (agrupadas pelo índice da janela a partir da
+//      primeira amostra): mín, máx, média, último e contagem exatos;
+//   2. mede o custo por frame contra o StateDecoder (só applyFrame);
+//   3. compara os bytes de JSON das janelas com os dos frames brutos.
+// Frames: a captura _can_log.csv (duas sessões) e 20 min do simulador.
+// Termina com código 2 se alguma janela divergir.
+//
+// IDs da bateria e do controlador: os da captura (capture_ids.h), não os
+// de config/constants.h.
+//
+// Compilação:
+//   g++ -std=c++11 -O2 -Wall tools/signal_window_bench.cpp -o .build/signal_window_bench
+// Uso:
+//   .build/signal_window_bench ["src/esp32/_can_log (2).csv"] [repetições]
+
+#include "../src/common/capture_ids.h" // Antes de tudo: fixa os IDs
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "../src/common/capture_replay.h"
+#include "../src/common/pipeline.h"
+#include "../src/common/vehicle_sim.h"
+
+#define TICK_US 100000U            // BUS_CHECK_INTERVAL_MS do firmware
+#define SESSION_GAP_US 10000000U   // Pausa entre as sessões da captura
+#define SIM_RIDE_US (20U * 60 * 1000000)
+
+typedef AggregateDecoder<false, true> WindowDecoder;
+
+/**
+ * @brief Uma volta do simulador (só bateria e controlador) depois da captura
+ */
+static void simulateRide(std::vector<CanMessage> &frames) {
+  SimConfig config;
+  config.busLoadPercent = 0;
+  VehicleSim sim(config);
+  sim.setBusLoad(0);
+  uint32_t startUs = frames.empty() ? 0 : frames.back().timestampUs + SESSION_GAP_US;
+  SimFrame simFrame;
+  do {
+    sim.nextFrame(simFrame);
+    CanMessage frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.timestampUs = startUs + (uint32_t)simFrame.timeUs;
+    frame.id = simFrame.id;
+    frame.length = simFrame.length;
+    frame.isExtended = simFrame.isExtended;
+    memcpy(frame.data, simFrame.data, sizeof(frame.data));
+    frames.push_back(frame);
+  } while (simFrame.timeUs < SIM_RIDE_US);
+}
+
+/**
+ * @brief Roda o decodificador com ticks de 100 ms, como a task do firmware
+ */
+template <class Decoder>
+static void run(const std::vector<CanMessage> &frames, std::vector<WindowRecord> *records) {
+  Decoder decoder;
+  VehicleState state;
+  TripSummary trip;
+  WindowRecord record;
+  uint32_t nextTickUs = frames.front().timestampUs + TICK_US;
+  for (size_t i = 0; i < frames.size(); i++) {
+    const CanMessage &frame = frames[i];
+    while ((int32_t)(frame.timestampUs - nextTickUs) >= 0) {
+      decoder.tick(nextTickUs, trip);
+      nextTickUs += TICK_US;
+    }
+    decoder.decode(frame, state);
+    while (decoder.popWindow(record)) {
+      if (records) records->push_back(record);
+    }
+  }
+  decoder.tick(nextTickUs + SIGNAL_WINDOW_LONG_MS * 1000U, trip); // Fecha as últimas
+  while (decoder.popWindow(record)) {
+    if (records) records->push_back(record);
+  }
+}
+
+// ------------------------------------------------------------------
+// --- REFERÊNCIA INGÊNUA ---
+// ------------------------------------------------------------------
+
+struct Sample {
+  uint32_t us;
+  bool battery;
+  VehicleState state;
+};
+
+static int32_t sampleValue(const Sample &sample, uint8_t signal) {
+  const BatteryState &b = sample.state.battery;
+  const MotorState &m = sample.state.motor;
+  switch (signal) {
+    case WINDOW_VOLTAGE: return b.voltageDeci;
+    case WINDOW_CURRENT: return b.currentDeci;
+    case WINDOW_SOC: return b.soc;
+    case WINDOW_BATTERY_TEMP: return b.temperature;
+    case WINDOW_RPM: return m.rpm;
+    case WINDOW_TORQUE: return m.torqueDeci;
+    case WINDOW_MOTOR_TEMP: return m.motorTemp;
+    default: return m.controllerTemp;
+  }
+}
+
+static bool batterySignal(uint8_t signal) { return signal <= WINDOW_BATTERY_TEMP; }
+
+/**
+ * @brief Janelas de um nível recalculadas com todas as amostras em memória
+ */
+static void referenceWindows(const std::vector<Sample> &samples, uint32_t periodMs, uint8_t level,
+                             std::vector<WindowRecord> &out) {
+  uint64_t periodUs = (uint64_t)periodMs * 1000;
+  uint32_t origin = samples.front().us;
+  size_t first = 0;
+  uint8_t mode = 0;
+  while (first < samples.size()) {
+    uint64_t index = (samples[first].us - origin) / periodUs;
+    size_t end = first;
+    while (end < samples.size() && (samples[end].us - origin) / periodUs == index) end++;
+
+    WindowRecord record;
+    memset(&record, 0, sizeof(record));
+    record.startUs = origin + (uint32_t)(index * periodUs);
+    record.periodMs = periodMs;
+    record.level = level;
+    for (uint8_t s = 0; s < WINDOW_SIGNAL_COUNT; s++) {
+      std::vector<int32_t> values;
+      for (size_t i = first; i < end; i++) {
+        if (samples[i].battery == batterySignal(s)) values.push_back(sampleValue(samples[i], s));
+      }
+      WindowStats &w = record.signals[s];
+      w.count = (uint16_t)values.size();
+      if (values.empty()) continue;
+      double sum = 0;
+      w.min = w.max = values[0];
+      for (size_t i = 0; i < values.size(); i++) {
+        if (values[i] < w.min) w.min = values[i];
+        if (values[i] > w.max) w.max = values[i];
+        sum += values[i];
+      }
+      w.mean = (int32_t)llround(sum / values.size());
+      w.last = values.back();
+    }
+    for (size_t i = first; i < end; i++) {
+      if (!samples[i].battery) mode = samples[i].state.motor.mode;
+    }
+    record.mode = mode;
+    out.push_back(record);
+    first = end;
+  }
+}
+
+static bool sameRecord(const WindowRecord &a, const WindowRecord &b) {
+  if (a.startUs != b.startUs || a.periodMs != b.periodMs || a.mode != b.mode) return false;
+  for (uint8_t s = 0; s < WINDOW_SIGNAL_COUNT; s++) {
+    const WindowStats &x = a.signals[s];
+    const WindowStats &y = b.signals[s];
+    if (x.count != y.count) return false;
+    if (x.count && (x.min != y.min || x.max != y.max || x.mean != y.mean || x.last != y.last)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static double nsPerFrame(std::chrono::steady_clock::time_point start, size_t frames) {
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+             .count() / frames;
+}
+
+int main(int argc, char **argv) {
+  const char *path = argc > 1 ? argv[1] : "src/esp32/_can_log (2).csv";
+  int repeats = argc > 2 ? atoi(argv[2]) : 20;
+  if (repeats < 1) repeats = 1;
+
+  std::vector<CanMessage> frames;
+  if (!loadCapture(path, frames, SESSION_GAP_US)) {
+    fprintf(stderr, "Captura %s não encontrada; só o simulador\n", path);
+  }
+  size_t captureFrames = frames.size();
+  simulateRide(frames);
+  printf("Frames: %zu (captura %zu, simulador %zu)\n", frames.size(), captureFrames,
+         frames.size() - captureFrames);
+
+  // --- 1. VALIDAÇÃO ---
+  std::vector<WindowRecord> records;
+  run<WindowDecoder>(frames, &records);
+
+  std::vector<Sample> samples;
+  VehicleState state;
+  for (size_t i = 0; i < frames.size(); i++) {
+    if (!applyFrame(state, frames[i].id, frames[i].data, frames[i].length,
+                    frames[i].timestampUs / 1000)) {
+      continue;
+    }
+    Sample sample = {frames[i].timestampUs, frames[i].id == BASE_BATTERY_ID, state};
+    samples.push_back(sample);
+  }
+
+  const uint32_t periodsMs[] = {SIGNAL_WINDOW_SHORT_MS, SIGNAL_WINDOW_LONG_MS};
+  unsigned mismatches = 0;
+  for (uint8_t level = 0; level < 2; level++) {
+    std::vector<WindowRecord> expected, got;
+    referenceWindows(samples, periodsMs[level], level, expected);
+    for (size_t i = 0; i < records.size(); i++) {
+      if (records[i].level == level) got.push_back(records[i]);
+    }
+    size_t n = got.size() < expected.size() ? got.size() : expected.size();
+    unsigned bad = got.size() == expected.size() ? 0 : 1;
+    for (size_t i = 0; i < n; i++) {
+      if (!sameRecord(got[i], expected[i])) {
+        if (bad++ == 0) {
+          fprintf(stderr, "Janela %lums #%zu diverge (início %lu µs)\n",
+                  (unsigned long)periodsMs[level], i, (unsigned long)expected[i].startUs);
+        }
+      }
+    }
+    printf("Janelas de %5lu ms: %zu (referência %zu) %s\n", (unsigned long)periodsMs[level],
+           got.size(), expected.size(), bad ? "DIVERGE" : "ok");
+    mismatches += bad;
+  }
+
+  // --- 2. CUSTO POR FRAME ---
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeats; r++) run<StateDecoder>(frames, NULL);
+  double baseNs = nsPerFrame(start, frames.size() * repeats);
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeats; r++) run<WindowDecoder>(frames, NULL);
+  double windowNs = nsPerFrame(start, frames.size() * repeats);
+  printf("Custo: applyFrame %.1f ns/frame, com janelas %.1f ns/frame (+%.1f ns)\n", baseNs,
+         windowNs, windowNs - baseNs);
+  printf("Memória: SignalWindows %zu bytes, WindowRecord %zu bytes\n", sizeof(SignalWindows),
+         sizeof(WindowRecord));
+
+  // --- 3. BYTES PUBLICADOS ---
+  char buffer[384];
+  uint64_t rawBytes = 0, windowBytes[2] = {0, 0};
+  for (size_t i = 0; i < samples.size(); i++) {
+    // Mesmo formato do MqttJsonSink (sem IMU): dados em hex espaçado
+    rawBytes += (uint64_t)snprintf(buffer, sizeof(buffer),
+                                   "{\"canId\":%lu,\"ide\":false,\"dlc\":8,\"data\":\"%s\","
+                                   "\"dt\":%ld,\"as\":%u}",
+                                   (unsigned long)(samples[i].battery ? BASE_BATTERY_ID
+                                                                      : BASE_CONTROLLER_ID),
+                                   "00 00 00 00 00 00 00 00", 12345678L, 12u);
+  }
+  for (size_t i = 0; i < records.size(); i++) {
+    int length = windowRecordToJson(records[i], 12345678L, 12, buffer, sizeof(buffer));
+    windowBytes[records[i].level] += (uint64_t)length;
+  }
+  printf("JSON: frames brutos %llu bytes, janelas de %lu ms %llu bytes (%.1f%%), "
+         "de %lu ms %llu bytes (%.1f%%)\n",
+         (unsigned long long)rawBytes, (unsigned long)periodsMs[0],
+         (unsigned long long)windowBytes[0], 100.0 * windowBytes[0] / rawBytes,
+         (unsigned long)periodsMs[1], (unsigned long long)windowBytes[1],
+         100.0 * windowBytes[1] / rawBytes);
+
+  if (mismatches) {
+    printf("FALHA: %u nível(is) divergem da referência\n", mismatches);
+    return 2;
+  }
+  printf("OK\n");
+  return 0;
+}
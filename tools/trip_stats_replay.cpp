@@ -0,0 +1,269 @@
+// ------------------------------------------------------------------
+// Validação no PC dos agregados da viagem (src/common/trip_stats.h)
+// ------------------------------------------------------------------
+// Passa frames pelo TripDecoder do firmware (pipeline.h), com tick() a
+// cada 100 ms como a task de decodificação, e compara cada viagem com um
+// cálculo offline independente em double sobre os mesmos frames
+// (decodificação direta dos bytes, trapézio com corte no zero):
+//   captura:    _can_log.csv ("ms,0xID,S|E,dlc,HEX"); as duas sessões são
+//               separadas por uma pausa maior que o key-off → 2 viagens
+//   simulador:  vehicle_sim.h, 2 × 40 min com regeneração e troca de
+//               modo, separados por uma parada; os timestamps de 32 bits
+//               dão a volta (71 min) no meio da segunda viagem
+// Tolerâncias: energia ±1 mWh (o firmware trunca no mWh), potência média
+// ±1 W, distância ±1 m, tempo por modo ±1 ms; picos, máximos e SoC exatos.
+// Termina com código 2 se alguma viagem divergir.
+//
+// IDs da bateria e do controlador: os da captura (capture_ids.h), não os
+// de config/constants.h.
+//
+// Compilação:
+//   g++ -std=c++11 -O2 -Wall tools/trip_stats_replay.cpp -o .build/trip_stats_replay
+// Uso:
+//   .build/trip_stats_replay ["src/esp32/_can_log (2).csv"]
+
+#include "../src/common/capture_ids.h" // Antes de tudo: fixa os IDs
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "../src/common/capture_replay.h"
+#include "../src/common/pipeline.h"
+#include "../src/common/vehicle_sim.h"
+
+#define TICK_US 100000ULL          // BUS_CHECK_INTERVAL_MS do firmware
+#define SESSION_GAP_US 10000000ULL // Pausa entre sessões/viagens (> key-off)
+#define SIM_TRIP_US (40ULL * 60 * 1000000)
+
+/**
+ * @brief Duas viagens do simulador (só bateria e controlador), com parada
+ */
+static void simulateRides(std::vector<CaptureFrame> &frames) {
+  SimConfig config;
+  config.busLoadPercent = 0;
+  VehicleSim sim(config);
+  sim.setBusLoad(0);
+  uint64_t startUs = frames.empty() ? 0 : frames.back().us + SESSION_GAP_US;
+  for (int trip = 0; trip < 2; trip++) {
+    uint64_t simStart = sim.nowUs();
+    SimFrame simFrame;
+    do {
+      sim.nextFrame(simFrame);
+      CaptureFrame frame;
+      frame.us = startUs + simFrame.timeUs;
+      frame.message.id = simFrame.id;
+      frame.message.length = simFrame.length;
+      frame.message.isExtended = simFrame.isExtended;
+      memcpy(frame.message.data, simFrame.data, sizeof(frame.message.data));
+      frames.push_back(frame);
+    } while (simFrame.timeUs - simStart < SIM_TRIP_US);
+    startUs += SESSION_GAP_US; // Parada: o tempo virtual do simulador não anda
+  }
+}
+
+// ------------------------------------------------------------------
+// --- REFERÊNCIA OFFLINE (DOUBLE) ---
+// ------------------------------------------------------------------
+
+struct ReferenceTrip {
+  double consumedWh = 0, regenWh = 0, integratedS = 0;
+  double peakW = 0, peakRegenW = 0;
+  double distanceM = 0, durationS = 0;
+  double modeS[TRIP_MODE_COUNT] = {0};
+  int maxRpm = 0, maxMotorTemp = 0, maxControllerTemp = 0, maxBatteryTemp = 0;
+  int socStart = 0, socEnd = 0;
+  double minVoltage = 0;
+  unsigned batteryFrames = 0, motorFrames = 0;
+};
+
+class ReferenceAggregator {
+public:
+  void add(const CaptureFrame &frame, std::vector<ReferenceTrip> &done) {
+    const uint8_t *d = frame.message.data;
+    bool battery = frame.message.id == BASE_BATTERY_ID;
+    bool motor = frame.message.id == BASE_CONTROLLER_ID;
+    if ((!battery && !motor) || frame.message.isExtended || frame.message.length < 8) return;
+
+    double t = frame.us / 1e6;
+    if (active_ && t - lastFrame_ > TRIP_KEY_OFF_MS / 1000.0) close(done);
+    if (!active_) {
+      active_ = true;
+      trip_ = ReferenceTrip();
+      haveBattery_ = haveMotor_ = false;
+    } else {
+      trip_.durationS += t - lastFrame_;
+    }
+    lastFrame_ = t;
+
+    if (battery) {
+      double voltage = ((d[0] << 8) | d[1]) / 10.0;
+      double current = (int16_t)((d[2] << 8) | d[3]) / 10.0;
+      double power = voltage * current;
+      if (!haveBattery_) {
+        trip_.socStart = d[6];
+        trip_.minVoltage = voltage;
+        trip_.maxBatteryTemp = d[4];
+      } else if (t - lastBattery_ <= TRIP_MAX_HOLD_MS / 1000.0) {
+        double dt = t - lastBattery_;
+        integrate(lastPower_, power, dt);
+        trip_.integratedS += dt;
+      }
+      haveBattery_ = true;
+      lastBattery_ = t;
+      lastPower_ = power;
+      trip_.batteryFrames++;
+      trip_.socEnd = d[6];
+      trip_.peakW = fmax(trip_.peakW, power);
+      trip_.peakRegenW = fmax(trip_.peakRegenW, -power);
+      trip_.minVoltage = fmin(trip_.minVoltage, voltage);
+      trip_.maxBatteryTemp = d[4] > trip_.maxBatteryTemp ? d[4] : trip_.maxBatteryTemp;
+    } else {
+      int rpm = (d[0] << 8) | d[1];
+      int controllerTemp = d[6] - 40, motorTemp = d[7] * 2;
+      if (!haveMotor_) {
+        trip_.maxMotorTemp = motorTemp;
+        trip_.maxControllerTemp = controllerTemp;
+      } else if (t - lastMotor_ <= TRIP_MAX_HOLD_MS / 1000.0) {
+        double dt = t - lastMotor_;
+        trip_.modeS[tripMode(lastMode_)] += dt;
+        trip_.distanceM += (lastRpm_ + rpm) / 2.0 / 60.0 * dt * TRIP_WHEEL_CIRCUMFERENCE_MM / 1000.0;
+      }
+      haveMotor_ = true;
+      lastMotor_ = t;
+      lastRpm_ = rpm;
+      lastMode_ = d[5];
+      trip_.motorFrames++;
+      if (rpm > trip_.maxRpm) trip_.maxRpm = rpm;
+      if (motorTemp > trip_.maxMotorTemp) trip_.maxMotorTemp = motorTemp;
+      if (controllerTemp > trip_.maxControllerTemp) trip_.maxControllerTemp = controllerTemp;
+    }
+  }
+
+  void close(std::vector<ReferenceTrip> &done) {
+    if (!active_) return;
+    done.push_back(trip_);
+    active_ = false;
+  }
+
+private:
+  void integrate(double p0, double p1, double dt) {
+    if (p0 >= 0 && p1 >= 0) {
+      trip_.consumedWh += (p0 + p1) / 2 * dt / 3600;
+    } else if (p0 <= 0 && p1 <= 0) {
+      trip_.regenWh -= (p0 + p1) / 2 * dt / 3600;
+    } else {
+      double t0 = p0 / (p0 - p1) * dt;
+      double first = p0 / 2 * t0 / 3600, second = p1 / 2 * (dt - t0) / 3600;
+      if (p0 > 0) {
+        trip_.consumedWh += first;
+        trip_.regenWh -= second;
+      } else {
+        trip_.regenWh -= first;
+        trip_.consumedWh += second;
+      }
+    }
+  }
+
+  ReferenceTrip trip_;
+  bool active_ = false, haveBattery_ = false, haveMotor_ = false;
+  double lastFrame_ = 0, lastBattery_ = 0, lastMotor_ = 0, lastPower_ = 0;
+  int lastRpm_ = 0;
+  uint8_t lastMode_ = 0;
+};
+
+// ------------------------------------------------------------------
+// --- COMPARAÇÃO ---
+// ------------------------------------------------------------------
+
+static bool near(const char *name, double firmware, double reference, double tolerance) {
+  bool ok = fabs(firmware - reference) <= tolerance;
+  if (!ok) printf("    %s: firmware %.3f, referência %.3f\n", name, firmware, reference);
+  return ok;
+}
+
+static bool compare(const TripSummary &f, const ReferenceTrip &r) {
+  bool ok = true;
+  ok &= near("consumo mWh", f.consumedMilliWh, r.consumedWh * 1000, 1.0);
+  ok &= near("regen mWh", f.regenMilliWh, r.regenWh * 1000, 1.0);
+  double avg = r.integratedS > 0 ? (r.consumedWh - r.regenWh) * 3600 / r.integratedS : 0;
+  ok &= near("média W", f.avgPowerW, avg, 1.0);
+  ok &= near("pico W", f.peakPowerW, trunc(r.peakW), 0.0);
+  ok &= near("pico regen W", f.peakRegenW, trunc(r.peakRegenW), 0.0);
+  ok &= near("distância m", f.distanceM, r.distanceM, 1.0);
+  ok &= near("duração ms", f.durationMs, r.durationS * 1000, 1.0);
+  for (int i = 0; i < TRIP_MODE_COUNT; i++) ok &= near("modo ms", f.modeMs[i], r.modeS[i] * 1000, 1.0);
+  ok &= near("rpm máx", f.maxRpm, r.maxRpm, 0);
+  ok &= near("tMotor máx", f.maxMotorTemp, r.maxMotorTemp, 0);
+  ok &= near("tCtrl máx", f.maxControllerTemp, r.maxControllerTemp, 0);
+  ok &= near("tBat máx", f.maxBatteryTemp, r.maxBatteryTemp, 0);
+  ok &= near("tensão mín", f.minVoltageDeci / 10.0, r.minVoltage, 1e-9);
+  ok &= near("soc inicial", f.socStart, r.socStart, 0);
+  ok &= near("soc final", f.socEnd, r.socEnd, 0);
+  ok &= near("frames bateria", f.batteryFrames, r.batteryFrames, 0);
+  ok &= near("frames controlador", f.motorFrames, r.motorFrames, 0);
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  const char *path = argc > 1 ? argv[1] : "src/esp32/_can_log (2).csv";
+  std::vector<CaptureFrame> frames;
+  if (!loadCapture(path, frames, SESSION_GAP_US)) {
+    fprintf(stderr, "uso: trip_stats_replay [captura.csv]\n");
+    return 1;
+  }
+  size_t captureFrames = frames.size();
+  simulateRides(frames);
+  printf("%s: %lu frames da captura + %lu do simulador\n", path, (unsigned long)captureFrames,
+         (unsigned long)(frames.size() - captureFrames));
+
+  // --- Firmware: TripDecoder com tick() a cada 100 ms ---
+  TripDecoder decoder;
+  VehicleState state;
+  std::vector<TripSummary> firmware;
+  uint64_t nextTick = frames.front().us + TICK_US;
+  for (size_t i = 0; i <= frames.size(); i++) {
+    uint64_t until = i < frames.size() ? frames[i].us : frames.back().us + SESSION_GAP_US;
+    for (; nextTick <= until; nextTick += TICK_US) {
+      TripSummary trip;
+      if (decoder.tick((uint32_t)nextTick, trip)) firmware.push_back(trip);
+    }
+    if (i == frames.size()) break;
+    CanMessage message = frames[i].message;
+    message.timestampUs = (uint32_t)frames[i].us; // 32 bits, como TimeBase::stamp()
+    decoder.decode(message, state);
+  }
+
+  // --- Referência offline ---
+  ReferenceAggregator reference;
+  std::vector<ReferenceTrip> expected;
+  for (size_t i = 0; i < frames.size(); i++) reference.add(frames[i], expected);
+  reference.close(expected);
+
+  bool ok = firmware.size() == expected.size();
+  printf("%lu viagens (referência: %lu)\n\n", (unsigned long)firmware.size(),
+         (unsigned long)expected.size());
+  for (size_t i = 0; i < firmware.size() && i < expected.size(); i++) {
+    const TripSummary &t = firmware[i];
+    char json[384];
+    tripSummaryToJson(t, json, sizeof(json));
+    printf("  %s\n", json);
+    printf("  #%lu %.1f min, %.3f Wh consumidos, %.3f Wh regenerados, %.2f km, "
+           "ECO/STD/TURBO %.0f/%.0f/%.0f s\n",
+           (unsigned long)t.number, t.durationMs / 60000.0, t.consumedMilliWh / 1000.0,
+           t.regenMilliWh / 1000.0, t.distanceM / 1000.0, t.modeMs[TRIP_MODE_ECO] / 1000.0,
+           t.modeMs[TRIP_MODE_STD] / 1000.0, t.modeMs[TRIP_MODE_TURBO] / 1000.0);
+    printf("     referência: %.4f Wh / %.4f Wh / %.4f km\n", expected[i].consumedWh,
+           expected[i].regenWh, expected[i].distanceM / 1000.0);
+    if (!compare(t, expected[i])) {
+      printf("  FALHA: viagem %lu diverge da referência\n", (unsigned long)t.number);
+      ok = false;
+    }
+  }
+
+  printf("\n%s\n", ok ? "OK" : "FALHOU");
+  return ok ? 0 : 2;
+}
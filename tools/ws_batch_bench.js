@@ -0,0 +1,120 @@
+#!/usr/bin/env node
+// ------------------------------------------------------------------
+// Vazão do uplink WebSocket: JSON por frame × lote binário (sendBIN)
+// ------------------------------------------------------------------
+// Um servidor `ws` local faz o papel do backend e um cliente `ws` o do
+// ESP32 (esp32_WebSocket_RealTime_ok.cpp), na mesma máquina:
+//   antes : uma mensagem de texto por frame, o JSON de
+//           enviarFrameViaWebSocket ({"type":"canFrame","id",...})
+//   depois: lotes binários de utils/canBatchCodec.js (WS_BINARY_BATCH)
+// O servidor faz com cada mensagem o mesmo que handleWebSocketMessage
+// antes do processCanFrame (JSON.parse + objeto do frame, ou
+// decodeCanBatch) e confere que todos os frames chegaram iguais. Mede
+// frames/s do envio do primeiro frame ao último processado, e os bytes
+// de payload por frame.
+//
+// Uso:
+//   node tools/ws_batch_bench.js [frames] [frames por lote]
+
+const WebSocket = require('ws');
+const { decodeCanBatch, encodeCanBatch } = require('../utils/canBatchCodec');
+
+function makeFrame(i) {
+  return {
+    canId: i & 1 ? 0x120 : 0x300,
+    dlc: 8,
+    ide: false,
+    data: [i & 255, (i >> 8) & 255, (i >> 16) & 255, 4, 5, 6, 7, 8]
+  };
+}
+
+// Soma simples dos frames recebidos, para conferir que nada se perdeu
+function frameSum(frame) {
+  return frame.canId + frame.data.reduce((total, byte) => total + byte, 0);
+}
+
+/**
+ * Prepara as mensagens do ESP32 (fora da medição)
+ */
+function buildMessages(mode, frames, batchSize) {
+  const messages = [];
+  if (mode === 'json') {
+    for (let i = 0; i < frames; i++) {
+      const f = makeFrame(i);
+      messages.push(JSON.stringify({ type: 'canFrame', id: f.canId, dlc: f.dlc, extended: f.ide, data: f.data }));
+    }
+  } else {
+    for (let i = 0; i < frames; i += batchSize) {
+      const batch = [];
+      for (let j = i; j < Math.min(i + batchSize, frames); j++) batch.push(makeFrame(j));
+      messages.push(encodeCanBatch(batch));
+    }
+  }
+  return messages;
+}
+
+function run(mode, frames, batchSize) {
+  const messages = buildMessages(mode, frames, batchSize);
+  const bytes = messages.reduce((total, m) => total + (Buffer.isBuffer(m) ? m.length : Buffer.byteLength(m)), 0);
+  let expectedSum = 0;
+  for (let i = 0; i < frames; i++) expectedSum += frameSum(makeFrame(i));
+
+  return new Promise((resolve, reject) => {
+    const server = new WebSocket.Server({ port: 0 }, () => {
+      let received = 0;
+      let sum = 0;
+      let start;
+
+      server.on('connection', (ws) => {
+        ws.on('message', (message, isBinary) => {
+          if (isBinary) {
+            for (const frame of decodeCanBatch(message)) {
+              sum += frameSum(frame);
+              received++;
+            }
+          } else {
+            const data = JSON.parse(message.toString().trim());
+            const frame = { canId: data.id, data: data.data, dlc: data.dlc, ide: data.extended || false };
+            sum += frameSum(frame);
+            received++;
+          }
+          if (received < frames) return;
+          const seconds = Number(process.hrtime.bigint() - start) / 1e9;
+          ws.close();
+          server.close();
+          resolve({ framesPerSecond: frames / seconds, bytesPerFrame: bytes / frames, ok: sum === expectedSum });
+        });
+      });
+
+      const client = new WebSocket(`ws://127.0.0.1:${server.address().port}`);
+      client.on('error', reject);
+      client.on('open', () => {
+        start = process.hrtime.bigint();
+        for (const message of messages) client.send(message, { binary: Buffer.isBuffer(message) });
+      });
+    });
+  });
+}
+
+async function main(argv) {
+  const frames = Number(argv[0]) || 200000;
+  const batchSize = Number(argv[1]) || 100;
+
+  console.log(`${frames} frames, lote de ${batchSize}`);
+  console.log('caminho       frames/s   B/frame');
+  const before = await run('json', frames, batchSize);
+  const after = await run('binary', frames, batchSize);
+  const row = (name, r) => console.log(`${name.padEnd(12)} ${Math.round(r.framesPerSecond).toString().padStart(9)} ${r.bytesPerFrame.toFixed(1).padStart(9)}`);
+  row('json/frame', before);
+  row(`binário x${batchSize}`, after);
+  console.log(`ganho: ${(after.framesPerSecond / before.framesPerSecond).toFixed(2)}x`);
+
+  const ok = before.ok && after.ok;
+  console.log(ok ? 'OK' : 'FALHA: frames recebidos diferentes dos enviados');
+  return ok ? 0 : 1;
+}
+
+main(process.argv.slice(2)).then((code) => process.exit(code), (error) => {
+  console.error(error);
+  process.exit(1);
+});
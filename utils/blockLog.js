@@ -0,0 +1,192 @@
+/**
+ * @fileoverview Leitura e validação do log em blocos com CRC gravado pelo
+ * firmware no cartão SD (datalog.vzl). Espelha src/common/block_log.h.
+ *
+ * Arquivo: N blocos de 512 bytes gravados em círculo; o bloco da sequência
+ * s fica no índice (s - 1) % N. Cada bloco (little-endian):
+ *   magic (uint32, "VZBL") | seq (uint32) | tamanho (uint16) | versão (uint8)
+ *   | flags (uint8) | crc32 (uint32) | linhas CSV inteiras[tamanho]
+ * O CRC-32 (zlib) cobre os 12 primeiros bytes do cabeçalho e as linhas.
+ *
+ * @module blockLog
+ */
+
+const BLOCK_BYTES = 512;
+const HEADER_BYTES = 16;
+const PAYLOAD_BYTES = BLOCK_BYTES - HEADER_BYTES;
+const MAGIC = 0x4C425A56; // "VZBL"
+const VERSION = 1;
+const RECOVERY_BLOCKS = 4;
+
+const CRC_TABLE = new Uint32Array(256);
+for (let n = 0; n < 256; n++) {
+  let c = n;
+  for (let k = 0; k < 8; k++) {
+    c = c & 1 ? 0xEDB88320 ^ (c >>> 1) : c >>> 1;
+  }
+  CRC_TABLE[n] = c >>> 0;
+}
+
+/**
+ * CRC-32 (IEEE 802.3), o mesmo de blockLogCrc32() no firmware
+ * @param {Buffer} buffer
+ * @param {number} [crc=0] - Valor anterior, para continuar um cálculo
+ * @returns {number}
+ */
+function crc32(buffer, crc = 0) {
+  crc = ~crc >>> 0;
+  for (let i = 0; i < buffer.length; i++) {
+    crc = CRC_TABLE[(crc ^ buffer[i]) & 0xFF] ^ (crc >>> 8);
+  }
+  return ~crc >>> 0;
+}
+
+/**
+ * Monta um bloco como BlockLog::writeBlock() (uso: testes e simulações)
+ * @param {number} seq - Sequência (>= 1)
+ * @param {Buffer|string} payload - Linhas inteiras, até 496 bytes
+ * @returns {Buffer} Bloco de 512 bytes
+ */
+function encodeBlock(seq, payload) {
+  const data = Buffer.isBuffer(payload) ? payload : Buffer.from(payload);
+  if (data.length > PAYLOAD_BYTES) {
+    throw new Error(`Bloco com ${data.length} bytes de linhas (máximo ${PAYLOAD_BYTES})`);
+  }
+  const block = Buffer.alloc(BLOCK_BYTES);
+  block.writeUInt32LE(MAGIC, 0);
+  block.writeUInt32LE(seq >>> 0, 4);
+  block.writeUInt16LE(data.length, 8);
+  block[10] = VERSION;
+  block[11] = 0;
+  data.copy(block, HEADER_BYTES);
+  block.writeUInt32LE(crc32(data, crc32(block.subarray(0, 12))), 12);
+  return block;
+}
+
+/**
+ * Lê o bloco de um índice
+ * @details Ao contrário do firmware, não confere se o índice corresponde à
+ *          sequência: numa cópia truncada o número de blocos é desconhecido
+ * @param {Buffer} image - Arquivo inteiro
+ * @param {number} index
+ * @param {boolean} verify - Também confere o CRC
+ * @returns {{seq: number, payload: Buffer}|null} null se vazio, truncado ou inválido
+ */
+function readBlock(image, index, verify) {
+  const start = index * BLOCK_BYTES;
+  if (start + HEADER_BYTES > image.length) return null;
+  const seq = image.readUInt32LE(start + 4);
+  const length = image.readUInt16LE(start + 8);
+  if (image.readUInt32LE(start) !== MAGIC || image[start + 10] !== VERSION || seq === 0 ||
+      length > PAYLOAD_BYTES) {
+    return null;
+  }
+  const end = start + HEADER_BYTES + length;
+  if (end > image.length) return null;
+  const payload = image.subarray(start + HEADER_BYTES, end);
+  if (verify && crc32(payload, crc32(image.subarray(start, start + 12))) !== image.readUInt32LE(start + 12)) {
+    return null;
+  }
+  return { seq, payload };
+}
+
+/**
+ * Recuperação rápida do fim, como BlockLog::recover() no boot
+ * @param {Buffer} image - Arquivo inteiro
+ * @returns {{seq: number, index: number, reads: number, dropped: number, fullScan: boolean}}
+ *   seq 0 = log vazio; reads = blocos lidos
+ */
+function recoverTail(image) {
+  const count = Math.floor(image.length / BLOCK_BYTES);
+  let reads = 0;
+  const seqAt = (index, verify) => {
+    reads++;
+    const block = readBlock(image, index, verify);
+    return block ? block.seq : 0;
+  };
+  if (count < 2) return { seq: 0, index: -1, reads, dropped: 0, fullScan: false };
+
+  const anchor = seqAt(0, false);
+  let candidate = count - 1;
+  if (anchor !== 0) {
+    let low = 0;
+    let high = count - 1;
+    while (low < high) {
+      const mid = low + Math.floor((high - low + 1) / 2);
+      if (seqAt(mid, false) === anchor + mid) {
+        low = mid;
+      } else {
+        high = mid - 1;
+      }
+    }
+    candidate = low;
+  }
+
+  for (let back = 0; back < RECOVERY_BLOCKS && back < count; back++) {
+    const index = (candidate + count - back) % count;
+    const seq = seqAt(index, true);
+    if (seq !== 0) return { seq, index, reads, dropped: back, fullScan: false };
+    // Fim do arquivo nunca gravado: nada antes do bloco 0
+    if (index === count - 1 && seqAt(index, false) === 0) {
+      return { seq: 0, index: -1, reads, dropped: back, fullScan: false };
+    }
+  }
+
+  let best = { seq: 0, index: -1 };
+  for (let index = 0; index < count; index++) {
+    const seq = seqAt(index, true);
+    if (seq > best.seq) best = { seq, index };
+  }
+  return { ...best, reads, dropped: 0, fullScan: true };
+}
+
+/**
+ * Valida o arquivo inteiro e extrai as linhas, da mais antiga à mais nova
+ * @param {Buffer} image - Arquivo inteiro (pode estar truncado)
+ * @returns {{
+ *   blocks: number, valid: number, corrupt: number[], gaps: number,
+ *   firstSeq: number, lastSeq: number, tail: object, text: string
+ * }}
+ *   corrupt: índices com cabeçalho reconhecível mas CRC inválido;
+ *   gaps: sequências ausentes entre firstSeq e lastSeq
+ */
+function parseBlockLog(image) {
+  const count = Math.floor(image.length / BLOCK_BYTES);
+  const tail = recoverTail(image);
+  const found = [];
+  const corrupt = [];
+
+  for (let index = 0; index < count; index++) {
+    const block = readBlock(image, index, true);
+    if (block) {
+      // Mais novo que o fim recuperado: seria sobrescrito pelo firmware
+      if (block.seq <= tail.seq) found.push(block);
+    } else if (readBlock(image, index, false)) {
+      corrupt.push(index);
+    }
+  }
+
+  found.sort((a, b) => a.seq - b.seq);
+  const firstSeq = found.length ? found[0].seq : 0;
+  const lastSeq = found.length ? found[found.length - 1].seq : 0;
+  return {
+    blocks: count,
+    valid: found.length,
+    corrupt,
+    gaps: found.length ? lastSeq - firstSeq + 1 - found.length : 0,
+    firstSeq,
+    lastSeq,
+    tail,
+    text: Buffer.concat(found.map((block) => block.payload)).toString('latin1')
+  };
+}
+
+module.exports = {
+  BLOCK_BYTES,
+  PAYLOAD_BYTES,
+  crc32,
+  encodeBlock,
+  readBlock,
+  recoverTail,
+  parseBlockLog
+};
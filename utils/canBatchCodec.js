@@ -0,0 +1,101 @@
+/**
+ * @fileoverview Codec do lote binário de frames CAN enviado pelo ESP32 via
+ * WebSocket (sendBIN). Espelha src/common/can_batch_codec.h.
+ *
+ * Formato (little-endian):
+ *   Cabeçalho (5 bytes): 'V' 'B' | versão (1) | quantidade (uint16)
+ *   Cada frame: id (uint32, bit 31 = ID estendido) | dlc (uint8) | dados[dlc]
+ *
+ * @module canBatchCodec
+ */
+
+const MAGIC_0 = 0x56; // 'V'
+const MAGIC_1 = 0x42; // 'B'
+const VERSION = 1;
+const HEADER_SIZE = 5;
+const EXTENDED_FLAG = 0x80000000;
+
+/**
+ * Verifica se o buffer começa com o cabeçalho de um lote binário
+ * @param {Buffer} buffer
+ * @returns {boolean}
+ */
+function isCanBatch(buffer) {
+  return Buffer.isBuffer(buffer) &&
+    buffer.length >= HEADER_SIZE &&
+    buffer[0] === MAGIC_0 &&
+    buffer[1] === MAGIC_1;
+}
+
+/**
+ * Decodifica um lote binário em frames no formato usado pelo backend
+ * @param {Buffer} buffer - Mensagem binária recebida do ESP32
+ * @returns {Array<{canId: number, dlc: number, ide: boolean, data: number[]}>}
+ * @throws {Error} Se o cabeçalho for inválido ou o lote estiver truncado
+ */
+function decodeCanBatch(buffer) {
+  if (!isCanBatch(buffer)) {
+    throw new Error('Lote CAN inválido: cabeçalho ausente');
+  }
+  if (buffer[2] !== VERSION) {
+    throw new Error(`Lote CAN com versão não suportada: ${buffer[2]}`);
+  }
+
+  const count = buffer.readUInt16LE(3);
+  const frames = new Array(count);
+  let offset = HEADER_SIZE;
+
+  for (let i = 0; i < count; i++) {
+    if (offset + 5 > buffer.length) {
+      throw new Error(`Lote CAN truncado no frame ${i}`);
+    }
+    const word = buffer.readUInt32LE(offset);
+    const dlc = buffer[offset + 4];
+    offset += 5;
+    if (dlc > 8 || offset + dlc > buffer.length) {
+      throw new Error(`Lote CAN truncado no frame ${i}`);
+    }
+
+    frames[i] = {
+      canId: (word & ~EXTENDED_FLAG) >>> 0,
+      dlc,
+      ide: (word & EXTENDED_FLAG) !== 0,
+      data: Array.from(buffer.subarray(offset, offset + dlc))
+    };
+    offset += dlc;
+  }
+
+  return frames;
+}
+
+/**
+ * Codifica frames no formato binário (usado em testes e simuladores)
+ * @param {Array<{canId: number, ide?: boolean, data: number[]}>} frames
+ * @returns {Buffer}
+ */
+function encodeCanBatch(frames) {
+  const size = frames.reduce((total, f) => total + 5 + f.data.length, HEADER_SIZE);
+  const buffer = Buffer.alloc(size);
+
+  buffer[0] = MAGIC_0;
+  buffer[1] = MAGIC_1;
+  buffer[2] = VERSION;
+  buffer.writeUInt16LE(frames.length, 3);
+
+  let offset = HEADER_SIZE;
+  for (const frame of frames) {
+    const word = frame.ide ? (frame.canId | EXTENDED_FLAG) >>> 0 : frame.canId;
+    buffer.writeUInt32LE(word, offset);
+    buffer[offset + 4] = frame.data.length;
+    Buffer.from(frame.data).copy(buffer, offset + 5);
+    offset += 5 + frame.data.length;
+  }
+
+  return buffer;
+}
+
+module.exports = {
+  isCanBatch,
+  decodeCanBatch,
+  encodeCanBatch
+};
@@ -1,6 +1,8 @@
 // utils/canDecoder.js
 
 const { BASE_BATTERY_ID, BASE_CONTROLLER_ID } = require('../config/constants');
+// Layout dos sinais gerado de config/voltz.dbc (o mesmo do firmware)
+const { MESSAGES, decodeBattery, decodeController } = require('./voltzSignals');
 
 /**
  * Decodifica dados da bateria a partir de um frame CAN
@@ -12,20 +14,20 @@ function decodeBatteryData(data) {
     throw new Error('Dados da bateria inválidos: array deve ter pelo menos 8 bytes');
   }
 
+  const battery = decodeBattery(data);
   return {
-    current: ((data[2] * 256 + data[3]) * 0.1).toFixed(2),
-    voltage: ((data[0] * 256 + data[1]) * 0.1).toFixed(2),
-    soc: (data[6]).toFixed(2),
-    soh: (data[7]).toFixed(2),
-    temperature: (data[4]).toFixed(2)
+    current: battery.current.toFixed(2),
+    voltage: battery.voltage.toFixed(2),
+    soc: battery.soc.toFixed(2),
+    soh: battery.soh.toFixed(2),
+    temperature: battery.temperature.toFixed(2)
   };
 }
 
+const MODE_NAMES = MESSAGES.Controller.signals.find((signal) => signal.name === 'mode').values;
+
 function modo(params) {
-  if (params == 0x45) return "ECO";
-  else if (params == 0x4D) return "STD";
-  else if (params == 0x55) return "TURBO";
-  return "DESCONHECIDO";
+  return MODE_NAMES[params] || "DESCONHECIDO";
 }
 
 /**
@@ -38,12 +40,13 @@ function decodeMotorControllerData(data) {
     throw new Error('Dados do motor inválidos: array deve ter pelo menos 8 bytes');
   }
 
+  const motor = decodeController(data);
   return {
-    rpm: (data[0] * 256 + data[1]).toFixed(2),
-    torque: ((data[2] * 256 + data[3]) * 0.1).toFixed(2),
-    motorTemp: (data[7] * 2).toFixed(2),
-    controlTemp: (data[6] - 40).toFixed(2),
-    modo: modo(data[5])
+    rpm: motor.rpm.toFixed(2),
+    torque: motor.torque.toFixed(2),
+    motorTemp: motor.motorTemp.toFixed(2),
+    controlTemp: motor.controlTemp.toFixed(2),
+    modo: modo(motor.mode)
   };
 }
 
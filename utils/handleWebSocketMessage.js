@@ -15,6 +15,7 @@
 
 const axios = require('axios');
 const { decodeCanFrame, } = require('../utils/canDecoder');
+const { isCanBatch, decodeCanBatch } = require('../utils/canBatchCodec');
 const VehicleData = require('../models/canDataModels'); // Importe seu modelo
 const CanFrame = require('../models/canFrameModels');
 
@@ -35,6 +36,16 @@ const canBuffer = [];
 // Limite do buffer (envia quando atingir este número)
 const BUFFER_LIMIT = 100;
 
+// Lotes binários que chegam antes da identificação (addData() ainda em
+// curso) ficam guardados por conexão até o deviceId existir
+const PENDING_BATCH_LIMIT = 32;
+
+// Contadores dos lotes binários que não viraram frames
+const batchStats = {
+  rejected: 0,       // Binário sem cabeçalho de lote ou truncado
+  pendingDropped: 0  // Mais antigos descartados com a espera cheia
+};
+
 /**
  * Adiciona um frame CAN ao buffer
  */
@@ -79,6 +90,87 @@ async function processBuffer() {
   }
 }
 
+/**
+ * Processa um frame CAN recebido do ESP32: bufferiza para o banco,
+ * repassa aos dashboards e envia a versão decodificada.
+ *
+ * @param {WebSocket.Server} wss - Servidor WebSocket
+ * @param {WebSocket} ws - Conexão do ESP32 (não recebe o eco)
+ * @param {Object} canFrame - Frame `{ canId, data, dlc, ide }`
+ */
+function processCanFrame(wss, ws, canFrame) {
+  // Adiciona ao buffer em vez de salvar imediatamente
+  addBuffer(canFrame, ws.deviceId);
+
+  // Cria o objeto para envio reaproveitando as propriedades anteriores
+  const messagePayload = {
+    ...canFrame,
+    type: "canFrame"
+  };
+  sendMessage(wss, ws, messagePayload);
+  const decoded = decodeCanFrame(canFrame);
+  const validTypes = ['battery', 'motorController'];
+
+  if (decoded && validTypes.includes(decoded.type)) {
+    const decodedData = {
+      type: decoded.type,
+      decoded: decoded.data
+    };
+    sendMessage(wss, ws, decodedData);
+  }
+}
+
+/**
+ * Decodifica um lote binário e processa cada frame
+ * @returns {boolean} false se o lote é inválido (contabilizado)
+ */
+function processCanBatch(wss, ws, message) {
+  let frames;
+  try {
+    frames = decodeCanBatch(message);
+  } catch (error) {
+    batchStats.rejected++;
+    console.warn(`⚠️ Lote CAN recusado (${batchStats.rejected}): ${error.message}`);
+    return false;
+  }
+  for (const canFrame of frames) {
+    processCanFrame(wss, ws, canFrame);
+  }
+  return true;
+}
+
+/**
+ * Guarda um lote recebido antes da identificação do ESP32
+ */
+function holdCanBatch(ws, message) {
+  if (!ws.pendingBatches) ws.pendingBatches = [];
+  if (ws.pendingBatches.length >= PENDING_BATCH_LIMIT) {
+    ws.pendingBatches.shift();
+    batchStats.pendingDropped++;
+    console.warn(`⚠️ Lote CAN antes da identificação descartado (${batchStats.pendingDropped})`);
+  }
+  ws.pendingBatches.push(message);
+}
+
+/**
+ * Processa os lotes guardados, na ordem de chegada, depois da identificação
+ */
+function flushPendingBatches(wss, ws) {
+  const pending = ws.pendingBatches || [];
+  ws.pendingBatches = [];
+  for (const message of pending) {
+    processCanBatch(wss, ws, message);
+  }
+}
+
+/**
+ * Contadores dos lotes binários recusados ou descartados
+ * @returns {{rejected: number, pendingDropped: number}}
+ */
+function getBatchStats() {
+  return { ...batchStats };
+}
+
 /**
  * Adiciona dados iniciais para o dispositivo no banco de dados.
  * 
@@ -114,17 +206,33 @@ async function addData() {
  * @param {WebSocket} ws - Conexão WebSocket do cliente (ESP32).
  * @param {Buffer} message - Mensagem recebida do cliente.
  * @param {Set<WebSocket>} allClients - Conjunto de todos os clientes conectados (ex: dashboards).
+ * @param {boolean} [isBinary] - true para mensagens binárias (lote de frames CAN).
  * @returns {Promise<void>}
  * Esta função:
+ * - Decodifica lotes binários de frames CAN (sendBIN do ESP32).
  * - Faz parse da mensagem JSON.
  * - Processa frames CAN recebidos.
  * - Decodifica os dados (bateria/motor) e envia para o frontend.
  * - Salva os frames no banco de dados.
  * - Reenvia mensagens para outros clientes conectados.
  */
-async function handleWebSocketMessage(wss, ws, message, req) {
+async function handleWebSocketMessage(wss, ws, message, req, isBinary = false) {
   try {
 
+    // Lote binário: vários frames CAN em uma única mensagem WebSocket.
+    // Antes da identificação ele espera; sem cabeçalho é recusado
+    if (isBinary) {
+      if (!isCanBatch(message)) {
+        batchStats.rejected++;
+        console.warn(`⚠️ Mensagem binária sem cabeçalho de lote recusada (${batchStats.rejected})`);
+      } else if (ws.deviceId) {
+        processCanBatch(wss, ws, message);
+      } else {
+        holdCanBatch(ws, message);
+      }
+      return;
+    }
+
     const raw = message.toString().trim();
 
     // Primeira mensagem do ESP32: identificação
@@ -132,6 +240,7 @@ async function handleWebSocketMessage(wss, ws, message, req) {
       addData().then(deviceId => {
         ws.deviceId = deviceId;
         console.log(`🔌 ESP32 Conectado: ${deviceId} | IP: ${req.socket.remoteAddress}`);
+        if (deviceId) flushPendingBatches(wss, ws);
         // Notifica outros clientes (dashboards) sobre a nova conexão do ESP32
         sendMessage(wss, ws, `🔌 ESP32 Conectado ${deviceId}`);
       });
@@ -159,25 +268,7 @@ async function handleWebSocketMessage(wss, ws, message, req) {
           ide: data.extended || false
         };
 
-        // Adiciona ao buffer em vez de salvar imediatamente
-        addBuffer(canFrame, ws.deviceId);
-
-        // Cria o objeto para envio reaproveitando as propriedades anteriores
-        const messagePayload = {
-          ...canFrame,
-          type: "canFrame"
-        };
-        sendMessage(wss, ws, messagePayload);
-        const decoded = decodeCanFrame(canFrame);
-        const validTypes = ['battery', 'motorController'];
-
-        if (decoded && validTypes.includes(decoded.type)) {
-          const decodedData = {
-            type: decoded.type,
-            decoded: decoded.data
-          };
-          sendMessage(wss, ws, decodedData);
-        }
+        processCanFrame(wss, ws, canFrame);
       }
     }
 
@@ -191,4 +282,5 @@ module.exports = {
   handleWebSocketMessage,
   addData,
   sendMessage,
+  getBatchStats,
 };
\ No newline at end of file
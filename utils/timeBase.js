@@ -0,0 +1,90 @@
+/**
+ * @fileoverview Reconstrução do horário absoluto dos frames CAN a partir das
+ * âncoras de tempo publicadas pelo ESP32.
+ *
+ * O firmware carimba cada frame com um contador monotônico (µs) e envia
+ * apenas o delta `dt` em relação à âncora `as`. As âncoras chegam pelo mesmo
+ * tópico como `{ type: 'anchor', as, mono, utc, ppm, sync, step }`.
+ *
+ * @module timeBase
+ */
+
+// Quantas âncoras recentes manter por origem (frames atrasados na fila
+// ainda podem referenciar uma âncora anterior)
+const MAX_ANCHORS_PER_SOURCE = 8;
+
+// source (ex: tópico MQTT ou deviceId) → Map(seq → âncora)
+const anchorsBySource = new Map();
+
+/**
+ * Verifica se a mensagem é uma âncora de tempo
+ * @param {Object} msg - Mensagem decodificada do ESP32
+ * @returns {boolean}
+ */
+function isAnchor(msg) {
+  return !!msg && msg.type === 'anchor' && msg.as !== undefined;
+}
+
+/**
+ * Registra uma âncora recebida
+ * @param {string} source - Identificador da origem (tópico/dispositivo)
+ * @param {Object} msg - Âncora `{ as, mono, utc, ppm, sync, step }`
+ */
+function updateAnchor(source, msg) {
+  let anchors = anchorsBySource.get(source);
+  if (!anchors) {
+    anchors = new Map();
+    anchorsBySource.set(source, anchors);
+  }
+
+  // seq menor que a última âncora: o ESP32 reiniciou e recomeçou do 0.
+  // As âncoras do boot anterior não valem para os frames novos
+  const seq = Number(msg.as);
+  const newest = [...anchors.keys()].pop();
+  if (newest !== undefined && seq < newest) anchors.clear();
+
+  // delete antes do set: uma chave reaproveitada volta ao fim da ordem de
+  // inserção, e o descarte abaixo remove de fato as mais antigas
+  anchors.delete(seq);
+  anchors.set(seq, {
+    utc: Number(msg.utc),
+    ppm: Number(msg.ppm) || 0,
+    synced: msg.sync !== false && msg.sync !== 0
+  });
+
+  // Descarta as âncoras mais antigas (Map preserva ordem de inserção)
+  while (anchors.size > MAX_ANCHORS_PER_SOURCE) {
+    anchors.delete(anchors.keys().next().value);
+  }
+}
+
+/**
+ * Reconstrói o horário UTC de um frame
+ * @param {string} source - Identificador da origem (tópico/dispositivo)
+ * @param {Object} msg - Frame com `dt` (µs) e `as` (seq da âncora)
+ * @returns {Date|null} Horário absoluto ou null se não for possível
+ */
+function resolveTimestamp(source, msg) {
+  if (!msg || msg.dt === undefined || msg.as === undefined) return null;
+
+  const anchor = anchorsBySource.get(source)?.get(Number(msg.as));
+  if (!anchor || !anchor.synced) return null;
+
+  // Corrige o delta pelo desvio medido entre monotônico e UTC
+  const deltaMs = (Number(msg.dt) / 1000) * (1 + anchor.ppm / 1e6);
+  return new Date(Math.round(anchor.utc + deltaMs));
+}
+
+/**
+ * Limpa todas as âncoras (usado em testes)
+ */
+function resetAnchors() {
+  anchorsBySource.clear();
+}
+
+module.exports = {
+  isAnchor,
+  updateAnchor,
+  resolveTimestamp,
+  resetAnchors
+};
@@ -0,0 +1,67 @@
+// utils/voltzSignals.js
+// Gerado por tools/dbc_codegen.js a partir de config/voltz.dbc: não editar.
+// Altere o DBC e rode `node tools/dbc_codegen.js`.
+
+/** Layout de cada mensagem, como no DBC */
+const MESSAGES = {
+  Battery: {
+    id: 0x120,
+    extended: false,
+    dlc: 8,
+    signals: [
+      { name: 'voltage', startBit: 7, length: 16, motorola: true, signed: false, factor: 0.1, offset: 0, unit: 'V' },
+      { name: 'current', startBit: 23, length: 16, motorola: true, signed: true, factor: 0.1, offset: 0, unit: 'A' },
+      { name: 'temperature', startBit: 39, length: 8, motorola: true, signed: false, factor: 1, offset: 0, unit: 'C' },
+      { name: 'soc', startBit: 55, length: 8, motorola: true, signed: false, factor: 1, offset: 0, unit: '%' },
+      { name: 'soh', startBit: 63, length: 8, motorola: true, signed: false, factor: 1, offset: 0, unit: '%' },
+    ]
+  },
+  Controller: {
+    id: 0x300,
+    extended: false,
+    dlc: 8,
+    signals: [
+      { name: 'rpm', startBit: 7, length: 16, motorola: true, signed: false, factor: 1, offset: 0, unit: 'rpm' },
+      { name: 'torque', startBit: 23, length: 16, motorola: true, signed: false, factor: 0.1, offset: 0, unit: 'Nm' },
+      { name: 'mode', startBit: 47, length: 8, motorola: true, signed: false, factor: 1, offset: 0, unit: '', values: { 69: 'ECO', 77: 'STD', 85: 'TURBO' } },
+      { name: 'controlTemp', startBit: 55, length: 8, motorola: true, signed: false, factor: 1, offset: -40, unit: 'C' },
+      { name: 'motorTemp', startBit: 63, length: 8, motorola: true, signed: false, factor: 2, offset: 0, unit: 'C' },
+    ]
+  },
+};
+
+/**
+ * Decodifica Battery (0x120) em valores físicos
+ * @param {number[]|Uint8Array} data - Pelo menos 8 bytes
+ * @returns {object}
+ */
+function decodeBattery(data) {
+  return {
+    voltage: ((data[0] << 8) | data[1]) / 10, // BE uint16 bit 7 × 0.1 V
+    current: ((((data[2] << 8) | data[3]) << 16) >> 16) / 10, // BE int16 bit 23 × 0.1 A
+    temperature: data[4], // BE uint8 bit 39 C
+    soc: data[6], // BE uint8 bit 55 %
+    soh: data[7], // BE uint8 bit 63 %
+  };
+}
+
+/**
+ * Decodifica Controller (0x300) em valores físicos
+ * @param {number[]|Uint8Array} data - Pelo menos 8 bytes
+ * @returns {object}
+ */
+function decodeController(data) {
+  return {
+    rpm: ((data[0] << 8) | data[1]), // BE uint16 bit 7 rpm
+    torque: ((data[2] << 8) | data[3]) / 10, // BE uint16 bit 23 × 0.1 Nm
+    mode: data[5], // BE uint8 bit 47
+    controlTemp: (data[6] - 40), // BE uint8 bit 55 − 40 C
+    motorTemp: data[7] * 2, // BE uint8 bit 63 × 2 C
+  };
+}
+
+module.exports = {
+  MESSAGES,
+  decodeBattery,
+  decodeController,
+};